@@ -17,9 +17,71 @@
 */
 
 #include <Box2D/Collision/b2BroadPhase.h>
+#include <Box2D/Common/b2ThreadPool.h>
 #include <cstring>
 using namespace std;
 
+// The pairs found by the queries of one thread.
+struct b2ThreadPairBuffer
+{
+	bool QueryCallback(int32 proxyId)
+	{
+		// A proxy cannot form a pair with itself.
+		if (proxyId == queryProxyId)
+		{
+			return true;
+		}
+
+		// Grow the pair buffer as needed.
+		if (pairCount == pairCapacity)
+		{
+			b2Pair* oldBuffer = pairs;
+			pairCapacity *= 2;
+			pairs = (b2Pair*)b2Alloc(pairCapacity * sizeof(b2Pair));
+			memcpy(pairs, oldBuffer, pairCount * sizeof(b2Pair));
+			b2Free(oldBuffer);
+		}
+
+		pairs[pairCount].proxyIdA = b2Min(proxyId, queryProxyId);
+		pairs[pairCount].proxyIdB = b2Max(proxyId, queryProxyId);
+		++pairCount;
+
+		return true;
+	}
+
+	b2Pair* pairs;
+	int32 pairCapacity;
+	int32 pairCount;
+	int32 queryProxyId;
+};
+
+class b2QueryMovesTask : public b2ThreadPoolTask
+{
+public:
+	void Execute(int32 begin, int32 end, int32 threadIndex)
+	{
+		b2ThreadPairBuffer* buffer = m_buffers + threadIndex;
+
+		for (int32 i = begin; i < end; ++i)
+		{
+			buffer->queryProxyId = m_moveBuffer[i];
+			if (buffer->queryProxyId == b2BroadPhase::e_nullProxy)
+			{
+				continue;
+			}
+
+			// We have to query the tree with the fat AABB so that
+			// we don't fail to create a pair that may touch later.
+			const b2AABB& fatAABB = m_tree->GetFatAABB(buffer->queryProxyId);
+			m_tree->Query(buffer, fatAABB);
+		}
+	}
+
+	const b2DynamicTree* m_tree;
+	const int32* m_moveBuffer;
+	b2ThreadPairBuffer* m_buffers;
+};
+
 b2BroadPhase::b2BroadPhase()
 {
 	m_proxyCount = 0;
@@ -31,14 +93,88 @@ b2BroadPhase::b2BroadPhase()
 	m_moveCapacity = 16;
 	m_moveCount = 0;
 	m_moveBuffer = (int32*)b2Alloc(m_moveCapacity * sizeof(int32));
+
+	m_refitProxies = false;
+
+	m_threadPool = NULL;
+	m_threadPairs = NULL;
+	m_threadPairCount = 0;
 }
 
 b2BroadPhase::~b2BroadPhase()
 {
+	SetThreadPool(NULL);
 	b2Free(m_moveBuffer);
 	b2Free(m_pairBuffer);
 }
 
+void b2BroadPhase::SetThreadPool(b2ThreadPool* threadPool)
+{
+	for (int32 i = 0; i < m_threadPairCount; ++i)
+	{
+		b2Free(m_threadPairs[i].pairs);
+	}
+	b2Free(m_threadPairs);
+	m_threadPairs = NULL;
+	m_threadPairCount = 0;
+
+	m_threadPool = threadPool;
+
+	if (m_threadPool)
+	{
+		m_threadPairCount = m_threadPool->GetThreadCount();
+		m_threadPairs = (b2ThreadPairBuffer*)b2Alloc(m_threadPairCount * sizeof(b2ThreadPairBuffer));
+		for (int32 i = 0; i < m_threadPairCount; ++i)
+		{
+			b2ThreadPairBuffer* buffer = m_threadPairs + i;
+			buffer->pairCapacity = 16;
+			buffer->pairCount = 0;
+			buffer->pairs = (b2Pair*)b2Alloc(buffer->pairCapacity * sizeof(b2Pair));
+			buffer->queryProxyId = e_nullProxy;
+		}
+	}
+}
+
+void b2BroadPhase::QueryMovesParallel()
+{
+	for (int32 i = 0; i < m_threadPairCount; ++i)
+	{
+		m_threadPairs[i].pairCount = 0;
+	}
+
+	b2QueryMovesTask task;
+	task.m_tree = &m_tree;
+	task.m_moveBuffer = m_moveBuffer;
+	task.m_buffers = m_threadPairs;
+	m_threadPool->ParallelFor(&task, m_moveCount, 64);
+
+	// Merge the thread buffers. The pairs are sorted afterwards, so
+	// the order in which the threads found them does not matter.
+	int32 pairCount = 0;
+	for (int32 i = 0; i < m_threadPairCount; ++i)
+	{
+		pairCount += m_threadPairs[i].pairCount;
+	}
+
+	if (pairCount > m_pairCapacity)
+	{
+		while (m_pairCapacity < pairCount)
+		{
+			m_pairCapacity *= 2;
+		}
+		b2Free(m_pairBuffer);
+		m_pairBuffer = (b2Pair*)b2Alloc(m_pairCapacity * sizeof(b2Pair));
+	}
+
+	m_pairCount = 0;
+	for (int32 i = 0; i < m_threadPairCount; ++i)
+	{
+		const b2ThreadPairBuffer* buffer = m_threadPairs + i;
+		memcpy(m_pairBuffer + m_pairCount, buffer->pairs, buffer->pairCount * sizeof(b2Pair));
+		m_pairCount += buffer->pairCount;
+	}
+}
+
 int32 b2BroadPhase::CreateProxy(const b2AABB& aabb, void* userData)
 {
 	int32 proxyId = m_tree.CreateProxy(aabb, userData);
@@ -47,6 +183,16 @@ int32 b2BroadPhase::CreateProxy(const b2AABB& aabb, void* userData)
 	return proxyId;
 }
 
+void b2BroadPhase::CreateProxies(const b2AABB* aabbs, void* const* userData, int32 count, int32* proxyIds)
+{
+	m_tree.CreateProxies(aabbs, userData, count, proxyIds);
+	m_proxyCount += count;
+	for (int32 i = 0; i < count; ++i)
+	{
+		BufferMove(proxyIds[i]);
+	}
+}
+
 void b2BroadPhase::DestroyProxy(int32 proxyId)
 {
 	UnBufferMove(proxyId);
@@ -56,7 +202,16 @@ void b2BroadPhase::DestroyProxy(int32 proxyId)
 
 void b2BroadPhase::MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement)
 {
-	bool buffer = m_tree.MoveProxy(proxyId, aabb, displacement);
+	bool buffer;
+	if (m_refitProxies)
+	{
+		buffer = m_tree.RefitProxy(proxyId, aabb, displacement);
+	}
+	else
+	{
+		buffer = m_tree.MoveProxy(proxyId, aabb, displacement);
+	}
+
 	if (buffer)
 	{
 		BufferMove(proxyId);
@@ -31,6 +31,8 @@ struct b2Pair
 	int32 next;
 };
 
+struct b2ThreadPairBuffer;
+
 /// The broad-phase is used for computing pairs and performing volume queries and ray casts.
 /// This broad-phase does not persist pairs. Instead, this reports potentially new pairs.
 /// It is up to the client to consume the new pairs and to track subsequent overlap.
@@ -50,6 +52,11 @@ public:
 	/// UpdatePairs is called.
 	int32 CreateProxy(const b2AABB& aabb, void* userData);
 
+	/// Create many proxies at once with b2DynamicTree::CreateProxies, which rebuilds
+	/// the tree. Pairs are not reported until UpdatePairs is called.
+	/// @param proxyIds receives the id of each proxy.
+	void CreateProxies(const b2AABB* aabbs, void* const* userData, int32 count, int32* proxyIds);
+
 	/// Destroy a proxy. It is up to the client to remove any pairs.
 	void DestroyProxy(int32 proxyId);
 
@@ -57,6 +64,12 @@ public:
 	/// call UpdatePairs to finalized the proxy pairs (for your time step).
 	void MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement);
 
+	/// Let MoveProxy refit the tree with b2DynamicTree::RefitProxy instead of
+	/// re-inserting the proxies that leave their fat AABB. Call RebuildTree once in
+	/// a while when this is enabled.
+	void SetRefitProxies(bool flag) { m_refitProxies = flag; }
+	bool GetRefitProxies() const { return m_refitProxies; }
+
 	/// Call to trigger a re-processing of it's pairs on the next call to UpdatePairs.
 	void TouchProxy(int32 proxyId);
 
@@ -76,11 +89,20 @@ public:
 	template <typename T>
 	void UpdatePairs(T* callback);
 
+	/// Register a thread pool used by UpdatePairs to query the moved proxies
+	/// concurrently. The pairs are reported in the same order either way.
+	void SetThreadPool(b2ThreadPool* threadPool);
+
 	/// Query an AABB for overlapping proxies. The callback class
 	/// is called for each proxy that overlaps the supplied AABB.
 	template <typename T>
 	void Query(T* callback, const b2AABB& aabb) const;
 
+	/// Query a batch of AABBs, see b2DynamicTree::QueryBatch. The queries are split
+	/// across the thread pool registered with SetThreadPool, if any.
+	template <typename T>
+	void QueryBatch(T* callback, const b2AABB* aabbs, int32 count) const;
+
 	/// Ray-cast against the proxies in the tree. This relies on the callback
 	/// to perform a exact ray-cast in the case were the proxy contains a shape.
 	/// The callback also performs the any collision filtering. This has performance
@@ -100,15 +122,25 @@ public:
 	/// Get the quality metric of the embedded tree.
 	float32 GetTreeQuality() const;
 
+	/// Get the average depth of the leaves of the embedded tree.
+	float32 GetTreeAverageDepth() const;
+
+	/// Rebuild the embedded tree with b2DynamicTree::RebuildTopDown.
+	void RebuildTree();
+
 private:
 
 	friend class b2DynamicTree;
+	friend class b2World;
 
 	void BufferMove(int32 proxyId);
 	void UnBufferMove(int32 proxyId);
 
 	bool QueryCallback(int32 proxyId);
 
+	// Query the moved proxies on the thread pool and fill the pair buffer.
+	void QueryMovesParallel();
+
 	b2DynamicTree m_tree;
 
 	int32 m_proxyCount;
@@ -122,6 +154,12 @@ private:
 	int32 m_pairCount;
 
 	int32 m_queryProxyId;
+
+	bool m_refitProxies;
+
+	b2ThreadPool* m_threadPool;
+	b2ThreadPairBuffer* m_threadPairs;
+	int32 m_threadPairCount;
 };
 
 /// This is used to sort pairs.
@@ -177,6 +215,16 @@ inline float32 b2BroadPhase::GetTreeQuality() const
 	return m_tree.GetAreaRatio();
 }
 
+inline float32 b2BroadPhase::GetTreeAverageDepth() const
+{
+	return m_tree.GetAverageDepth();
+}
+
+inline void b2BroadPhase::RebuildTree()
+{
+	m_tree.RebuildTopDown();
+}
+
 template <typename T>
 void b2BroadPhase::UpdatePairs(T* callback)
 {
@@ -184,20 +232,27 @@ void b2BroadPhase::UpdatePairs(T* callback)
 	m_pairCount = 0;
 
 	// Perform tree queries for all moving proxies.
-	for (int32 i = 0; i < m_moveCount; ++i)
+	if (m_threadPool)
 	{
-		m_queryProxyId = m_moveBuffer[i];
-		if (m_queryProxyId == e_nullProxy)
+		QueryMovesParallel();
+	}
+	else
+	{
+		for (int32 i = 0; i < m_moveCount; ++i)
 		{
-			continue;
-		}
+			m_queryProxyId = m_moveBuffer[i];
+			if (m_queryProxyId == e_nullProxy)
+			{
+				continue;
+			}
 
-		// We have to query the tree with the fat AABB so that
-		// we don't fail to create a pair that may touch later.
-		const b2AABB& fatAABB = m_tree.GetFatAABB(m_queryProxyId);
+			// We have to query the tree with the fat AABB so that
+			// we don't fail to create a pair that may touch later.
+			const b2AABB& fatAABB = m_tree.GetFatAABB(m_queryProxyId);
 
-		// Query tree, create pairs and add them pair buffer.
-		m_tree.Query(this, fatAABB);
+			// Query tree, create pairs and add them pair buffer.
+			m_tree.Query(this, fatAABB);
+		}
 	}
 
 	// Reset move buffer
@@ -239,6 +294,12 @@ inline void b2BroadPhase::Query(T* callback, const b2AABB& aabb) const
 	m_tree.Query(callback, aabb);
 }
 
+template <typename T>
+inline void b2BroadPhase::QueryBatch(T* callback, const b2AABB* aabbs, int32 count) const
+{
+	m_tree.QueryBatch(callback, aabbs, count, m_threadPool);
+}
+
 template <typename T>
 inline void b2BroadPhase::RayCast(T* callback, const b2RayCastInput& input) const
 {
@@ -17,6 +17,7 @@
 */
 
 #include <Box2D/Collision/b2DynamicTree.h>
+#include <Box2D/Common/b2ThreadPool.h>
 #include <cstring>
 #ifndef SHP
 #include <cfloat>
@@ -125,28 +126,34 @@ int32 b2DynamicTree::CreateProxy(const b2AABB& aabb, void* userData)
 	return proxyId;
 }
 
-void b2DynamicTree::DestroyProxy(int32 proxyId)
+void b2DynamicTree::CreateProxies(const b2AABB* aabbs, void* const* userData, int32 count, int32* proxyIds)
 {
-	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
-	b2Assert(m_nodes[proxyId].IsLeaf());
+	b2Vec2 r(b2_aabbExtension, b2_aabbExtension);
+	for (int32 i = 0; i < count; ++i)
+	{
+		int32 proxyId = AllocateNode();
+		m_nodes[proxyId].aabb.lowerBound = aabbs[i].lowerBound - r;
+		m_nodes[proxyId].aabb.upperBound = aabbs[i].upperBound + r;
+		m_nodes[proxyId].userData = userData[i];
+		m_nodes[proxyId].height = 0;
+		proxyIds[i] = proxyId;
+	}
 
-	RemoveLeaf(proxyId);
-	FreeNode(proxyId);
+	RebuildTopDown();
 }
 
-bool b2DynamicTree::MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement)
+void b2DynamicTree::DestroyProxy(int32 proxyId)
 {
 	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
-
 	b2Assert(m_nodes[proxyId].IsLeaf());
 
-	if (m_nodes[proxyId].aabb.Contains(aabb))
-	{
-		return false;
-	}
-
 	RemoveLeaf(proxyId);
+	FreeNode(proxyId);
+}
 
+// Extend an AABB by the margin and by the predicted displacement.
+static b2AABB b2FattenAABB(const b2AABB& aabb, const b2Vec2& displacement)
+{
 	// Extend AABB.
 	b2AABB b = aabb;
 	b2Vec2 r(b2_aabbExtension, b2_aabbExtension);
@@ -174,12 +181,61 @@ bool b2DynamicTree::MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& d
 		b.upperBound.y += d.y;
 	}
 
-	m_nodes[proxyId].aabb = b;
+	return b;
+}
+
+bool b2DynamicTree::MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement)
+{
+	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
+
+	b2Assert(m_nodes[proxyId].IsLeaf());
+
+	if (m_nodes[proxyId].aabb.Contains(aabb))
+	{
+		return false;
+	}
+
+	RemoveLeaf(proxyId);
+
+	m_nodes[proxyId].aabb = b2FattenAABB(aabb, displacement);
 
 	InsertLeaf(proxyId);
 	return true;
 }
 
+bool b2DynamicTree::RefitProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement)
+{
+	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
+
+	b2Assert(m_nodes[proxyId].IsLeaf());
+
+	if (m_nodes[proxyId].aabb.Contains(aabb))
+	{
+		return false;
+	}
+
+	m_nodes[proxyId].aabb = b2FattenAABB(aabb, displacement);
+
+	// Walk back up the tree fixing the AABBs. Stop once they no longer change.
+	int32 index = m_nodes[proxyId].parent;
+	while (index != b2_nullNode)
+	{
+		b2TreeNode* node = m_nodes + index;
+
+		b2AABB b;
+		b.Combine(m_nodes[node->child1].aabb, m_nodes[node->child2].aabb);
+		if (b.lowerBound == node->aabb.lowerBound && b.upperBound == node->aabb.upperBound)
+		{
+			break;
+		}
+
+		node->aabb = b;
+		index = node->parent;
+	}
+
+	return true;
+}
+
 void b2DynamicTree::InsertLeaf(int32 leaf)
 {
 	++m_insertionCount;
@@ -698,6 +754,34 @@ int32 b2DynamicTree::GetMaxBalance() const
 	return maxBalance;
 }
 
+float32 b2DynamicTree::GetAverageDepth() const
+{
+	int32 leafCount = 0;
+	int32 depthSum = 0;
+	for (int32 i = 0; i < m_nodeCapacity; ++i)
+	{
+		const b2TreeNode* node = m_nodes + i;
+		if (node->height != 0)
+		{
+			// Free or internal node
+			continue;
+		}
+
+		++leafCount;
+		for (int32 index = node->parent; index != b2_nullNode; index = m_nodes[index].parent)
+		{
+			++depthSum;
+		}
+	}
+
+	if (leafCount == 0)
+	{
+		return 0.0f;
+	}
+
+	return float32(depthSum) / float32(leafCount);
+}
+
 void b2DynamicTree::RebuildBottomUp()
 {
 	int32* nodes = (int32*)b2Alloc(m_nodeCount * sizeof(int32));
@@ -773,3 +857,284 @@ void b2DynamicTree::RebuildBottomUp()
 
 	Validate();
 }
+
+// The leaves are sorted into this many bins along the split axis.
+#define b2_treeBinCount 16
+
+struct b2TreeBuildLeaf
+{
+	int32 id;
+	b2Vec2 center;
+};
+
+struct b2TreeBuildRange
+{
+	int32 begin;
+	int32 end;
+	int32 parent;
+};
+
+inline int32 b2TreeBin(const b2Vec2& center, int32 axis, float32 origin, float32 scale)
+{
+	int32 bin = int32((center(axis) - origin) * scale);
+	return b2Clamp(bin, 0, b2_treeBinCount - 1);
+}
+
+// Split the leaves where the surface area heuristic is cheapest. The heuristic
+// estimates the cost of a query by the perimeter of each side times its number of
+// leaves. The splits are only tried between bins of leaf centers along the longest
+// axis. Returns the number of leaves moved to the left side.
+static int32 b2PartitionLeaves(b2TreeBuildLeaf* leaves, int32 count, const b2TreeNode* nodes)
+{
+	b2Vec2 lower = leaves[0].center;
+	b2Vec2 upper = leaves[0].center;
+	for (int32 i = 1; i < count; ++i)
+	{
+		lower = b2Min(lower, leaves[i].center);
+		upper = b2Max(upper, leaves[i].center);
+	}
+
+	b2Vec2 extent = upper - lower;
+	int32 axis = extent.x >= extent.y ? 0 : 1;
+	if (extent(axis) <= 0.0f)
+	{
+		// The centers coincide, split in the middle.
+		return count / 2;
+	}
+
+	float32 origin = lower(axis);
+	float32 scale = b2_treeBinCount / extent(axis);
+
+	b2AABB binAABBs[b2_treeBinCount];
+	int32 binCounts[b2_treeBinCount];
+	for (int32 i = 0; i < b2_treeBinCount; ++i)
+	{
+		binCounts[i] = 0;
+	}
+
+	for (int32 i = 0; i < count; ++i)
+	{
+		int32 bin = b2TreeBin(leaves[i].center, axis, origin, scale);
+		const b2AABB& aabb = nodes[leaves[i].id].aabb;
+		if (binCounts[bin] == 0)
+		{
+			binAABBs[bin] = aabb;
+		}
+		else
+		{
+			binAABBs[bin].Combine(aabb);
+		}
+		++binCounts[bin];
+	}
+
+	// Cost of the right side of the split after each bin.
+	float32 rightCosts[b2_treeBinCount - 1];
+	b2AABB rightAABB;
+	int32 rightCount = 0;
+	for (int32 i = b2_treeBinCount - 1; i > 0; --i)
+	{
+		if (binCounts[i] > 0)
+		{
+			if (rightCount == 0)
+			{
+				rightAABB = binAABBs[i];
+			}
+			else
+			{
+				rightAABB.Combine(binAABBs[i]);
+			}
+			rightCount += binCounts[i];
+		}
+
+		rightCosts[i - 1] = rightCount > 0 ? rightCount * rightAABB.GetPerimeter() : -1.0f;
+	}
+
+	int32 bestBin = -1;
+	float32 bestCost = b2_maxFloat;
+	b2AABB leftAABB;
+	int32 leftCount = 0;
+	for (int32 i = 0; i < b2_treeBinCount - 1; ++i)
+	{
+		if (binCounts[i] > 0)
+		{
+			if (leftCount == 0)
+			{
+				leftAABB = binAABBs[i];
+			}
+			else
+			{
+				leftAABB.Combine(binAABBs[i]);
+			}
+			leftCount += binCounts[i];
+		}
+
+		if (leftCount == 0 || rightCosts[i] < 0.0f)
+		{
+			continue;
+		}
+
+		float32 cost = leftCount * leftAABB.GetPerimeter() + rightCosts[i];
+		if (cost < bestCost)
+		{
+			bestCost = cost;
+			bestBin = i;
+		}
+	}
+
+	if (bestBin == -1)
+	{
+		return count / 2;
+	}
+
+	int32 left = 0;
+	for (int32 i = 0; i < count; ++i)
+	{
+		if (b2TreeBin(leaves[i].center, axis, origin, scale) <= bestBin)
+		{
+			b2Swap(leaves[i], leaves[left]);
+			++left;
+		}
+	}
+
+	return left;
+}
+
+void b2DynamicTree::RebuildTopDown()
+{
+	b2TreeBuildLeaf* leaves = (b2TreeBuildLeaf*)b2Alloc(m_nodeCount * sizeof(b2TreeBuildLeaf));
+	int32 count = 0;
+
+	// Build array of leaves. Free the rest.
+	for (int32 i = 0; i < m_nodeCapacity; ++i)
+	{
+		if (m_nodes[i].height < 0)
+		{
+			// free node in pool
+			continue;
+		}
+
+		if (m_nodes[i].IsLeaf())
+		{
+			m_nodes[i].parent = b2_nullNode;
+			leaves[count].id = i;
+			leaves[count].center = m_nodes[i].aabb.GetCenter();
+			++count;
+		}
+		else
+		{
+			FreeNode(i);
+		}
+	}
+
+	m_root = b2_nullNode;
+	if (count == 0)
+	{
+		b2Free(leaves);
+		return;
+	}
+
+	// Internal nodes in the order they are created, parents before children.
+	int32* internalNodes = (int32*)b2Alloc(count * sizeof(int32));
+	int32 internalCount = 0;
+
+	b2GrowableStack<b2TreeBuildRange, 64> stack;
+	b2TreeBuildRange range;
+	range.begin = 0;
+	range.end = count;
+	range.parent = b2_nullNode;
+	stack.Push(range);
+
+	while (stack.GetCount() > 0)
+	{
+		range = stack.Pop();
+
+		int32 nodeId;
+		if (range.end - range.begin == 1)
+		{
+			nodeId = leaves[range.begin].id;
+		}
+		else
+		{
+			nodeId = AllocateNode();
+			internalNodes[internalCount] = nodeId;
+			++internalCount;
+		}
+
+		m_nodes[nodeId].parent = range.parent;
+		if (range.parent == b2_nullNode)
+		{
+			m_root = nodeId;
+		}
+		else if (m_nodes[range.parent].child1 == b2_nullNode)
+		{
+			m_nodes[range.parent].child1 = nodeId;
+		}
+		else
+		{
+			m_nodes[range.parent].child2 = nodeId;
+		}
+
+		if (range.end - range.begin == 1)
+		{
+			continue;
+		}
+
+		int32 split = range.begin + b2PartitionLeaves(leaves + range.begin, range.end - range.begin, m_nodes);
+
+		b2TreeBuildRange right;
+		right.begin = split;
+		right.end = range.end;
+		right.parent = nodeId;
+		stack.Push(right);
+
+		b2TreeBuildRange left;
+		left.begin = range.begin;
+		left.end = split;
+		left.parent = nodeId;
+		stack.Push(left);
+	}
+
+	// Children are created after their parent, so walking backwards computes
+	// the children first.
+	for (int32 i = internalCount - 1; i >= 0; --i)
+	{
+		b2TreeNode* node = m_nodes + internalNodes[i];
+		const b2TreeNode* child1 = m_nodes + node->child1;
+		const b2TreeNode* child2 = m_nodes + node->child2;
+		node->aabb.Combine(child1->aabb, child2->aabb);
+		node->height = 1 + b2Max(child1->height, child2->height);
+	}
+
+	b2Free(internalNodes);
+	b2Free(leaves);
+
+	Validate();
+}
+
+// Adapts a batch function to the thread pool task interface.
+class b2TreeBatchTask : public b2ThreadPoolTask
+{
+public:
+	void Execute(int32 begin, int32 end, int32 threadIndex)
+	{
+		m_fcn(m_context, begin, end, threadIndex);
+	}
+
+	void (*m_fcn)(void* context, int32 begin, int32 end, int32 threadIndex);
+	void* m_context;
+};
+
+void b2DynamicTree::ExecuteBatch(b2BatchFcn* fcn, void* context, int32 count, b2ThreadPool* threadPool)
+{
+	if (threadPool)
+	{
+		b2TreeBatchTask task;
+		task.m_fcn = fcn;
+		task.m_context = context;
+		threadPool->ParallelFor(&task, count, 32);
+	}
+	else
+	{
+		fcn(context, 0, count, 0);
+	}
+}
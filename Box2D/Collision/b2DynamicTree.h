@@ -24,6 +24,8 @@
 
 #define b2_nullNode (-1)
 
+class b2ThreadPool;
+
 /// A node in the dynamic tree. The client does not interact with this directly.
 struct b2TreeNode
 {
@@ -70,6 +72,11 @@ public:
 	/// Create a proxy. Provide a tight fitting AABB and a userData pointer.
 	int32 CreateProxy(const b2AABB& aabb, void* userData);
 
+	/// Create many proxies at once, such as the static geometry of a level. The tree
+	/// is rebuilt with RebuildTopDown instead of inserting the proxies one by one.
+	/// @param proxyIds receives the id of each proxy.
+	void CreateProxies(const b2AABB* aabbs, void* const* userData, int32 count, int32* proxyIds);
+
 	/// Destroy a proxy. This asserts if the id is invalid.
 	void DestroyProxy(int32 proxyId);
 
@@ -79,6 +86,12 @@ public:
 	/// @return true if the proxy was re-inserted.
 	bool MoveProxy(int32 proxyId, const b2AABB& aabb1, const b2Vec2& displacement);
 
+	/// Move a proxy like MoveProxy, but keep it in place and refit the AABBs of its
+	/// ancestors instead of re-inserting it. This is cheaper, but the tree degrades
+	/// as proxies travel, so call RebuildTopDown once in a while.
+	/// @return true if the fat AABB changed.
+	bool RefitProxy(int32 proxyId, const b2AABB& aabb1, const b2Vec2& displacement);
+
 	/// Get proxy user data.
 	/// @return the proxy user data or 0 if the id is invalid.
 	void* GetUserData(int32 proxyId) const;
@@ -91,6 +104,15 @@ public:
 	template <typename T>
 	void Query(T* callback, const b2AABB& aabb) const;
 
+	/// Query a batch of AABBs, such as the sensing volumes of many agents. The callback
+	/// class is called as QueryCallback(queryIndex, proxyId, threadIndex) for each proxy
+	/// that overlaps aabbs[queryIndex], returning false ends that query only. Without a
+	/// thread pool the queries run in order with threadIndex 0. With one they are split
+	/// across its threads, so the callback must be thread safe. Use threadIndex to keep
+	/// per thread results.
+	template <typename T>
+	void QueryBatch(T* callback, const b2AABB* aabbs, int32 count, b2ThreadPool* threadPool = NULL) const;
+
 	/// Ray-cast against the proxies in the tree. This relies on the callback
 	/// to perform a exact ray-cast in the case were the proxy contains a shape.
 	/// The callback also performs the any collision filtering. This has performance
@@ -115,11 +137,26 @@ public:
 	/// Get the ratio of the sum of the node areas to the root area.
 	float32 GetAreaRatio() const;
 
+	/// Get the average depth of the leaves. Along with GetAreaRatio this estimates
+	/// the cost of a query.
+	float32 GetAverageDepth() const;
+
 	/// Build an optimal tree. Very expensive. For testing.
 	void RebuildBottomUp();
 
+	/// Rebuild the tree top down, splitting the leaves with a binned surface area
+	/// heuristic. This is O(n log n) and gives better queries than incremental
+	/// insertion. Proxy ids are kept.
+	void RebuildTopDown();
+
 private:
 
+	// Runs fcn(context, begin, end, threadIndex) over [0, count), on the thread pool if there is one.
+	typedef void b2BatchFcn(void* context, int32 begin, int32 end, int32 threadIndex);
+	static void ExecuteBatch(b2BatchFcn* fcn, void* context, int32 count, b2ThreadPool* threadPool);
+
+	friend class b2World;
+
 	int32 AllocateNode();
 	void FreeNode(int32 node);
 
@@ -195,6 +232,53 @@ inline void b2DynamicTree::Query(T* callback, const b2AABB& aabb) const
 	}
 }
 
+// Forwards the proxies of one query of a batch.
+template <typename T>
+struct b2TreeBatchQueryCallback
+{
+	bool QueryCallback(int32 proxyId)
+	{
+		return callback->QueryCallback(queryIndex, proxyId, threadIndex);
+	}
+
+	T* callback;
+	int32 queryIndex;
+	int32 threadIndex;
+};
+
+template <typename T>
+struct b2TreeBatchQuery
+{
+	static void Execute(void* context, int32 begin, int32 end, int32 threadIndex)
+	{
+		const b2TreeBatchQuery* batch = (const b2TreeBatchQuery*)context;
+
+		b2TreeBatchQueryCallback<T> queryCallback;
+		queryCallback.callback = batch->callback;
+		queryCallback.threadIndex = threadIndex;
+
+		for (int32 i = begin; i < end; ++i)
+		{
+			queryCallback.queryIndex = i;
+			batch->tree->Query(&queryCallback, batch->aabbs[i]);
+		}
+	}
+
+	const b2DynamicTree* tree;
+	T* callback;
+	const b2AABB* aabbs;
+};
+
+template <typename T>
+inline void b2DynamicTree::QueryBatch(T* callback, const b2AABB* aabbs, int32 count, b2ThreadPool* threadPool) const
+{
+	b2TreeBatchQuery<T> batch;
+	batch.tree = this;
+	batch.callback = callback;
+	batch.aabbs = aabbs;
+	ExecuteBatch(&b2TreeBatchQuery<T>::Execute, &batch, count, threadPool);
+}
+
 template <typename T>
 inline void b2DynamicTree::RayCast(T* callback, const b2RayCastInput& input) const
 {
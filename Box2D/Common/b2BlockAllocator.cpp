@@ -17,10 +17,12 @@
 */
 
 #include <Box2D/Common/b2BlockAllocator.h>
+#include <Box2D/Common/b2Math.h>
 #include <cstdlib>
 #include <climits>
 #include <cstring>
 #include <memory>
+#include <mutex>
 
 using namespace std;
 
@@ -42,7 +44,9 @@ int32 b2BlockAllocator::s_blockSizes[b2_blockSizes] =
 	640,	// 13
 };
 uint8 b2BlockAllocator::s_blockSizeLookup[b2_maxBlockSize + 1];
-bool b2BlockAllocator::s_blockSizeLookupInitialized;
+
+// Allocators may be created on several threads at once.
+static std::once_flag s_blockSizeLookupFlag;
 
 struct b2Chunk
 {
@@ -55,9 +59,35 @@ struct b2Block
 	b2Block* next;
 };
 
+// Memory queued by FreeConcurrent. This fits in the smallest block.
+struct b2RemoteBlock
+{
+	b2RemoteBlock* next;
+	int32 size;
+};
+
+static void b2InitializeBlockSizeLookup(const int32* blockSizes, uint8* blockSizeLookup)
+{
+	int32 j = 0;
+	for (int32 i = 1; i <= b2_maxBlockSize; ++i)
+	{
+		b2Assert(j < b2_blockSizes);
+		if (i <= blockSizes[j])
+		{
+			blockSizeLookup[i] = (uint8)j;
+		}
+		else
+		{
+			++j;
+			blockSizeLookup[i] = (uint8)j;
+		}
+	}
+}
+
 b2BlockAllocator::b2BlockAllocator()
 {
 	b2Assert(b2_blockSizes < UCHAR_MAX);
+	b2Assert(sizeof(b2RemoteBlock) <= 16);
 
 	m_chunkSpace = b2_chunkArrayIncrement;
 	m_chunkCount = 0;
@@ -65,30 +95,22 @@ b2BlockAllocator::b2BlockAllocator()
 	
 	memset(m_chunks, 0, m_chunkSpace * sizeof(b2Chunk));
 	memset(m_freeLists, 0, sizeof(m_freeLists));
+	m_remoteBlocks = NULL;
 
-	if (s_blockSizeLookupInitialized == false)
-	{
-		int32 j = 0;
-		for (int32 i = 1; i <= b2_maxBlockSize; ++i)
-		{
-			b2Assert(j < b2_blockSizes);
-			if (i <= s_blockSizes[j])
-			{
-				s_blockSizeLookup[i] = (uint8)j;
-			}
-			else
-			{
-				++j;
-				s_blockSizeLookup[i] = (uint8)j;
-			}
-		}
+	m_liveBytes = 0;
+	m_maxLiveBytes = 0;
+	memset(m_liveBlocks, 0, sizeof(m_liveBlocks));
+	memset(m_maxLiveBlocks, 0, sizeof(m_maxLiveBlocks));
+	m_largeCount = 0;
+	m_largeBytes = 0;
 
-		s_blockSizeLookupInitialized = true;
-	}
+	std::call_once(s_blockSizeLookupFlag, b2InitializeBlockSizeLookup, s_blockSizes, s_blockSizeLookup);
 }
 
 b2BlockAllocator::~b2BlockAllocator()
 {
+	FreeRemoteBlocks();
+
 	for (int32 i = 0; i < m_chunkCount; ++i)
 	{
 		b2Free(m_chunks[i].blocks);
@@ -104,14 +126,28 @@ void* b2BlockAllocator::Allocate(int32 size)
 
 	b2Assert(0 < size);
 
+	if (m_remoteBlocks.load(std::memory_order_relaxed) != NULL)
+	{
+		FreeRemoteBlocks();
+	}
+
 	if (size > b2_maxBlockSize)
 	{
+		++m_largeCount;
+		m_largeBytes += size;
+		m_liveBytes += size;
+		m_maxLiveBytes = b2Max(m_maxLiveBytes, m_liveBytes);
 		return b2Alloc(size);
 	}
 
 	int32 index = s_blockSizeLookup[size];
 	b2Assert(0 <= index && index < b2_blockSizes);
 
+	++m_liveBlocks[index];
+	m_maxLiveBlocks[index] = b2Max(m_maxLiveBlocks[index], m_liveBlocks[index]);
+	m_liveBytes += s_blockSizes[index];
+	m_maxLiveBytes = b2Max(m_maxLiveBytes, m_liveBytes);
+
 	if (m_freeLists[index])
 	{
 		b2Block* block = m_freeLists[index];
@@ -166,6 +202,9 @@ void b2BlockAllocator::Free(void* p, int32 size)
 
 	if (size > b2_maxBlockSize)
 	{
+		--m_largeCount;
+		m_largeBytes -= size;
+		m_liveBytes -= size;
 		b2Free(p);
 		return;
 	}
@@ -173,6 +212,10 @@ void b2BlockAllocator::Free(void* p, int32 size)
 	int32 index = s_blockSizeLookup[size];
 	b2Assert(0 <= index && index < b2_blockSizes);
 
+	b2Assert(m_liveBlocks[index] > 0);
+	--m_liveBlocks[index];
+	m_liveBytes -= s_blockSizes[index];
+
 #ifdef _DEBUG
 	// Verify the memory address and size is valid.
 	int32 blockSize = s_blockSizes[index];
@@ -204,8 +247,40 @@ void b2BlockAllocator::Free(void* p, int32 size)
 	m_freeLists[index] = block;
 }
 
+void b2BlockAllocator::FreeConcurrent(void* p, int32 size)
+{
+	if (size == 0)
+	{
+		return;
+	}
+
+	b2Assert(0 < size);
+
+	b2RemoteBlock* block = (b2RemoteBlock*)p;
+	block->size = size;
+	block->next = m_remoteBlocks.load(std::memory_order_relaxed);
+	while (m_remoteBlocks.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed) == false)
+	{
+	}
+}
+
+// Called by the thread using the allocator to take back the memory queued by FreeConcurrent.
+void b2BlockAllocator::FreeRemoteBlocks()
+{
+	b2RemoteBlock* block = m_remoteBlocks.exchange(NULL, std::memory_order_acquire);
+	while (block)
+	{
+		b2RemoteBlock* next = block->next;
+		Free(block, block->size);
+		block = next;
+	}
+}
+
 void b2BlockAllocator::Clear()
 {
+	// Allocations larger than b2_maxBlockSize may be queued.
+	FreeRemoteBlocks();
+
 	for (int32 i = 0; i < m_chunkCount; ++i)
 	{
 		b2Free(m_chunks[i].blocks);
@@ -215,4 +290,32 @@ void b2BlockAllocator::Clear()
 	memset(m_chunks, 0, m_chunkSpace * sizeof(b2Chunk));
 
 	memset(m_freeLists, 0, sizeof(m_freeLists));
+
+	// Large allocations are still live.
+	m_liveBytes = m_largeBytes;
+	memset(m_liveBlocks, 0, sizeof(m_liveBlocks));
+}
+
+void b2BlockAllocator::GetStats(b2BlockAllocatorStats* stats) const
+{
+	stats->liveBytes = m_liveBytes;
+	stats->maxLiveBytes = m_maxLiveBytes;
+	stats->reservedBytes = m_chunkCount * b2_chunkSize + m_largeBytes;
+
+	for (int32 i = 0; i < b2_blockSizes; ++i)
+	{
+		stats->blockSizes[i] = s_blockSizes[i];
+		stats->liveBlocks[i] = m_liveBlocks[i];
+		stats->maxLiveBlocks[i] = m_maxLiveBlocks[i];
+		stats->chunkCounts[i] = 0;
+	}
+
+	for (int32 i = 0; i < m_chunkCount; ++i)
+	{
+		int32 index = s_blockSizeLookup[m_chunks[i].blockSize];
+		++stats->chunkCounts[index];
+	}
+
+	stats->largeCount = m_largeCount;
+	stats->largeBytes = m_largeBytes;
 }
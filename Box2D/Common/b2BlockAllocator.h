@@ -21,6 +21,8 @@
 
 #include <Box2D/Common/b2Settings.h>
 
+#include <atomic>
+
 const int32 b2_chunkSize = 16 * 1024;
 const int32 b2_maxBlockSize = 640;
 const int32 b2_blockSizes = 14;
@@ -28,10 +30,44 @@ const int32 b2_chunkArrayIncrement = 128;
 
 struct b2Block;
 struct b2Chunk;
+struct b2RemoteBlock;
+
+/// Memory usage of a b2BlockAllocator.
+struct b2BlockAllocatorStats
+{
+	/// Bytes in live blocks, counted at their block size, and in live allocations
+	/// larger than b2_maxBlockSize.
+	int32 liveBytes;
+
+	/// The highest liveBytes so far.
+	int32 maxLiveBytes;
+
+	/// Bytes held in chunks and in live allocations larger than b2_maxBlockSize.
+	int32 reservedBytes;
+
+	/// The block size of each size class.
+	int32 blockSizes[b2_blockSizes];
+
+	/// Live blocks of each size class.
+	int32 liveBlocks[b2_blockSizes];
+
+	/// The highest number of live blocks of each size class so far.
+	int32 maxLiveBlocks[b2_blockSizes];
+
+	/// Chunks carved into blocks of each size class.
+	int32 chunkCounts[b2_blockSizes];
+
+	/// Live allocations larger than b2_maxBlockSize.
+	int32 largeCount;
+	int32 largeBytes;
+};
 
 /// This is a small object allocator used for allocating small
 /// objects that persist for more than one time step.
 /// See: http://www.codeproject.com/useritems/Small_Block_Allocator.asp
+/// Allocate and Free must be called by one thread at a time, usually the thread
+/// stepping the world. Other threads, such as the workers of a b2ThreadPool, may
+/// return memory with FreeConcurrent at any time.
 class b2BlockAllocator
 {
 public:
@@ -44,19 +80,38 @@ public:
 	/// Free memory. This will use b2Free if the size is larger than b2_maxBlockSize.
 	void Free(void* p, int32 size);
 
+	/// Free memory from a thread other than the one using the allocator, such as a
+	/// worker thread. This is lock free. The memory is queued and reclaimed by the
+	/// next call to Allocate, until then it counts as live.
+	void FreeConcurrent(void* p, int32 size);
+
 	void Clear();
 
+	/// Get the memory usage.
+	void GetStats(b2BlockAllocatorStats* stats) const;
+
 private:
 
+	void FreeRemoteBlocks();
+
 	b2Chunk* m_chunks;
 	int32 m_chunkCount;
 	int32 m_chunkSpace;
 
 	b2Block* m_freeLists[b2_blockSizes];
 
+	// Memory returned with FreeConcurrent.
+	std::atomic<b2RemoteBlock*> m_remoteBlocks;
+
+	int32 m_liveBytes;
+	int32 m_maxLiveBytes;
+	int32 m_liveBlocks[b2_blockSizes];
+	int32 m_maxLiveBlocks[b2_blockSizes];
+	int32 m_largeCount;
+	int32 m_largeBytes;
+
 	static int32 s_blockSizes[b2_blockSizes];
 	static uint8 s_blockSizeLookup[b2_maxBlockSize + 1];
-	static bool s_blockSizeLookupInitialized;
 };
 
 #endif
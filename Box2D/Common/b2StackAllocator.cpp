@@ -18,31 +18,50 @@
 
 #include <Box2D/Common/b2StackAllocator.h>
 #include <Box2D/Common/b2Math.h>
+#include <cstring>
 
 b2StackAllocator::b2StackAllocator()
 {
+	m_capacity = b2_stackSize;
+	m_data = (char*)b2Alloc(m_capacity);
 	m_index = 0;
 	m_allocation = 0;
 	m_maxAllocation = 0;
+	m_heapAllocations = 0;
+	m_entryCapacity = b2_maxStackEntries;
+	m_entries = (b2StackEntry*)b2Alloc(m_entryCapacity * sizeof(b2StackEntry));
 	m_entryCount = 0;
+	m_maxEntryCount = 0;
 }
 
 b2StackAllocator::~b2StackAllocator()
 {
 	b2Assert(m_index == 0);
 	b2Assert(m_entryCount == 0);
+	b2Free(m_entries);
+	b2Free(m_data);
 }
 
 void* b2StackAllocator::Allocate(int32 size)
 {
-	b2Assert(m_entryCount < b2_maxStackEntries);
+	if (m_entryCount == m_entryCapacity)
+	{
+		b2StackEntry* oldEntries = m_entries;
+		m_entryCapacity *= 2;
+		m_entries = (b2StackEntry*)b2Alloc(m_entryCapacity * sizeof(b2StackEntry));
+		memcpy(m_entries, oldEntries, m_entryCount * sizeof(b2StackEntry));
+		b2Free(oldEntries);
+	}
+
+	size = (size + b2_stackAlignment - 1) & ~(b2_stackAlignment - 1);
 
 	b2StackEntry* entry = m_entries + m_entryCount;
 	entry->size = size;
-	if (m_index + size > b2_stackSize)
+	if (m_index + size > m_capacity)
 	{
 		entry->data = (char*)b2Alloc(size);
 		entry->usedMalloc = true;
+		++m_heapAllocations;
 	}
 	else
 	{
@@ -54,6 +73,7 @@ void* b2StackAllocator::Allocate(int32 size)
 	m_allocation += size;
 	m_maxAllocation = b2Max(m_maxAllocation, m_allocation);
 	++m_entryCount;
+	m_maxEntryCount = b2Max(m_maxEntryCount, m_entryCount);
 
 	return entry->data;
 }
@@ -74,6 +94,18 @@ void b2StackAllocator::Free(void* p)
 	m_allocation -= entry->size;
 	--m_entryCount;
 
+	// Grow the stack while nothing points into it, so the next step fits.
+	if (m_entryCount == 0 && m_maxAllocation > m_capacity)
+	{
+		while (m_capacity < m_maxAllocation)
+		{
+			m_capacity *= 2;
+		}
+
+		b2Free(m_data);
+		m_data = (char*)b2Alloc(m_capacity);
+	}
+
 	p = NULL;
 }
 
@@ -81,3 +113,12 @@ int32 b2StackAllocator::GetMaxAllocation() const
 {
 	return m_maxAllocation;
 }
+
+void b2StackAllocator::GetStats(b2StackAllocatorStats* stats) const
+{
+	stats->liveBytes = m_allocation;
+	stats->maxLiveBytes = m_maxAllocation;
+	stats->capacity = m_capacity;
+	stats->maxEntryCount = m_maxEntryCount;
+	stats->heapAllocations = m_heapAllocations;
+}
@@ -21,8 +21,9 @@
 
 #include <Box2D/Common/b2Settings.h>
 
-const int32 b2_stackSize = 100 * 1024;	// 100k
-const int32 b2_maxStackEntries = 32;
+const int32 b2_stackSize = 100 * 1024;	// 100k, initial size
+const int32 b2_maxStackEntries = 32;	// initial number of entries
+const int32 b2_stackAlignment = 8;		// alignment of each allocation
 
 struct b2StackEntry
 {
@@ -31,9 +32,31 @@ struct b2StackEntry
 	bool usedMalloc;
 };
 
+/// Memory usage of a b2StackAllocator.
+struct b2StackAllocatorStats
+{
+	/// Bytes currently allocated.
+	int32 liveBytes;
+
+	/// The highest liveBytes so far.
+	int32 maxLiveBytes;
+
+	/// The size of the stack.
+	int32 capacity;
+
+	/// The highest number of nested allocations so far.
+	int32 maxEntryCount;
+
+	/// Allocations that did not fit on the stack and used b2Alloc.
+	int32 heapAllocations;
+};
+
 // This is a stack allocator used for fast per step allocations.
 // You must nest allocate/free pairs. The code will assert
 // if you try to interleave multiple allocate/free pairs.
+// Allocations that do not fit fall back to b2Alloc, and the stack grows
+// to the high water mark once it is empty again. Sizes are rounded up to
+// b2_stackAlignment, so arrays of pointers can follow arrays of int32.
 class b2StackAllocator
 {
 public:
@@ -45,16 +68,23 @@ public:
 
 	int32 GetMaxAllocation() const;
 
+	/// Get the memory usage.
+	void GetStats(b2StackAllocatorStats* stats) const;
+
 private:
 
-	char m_data[b2_stackSize];
+	char* m_data;
+	int32 m_capacity;
 	int32 m_index;
 
 	int32 m_allocation;
 	int32 m_maxAllocation;
+	int32 m_heapAllocations;
 
-	b2StackEntry m_entries[b2_maxStackEntries];
+	b2StackEntry* m_entries;
+	int32 m_entryCapacity;
 	int32 m_entryCount;
+	int32 m_maxEntryCount;
 };
 
 #endif
@@ -0,0 +1,150 @@
+/*
+* Copyright (c) 2006-2011 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Box2D/Common/b2ThreadPool.h>
+#include <Box2D/Common/b2Math.h>
+
+b2ThreadPool::b2ThreadPool(int32 threadCount)
+{
+	if (threadCount <= 0)
+	{
+		threadCount = b2Max(int32(std::thread::hardware_concurrency()), 1);
+	}
+
+	m_threadCount = threadCount;
+	m_generation = 0;
+	m_busyWorkers = 0;
+	m_quit = false;
+	m_task = NULL;
+	m_count = 0;
+	m_grainSize = 1;
+	m_next = 0;
+
+	m_workers = NULL;
+	if (m_threadCount > 1)
+	{
+		m_workers = new std::thread[m_threadCount - 1];
+		for (int32 i = 1; i < m_threadCount; ++i)
+		{
+			m_workers[i - 1] = std::thread(&b2ThreadPool::WorkerMain, this, i);
+		}
+	}
+}
+
+b2ThreadPool::~b2ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_startCondition.notify_all();
+
+	for (int32 i = 0; i < m_threadCount - 1; ++i)
+	{
+		m_workers[i].join();
+	}
+	delete [] m_workers;
+}
+
+void b2ThreadPool::ParallelFor(b2ThreadPoolTask* task, int32 count, int32 grainSize)
+{
+	b2Assert(grainSize > 0);
+	if (count <= 0)
+	{
+		return;
+	}
+
+	// Not worth waking the workers.
+	if (m_threadCount == 1 || count <= grainSize)
+	{
+		task->Execute(0, count, 0);
+		return;
+	}
+
+	std::lock_guard<std::mutex> run(m_runMutex);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_task = task;
+		m_count = count;
+		m_grainSize = grainSize;
+		m_next = 0;
+		m_busyWorkers = m_threadCount - 1;
+		++m_generation;
+	}
+	m_startCondition.notify_all();
+
+	ExecuteRanges(0);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (m_busyWorkers > 0)
+	{
+		m_doneCondition.wait(lock);
+	}
+	m_task = NULL;
+}
+
+void b2ThreadPool::ExecuteRanges(int32 threadIndex)
+{
+	for (;;)
+	{
+		int32 begin = m_next.fetch_add(m_grainSize);
+		if (begin >= m_count)
+		{
+			break;
+		}
+
+		m_task->Execute(begin, b2Min(begin + m_grainSize, m_count), threadIndex);
+	}
+}
+
+void b2ThreadPool::WorkerMain(int32 threadIndex)
+{
+	int32 generation = 0;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while (m_quit == false && m_generation == generation)
+			{
+				m_startCondition.wait(lock);
+			}
+
+			if (m_quit)
+			{
+				return;
+			}
+
+			generation = m_generation;
+		}
+
+		ExecuteRanges(threadIndex);
+
+		bool done;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			done = (--m_busyWorkers == 0);
+		}
+
+		if (done)
+		{
+			m_doneCondition.notify_one();
+		}
+	}
+}
@@ -0,0 +1,88 @@
+/*
+* Copyright (c) 2006-2011 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef B2_THREAD_POOL_H
+#define B2_THREAD_POOL_H
+
+#include <Box2D/Common/b2Settings.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/// Work that b2ThreadPool splits in ranges of items executed concurrently.
+class b2ThreadPoolTask
+{
+public:
+	virtual ~b2ThreadPoolTask() {}
+
+	/// Execute the items [begin, end).
+	/// @param threadIndex the executing thread, in [0, b2ThreadPool::GetThreadCount()).
+	/// Thread 0 is the thread that called b2ThreadPool::ParallelFor.
+	virtual void Execute(int32 begin, int32 end, int32 threadIndex) = 0;
+};
+
+/// A fixed set of worker threads used by b2World to run parts of a time step
+/// concurrently. The thread calling ParallelFor takes part in the work, so a pool
+/// of n threads starts n - 1 workers. A pool can be shared by several worlds,
+/// ParallelFor calls from different threads run one after the other.
+class b2ThreadPool
+{
+public:
+
+	/// @param threadCount the number of threads including the calling thread,
+	/// 0 to use one thread per hardware thread.
+	explicit b2ThreadPool(int32 threadCount = 0);
+
+	/// Stops and joins the workers.
+	~b2ThreadPool();
+
+	/// Get the number of threads including the calling thread.
+	int32 GetThreadCount() const { return m_threadCount; }
+
+	/// Execute the items [0, count) of a task in ranges of at most grainSize items
+	/// and return when they are all done. The ranges are handed out in increasing
+	/// order but may complete in any order.
+	void ParallelFor(b2ThreadPoolTask* task, int32 count, int32 grainSize);
+
+private:
+
+	void WorkerMain(int32 threadIndex);
+	void ExecuteRanges(int32 threadIndex);
+
+	int32 m_threadCount;
+	std::thread* m_workers;
+
+	// Serializes ParallelFor calls.
+	std::mutex m_runMutex;
+
+	std::mutex m_mutex;
+	std::condition_variable m_startCondition;
+	std::condition_variable m_doneCondition;
+	int32 m_generation;
+	int32 m_busyWorkers;
+	bool m_quit;
+
+	b2ThreadPoolTask* m_task;
+	int32 m_count;
+	int32 m_grainSize;
+	std::atomic<int32> m_next;
+};
+
+#endif
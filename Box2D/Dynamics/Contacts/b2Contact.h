@@ -183,8 +183,14 @@ protected:
 
 	void Update(b2ContactListener* listener);
 
+	// Compute the manifold for the current body transforms without changing the contact.
+	// Returns true if the shapes touch. Different contacts can be evaluated concurrently.
+	bool ComputeManifold(b2Manifold* manifold);
+
+	// Apply a manifold from ComputeManifold: update the touching state and call the listener.
+	void Update(b2ContactListener* listener, const b2Manifold& manifold, bool touching);
+
 	static b2ContactRegister s_registers[b2Shape::e_typeCount][b2Shape::e_typeCount];
-	static bool s_initialized;
 
 	uint32 m_flags;
 
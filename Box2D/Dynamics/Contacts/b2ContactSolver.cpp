@@ -24,6 +24,15 @@
 #include <Box2D/Dynamics/b2World.h>
 #include <Box2D/Common/b2StackAllocator.h>
 
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define B2_WIDE_SSE2 1
+#include <emmintrin.h>
+#else
+#define B2_WIDE_SSE2 0
+#endif
+
 #define B2_DEBUG_SOLVER 0
 
 struct b2ContactPositionConstraint
@@ -51,6 +60,10 @@ b2ContactSolver::b2ContactSolver(b2ContactSolverDef* def)
 	m_positions = def->positions;
 	m_velocities = def->velocities;
 	m_contacts = def->contacts;
+	m_wideVelocityConstraints = NULL;
+	m_widePositionConstraints = NULL;
+	m_wideCount = 0;
+	m_wideScratch = NULL;
 
 	// Initialize position independent portions of the constraints.
 	for (int32 i = 0; i < m_count; ++i)
@@ -129,6 +142,12 @@ b2ContactSolver::b2ContactSolver(b2ContactSolverDef* def)
 
 b2ContactSolver::~b2ContactSolver()
 {
+	if (m_wideVelocityConstraints)
+	{
+		m_allocator->Free(m_widePositionConstraints);
+		m_allocator->Free(m_wideVelocityConstraints);
+		m_allocator->Free(m_wideScratch);
+	}
 	m_allocator->Free(m_velocityConstraints);
 	m_allocator->Free(m_positionConstraints);
 }
@@ -243,10 +262,21 @@ void b2ContactSolver::InitializeVelocityConstraints()
 			}
 		}
 	}
+
+	if (m_step.wideContactSolver && m_count > 0)
+	{
+		InitializeWideConstraints();
+	}
 }
 
 void b2ContactSolver::WarmStart()
 {
+	if (m_wideVelocityConstraints)
+	{
+		WarmStartWide();
+		return;
+	}
+
 	// Warm start.
 	for (int32 i = 0; i < m_count; ++i)
 	{
@@ -287,6 +317,12 @@ void b2ContactSolver::WarmStart()
 
 void b2ContactSolver::SolveVelocityConstraints()
 {
+	if (m_wideVelocityConstraints)
+	{
+		SolveWideVelocityConstraints();
+		return;
+	}
+
 	for (int32 i = 0; i < m_count; ++i)
 	{
 		b2ContactVelocityConstraint* vc = m_velocityConstraints + i;
@@ -597,6 +633,11 @@ void b2ContactSolver::SolveVelocityConstraints()
 
 void b2ContactSolver::StoreImpulses()
 {
+	if (m_wideVelocityConstraints)
+	{
+		StoreWideImpulses();
+	}
+
 	for (int32 i = 0; i < m_count; ++i)
 	{
 		b2ContactVelocityConstraint* vc = m_velocityConstraints + i;
@@ -664,6 +705,11 @@ struct b2PositionSolverManifold
 // Sequential solver.
 bool b2ContactSolver::SolvePositionConstraints()
 {
+	if (m_widePositionConstraints)
+	{
+		return SolveWidePositionConstraints();
+	}
+
 	float32 minSeparation = 0.0f;
 
 	for (int32 i = 0; i < m_count; ++i)
@@ -830,3 +876,770 @@ bool b2ContactSolver::SolveTOIPositionConstraints(int32 toiIndexA, int32 toiInde
 	// push the separation above -b2_linearSlop.
 	return minSeparation >= -1.5f * b2_linearSlop;
 }
+
+// Wide solver. Constraints are colored so that no two constraints of a color share a
+// dynamic body, then each color is split in batches of four constraints that are solved
+// together, one constraint per SIMD lane. Constraints that find no color are solved
+// one per batch after the colored batches.
+
+#define b2_wideLanes 4
+#define b2_maxContactColors 16
+
+#if B2_WIDE_SSE2
+
+typedef __m128 b2FloatW;
+
+inline b2FloatW b2LoadW(const float32* p) { return _mm_loadu_ps(p); }
+inline void b2StoreW(float32* p, b2FloatW a) { _mm_storeu_ps(p, a); }
+inline b2FloatW b2SplatW(float32 s) { return _mm_set1_ps(s); }
+inline b2FloatW b2AddW(b2FloatW a, b2FloatW b) { return _mm_add_ps(a, b); }
+inline b2FloatW b2SubW(b2FloatW a, b2FloatW b) { return _mm_sub_ps(a, b); }
+inline b2FloatW b2MulW(b2FloatW a, b2FloatW b) { return _mm_mul_ps(a, b); }
+inline b2FloatW b2DivW(b2FloatW a, b2FloatW b) { return _mm_div_ps(a, b); }
+inline b2FloatW b2SqrtW(b2FloatW a) { return _mm_sqrt_ps(a); }
+inline b2FloatW b2NegW(b2FloatW a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+inline b2FloatW b2LessW(b2FloatW a, b2FloatW b) { return _mm_cmplt_ps(a, b); }
+inline b2FloatW b2GreaterW(b2FloatW a, b2FloatW b) { return _mm_cmpgt_ps(a, b); }
+inline b2FloatW b2GreaterEqualW(b2FloatW a, b2FloatW b) { return _mm_cmpge_ps(a, b); }
+inline b2FloatW b2AndW(b2FloatW a, b2FloatW b) { return _mm_and_ps(a, b); }
+inline b2FloatW b2OrW(b2FloatW a, b2FloatW b) { return _mm_or_ps(a, b); }
+
+// mask ? a : b per lane.
+inline b2FloatW b2SelectW(b2FloatW mask, b2FloatW a, b2FloatW b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+#else
+
+// Portable fallback, masks are lanes with all bits set.
+struct b2FloatW
+{
+	float32 v[b2_wideLanes];
+};
+
+inline uint32 b2FloatBits(float32 f) { uint32 u; memcpy(&u, &f, sizeof(u)); return u; }
+inline float32 b2BitsFloat(uint32 u) { float32 f; memcpy(&f, &u, sizeof(f)); return f; }
+inline float32 b2MaskFloat(bool flag) { return b2BitsFloat(flag ? 0xFFFFFFFF : 0); }
+
+inline b2FloatW b2LoadW(const float32* p) { b2FloatW r; memcpy(r.v, p, sizeof(r.v)); return r; }
+inline void b2StoreW(float32* p, b2FloatW a) { memcpy(p, a.v, sizeof(a.v)); }
+
+#define B2_WIDE_OP(expression) \
+	b2FloatW r; for (int32 l = 0; l < b2_wideLanes; ++l) { r.v[l] = expression; } return r;
+
+inline b2FloatW b2SplatW(float32 s) { B2_WIDE_OP(s) }
+inline b2FloatW b2AddW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(a.v[l] + b.v[l]) }
+inline b2FloatW b2SubW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(a.v[l] - b.v[l]) }
+inline b2FloatW b2MulW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(a.v[l] * b.v[l]) }
+inline b2FloatW b2DivW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(a.v[l] / b.v[l]) }
+inline b2FloatW b2SqrtW(b2FloatW a) { B2_WIDE_OP(sqrtf(a.v[l])) }
+inline b2FloatW b2NegW(b2FloatW a) { B2_WIDE_OP(-a.v[l]) }
+inline b2FloatW b2LessW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(b2MaskFloat(a.v[l] < b.v[l])) }
+inline b2FloatW b2GreaterW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(b2MaskFloat(a.v[l] > b.v[l])) }
+inline b2FloatW b2GreaterEqualW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(b2MaskFloat(a.v[l] >= b.v[l])) }
+inline b2FloatW b2AndW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(b2BitsFloat(b2FloatBits(a.v[l]) & b2FloatBits(b.v[l]))) }
+inline b2FloatW b2OrW(b2FloatW a, b2FloatW b) { B2_WIDE_OP(b2BitsFloat(b2FloatBits(a.v[l]) | b2FloatBits(b.v[l]))) }
+inline b2FloatW b2SelectW(b2FloatW mask, b2FloatW a, b2FloatW b) { B2_WIDE_OP(b2FloatBits(mask.v[l]) ? a.v[l] : b.v[l]) }
+
+#undef B2_WIDE_OP
+
+#endif
+
+// These match b2Min, b2Max and b2Clamp lane by lane.
+inline b2FloatW b2MinW(b2FloatW a, b2FloatW b) { return b2SelectW(b2LessW(a, b), a, b); }
+inline b2FloatW b2MaxW(b2FloatW a, b2FloatW b) { return b2SelectW(b2GreaterW(a, b), a, b); }
+inline b2FloatW b2ClampW(b2FloatW a, b2FloatW low, b2FloatW high) { return b2MaxW(low, b2MinW(a, high)); }
+
+// Lanes of a flag array are 1 or 0.
+inline b2FloatW b2FlagW(const float32* p) { return b2GreaterW(b2LoadW(p), b2SplatW(0.5f)); }
+
+struct b2WideVelocityPoint
+{
+	float32 rAX[b2_wideLanes], rAY[b2_wideLanes];
+	float32 rBX[b2_wideLanes], rBY[b2_wideLanes];
+	float32 normalImpulse[b2_wideLanes];
+	float32 tangentImpulse[b2_wideLanes];
+	float32 normalMass[b2_wideLanes];
+	float32 tangentMass[b2_wideLanes];
+	float32 velocityBias[b2_wideLanes];
+};
+
+struct b2WideVelocityConstraint
+{
+	b2WideVelocityPoint points[b2_maxManifoldPoints];
+	float32 normalX[b2_wideLanes], normalY[b2_wideLanes];
+	float32 k11[b2_wideLanes], k12[b2_wideLanes], k22[b2_wideLanes];
+	float32 normalMass11[b2_wideLanes], normalMass12[b2_wideLanes], normalMass22[b2_wideLanes];
+	float32 invMassA[b2_wideLanes], invMassB[b2_wideLanes];
+	float32 invIA[b2_wideLanes], invIB[b2_wideLanes];
+	float32 friction[b2_wideLanes];
+	float32 blockSolve[b2_wideLanes];
+	int32 indexA[b2_wideLanes];
+	int32 indexB[b2_wideLanes];
+	int32 constraintIndex[b2_wideLanes];
+	int32 laneCount;
+	int32 pointCount;
+};
+
+struct b2WidePositionConstraint
+{
+	float32 localPointsX[b2_maxManifoldPoints][b2_wideLanes];
+	float32 localPointsY[b2_maxManifoldPoints][b2_wideLanes];
+	float32 localNormalX[b2_wideLanes], localNormalY[b2_wideLanes];
+	float32 localPointX[b2_wideLanes], localPointY[b2_wideLanes];
+	float32 localCenterAX[b2_wideLanes], localCenterAY[b2_wideLanes];
+	float32 localCenterBX[b2_wideLanes], localCenterBY[b2_wideLanes];
+	float32 invMassA[b2_wideLanes], invMassB[b2_wideLanes];
+	float32 invIA[b2_wideLanes], invIB[b2_wideLanes];
+	float32 radiusA[b2_wideLanes], radiusB[b2_wideLanes];
+	float32 circles[b2_wideLanes];
+	float32 faceB[b2_wideLanes];
+	float32 active[b2_wideLanes];
+	float32 twoPoints[b2_wideLanes];
+	int32 pointCount;
+};
+
+void b2ContactSolver::InitializeWideConstraints()
+{
+	// Only dynamic bodies constrain the coloring, static and kinematic bodies are
+	// never written by the solver.
+	int32 bodyCount = 0;
+	for (int32 i = 0; i < m_count; ++i)
+	{
+		b2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+		if (vc->invMassA > 0.0f)
+		{
+			bodyCount = b2Max(bodyCount, vc->indexA + 1);
+		}
+		if (vc->invMassB > 0.0f)
+		{
+			bodyCount = b2Max(bodyCount, vc->indexB + 1);
+		}
+	}
+
+	// Greedy coloring in constraint order. The last color holds the constraints
+	// that could not be colored. The scratch memory is released with the batches.
+	m_wideScratch = (int32*)m_allocator->Allocate((m_count + bodyCount) * sizeof(int32));
+	int32* colors = m_wideScratch;
+	uint32* bodyColors = (uint32*)(m_wideScratch + m_count);
+	memset(bodyColors, 0, bodyCount * sizeof(uint32));
+	int32 colorCounts[b2_maxContactColors + 1];
+	memset(colorCounts, 0, sizeof(colorCounts));
+
+	for (int32 i = 0; i < m_count; ++i)
+	{
+		b2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+		bool dynamicA = vc->invMassA > 0.0f;
+		bool dynamicB = vc->invMassB > 0.0f;
+
+		uint32 usedColors = 0;
+		if (dynamicA)
+		{
+			usedColors |= bodyColors[vc->indexA];
+		}
+		if (dynamicB)
+		{
+			usedColors |= bodyColors[vc->indexB];
+		}
+
+		int32 color = b2_maxContactColors;
+		for (int32 c = 0; c < b2_maxContactColors; ++c)
+		{
+			if ((usedColors & (1 << c)) == 0)
+			{
+				color = c;
+				break;
+			}
+		}
+
+		if (color < b2_maxContactColors)
+		{
+			if (dynamicA)
+			{
+				bodyColors[vc->indexA] |= 1 << color;
+			}
+			if (dynamicB)
+			{
+				bodyColors[vc->indexB] |= 1 << color;
+			}
+		}
+
+		colors[i] = color;
+		++colorCounts[color];
+	}
+
+	int32 colorBatches[b2_maxContactColors + 1];
+	int32 colorFill[b2_maxContactColors + 1];
+	m_wideCount = 0;
+	for (int32 c = 0; c < b2_maxContactColors; ++c)
+	{
+		colorBatches[c] = m_wideCount;
+		colorFill[c] = 0;
+		m_wideCount += (colorCounts[c] + b2_wideLanes - 1) / b2_wideLanes;
+	}
+	colorBatches[b2_maxContactColors] = m_wideCount;
+	colorFill[b2_maxContactColors] = 0;
+	m_wideCount += colorCounts[b2_maxContactColors];
+
+	m_wideVelocityConstraints = (b2WideVelocityConstraint*)m_allocator->Allocate(m_wideCount * sizeof(b2WideVelocityConstraint));
+	m_widePositionConstraints = (b2WidePositionConstraint*)m_allocator->Allocate(m_wideCount * sizeof(b2WidePositionConstraint));
+
+	// Unused lanes stay zero: no mass, no impulse.
+	memset(m_wideVelocityConstraints, 0, m_wideCount * sizeof(b2WideVelocityConstraint));
+	memset(m_widePositionConstraints, 0, m_wideCount * sizeof(b2WidePositionConstraint));
+
+	for (int32 i = 0; i < m_count; ++i)
+	{
+		int32 color = colors[i];
+		int32 batch, lane;
+		if (color < b2_maxContactColors)
+		{
+			batch = colorBatches[color] + colorFill[color] / b2_wideLanes;
+			lane = colorFill[color] % b2_wideLanes;
+		}
+		else
+		{
+			batch = colorBatches[color] + colorFill[color];
+			lane = 0;
+		}
+		++colorFill[color];
+
+		const b2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+		b2WideVelocityConstraint* wvc = m_wideVelocityConstraints + batch;
+		wvc->laneCount = lane + 1;
+		wvc->indexA[lane] = vc->indexA;
+		wvc->indexB[lane] = vc->indexB;
+		wvc->constraintIndex[lane] = i;
+		wvc->normalX[lane] = vc->normal.x;
+		wvc->normalY[lane] = vc->normal.y;
+		wvc->k11[lane] = vc->K.ex.x;
+		wvc->k12[lane] = vc->K.ex.y;
+		wvc->k22[lane] = vc->K.ey.y;
+		wvc->normalMass11[lane] = vc->normalMass.ex.x;
+		wvc->normalMass12[lane] = vc->normalMass.ex.y;
+		wvc->normalMass22[lane] = vc->normalMass.ey.y;
+		wvc->invMassA[lane] = vc->invMassA;
+		wvc->invMassB[lane] = vc->invMassB;
+		wvc->invIA[lane] = vc->invIA;
+		wvc->invIB[lane] = vc->invIB;
+		wvc->friction[lane] = vc->friction;
+		wvc->blockSolve[lane] = vc->pointCount == 2 ? 1.0f : 0.0f;
+
+		for (int32 j = 0; j < vc->pointCount; ++j)
+		{
+			const b2VelocityConstraintPoint* vcp = vc->points + j;
+			b2WideVelocityPoint* wvcp = wvc->points + j;
+			wvcp->rAX[lane] = vcp->rA.x;
+			wvcp->rAY[lane] = vcp->rA.y;
+			wvcp->rBX[lane] = vcp->rB.x;
+			wvcp->rBY[lane] = vcp->rB.y;
+			wvcp->normalImpulse[lane] = vcp->normalImpulse;
+			wvcp->tangentImpulse[lane] = vcp->tangentImpulse;
+			wvcp->normalMass[lane] = vcp->normalMass;
+			wvcp->tangentMass[lane] = vcp->tangentMass;
+			wvcp->velocityBias[lane] = vcp->velocityBias;
+		}
+
+		const b2ContactPositionConstraint* pc = m_positionConstraints + i;
+		b2WidePositionConstraint* wpc = m_widePositionConstraints + batch;
+		for (int32 j = 0; j < pc->pointCount; ++j)
+		{
+			wpc->localPointsX[j][lane] = pc->localPoints[j].x;
+			wpc->localPointsY[j][lane] = pc->localPoints[j].y;
+		}
+		wpc->localNormalX[lane] = pc->localNormal.x;
+		wpc->localNormalY[lane] = pc->localNormal.y;
+		wpc->localPointX[lane] = pc->localPoint.x;
+		wpc->localPointY[lane] = pc->localPoint.y;
+		wpc->localCenterAX[lane] = pc->localCenterA.x;
+		wpc->localCenterAY[lane] = pc->localCenterA.y;
+		wpc->localCenterBX[lane] = pc->localCenterB.x;
+		wpc->localCenterBY[lane] = pc->localCenterB.y;
+		wpc->invMassA[lane] = pc->invMassA;
+		wpc->invMassB[lane] = pc->invMassB;
+		wpc->invIA[lane] = pc->invIA;
+		wpc->invIB[lane] = pc->invIB;
+		wpc->radiusA[lane] = pc->radiusA;
+		wpc->radiusB[lane] = pc->radiusB;
+		wpc->circles[lane] = pc->type == b2Manifold::e_circles ? 1.0f : 0.0f;
+		wpc->faceB[lane] = pc->type == b2Manifold::e_faceB ? 1.0f : 0.0f;
+		wpc->active[lane] = 1.0f;
+		wpc->twoPoints[lane] = pc->pointCount == 2 ? 1.0f : 0.0f;
+
+		wvc->pointCount = b2Max(wvc->pointCount, vc->pointCount);
+		wpc->pointCount = b2Max(wpc->pointCount, pc->pointCount);
+	}
+}
+
+static void b2GatherVelocities(const b2Velocity* velocities, const int32* indices, int32 laneCount,
+							   b2FloatW* vX, b2FloatW* vY, b2FloatW* w)
+{
+	float32 x[b2_wideLanes] = {0.0f}, y[b2_wideLanes] = {0.0f}, a[b2_wideLanes] = {0.0f};
+	for (int32 l = 0; l < laneCount; ++l)
+	{
+		const b2Velocity& velocity = velocities[indices[l]];
+		x[l] = velocity.v.x;
+		y[l] = velocity.v.y;
+		a[l] = velocity.w;
+	}
+	*vX = b2LoadW(x);
+	*vY = b2LoadW(y);
+	*w = b2LoadW(a);
+}
+
+static void b2ScatterVelocities(b2Velocity* velocities, const int32* indices, int32 laneCount,
+								b2FloatW vX, b2FloatW vY, b2FloatW w)
+{
+	float32 x[b2_wideLanes], y[b2_wideLanes], a[b2_wideLanes];
+	b2StoreW(x, vX);
+	b2StoreW(y, vY);
+	b2StoreW(a, w);
+	for (int32 l = 0; l < laneCount; ++l)
+	{
+		b2Velocity& velocity = velocities[indices[l]];
+		velocity.v.Set(x[l], y[l]);
+		velocity.w = a[l];
+	}
+}
+
+void b2ContactSolver::WarmStartWide()
+{
+	for (int32 i = 0; i < m_wideCount; ++i)
+	{
+		b2WideVelocityConstraint* c = m_wideVelocityConstraints + i;
+
+		b2FloatW vAX, vAY, wA, vBX, vBY, wB;
+		b2GatherVelocities(m_velocities, c->indexA, c->laneCount, &vAX, &vAY, &wA);
+		b2GatherVelocities(m_velocities, c->indexB, c->laneCount, &vBX, &vBY, &wB);
+
+		b2FloatW mA = b2LoadW(c->invMassA);
+		b2FloatW iA = b2LoadW(c->invIA);
+		b2FloatW mB = b2LoadW(c->invMassB);
+		b2FloatW iB = b2LoadW(c->invIB);
+		b2FloatW normalX = b2LoadW(c->normalX);
+		b2FloatW normalY = b2LoadW(c->normalY);
+		b2FloatW twoPoints = b2FlagW(c->blockSolve);
+
+		for (int32 j = 0; j < c->pointCount; ++j)
+		{
+			b2WideVelocityPoint* cp = c->points + j;
+			b2FloatW rAX = b2LoadW(cp->rAX), rAY = b2LoadW(cp->rAY);
+			b2FloatW rBX = b2LoadW(cp->rBX), rBY = b2LoadW(cp->rBY);
+			b2FloatW normalImpulse = b2LoadW(cp->normalImpulse);
+			b2FloatW tangentImpulse = b2LoadW(cp->tangentImpulse);
+
+			// P = normalImpulse * normal + tangentImpulse * tangent
+			b2FloatW PX = b2AddW(b2MulW(normalImpulse, normalX), b2MulW(tangentImpulse, normalY));
+			b2FloatW PY = b2SubW(b2MulW(normalImpulse, normalY), b2MulW(tangentImpulse, normalX));
+
+			b2FloatW newWA = b2SubW(wA, b2MulW(iA, b2SubW(b2MulW(rAX, PY), b2MulW(rAY, PX))));
+			b2FloatW newVAX = b2SubW(vAX, b2MulW(mA, PX));
+			b2FloatW newVAY = b2SubW(vAY, b2MulW(mA, PY));
+			b2FloatW newWB = b2AddW(wB, b2MulW(iB, b2SubW(b2MulW(rBX, PY), b2MulW(rBY, PX))));
+			b2FloatW newVBX = b2AddW(vBX, b2MulW(mB, PX));
+			b2FloatW newVBY = b2AddW(vBY, b2MulW(mB, PY));
+
+			if (j == 0)
+			{
+				wA = newWA; vAX = newVAX; vAY = newVAY;
+				wB = newWB; vBX = newVBX; vBY = newVBY;
+			}
+			else
+			{
+				wA = b2SelectW(twoPoints, newWA, wA);
+				vAX = b2SelectW(twoPoints, newVAX, vAX);
+				vAY = b2SelectW(twoPoints, newVAY, vAY);
+				wB = b2SelectW(twoPoints, newWB, wB);
+				vBX = b2SelectW(twoPoints, newVBX, vBX);
+				vBY = b2SelectW(twoPoints, newVBY, vBY);
+			}
+		}
+
+		b2ScatterVelocities(m_velocities, c->indexA, c->laneCount, vAX, vAY, wA);
+		b2ScatterVelocities(m_velocities, c->indexB, c->laneCount, vBX, vBY, wB);
+	}
+}
+
+void b2ContactSolver::SolveWideVelocityConstraints()
+{
+	const b2FloatW zero = b2SplatW(0.0f);
+
+	for (int32 i = 0; i < m_wideCount; ++i)
+	{
+		b2WideVelocityConstraint* c = m_wideVelocityConstraints + i;
+
+		b2FloatW vAX, vAY, wA, vBX, vBY, wB;
+		b2GatherVelocities(m_velocities, c->indexA, c->laneCount, &vAX, &vAY, &wA);
+		b2GatherVelocities(m_velocities, c->indexB, c->laneCount, &vBX, &vBY, &wB);
+
+		b2FloatW mA = b2LoadW(c->invMassA);
+		b2FloatW iA = b2LoadW(c->invIA);
+		b2FloatW mB = b2LoadW(c->invMassB);
+		b2FloatW iB = b2LoadW(c->invIB);
+		b2FloatW normalX = b2LoadW(c->normalX);
+		b2FloatW normalY = b2LoadW(c->normalY);
+		b2FloatW friction = b2LoadW(c->friction);
+		b2FloatW blockSolve = b2FlagW(c->blockSolve);
+
+		// Solve tangent constraints first because non-penetration is more important
+		// than friction. The second point only exists in block solved lanes.
+		for (int32 j = 0; j < c->pointCount; ++j)
+		{
+			b2WideVelocityPoint* cp = c->points + j;
+			b2FloatW rAX = b2LoadW(cp->rAX), rAY = b2LoadW(cp->rAY);
+			b2FloatW rBX = b2LoadW(cp->rBX), rBY = b2LoadW(cp->rBY);
+
+			// Relative velocity at contact
+			b2FloatW dvX = b2AddW(b2SubW(b2SubW(vBX, b2MulW(wB, rBY)), vAX), b2MulW(wA, rAY));
+			b2FloatW dvY = b2SubW(b2SubW(b2AddW(vBY, b2MulW(wB, rBX)), vAY), b2MulW(wA, rAX));
+
+			// Compute tangent force, tangent = (normal.y, -normal.x)
+			b2FloatW vt = b2SubW(b2MulW(dvX, normalY), b2MulW(dvY, normalX));
+			b2FloatW lambda = b2MulW(b2LoadW(cp->tangentMass), b2NegW(vt));
+
+			// b2Clamp the accumulated force
+			b2FloatW tangentImpulse = b2LoadW(cp->tangentImpulse);
+			b2FloatW maxFriction = b2MulW(friction, b2LoadW(cp->normalImpulse));
+			b2FloatW newImpulse = b2ClampW(b2AddW(tangentImpulse, lambda), b2NegW(maxFriction), maxFriction);
+			lambda = b2SubW(newImpulse, tangentImpulse);
+
+			// Apply contact impulse
+			b2FloatW PX = b2MulW(lambda, normalY);
+			b2FloatW PY = b2NegW(b2MulW(lambda, normalX));
+
+			b2FloatW newVAX = b2SubW(vAX, b2MulW(mA, PX));
+			b2FloatW newVAY = b2SubW(vAY, b2MulW(mA, PY));
+			b2FloatW newWA = b2SubW(wA, b2MulW(iA, b2SubW(b2MulW(rAX, PY), b2MulW(rAY, PX))));
+
+			b2FloatW newVBX = b2AddW(vBX, b2MulW(mB, PX));
+			b2FloatW newVBY = b2AddW(vBY, b2MulW(mB, PY));
+			b2FloatW newWB = b2AddW(wB, b2MulW(iB, b2SubW(b2MulW(rBX, PY), b2MulW(rBY, PX))));
+
+			if (j == 0)
+			{
+				b2StoreW(cp->tangentImpulse, newImpulse);
+				vAX = newVAX; vAY = newVAY; wA = newWA;
+				vBX = newVBX; vBY = newVBY; wB = newWB;
+			}
+			else
+			{
+				b2StoreW(cp->tangentImpulse, b2SelectW(blockSolve, newImpulse, tangentImpulse));
+				vAX = b2SelectW(blockSolve, newVAX, vAX);
+				vAY = b2SelectW(blockSolve, newVAY, vAY);
+				wA = b2SelectW(blockSolve, newWA, wA);
+				vBX = b2SelectW(blockSolve, newVBX, vBX);
+				vBY = b2SelectW(blockSolve, newVBY, vBY);
+				wB = b2SelectW(blockSolve, newWB, wB);
+			}
+		}
+
+		// Solve normal constraints. Batches with two point lanes compute both the single
+		// point and the block solution, each lane keeps the one the sequential solver uses.
+		b2WideVelocityPoint* cp1 = c->points + 0;
+		b2FloatW rA1X = b2LoadW(cp1->rAX), rA1Y = b2LoadW(cp1->rAY);
+		b2FloatW rB1X = b2LoadW(cp1->rBX), rB1Y = b2LoadW(cp1->rBY);
+		b2FloatW normalImpulse1 = b2LoadW(cp1->normalImpulse);
+
+		// Relative velocity at contact
+		b2FloatW dv1X = b2AddW(b2SubW(b2SubW(vBX, b2MulW(wB, rB1Y)), vAX), b2MulW(wA, rA1Y));
+		b2FloatW dv1Y = b2SubW(b2SubW(b2AddW(vBY, b2MulW(wB, rB1X)), vAY), b2MulW(wA, rA1X));
+
+		// Compute normal velocity
+		b2FloatW vn1 = b2AddW(b2MulW(dv1X, normalX), b2MulW(dv1Y, normalY));
+
+		// Single point
+		b2FloatW singleVAX, singleVAY, singleWA, singleVBX, singleVBY, singleWB, singleImpulse;
+		{
+			b2FloatW lambda = b2MulW(b2NegW(b2LoadW(cp1->normalMass)), b2SubW(vn1, b2LoadW(cp1->velocityBias)));
+
+			// b2Clamp the accumulated impulse
+			singleImpulse = b2MaxW(b2AddW(normalImpulse1, lambda), zero);
+			lambda = b2SubW(singleImpulse, normalImpulse1);
+
+			// Apply contact impulse
+			b2FloatW PX = b2MulW(lambda, normalX);
+			b2FloatW PY = b2MulW(lambda, normalY);
+			singleVAX = b2SubW(vAX, b2MulW(mA, PX));
+			singleVAY = b2SubW(vAY, b2MulW(mA, PY));
+			singleWA = b2SubW(wA, b2MulW(iA, b2SubW(b2MulW(rA1X, PY), b2MulW(rA1Y, PX))));
+
+			singleVBX = b2AddW(vBX, b2MulW(mB, PX));
+			singleVBY = b2AddW(vBY, b2MulW(mB, PY));
+			singleWB = b2AddW(wB, b2MulW(iB, b2SubW(b2MulW(rB1X, PY), b2MulW(rB1Y, PX))));
+		}
+
+		if (c->pointCount == 1)
+		{
+			b2StoreW(cp1->normalImpulse, singleImpulse);
+			b2ScatterVelocities(m_velocities, c->indexA, c->laneCount, singleVAX, singleVAY, singleWA);
+			b2ScatterVelocities(m_velocities, c->indexB, c->laneCount, singleVBX, singleVBY, singleWB);
+			continue;
+		}
+
+		// Block solver, see SolveVelocityConstraints for the derivation.
+		b2WideVelocityPoint* cp2 = c->points + 1;
+		b2FloatW rA2X = b2LoadW(cp2->rAX), rA2Y = b2LoadW(cp2->rAY);
+		b2FloatW rB2X = b2LoadW(cp2->rBX), rB2Y = b2LoadW(cp2->rBY);
+		b2FloatW normalImpulse2 = b2LoadW(cp2->normalImpulse);
+
+		b2FloatW dv2X = b2AddW(b2SubW(b2SubW(vBX, b2MulW(wB, rB2Y)), vAX), b2MulW(wA, rA2Y));
+		b2FloatW dv2Y = b2SubW(b2SubW(b2AddW(vBY, b2MulW(wB, rB2X)), vAY), b2MulW(wA, rA2X));
+		b2FloatW vn2 = b2AddW(b2MulW(dv2X, normalX), b2MulW(dv2Y, normalY));
+
+		b2FloatW k11 = b2LoadW(c->k11), k12 = b2LoadW(c->k12), k22 = b2LoadW(c->k22);
+		b2FloatW aX = normalImpulse1;
+		b2FloatW aY = normalImpulse2;
+
+		// b' = vn - velocityBias - K * a
+		b2FloatW bX = b2SubW(vn1, b2LoadW(cp1->velocityBias));
+		b2FloatW bY = b2SubW(vn2, b2LoadW(cp2->velocityBias));
+		bX = b2SubW(bX, b2AddW(b2MulW(k11, aX), b2MulW(k12, aY)));
+		bY = b2SubW(bY, b2AddW(b2MulW(k12, aX), b2MulW(k22, aY)));
+
+		// Case 1: vn = 0
+		b2FloatW normalMass12 = b2LoadW(c->normalMass12);
+		b2FloatW x1X = b2NegW(b2AddW(b2MulW(b2LoadW(c->normalMass11), bX), b2MulW(normalMass12, bY)));
+		b2FloatW x1Y = b2NegW(b2AddW(b2MulW(normalMass12, bX), b2MulW(b2LoadW(c->normalMass22), bY)));
+		b2FloatW case1 = b2AndW(b2GreaterEqualW(x1X, zero), b2GreaterEqualW(x1Y, zero));
+
+		// Case 2: vn1 = 0 and x2 = 0
+		b2FloatW x2X = b2MulW(b2NegW(b2LoadW(cp1->normalMass)), bX);
+		b2FloatW vn2Case2 = b2AddW(b2MulW(k12, x2X), bY);
+		b2FloatW case2 = b2AndW(b2GreaterEqualW(x2X, zero), b2GreaterEqualW(vn2Case2, zero));
+
+		// Case 3: vn2 = 0 and x1 = 0
+		b2FloatW x3Y = b2MulW(b2NegW(b2LoadW(cp2->normalMass)), bY);
+		b2FloatW vn1Case3 = b2AddW(b2MulW(k12, x3Y), bX);
+		b2FloatW case3 = b2AndW(b2GreaterEqualW(x3Y, zero), b2GreaterEqualW(vn1Case3, zero));
+
+		// Case 4: x1 = 0 and x2 = 0
+		b2FloatW case4 = b2AndW(b2GreaterEqualW(bX, zero), b2GreaterEqualW(bY, zero));
+
+		// The first valid case wins. Lanes without a valid case keep their impulses.
+		b2FloatW xX = b2SelectW(case1, x1X, b2SelectW(case2, x2X, zero));
+		b2FloatW xY = b2SelectW(case1, x1Y, b2SelectW(case2, zero, b2SelectW(case3, x3Y, zero)));
+		b2FloatW solved = b2AndW(blockSolve, b2OrW(b2OrW(case1, case2), b2OrW(case3, case4)));
+
+		// Get the incremental impulse
+		b2FloatW dX = b2SubW(xX, aX);
+		b2FloatW dY = b2SubW(xY, aY);
+
+		// Apply incremental impulse
+		b2FloatW P1X = b2MulW(dX, normalX), P1Y = b2MulW(dX, normalY);
+		b2FloatW P2X = b2MulW(dY, normalX), P2Y = b2MulW(dY, normalY);
+		b2FloatW PX = b2AddW(P1X, P2X);
+		b2FloatW PY = b2AddW(P1Y, P2Y);
+		b2FloatW LA = b2AddW(b2SubW(b2MulW(rA1X, P1Y), b2MulW(rA1Y, P1X)), b2SubW(b2MulW(rA2X, P2Y), b2MulW(rA2Y, P2X)));
+		b2FloatW LB = b2AddW(b2SubW(b2MulW(rB1X, P1Y), b2MulW(rB1Y, P1X)), b2SubW(b2MulW(rB2X, P2Y), b2MulW(rB2Y, P2X)));
+
+		// Lanes that are not block solved take the single point solution.
+		b2StoreW(cp1->normalImpulse, b2SelectW(solved, xX, b2SelectW(blockSolve, aX, singleImpulse)));
+		b2StoreW(cp2->normalImpulse, b2SelectW(solved, xY, aY));
+
+		vAX = b2SelectW(solved, b2SubW(vAX, b2MulW(mA, PX)), b2SelectW(blockSolve, vAX, singleVAX));
+		vAY = b2SelectW(solved, b2SubW(vAY, b2MulW(mA, PY)), b2SelectW(blockSolve, vAY, singleVAY));
+		wA = b2SelectW(solved, b2SubW(wA, b2MulW(iA, LA)), b2SelectW(blockSolve, wA, singleWA));
+
+		vBX = b2SelectW(solved, b2AddW(vBX, b2MulW(mB, PX)), b2SelectW(blockSolve, vBX, singleVBX));
+		vBY = b2SelectW(solved, b2AddW(vBY, b2MulW(mB, PY)), b2SelectW(blockSolve, vBY, singleVBY));
+		wB = b2SelectW(solved, b2AddW(wB, b2MulW(iB, LB)), b2SelectW(blockSolve, wB, singleWB));
+
+		b2ScatterVelocities(m_velocities, c->indexA, c->laneCount, vAX, vAY, wA);
+		b2ScatterVelocities(m_velocities, c->indexB, c->laneCount, vBX, vBY, wB);
+	}
+}
+
+void b2ContactSolver::StoreWideImpulses()
+{
+	// Copy the lanes back to the velocity constraints, which are also used to report impulses.
+	for (int32 i = 0; i < m_wideCount; ++i)
+	{
+		const b2WideVelocityConstraint* c = m_wideVelocityConstraints + i;
+		for (int32 l = 0; l < c->laneCount; ++l)
+		{
+			b2ContactVelocityConstraint* vc = m_velocityConstraints + c->constraintIndex[l];
+			for (int32 j = 0; j < vc->pointCount; ++j)
+			{
+				vc->points[j].normalImpulse = c->points[j].normalImpulse[l];
+				vc->points[j].tangentImpulse = c->points[j].tangentImpulse[l];
+			}
+		}
+	}
+}
+
+static void b2GatherPositions(const b2Position* positions, const int32* indices, int32 laneCount,
+							  b2FloatW* cX, b2FloatW* cY, b2FloatW* a)
+{
+	float32 x[b2_wideLanes] = {0.0f}, y[b2_wideLanes] = {0.0f}, angle[b2_wideLanes] = {0.0f};
+	for (int32 l = 0; l < laneCount; ++l)
+	{
+		const b2Position& position = positions[indices[l]];
+		x[l] = position.c.x;
+		y[l] = position.c.y;
+		angle[l] = position.a;
+	}
+	*cX = b2LoadW(x);
+	*cY = b2LoadW(y);
+	*a = b2LoadW(angle);
+}
+
+static void b2ScatterPositions(b2Position* positions, const int32* indices, int32 laneCount,
+							   b2FloatW cX, b2FloatW cY, b2FloatW a)
+{
+	float32 x[b2_wideLanes], y[b2_wideLanes], angle[b2_wideLanes];
+	b2StoreW(x, cX);
+	b2StoreW(y, cY);
+	b2StoreW(angle, a);
+	for (int32 l = 0; l < laneCount; ++l)
+	{
+		b2Position& position = positions[indices[l]];
+		position.c.Set(x[l], y[l]);
+		position.a = angle[l];
+	}
+}
+
+// There is no SIMD sine, the rotations are computed per lane like b2Rot::Set.
+static void b2RotationW(b2FloatW angle, int32 laneCount, b2FloatW* s, b2FloatW* c)
+{
+	float32 a[b2_wideLanes], sines[b2_wideLanes] = {0.0f}, cosines[b2_wideLanes] = {0.0f};
+	b2StoreW(a, angle);
+	for (int32 l = 0; l < laneCount; ++l)
+	{
+		sines[l] = sinf(a[l]);
+		cosines[l] = cosf(a[l]);
+	}
+	*s = b2LoadW(sines);
+	*c = b2LoadW(cosines);
+}
+
+bool b2ContactSolver::SolveWidePositionConstraints()
+{
+	const b2FloatW zero = b2SplatW(0.0f);
+	b2FloatW minSeparation = zero;
+
+	for (int32 i = 0; i < m_wideCount; ++i)
+	{
+		const b2WideVelocityConstraint* vc = m_wideVelocityConstraints + i;
+		const b2WidePositionConstraint* pc = m_widePositionConstraints + i;
+		int32 laneCount = vc->laneCount;
+
+		b2FloatW cAX, cAY, aA, cBX, cBY, aB;
+		b2GatherPositions(m_positions, vc->indexA, laneCount, &cAX, &cAY, &aA);
+		b2GatherPositions(m_positions, vc->indexB, laneCount, &cBX, &cBY, &aB);
+
+		b2FloatW mA = b2LoadW(pc->invMassA);
+		b2FloatW iA = b2LoadW(pc->invIA);
+		b2FloatW mB = b2LoadW(pc->invMassB);
+		b2FloatW iB = b2LoadW(pc->invIB);
+		b2FloatW localCenterAX = b2LoadW(pc->localCenterAX), localCenterAY = b2LoadW(pc->localCenterAY);
+		b2FloatW localCenterBX = b2LoadW(pc->localCenterBX), localCenterBY = b2LoadW(pc->localCenterBY);
+		b2FloatW localNormalX = b2LoadW(pc->localNormalX), localNormalY = b2LoadW(pc->localNormalY);
+		b2FloatW localPointX = b2LoadW(pc->localPointX), localPointY = b2LoadW(pc->localPointY);
+		b2FloatW radiusA = b2LoadW(pc->radiusA);
+		b2FloatW radiusB = b2LoadW(pc->radiusB);
+		b2FloatW circles = b2FlagW(pc->circles);
+		b2FloatW faceB = b2FlagW(pc->faceB);
+
+		// Solve normal constraints
+		for (int32 j = 0; j < pc->pointCount; ++j)
+		{
+			b2FloatW pointMask = b2FlagW(j == 0 ? pc->active : pc->twoPoints);
+
+			b2FloatW sA, qA, sB, qB;
+			b2RotationW(aA, laneCount, &sA, &qA);
+			b2RotationW(aB, laneCount, &sB, &qB);
+
+			// xf.p = c - b2Mul(xf.q, localCenter)
+			b2FloatW pAX = b2SubW(cAX, b2SubW(b2MulW(qA, localCenterAX), b2MulW(sA, localCenterAY)));
+			b2FloatW pAY = b2SubW(cAY, b2AddW(b2MulW(sA, localCenterAX), b2MulW(qA, localCenterAY)));
+			b2FloatW pBX = b2SubW(cBX, b2SubW(b2MulW(qB, localCenterBX), b2MulW(sB, localCenterBY)));
+			b2FloatW pBY = b2SubW(cBY, b2AddW(b2MulW(sB, localCenterBX), b2MulW(qB, localCenterBY)));
+
+			// The reference frame holds the manifold normal, it is body B for e_faceB.
+			b2FloatW refS = b2SelectW(faceB, sB, sA), refC = b2SelectW(faceB, qB, qA);
+			b2FloatW refX = b2SelectW(faceB, pBX, pAX), refY = b2SelectW(faceB, pBY, pAY);
+			b2FloatW incS = b2SelectW(faceB, sA, sB), incC = b2SelectW(faceB, qA, qB);
+			b2FloatW incX = b2SelectW(faceB, pAX, pBX), incY = b2SelectW(faceB, pAY, pBY);
+
+			b2FloatW localClipX = b2LoadW(pc->localPointsX[j]);
+			b2FloatW localClipY = b2LoadW(pc->localPointsY[j]);
+
+			b2FloatW planeX = b2AddW(b2SubW(b2MulW(refC, localPointX), b2MulW(refS, localPointY)), refX);
+			b2FloatW planeY = b2AddW(b2AddW(b2MulW(refS, localPointX), b2MulW(refC, localPointY)), refY);
+			b2FloatW clipX = b2AddW(b2SubW(b2MulW(incC, localClipX), b2MulW(incS, localClipY)), incX);
+			b2FloatW clipY = b2AddW(b2AddW(b2MulW(incS, localClipX), b2MulW(incC, localClipY)), incY);
+			b2FloatW dX = b2SubW(clipX, planeX);
+			b2FloatW dY = b2SubW(clipY, planeY);
+
+			// Faces
+			b2FloatW faceNormalX = b2SubW(b2MulW(refC, localNormalX), b2MulW(refS, localNormalY));
+			b2FloatW faceNormalY = b2AddW(b2MulW(refS, localNormalX), b2MulW(refC, localNormalY));
+			b2FloatW faceSeparation = b2SubW(b2SubW(b2AddW(b2MulW(dX, faceNormalX), b2MulW(dY, faceNormalY)), radiusA), radiusB);
+
+			// Ensure normal points from A to B
+			faceNormalX = b2SelectW(faceB, b2NegW(faceNormalX), faceNormalX);
+			faceNormalY = b2SelectW(faceB, b2NegW(faceNormalY), faceNormalY);
+
+			// Circles, the plane point and the clip point are the two centers.
+			b2FloatW length = b2SqrtW(b2AddW(b2MulW(dX, dX), b2MulW(dY, dY)));
+			b2FloatW shortNormal = b2LessW(length, b2SplatW(b2_epsilon));
+			b2FloatW invLength = b2DivW(b2SplatW(1.0f), b2SelectW(shortNormal, b2SplatW(1.0f), length));
+			b2FloatW circleNormalX = b2SelectW(shortNormal, dX, b2MulW(dX, invLength));
+			b2FloatW circleNormalY = b2SelectW(shortNormal, dY, b2MulW(dY, invLength));
+			b2FloatW circleSeparation = b2SubW(b2SubW(b2AddW(b2MulW(dX, circleNormalX), b2MulW(dY, circleNormalY)), radiusA), radiusB);
+			b2FloatW half = b2SplatW(0.5f);
+
+			b2FloatW normalX = b2SelectW(circles, circleNormalX, faceNormalX);
+			b2FloatW normalY = b2SelectW(circles, circleNormalY, faceNormalY);
+			b2FloatW pointX = b2SelectW(circles, b2MulW(half, b2AddW(planeX, clipX)), clipX);
+			b2FloatW pointY = b2SelectW(circles, b2MulW(half, b2AddW(planeY, clipY)), clipY);
+			b2FloatW separation = b2SelectW(circles, circleSeparation, faceSeparation);
+
+			b2FloatW rAX = b2SubW(pointX, cAX), rAY = b2SubW(pointY, cAY);
+			b2FloatW rBX = b2SubW(pointX, cBX), rBY = b2SubW(pointY, cBY);
+
+			// Track max constraint error.
+			minSeparation = b2SelectW(pointMask, b2MinW(minSeparation, separation), minSeparation);
+
+			// Prevent large corrections and allow slop.
+			b2FloatW C = b2ClampW(b2MulW(b2SplatW(b2_baumgarte), b2AddW(separation, b2SplatW(b2_linearSlop))),
+				b2SplatW(-b2_maxLinearCorrection), zero);
+
+			// Compute the effective mass.
+			b2FloatW rnA = b2SubW(b2MulW(rAX, normalY), b2MulW(rAY, normalX));
+			b2FloatW rnB = b2SubW(b2MulW(rBX, normalY), b2MulW(rBY, normalX));
+			b2FloatW K = b2AddW(b2AddW(b2AddW(mA, mB), b2MulW(b2MulW(iA, rnA), rnA)), b2MulW(b2MulW(iB, rnB), rnB));
+
+			// Compute normal impulse
+			b2FloatW positiveK = b2GreaterW(K, zero);
+			b2FloatW impulse = b2SelectW(positiveK, b2DivW(b2NegW(C), b2SelectW(positiveK, K, b2SplatW(1.0f))), zero);
+
+			b2FloatW PX = b2MulW(impulse, normalX);
+			b2FloatW PY = b2MulW(impulse, normalY);
+
+			cAX = b2SelectW(pointMask, b2SubW(cAX, b2MulW(mA, PX)), cAX);
+			cAY = b2SelectW(pointMask, b2SubW(cAY, b2MulW(mA, PY)), cAY);
+			aA = b2SelectW(pointMask, b2SubW(aA, b2MulW(iA, b2SubW(b2MulW(rAX, PY), b2MulW(rAY, PX)))), aA);
+
+			cBX = b2SelectW(pointMask, b2AddW(cBX, b2MulW(mB, PX)), cBX);
+			cBY = b2SelectW(pointMask, b2AddW(cBY, b2MulW(mB, PY)), cBY);
+			aB = b2SelectW(pointMask, b2AddW(aB, b2MulW(iB, b2SubW(b2MulW(rBX, PY), b2MulW(rBY, PX)))), aB);
+		}
+
+		b2ScatterPositions(m_positions, vc->indexA, laneCount, cAX, cAY, aA);
+		b2ScatterPositions(m_positions, vc->indexB, laneCount, cBX, cBY, aB);
+	}
+
+	float32 separations[b2_wideLanes];
+	b2StoreW(separations, minSeparation);
+	float32 separation = separations[0];
+	for (int32 l = 1; l < b2_wideLanes; ++l)
+	{
+		separation = b2Min(separation, separations[l]);
+	}
+
+	// We can't expect minSpeparation >= -b2_linearSlop because we don't
+	// push the separation above -b2_linearSlop.
+	return separation >= -3.0f * b2_linearSlop;
+}
@@ -27,6 +27,8 @@ class b2Contact;
 class b2Body;
 class b2StackAllocator;
 struct b2ContactPositionConstraint;
+struct b2WideVelocityConstraint;
+struct b2WidePositionConstraint;
 
 struct b2VelocityConstraintPoint
 {
@@ -80,6 +82,12 @@ public:
 	bool SolvePositionConstraints();
 	bool SolveTOIPositionConstraints(int32 toiIndexA, int32 toiIndexB);
 
+	void InitializeWideConstraints();
+	void WarmStartWide();
+	void SolveWideVelocityConstraints();
+	void StoreWideImpulses();
+	bool SolveWidePositionConstraints();
+
 	b2TimeStep m_step;
 	b2Position* m_positions;
 	b2Velocity* m_velocities;
@@ -88,6 +96,12 @@ public:
 	b2ContactVelocityConstraint* m_velocityConstraints;
 	b2Contact** m_contacts;
 	int m_count;
+
+	// Constraint batches used when m_step.wideContactSolver is set.
+	b2WideVelocityConstraint* m_wideVelocityConstraints;
+	b2WidePositionConstraint* m_widePositionConstraints;
+	int32 m_wideCount;
+	int32* m_wideScratch;
 };
 
 #endif
@@ -19,6 +19,7 @@
 #include <Box2D/Dynamics/Joints/b2DistanceJoint.h>
 #include <Box2D/Dynamics/b2Body.h>
 #include <Box2D/Dynamics/b2TimeStep.h>
+#include <Box2D/Dynamics/b2WorldSnapshot.h>
 
 // 1-D constrained system
 // m (v2 - v1) = lambda
@@ -258,3 +259,27 @@ void b2DistanceJoint::Dump()
 	b2Log("  jd.dampingRatio = %.15lef;\n", m_dampingRatio);
 	b2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+void b2DistanceJoint::SerializeState(b2WorldSnapshot* snapshot)
+{
+	snapshot->Serialize(m_frequencyHz);
+	snapshot->Serialize(m_dampingRatio);
+	snapshot->Serialize(m_bias);
+	snapshot->Serialize(m_localAnchorA);
+	snapshot->Serialize(m_localAnchorB);
+	snapshot->Serialize(m_gamma);
+	snapshot->Serialize(m_impulse);
+	snapshot->Serialize(m_length);
+	snapshot->Serialize(m_indexA);
+	snapshot->Serialize(m_indexB);
+	snapshot->Serialize(m_u);
+	snapshot->Serialize(m_rA);
+	snapshot->Serialize(m_rB);
+	snapshot->Serialize(m_localCenterA);
+	snapshot->Serialize(m_localCenterB);
+	snapshot->Serialize(m_invMassA);
+	snapshot->Serialize(m_invMassB);
+	snapshot->Serialize(m_invIA);
+	snapshot->Serialize(m_invIB);
+	snapshot->Serialize(m_mass);
+}
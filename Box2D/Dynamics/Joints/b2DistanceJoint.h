@@ -109,6 +109,7 @@ protected:
 	void InitVelocityConstraints(const b2SolverData& data);
 	void SolveVelocityConstraints(const b2SolverData& data);
 	bool SolvePositionConstraints(const b2SolverData& data);
+	void SerializeState(b2WorldSnapshot* snapshot);
 
 	float32 m_frequencyHz;
 	float32 m_dampingRatio;
@@ -19,6 +19,7 @@
 #include <Box2D/Dynamics/Joints/b2FrictionJoint.h>
 #include <Box2D/Dynamics/b2Body.h>
 #include <Box2D/Dynamics/b2TimeStep.h>
+#include <Box2D/Dynamics/b2WorldSnapshot.h>
 
 // Point-to-point constraint
 // Cdot = v2 - v1
@@ -249,3 +250,25 @@ void b2FrictionJoint::Dump()
 	b2Log("  jd.maxTorque = %.15lef;\n", m_maxTorque);
 	b2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+void b2FrictionJoint::SerializeState(b2WorldSnapshot* snapshot)
+{
+	snapshot->Serialize(m_localAnchorA);
+	snapshot->Serialize(m_localAnchorB);
+	snapshot->Serialize(m_linearImpulse);
+	snapshot->Serialize(m_angularImpulse);
+	snapshot->Serialize(m_maxForce);
+	snapshot->Serialize(m_maxTorque);
+	snapshot->Serialize(m_indexA);
+	snapshot->Serialize(m_indexB);
+	snapshot->Serialize(m_rA);
+	snapshot->Serialize(m_rB);
+	snapshot->Serialize(m_localCenterA);
+	snapshot->Serialize(m_localCenterB);
+	snapshot->Serialize(m_invMassA);
+	snapshot->Serialize(m_invMassB);
+	snapshot->Serialize(m_invIA);
+	snapshot->Serialize(m_invIB);
+	snapshot->Serialize(m_linearMass);
+	snapshot->Serialize(m_angularMass);
+}
@@ -21,6 +21,7 @@
 #include <Box2D/Dynamics/Joints/b2PrismaticJoint.h>
 #include <Box2D/Dynamics/b2Body.h>
 #include <Box2D/Dynamics/b2TimeStep.h>
+#include <Box2D/Dynamics/b2WorldSnapshot.h>
 
 // Gear Joint:
 // C0 = (coordinate1 + ratio * coordinate2)_initial
@@ -421,3 +422,43 @@ void b2GearJoint::Dump()
 	b2Log("  jd.ratio = %.15lef;\n", m_ratio);
 	b2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+void b2GearJoint::SerializeState(b2WorldSnapshot* snapshot)
+{
+	snapshot->Serialize(m_typeA);
+	snapshot->Serialize(m_typeB);
+	snapshot->Serialize(m_localAnchorA);
+	snapshot->Serialize(m_localAnchorB);
+	snapshot->Serialize(m_localAnchorC);
+	snapshot->Serialize(m_localAnchorD);
+	snapshot->Serialize(m_localAxisC);
+	snapshot->Serialize(m_localAxisD);
+	snapshot->Serialize(m_referenceAngleA);
+	snapshot->Serialize(m_referenceAngleB);
+	snapshot->Serialize(m_constant);
+	snapshot->Serialize(m_ratio);
+	snapshot->Serialize(m_impulse);
+	snapshot->Serialize(m_indexA);
+	snapshot->Serialize(m_indexB);
+	snapshot->Serialize(m_indexC);
+	snapshot->Serialize(m_indexD);
+	snapshot->Serialize(m_lcA);
+	snapshot->Serialize(m_lcB);
+	snapshot->Serialize(m_lcC);
+	snapshot->Serialize(m_lcD);
+	snapshot->Serialize(m_mA);
+	snapshot->Serialize(m_mB);
+	snapshot->Serialize(m_mC);
+	snapshot->Serialize(m_mD);
+	snapshot->Serialize(m_iA);
+	snapshot->Serialize(m_iB);
+	snapshot->Serialize(m_iC);
+	snapshot->Serialize(m_iD);
+	snapshot->Serialize(m_JvAC);
+	snapshot->Serialize(m_JvBD);
+	snapshot->Serialize(m_JwA);
+	snapshot->Serialize(m_JwB);
+	snapshot->Serialize(m_JwC);
+	snapshot->Serialize(m_JwD);
+	snapshot->Serialize(m_mass);
+}
@@ -83,6 +83,7 @@ protected:
 	void InitVelocityConstraints(const b2SolverData& data);
 	void SolveVelocityConstraints(const b2SolverData& data);
 	bool SolvePositionConstraints(const b2SolverData& data);
+	void SerializeState(b2WorldSnapshot* snapshot);
 
 	b2Joint* m_joint1;
 	b2Joint* m_joint2;
@@ -25,6 +25,7 @@ class b2Body;
 class b2Joint;
 struct b2SolverData;
 class b2BlockAllocator;
+class b2WorldSnapshot;
 
 enum b2JointType
 {
@@ -163,6 +164,9 @@ protected:
 	// This returns true if the position errors are within tolerance.
 	virtual bool SolvePositionConstraints(const b2SolverData& data) = 0;
 
+	// Write or read the members of the derived joint, see b2World::SaveSnapshot.
+	virtual void SerializeState(b2WorldSnapshot* snapshot) = 0;
+
 	b2JointType m_type;
 	b2Joint* m_prev;
 	b2Joint* m_next;
@@ -19,6 +19,7 @@
 #include <Box2D/Dynamics/Joints/b2MouseJoint.h>
 #include <Box2D/Dynamics/b2Body.h>
 #include <Box2D/Dynamics/b2TimeStep.h>
+#include <Box2D/Dynamics/b2WorldSnapshot.h>
 
 // p = attached point, m = mouse point
 // C = p - m
@@ -215,3 +216,23 @@ float32 b2MouseJoint::GetReactionTorque(float32 inv_dt) const
 {
 	return inv_dt * 0.0f;
 }
+
+void b2MouseJoint::SerializeState(b2WorldSnapshot* snapshot)
+{
+	snapshot->Serialize(m_localAnchorB);
+	snapshot->Serialize(m_targetA);
+	snapshot->Serialize(m_frequencyHz);
+	snapshot->Serialize(m_dampingRatio);
+	snapshot->Serialize(m_beta);
+	snapshot->Serialize(m_impulse);
+	snapshot->Serialize(m_maxForce);
+	snapshot->Serialize(m_gamma);
+	snapshot->Serialize(m_indexA);
+	snapshot->Serialize(m_indexB);
+	snapshot->Serialize(m_rB);
+	snapshot->Serialize(m_localCenterB);
+	snapshot->Serialize(m_invMassB);
+	snapshot->Serialize(m_invIB);
+	snapshot->Serialize(m_mass);
+	snapshot->Serialize(m_C);
+}
@@ -100,6 +100,7 @@ protected:
 	void InitVelocityConstraints(const b2SolverData& data);
 	void SolveVelocityConstraints(const b2SolverData& data);
 	bool SolvePositionConstraints(const b2SolverData& data);
+	void SerializeState(b2WorldSnapshot* snapshot);
 
 	b2Vec2 m_localAnchorB;
 	b2Vec2 m_targetA;
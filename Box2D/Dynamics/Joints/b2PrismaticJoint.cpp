@@ -19,6 +19,7 @@
 #include <Box2D/Dynamics/Joints/b2PrismaticJoint.h>
 #include <Box2D/Dynamics/b2Body.h>
 #include <Box2D/Dynamics/b2TimeStep.h>
+#include <Box2D/Dynamics/b2WorldSnapshot.h>
 
 // Linear constraint (point-to-line)
 // d = p2 - p1 = x2 + r2 - x1 - r1
@@ -635,3 +636,37 @@ void b2PrismaticJoint::Dump()
 	b2Log("  jd.maxMotorForce = %.15lef;\n", m_maxMotorForce);
 	b2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+void b2PrismaticJoint::SerializeState(b2WorldSnapshot* snapshot)
+{
+	snapshot->Serialize(m_localAnchorA);
+	snapshot->Serialize(m_localAnchorB);
+	snapshot->Serialize(m_localXAxisA);
+	snapshot->Serialize(m_localYAxisA);
+	snapshot->Serialize(m_referenceAngle);
+	snapshot->Serialize(m_impulse);
+	snapshot->Serialize(m_motorImpulse);
+	snapshot->Serialize(m_lowerTranslation);
+	snapshot->Serialize(m_upperTranslation);
+	snapshot->Serialize(m_maxMotorForce);
+	snapshot->Serialize(m_motorSpeed);
+	snapshot->Serialize(m_enableLimit);
+	snapshot->Serialize(m_enableMotor);
+	snapshot->Serialize(m_limitState);
+	snapshot->Serialize(m_indexA);
+	snapshot->Serialize(m_indexB);
+	snapshot->Serialize(m_localCenterA);
+	snapshot->Serialize(m_localCenterB);
+	snapshot->Serialize(m_invMassA);
+	snapshot->Serialize(m_invMassB);
+	snapshot->Serialize(m_invIA);
+	snapshot->Serialize(m_invIB);
+	snapshot->Serialize(m_axis);
+	snapshot->Serialize(m_perp);
+	snapshot->Serialize(m_s1);
+	snapshot->Serialize(m_s2);
+	snapshot->Serialize(m_a1);
+	snapshot->Serialize(m_a2);
+	snapshot->Serialize(m_K);
+	snapshot->Serialize(m_motorMass);
+}
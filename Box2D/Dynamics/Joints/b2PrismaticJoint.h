@@ -155,6 +155,7 @@ protected:
 	void InitVelocityConstraints(const b2SolverData& data);
 	void SolveVelocityConstraints(const b2SolverData& data);
 	bool SolvePositionConstraints(const b2SolverData& data);
+	void SerializeState(b2WorldSnapshot* snapshot);
 
 	// Solver shared
 	b2Vec2 m_localAnchorA;
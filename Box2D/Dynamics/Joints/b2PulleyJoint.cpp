@@ -19,6 +19,7 @@
 #include <Box2D/Dynamics/Joints/b2PulleyJoint.h>
 #include <Box2D/Dynamics/b2Body.h>
 #include <Box2D/Dynamics/b2TimeStep.h>
+#include <Box2D/Dynamics/b2WorldSnapshot.h>
 
 // Pulley:
 // length1 = norm(p1 - s1)
@@ -330,3 +331,29 @@ void b2PulleyJoint::Dump()
 	b2Log("  jd.ratio = %.15lef;\n", m_ratio);
 	b2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+void b2PulleyJoint::SerializeState(b2WorldSnapshot* snapshot)
+{
+	snapshot->Serialize(m_groundAnchorA);
+	snapshot->Serialize(m_groundAnchorB);
+	snapshot->Serialize(m_lengthA);
+	snapshot->Serialize(m_lengthB);
+	snapshot->Serialize(m_localAnchorA);
+	snapshot->Serialize(m_localAnchorB);
+	snapshot->Serialize(m_constant);
+	snapshot->Serialize(m_ratio);
+	snapshot->Serialize(m_impulse);
+	snapshot->Serialize(m_indexA);
+	snapshot->Serialize(m_indexB);
+	snapshot->Serialize(m_uA);
+	snapshot->Serialize(m_uB);
+	snapshot->Serialize(m_rA);
+	snapshot->Serialize(m_rB);
+	snapshot->Serialize(m_localCenterA);
+	snapshot->Serialize(m_localCenterB);
+	snapshot->Serialize(m_invMassA);
+	snapshot->Serialize(m_invMassB);
+	snapshot->Serialize(m_invIA);
+	snapshot->Serialize(m_invIB);
+	snapshot->Serialize(m_mass);
+}
@@ -19,6 +19,7 @@
 #include <Box2D/Dynamics/Joints/b2RevoluteJoint.h>
 #include <Box2D/Dynamics/b2Body.h>
 #include <Box2D/Dynamics/b2TimeStep.h>
+#include <Box2D/Dynamics/b2WorldSnapshot.h>
 
 // Point-to-point constraint
 // C = p2 - p1
@@ -502,3 +503,31 @@ void b2RevoluteJoint::Dump()
 	b2Log("  jd.maxMotorTorque = %.15lef;\n", m_maxMotorTorque);
 	b2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+void b2RevoluteJoint::SerializeState(b2WorldSnapshot* snapshot)
+{
+	snapshot->Serialize(m_localAnchorA);
+	snapshot->Serialize(m_localAnchorB);
+	snapshot->Serialize(m_impulse);
+	snapshot->Serialize(m_motorImpulse);
+	snapshot->Serialize(m_enableMotor);
+	snapshot->Serialize(m_maxMotorTorque);
+	snapshot->Serialize(m_motorSpeed);
+	snapshot->Serialize(m_enableLimit);
+	snapshot->Serialize(m_referenceAngle);
+	snapshot->Serialize(m_lowerAngle);
+	snapshot->Serialize(m_upperAngle);
+	snapshot->Serialize(m_indexA);
+	snapshot->Serialize(m_indexB);
+	snapshot->Serialize(m_rA);
+	snapshot->Serialize(m_rB);
+	snapshot->Serialize(m_localCenterA);
+	snapshot->Serialize(m_localCenterB);
+	snapshot->Serialize(m_invMassA);
+	snapshot->Serialize(m_invMassB);
+	snapshot->Serialize(m_invIA);
+	snapshot->Serialize(m_invIB);
+	snapshot->Serialize(m_mass);
+	snapshot->Serialize(m_motorMass);
+	snapshot->Serialize(m_limitState);
+}
@@ -19,6 +19,7 @@
 #include <Box2D/Dynamics/Joints/b2WheelJoint.h>
 #include <Box2D/Dynamics/b2Body.h>
 #include <Box2D/Dynamics/b2TimeStep.h>
+#include <Box2D/Dynamics/b2WorldSnapshot.h>
 
 // Linear constraint (point-to-line)
 // d = pB - pA = xB + rB - xA - rA
@@ -417,3 +418,38 @@ void b2WheelJoint::Dump()
 	b2Log("  jd.dampingRatio = %.15lef;\n", m_dampingRatio);
 	b2Log("  joints[%d] = m_world->CreateJoint(&jd);\n", m_index);
 }
+
+void b2WheelJoint::SerializeState(b2WorldSnapshot* snapshot)
+{
+	snapshot->Serialize(m_frequencyHz);
+	snapshot->Serialize(m_dampingRatio);
+	snapshot->Serialize(m_localAnchorA);
+	snapshot->Serialize(m_localAnchorB);
+	snapshot->Serialize(m_localXAxisA);
+	snapshot->Serialize(m_localYAxisA);
+	snapshot->Serialize(m_impulse);
+	snapshot->Serialize(m_motorImpulse);
+	snapshot->Serialize(m_springImpulse);
+	snapshot->Serialize(m_maxMotorTorque);
+	snapshot->Serialize(m_motorSpeed);
+	snapshot->Serialize(m_enableMotor);
+	snapshot->Serialize(m_indexA);
+	snapshot->Serialize(m_indexB);
+	snapshot->Serialize(m_localCenterA);
+	snapshot->Serialize(m_localCenterB);
+	snapshot->Serialize(m_invMassA);
+	snapshot->Serialize(m_invMassB);
+	snapshot->Serialize(m_invIA);
+	snapshot->Serialize(m_invIB);
+	snapshot->Serialize(m_ax);
+	snapshot->Serialize(m_ay);
+	snapshot->Serialize(m_sAx);
+	snapshot->Serialize(m_sBx);
+	snapshot->Serialize(m_sAy);
+	snapshot->Serialize(m_sBy);
+	snapshot->Serialize(m_mass);
+	snapshot->Serialize(m_motorMass);
+	snapshot->Serialize(m_springMass);
+	snapshot->Serialize(m_bias);
+	snapshot->Serialize(m_gamma);
+}
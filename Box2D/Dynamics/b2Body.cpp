@@ -453,9 +453,58 @@ void b2Body::SetActive(bool flag)
 
 		// Create all proxies.
 		b2BroadPhase* broadPhase = &m_world->m_contactManager.m_broadPhase;
+		int32 proxyCount = 0;
 		for (b2Fixture* f = m_fixtureList; f; f = f->m_next)
 		{
-			f->CreateProxies(broadPhase, m_xf);
+			proxyCount += f->m_shape->GetChildCount();
+		}
+
+		if (proxyCount > 1 && proxyCount >= broadPhase->GetProxyCount())
+		{
+			// The body holds most of the proxies, such as the static geometry
+			// of a level. Building the tree once beats inserting them one by one.
+			b2StackAllocator* allocator = &m_world->m_stackAllocator;
+			b2AABB* aabbs = (b2AABB*)allocator->Allocate(proxyCount * sizeof(b2AABB));
+			void** userData = (void**)allocator->Allocate(proxyCount * sizeof(void*));
+			int32* proxyIds = (int32*)allocator->Allocate(proxyCount * sizeof(int32));
+
+			int32 index = 0;
+			for (b2Fixture* f = m_fixtureList; f; f = f->m_next)
+			{
+				f->m_proxyCount = f->m_shape->GetChildCount();
+				for (int32 i = 0; i < f->m_proxyCount; ++i)
+				{
+					b2FixtureProxy* proxy = f->m_proxies + i;
+					f->m_shape->ComputeAABB(&proxy->aabb, m_xf, i);
+					proxy->fixture = f;
+					proxy->childIndex = i;
+					aabbs[index] = proxy->aabb;
+					userData[index] = proxy;
+					++index;
+				}
+			}
+
+			broadPhase->CreateProxies(aabbs, userData, proxyCount, proxyIds);
+
+			index = 0;
+			for (b2Fixture* f = m_fixtureList; f; f = f->m_next)
+			{
+				for (int32 i = 0; i < f->m_proxyCount; ++i)
+				{
+					f->m_proxies[i].proxyId = proxyIds[index++];
+				}
+			}
+
+			allocator->Free(proxyIds);
+			allocator->Free(userData);
+			allocator->Free(aabbs);
+		}
+		else
+		{
+			for (b2Fixture* f = m_fixtureList; f; f = f->m_next)
+			{
+				f->CreateProxies(broadPhase, m_xf);
+			}
 		}
 
 		// Contacts are created the next time step.
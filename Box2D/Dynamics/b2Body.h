@@ -325,7 +325,9 @@ public:
 	/// Set the active state of the body. An inactive body is not
 	/// simulated and cannot be collided with or woken up.
 	/// If you pass a flag of true, all fixtures will be added to the
-	/// broad-phase.
+	/// broad-phase. When the body brings at least as many proxies as the
+	/// broad-phase holds, such as the static geometry of a level created
+	/// inactive, the dynamic tree is built once for all of them.
 	/// If you pass a flag of false, all fixtures will be removed from
 	/// the broad-phase and all contacts will be destroyed.
 	/// Fixtures and joints are otherwise unaffected. You may continue
@@ -21,10 +21,32 @@
 #include <Box2D/Dynamics/b2Fixture.h>
 #include <Box2D/Dynamics/b2WorldCallbacks.h>
 #include <Box2D/Dynamics/Contacts/b2Contact.h>
+#include <Box2D/Common/b2ThreadPool.h>
+#include <cstring>
 
 b2ContactFilter b2_defaultFilter;
 b2ContactListener b2_defaultListener;
 
+// A contact manifold evaluated ahead of the serial contact update.
+struct b2ContactUpdate
+{
+	b2Contact* contact;
+	b2Manifold manifold;
+	bool touching;
+};
+
+class b2ComputeManifoldsTask : public b2ThreadPoolTask
+{
+public:
+	void Execute(int32 begin, int32 end, int32 threadIndex)
+	{
+		B2_NOT_USED(threadIndex);
+		m_contactManager->ComputeManifolds(begin, end);
+	}
+
+	b2ContactManager* m_contactManager;
+};
+
 b2ContactManager::b2ContactManager()
 {
 	m_contactList = NULL;
@@ -32,6 +54,14 @@ b2ContactManager::b2ContactManager()
 	m_contactFilter = &b2_defaultFilter;
 	m_contactListener = &b2_defaultListener;
 	m_allocator = NULL;
+	m_threadPool = NULL;
+	m_updates = NULL;
+	m_updateCapacity = 0;
+}
+
+b2ContactManager::~b2ContactManager()
+{
+	b2Free(m_updates);
 }
 
 void b2ContactManager::Destroy(b2Contact* c)
@@ -104,10 +134,27 @@ void b2ContactManager::Destroy(b2Contact* c)
 // contact list.
 void b2ContactManager::Collide()
 {
+	// The manifolds are computed in parallel first. The loop below still handles
+	// the contacts one by one in list order, so filtering, destruction and the
+	// listener calls happen as without a thread pool.
+	int32 updateCount = 0;
+	if (m_threadPool && m_threadPool->GetThreadCount() > 1)
+	{
+		updateCount = ComputeManifolds();
+	}
+	int32 updateIndex = 0;
+
 	// Update awake contacts.
 	b2Contact* c = m_contactList;
 	while (c)
 	{
+		b2ContactUpdate* update = NULL;
+		if (updateIndex < updateCount && m_updates[updateIndex].contact == c)
+		{
+			update = m_updates + updateIndex;
+			++updateIndex;
+		}
+
 		b2Fixture* fixtureA = c->GetFixtureA();
 		b2Fixture* fixtureB = c->GetFixtureB();
 		int32 indexA = c->GetChildIndexA();
@@ -163,12 +210,83 @@ void b2ContactManager::Collide()
 			continue;
 		}
 
-		// The contact persists.
-		c->Update(m_contactListener);
+		// The contact persists. A contact missing from the updates has a body
+		// that was woken by an earlier contact.
+		if (update)
+		{
+			c->Update(m_contactListener, update->manifold, update->touching);
+		}
+		else
+		{
+			c->Update(m_contactListener);
+		}
 		c = c->GetNext();
 	}
 }
 
+int32 b2ContactManager::ComputeManifolds()
+{
+	// Gather the contacts that are expected to persist. Filtering is left to Collide,
+	// a contact it destroys only wastes its manifold. Sensors are also left to Collide
+	// because their overlap test updates the global GJK statistics.
+	int32 count = 0;
+	for (b2Contact* c = m_contactList; c; c = c->GetNext())
+	{
+		b2Fixture* fixtureA = c->GetFixtureA();
+		b2Fixture* fixtureB = c->GetFixtureB();
+		if (fixtureA->IsSensor() || fixtureB->IsSensor())
+		{
+			continue;
+		}
+		b2Body* bodyA = fixtureA->GetBody();
+		b2Body* bodyB = fixtureB->GetBody();
+
+		bool activeA = bodyA->IsAwake() && bodyA->m_type != b2_staticBody;
+		bool activeB = bodyB->IsAwake() && bodyB->m_type != b2_staticBody;
+		if (activeA == false && activeB == false)
+		{
+			continue;
+		}
+
+		int32 proxyIdA = fixtureA->m_proxies[c->GetChildIndexA()].proxyId;
+		int32 proxyIdB = fixtureB->m_proxies[c->GetChildIndexB()].proxyId;
+		if (m_broadPhase.TestOverlap(proxyIdA, proxyIdB) == false)
+		{
+			continue;
+		}
+
+		if (count == m_updateCapacity)
+		{
+			b2ContactUpdate* old = m_updates;
+			m_updateCapacity = b2Max(2 * m_updateCapacity, 256);
+			m_updates = (b2ContactUpdate*)b2Alloc(m_updateCapacity * sizeof(b2ContactUpdate));
+			if (old)
+			{
+				memcpy(m_updates, old, count * sizeof(b2ContactUpdate));
+				b2Free(old);
+			}
+		}
+
+		m_updates[count].contact = c;
+		++count;
+	}
+
+	b2ComputeManifoldsTask task;
+	task.m_contactManager = this;
+	m_threadPool->ParallelFor(&task, count, 32);
+
+	return count;
+}
+
+void b2ContactManager::ComputeManifolds(int32 begin, int32 end)
+{
+	for (int32 i = begin; i < end; ++i)
+	{
+		b2ContactUpdate* update = m_updates + i;
+		update->touching = update->contact->ComputeManifold(&update->manifold);
+	}
+}
+
 void b2ContactManager::FindNewContacts()
 {
 	m_broadPhase.UpdatePairs(this);
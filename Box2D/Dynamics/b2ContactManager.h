@@ -25,12 +25,15 @@ class b2Contact;
 class b2ContactFilter;
 class b2ContactListener;
 class b2BlockAllocator;
+class b2ThreadPool;
+struct b2ContactUpdate;
 
 // Delegate of b2World.
 class b2ContactManager
 {
 public:
 	b2ContactManager();
+	~b2ContactManager();
 
 	// Broad-phase callback.
 	void AddPair(void* proxyUserDataA, void* proxyUserDataB);
@@ -40,6 +43,10 @@ public:
 	void Destroy(b2Contact* c);
 
 	void Collide();
+
+	// Evaluate the manifolds of the contacts Collide is going to update on the thread pool.
+	int32 ComputeManifolds();
+	void ComputeManifolds(int32 begin, int32 end);
             
 	b2BroadPhase m_broadPhase;
 	b2Contact* m_contactList;
@@ -47,6 +54,11 @@ public:
 	b2ContactFilter* m_contactFilter;
 	b2ContactListener* m_contactListener;
 	b2BlockAllocator* m_allocator;
+
+	// Set by b2World::SetThreadPool.
+	b2ThreadPool* m_threadPool;
+	b2ContactUpdate* m_updates;
+	int32 m_updateCapacity;
 };
 
 #endif
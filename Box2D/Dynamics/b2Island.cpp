@@ -168,16 +168,52 @@ b2Island::b2Island(
 
 	m_velocities = (b2Velocity*)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Velocity));
 	m_positions = (b2Position*)m_allocator->Allocate(m_bodyCapacity * sizeof(b2Position));
+
+	m_staticCount = 0;
+	m_ownsArrays = true;
+}
+
+b2Island::b2Island(
+	b2Body** bodies, int32 bodyCount,
+	b2Contact** contacts, int32 contactCount,
+	b2Joint** joints, int32 jointCount,
+	int32 staticCount,
+	b2StackAllocator* allocator,
+	b2ContactListener* listener)
+{
+	m_bodyCapacity = bodyCount;
+	m_contactCapacity = contactCount;
+	m_jointCapacity = jointCount;
+	m_bodyCount = bodyCount;
+	m_contactCount = contactCount;
+	m_jointCount = jointCount;
+
+	m_allocator = allocator;
+	m_listener = listener;
+
+	m_bodies = bodies;
+	m_contacts = contacts;
+	m_joints = joints;
+
+	// Static bodies have negative indices.
+	m_staticCount = staticCount;
+	m_ownsArrays = false;
+	m_velocities = (b2Velocity*)m_allocator->Allocate((m_staticCount + m_bodyCount) * sizeof(b2Velocity)) + m_staticCount;
+	m_positions = (b2Position*)m_allocator->Allocate((m_staticCount + m_bodyCount) * sizeof(b2Position)) + m_staticCount;
 }
 
 b2Island::~b2Island()
 {
 	// Warning: the order should reverse the constructor order.
-	m_allocator->Free(m_positions);
-	m_allocator->Free(m_velocities);
-	m_allocator->Free(m_joints);
-	m_allocator->Free(m_contacts);
-	m_allocator->Free(m_bodies);
+	m_allocator->Free(m_positions - m_staticCount);
+	m_allocator->Free(m_velocities - m_staticCount);
+
+	if (m_ownsArrays)
+	{
+		m_allocator->Free(m_joints);
+		m_allocator->Free(m_contacts);
+		m_allocator->Free(m_bodies);
+	}
 }
 
 void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep)
@@ -36,6 +36,13 @@ class b2Island
 public:
 	b2Island(int32 bodyCapacity, int32 contactCapacity, int32 jointCapacity,
 			b2StackAllocator* allocator, b2ContactListener* listener);
+
+	/// Wrap an island gathered by b2World, the arrays are not copied. The bodies must
+	/// already have their island index. Static bodies are not in the body array, they
+	/// use the negative island indices [-staticCount, -1] and are set with AddStatic.
+	b2Island(b2Body** bodies, int32 bodyCount, b2Contact** contacts, int32 contactCount,
+			b2Joint** joints, int32 jointCount, int32 staticCount,
+			b2StackAllocator* allocator, b2ContactListener* listener);
 	~b2Island();
 
 	void Clear()
@@ -69,6 +76,17 @@ public:
 		m_joints[m_jointCount++] = joint;
 	}
 
+	/// Set the state of a static body of a wrapped island. The body is only read.
+	void AddStatic(const b2Body* body)
+	{
+		int32 index = body->m_islandIndex;
+		b2Assert(-m_staticCount <= index && index < 0);
+		m_positions[index].c = body->m_sweep.c;
+		m_positions[index].a = body->m_sweep.a;
+		m_velocities[index].v = body->m_linearVelocity;
+		m_velocities[index].w = body->m_angularVelocity;
+	}
+
 	void Report(const b2ContactVelocityConstraint* constraints);
 
 	b2StackAllocator* m_allocator;
@@ -88,6 +106,10 @@ public:
 	int32 m_bodyCapacity;
 	int32 m_contactCapacity;
 	int32 m_jointCapacity;
+
+	// Slots before m_positions and m_velocities used by static bodies.
+	int32 m_staticCount;
+	bool m_ownsArrays;
 };
 
 #endif
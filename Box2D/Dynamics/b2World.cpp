@@ -32,6 +32,8 @@
 #include <Box2D/Collision/b2TimeOfImpact.h>
 #include <Box2D/Common/b2Draw.h>
 #include <Box2D/Common/b2Timer.h>
+#include <Box2D/Common/b2ThreadPool.h>
+#include <algorithm>
 #include <new>
 
 b2World::b2World(const b2Vec2& gravity)
@@ -48,6 +50,7 @@ b2World::b2World(const b2Vec2& gravity)
 	m_warmStarting = true;
 	m_continuousPhysics = true;
 	m_subStepping = false;
+	m_wideContactSolver = false;
 
 	m_stepComplete = true;
 
@@ -60,6 +63,10 @@ b2World::b2World(const b2Vec2& gravity)
 
 	m_contactManager.m_allocator = &m_blockAllocator;
 
+	m_threadPool = NULL;
+	m_workerStackAllocators = NULL;
+	m_workerCount = 0;
+
 	memset(&m_profile, 0, sizeof(b2Profile));
 }
 
@@ -82,6 +89,8 @@ b2World::~b2World()
 
 		b = bNext;
 	}
+
+	SetThreadPool(NULL);
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
@@ -104,6 +113,37 @@ void b2World::SetDebugDraw(b2Draw* debugDraw)
 	m_debugDraw = debugDraw;
 }
 
+void b2World::SetThreadPool(b2ThreadPool* threadPool)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < m_workerCount; ++i)
+	{
+		m_workerStackAllocators[i].~b2StackAllocator();
+	}
+	b2Free(m_workerStackAllocators);
+	m_workerStackAllocators = NULL;
+	m_workerCount = 0;
+
+	m_threadPool = threadPool;
+	m_contactManager.m_threadPool = threadPool;
+	m_contactManager.m_broadPhase.SetThreadPool(threadPool);
+
+	if (m_threadPool)
+	{
+		m_workerCount = m_threadPool->GetThreadCount() - 1;
+		m_workerStackAllocators = (b2StackAllocator*)b2Alloc(b2Max(m_workerCount, 1) * sizeof(b2StackAllocator));
+		for (int32 i = 0; i < m_workerCount; ++i)
+		{
+			new (m_workerStackAllocators + i) b2StackAllocator;
+		}
+	}
+}
+
 b2Body* b2World::CreateBody(const b2BodyDef* def)
 {
 	b2Assert(IsLocked() == false);
@@ -383,19 +423,109 @@ void b2World::SetAllowSleeping(bool flag)
 }
 
 // Find islands, integrate and solve constraints, solve position constraints
+void b2World::BuildIsland(b2Island* island, b2Body* seed, b2Body** stack, int32 stackSize)
+{
+	int32 stackCount = 0;
+	stack[stackCount++] = seed;
+	seed->m_flags |= b2Body::e_islandFlag;
+
+	// Perform a depth first search (DFS) on the constraint graph.
+	while (stackCount > 0)
+	{
+		// Grab the next body off the stack and add it to the island.
+		b2Body* b = stack[--stackCount];
+		b2Assert(b->IsActive() == true);
+		island->Add(b);
+
+		// Make sure the body is awake.
+		b->SetAwake(true);
+
+		// To keep islands as small as possible, we don't
+		// propagate islands across static bodies.
+		if (b->GetType() == b2_staticBody)
+		{
+			continue;
+		}
+
+		// Search all contacts connected to this body.
+		for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+		{
+			b2Contact* contact = ce->contact;
+
+			// Has this contact already been added to an island?
+			if (contact->m_flags & b2Contact::e_islandFlag)
+			{
+				continue;
+			}
+
+			// Is this contact solid and touching?
+			if (contact->IsEnabled() == false ||
+				contact->IsTouching() == false)
+			{
+				continue;
+			}
+
+			// Skip sensors.
+			bool sensorA = contact->m_fixtureA->m_isSensor;
+			bool sensorB = contact->m_fixtureB->m_isSensor;
+			if (sensorA || sensorB)
+			{
+				continue;
+			}
+
+			island->Add(contact);
+			contact->m_flags |= b2Contact::e_islandFlag;
+
+			b2Body* other = ce->other;
+
+			// Was the other body already added to this island?
+			if (other->m_flags & b2Body::e_islandFlag)
+			{
+				continue;
+			}
+
+			b2Assert(stackCount < stackSize);
+			stack[stackCount++] = other;
+			other->m_flags |= b2Body::e_islandFlag;
+		}
+
+		// Search all joints connect to this body.
+		for (b2JointEdge* je = b->m_jointList; je; je = je->next)
+		{
+			if (je->joint->m_islandFlag == true)
+			{
+				continue;
+			}
+
+			b2Body* other = je->other;
+
+			// Don't simulate joints connected to inactive bodies.
+			if (other->IsActive() == false)
+			{
+				continue;
+			}
+
+			island->Add(je->joint);
+			je->joint->m_islandFlag = true;
+
+			if (other->m_flags & b2Body::e_islandFlag)
+			{
+				continue;
+			}
+
+			b2Assert(stackCount < stackSize);
+			stack[stackCount++] = other;
+			other->m_flags |= b2Body::e_islandFlag;
+		}
+	}
+}
+
 void b2World::Solve(const b2TimeStep& step)
 {
 	m_profile.solveInit = 0.0f;
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
 
-	// Size the island for the worst case.
-	b2Island island(m_bodyCount,
-					m_contactManager.m_contactCount,
-					m_jointCount,
-					&m_stackAllocator,
-					m_contactManager.m_contactListener);
-
 	// Clear all the island flags.
 	for (b2Body* b = m_bodyList; b; b = b->m_next)
 	{
@@ -410,167 +540,370 @@ void b2World::Solve(const b2TimeStep& step)
 		j->m_islandFlag = false;
 	}
 
-	// Build and simulate all awake islands.
-	int32 stackSize = m_bodyCount;
-	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
-	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+	if (m_workerCount > 0)
 	{
-		if (seed->m_flags & b2Body::e_islandFlag)
+		SolveParallel(step);
+	}
+	else
+	{
+		// Size the island for the worst case.
+		b2Island island(m_bodyCount,
+						m_contactManager.m_contactCount,
+						m_jointCount,
+						&m_stackAllocator,
+						m_contactManager.m_contactListener);
+
+		// Build and simulate all awake islands.
+		int32 stackSize = m_bodyCount;
+		b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
+		for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
 		{
-			continue;
+			if (seed->m_flags & b2Body::e_islandFlag)
+			{
+				continue;
+			}
+
+			if (seed->IsAwake() == false || seed->IsActive() == false)
+			{
+				continue;
+			}
+
+			// The seed can be dynamic or kinematic.
+			if (seed->GetType() == b2_staticBody)
+			{
+				continue;
+			}
+
+			// Reset island and stack.
+			island.Clear();
+			BuildIsland(&island, seed, stack, stackSize);
+
+			b2Profile profile;
+			island.Solve(&profile, step, m_gravity, m_allowSleep);
+			m_profile.solveInit += profile.solveInit;
+			m_profile.solveVelocity += profile.solveVelocity;
+			m_profile.solvePosition += profile.solvePosition;
+
+			// Post solve cleanup.
+			for (int32 i = 0; i < island.m_bodyCount; ++i)
+			{
+				// Allow static bodies to participate in other islands.
+				b2Body* b = island.m_bodies[i];
+				if (b->GetType() == b2_staticBody)
+				{
+					b->m_flags &= ~b2Body::e_islandFlag;
+				}
+			}
 		}
 
-		if (seed->IsAwake() == false || seed->IsActive() == false)
+		m_stackAllocator.Free(stack);
+	}
+
+	{
+		b2Timer timer;
+		// Synchronize fixtures, check for out of range bodies.
+		for (b2Body* b = m_bodyList; b; b = b->GetNext())
 		{
-			continue;
+			// If a body was not in an island then it did not move.
+			if ((b->m_flags & b2Body::e_islandFlag) == 0)
+			{
+				continue;
+			}
+
+			if (b->GetType() == b2_staticBody)
+			{
+				continue;
+			}
+
+			// Update fixtures (for broad-phase).
+			b->SynchronizeFixtures();
 		}
 
-		// The seed can be dynamic or kinematic.
-		if (seed->GetType() == b2_staticBody)
+		// Look for new contacts.
+		m_contactManager.FindNewContacts();
+		m_profile.broadphase = timer.GetMilliseconds();
+	}
+}
+
+// An island gathered by b2World::SolveParallel, as ranges of the gathered arrays.
+struct b2IslandRange
+{
+	int32 bodyStart;
+	int32 bodyCount;
+	int32 contactStart;
+	int32 contactCount;
+	int32 jointStart;
+	int32 jointCount;
+	int32 staticStart;
+	int32 staticCount;
+
+	// Number of static slots, the lowest static island index is -staticSlotCount.
+	int32 staticSlotCount;
+
+	b2Profile profile;
+};
+
+// Orders the islands from the most to the least work, to balance the threads.
+struct b2IslandWorkGreater
+{
+	bool operator()(int32 a, int32 b) const
+	{
+		int32 workA = ranges[a].bodyCount + ranges[a].contactCount + ranges[a].jointCount;
+		int32 workB = ranges[b].bodyCount + ranges[b].contactCount + ranges[b].jointCount;
+		if (workA != workB)
 		{
-			continue;
+			return workA > workB;
 		}
+		return a < b;
+	}
 
-		// Reset island and stack.
-		island.Clear();
-		int32 stackCount = 0;
-		stack[stackCount++] = seed;
-		seed->m_flags |= b2Body::e_islandFlag;
+	const b2IslandRange* ranges;
+};
+
+// Stores the impulses reported by an island solved on a worker thread, so that
+// PostSolve is called on the stepping thread once all the islands are solved.
+class b2ImpulseRecorder : public b2ContactListener
+{
+public:
+	void PostSolve(b2Contact* contact, const b2ContactImpulse* impulse)
+	{
+		B2_NOT_USED(contact);
+		m_impulses[m_count++] = *impulse;
+	}
 
-		// Perform a depth first search (DFS) on the constraint graph.
-		while (stackCount > 0)
+	b2ContactImpulse* m_impulses;
+	int32 m_count;
+};
+
+class b2SolveIslandsTask : public b2ThreadPoolTask
+{
+public:
+	void Execute(int32 begin, int32 end, int32 threadIndex)
+	{
+		b2StackAllocator* allocator = threadIndex == 0 ? mainAllocator : workerAllocators + threadIndex - 1;
+
+		for (int32 i = begin; i < end; ++i)
 		{
-			// Grab the next body off the stack and add it to the island.
-			b2Body* b = stack[--stackCount];
-			b2Assert(b->IsActive() == true);
-			island.Add(b);
+			b2IslandRange* range = ranges + order[i];
 
-			// Make sure the body is awake.
-			b->SetAwake(true);
+			b2ImpulseRecorder recorder;
+			recorder.m_impulses = impulses + range->contactStart;
+			recorder.m_count = 0;
 
-			// To keep islands as small as possible, we don't
-			// propagate islands across static bodies.
-			if (b->GetType() == b2_staticBody)
+			b2Island island(bodies + range->bodyStart, range->bodyCount,
+							contacts + range->contactStart, range->contactCount,
+							joints + range->jointStart, range->jointCount,
+							range->staticSlotCount,
+							allocator,
+							impulses ? &recorder : NULL);
+
+			for (int32 j = 0; j < range->staticCount; ++j)
 			{
-				continue;
+				island.AddStatic(statics[range->staticStart + j]);
 			}
 
-			// Search all contacts connected to this body.
-			for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
-			{
-				b2Contact* contact = ce->contact;
+			island.Solve(&range->profile, *step, gravity, allowSleep);
+		}
+	}
 
-				// Has this contact already been added to an island?
-				if (contact->m_flags & b2Contact::e_islandFlag)
-				{
-					continue;
-				}
+	const b2TimeStep* step;
+	b2Vec2 gravity;
+	bool allowSleep;
 
-				// Is this contact solid and touching?
-				if (contact->IsEnabled() == false ||
-					contact->IsTouching() == false)
-				{
-					continue;
-				}
+	b2IslandRange* ranges;
+	const int32* order;
+	b2Body** bodies;
+	b2Contact** contacts;
+	b2Joint** joints;
+	b2Body** statics;
+	b2ContactImpulse* impulses;
 
-				// Skip sensors.
-				bool sensorA = contact->m_fixtureA->m_isSensor;
-				bool sensorB = contact->m_fixtureB->m_isSensor;
-				if (sensorA || sensorB)
-				{
-					continue;
-				}
+	b2StackAllocator* mainAllocator;
+	b2StackAllocator* workerAllocators;
+};
 
-				island.Add(contact);
-				contact->m_flags |= b2Contact::e_islandFlag;
+// Gather all the awake islands, then solve them on the thread pool. The islands
+// are gathered in the same order as the serial path and each island is solved
+// the same way, so the results are identical. Static bodies can belong to several
+// islands, so the islands only read them: they get negative island indices that
+// refer to per island copies of their state.
+void b2World::SolveParallel(const b2TimeStep& step)
+{
+	int32 contactCapacity = m_contactManager.m_contactCount;
 
-				b2Body* other = ce->other;
+	// Scratch island used to gather each island.
+	b2Island island(m_bodyCount,
+					contactCapacity,
+					m_jointCount,
+					&m_stackAllocator,
+					NULL);
 
-				// Was the other body already added to this island?
-				if (other->m_flags & b2Body::e_islandFlag)
-				{
-					continue;
-				}
+	int32 stackSize = m_bodyCount;
+	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
 
-				b2Assert(stackCount < stackSize);
-				stack[stackCount++] = other;
-				other->m_flags |= b2Body::e_islandFlag;
-			}
+	// Each static body joins an island through at least one contact or joint.
+	int32 staticCapacity = contactCapacity + m_jointCount;
 
-			// Search all joints connect to this body.
-			for (b2JointEdge* je = b->m_jointList; je; je = je->next)
-			{
-				if (je->joint->m_islandFlag == true)
-				{
-					continue;
-				}
+	b2IslandRange* ranges = (b2IslandRange*)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2IslandRange));
+	b2Body** bodies = (b2Body**)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2Body*));
+	b2Contact** contacts = (b2Contact**)m_stackAllocator.Allocate(contactCapacity * sizeof(b2Contact*));
+	b2Joint** joints = (b2Joint**)m_stackAllocator.Allocate(m_jointCount * sizeof(b2Joint*));
+	b2Body** statics = (b2Body**)m_stackAllocator.Allocate(staticCapacity * sizeof(b2Body*));
 
-				b2Body* other = je->other;
+	int32 islandCount = 0;
+	int32 bodyCount = 0;
+	int32 contactCount = 0;
+	int32 jointCount = 0;
+	int32 staticCount = 0;
 
-				// Don't simulate joints connected to inactive bodies.
-				if (other->IsActive() == false)
-				{
-					continue;
-				}
-
-				island.Add(je->joint);
-				je->joint->m_islandFlag = true;
+	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+	{
+		if (seed->m_flags & b2Body::e_islandFlag)
+		{
+			continue;
+		}
 
-				if (other->m_flags & b2Body::e_islandFlag)
-				{
-					continue;
-				}
+		if (seed->IsAwake() == false || seed->IsActive() == false)
+		{
+			continue;
+		}
 
-				b2Assert(stackCount < stackSize);
-				stack[stackCount++] = other;
-				other->m_flags |= b2Body::e_islandFlag;
-			}
+		// The seed can be dynamic or kinematic.
+		if (seed->GetType() == b2_staticBody)
+		{
+			continue;
 		}
 
-		b2Profile profile;
-		island.Solve(&profile, step, m_gravity, m_allowSleep);
-		m_profile.solveInit += profile.solveInit;
-		m_profile.solveVelocity += profile.solveVelocity;
-		m_profile.solvePosition += profile.solvePosition;
+		island.Clear();
+		BuildIsland(&island, seed, stack, stackSize);
+
+		b2IslandRange* range = ranges + islandCount++;
+		range->bodyStart = bodyCount;
+		range->contactStart = contactCount;
+		range->jointStart = jointCount;
+		range->staticStart = staticCount;
 
-		// Post solve cleanup.
 		for (int32 i = 0; i < island.m_bodyCount; ++i)
 		{
-			// Allow static bodies to participate in other islands.
 			b2Body* b = island.m_bodies[i];
 			if (b->GetType() == b2_staticBody)
 			{
+				// Allow static bodies to participate in other islands.
 				b->m_flags &= ~b2Body::e_islandFlag;
+				statics[staticCount++] = b;
+			}
+			else
+			{
+				b->m_islandIndex = bodyCount - range->bodyStart;
+				bodies[bodyCount++] = b;
 			}
 		}
-	}
 
-	m_stackAllocator.Free(stack);
+		for (int32 i = 0; i < island.m_contactCount; ++i)
+		{
+			contacts[contactCount++] = island.m_contacts[i];
+		}
+
+		for (int32 i = 0; i < island.m_jointCount; ++i)
+		{
+			joints[jointCount++] = island.m_joints[i];
+		}
+
+		range->bodyCount = bodyCount - range->bodyStart;
+		range->contactCount = contactCount - range->contactStart;
+		range->jointCount = jointCount - range->jointStart;
+		range->staticCount = staticCount - range->staticStart;
+	}
 
+	// Number the static bodies in the order they are first met. Until then
+	// they still have the non negative index given by the scratch island.
+	int32 staticSlotCount = 0;
+	for (int32 i = 0; i < islandCount; ++i)
 	{
-		b2Timer timer;
-		// Synchronize fixtures, check for out of range bodies.
-		for (b2Body* b = m_bodyList; b; b = b->GetNext())
+		b2IslandRange* range = ranges + i;
+		range->staticSlotCount = 0;
+		for (int32 j = 0; j < range->staticCount; ++j)
 		{
-			// If a body was not in an island then it did not move.
-			if ((b->m_flags & b2Body::e_islandFlag) == 0)
+			b2Body* b = statics[range->staticStart + j];
+			if (b->m_islandIndex >= 0)
 			{
-				continue;
+				b->m_islandIndex = -(++staticSlotCount);
 			}
+			range->staticSlotCount = b2Max(range->staticSlotCount, -b->m_islandIndex);
+		}
+	}
 
-			if (b->GetType() == b2_staticBody)
+	int32* order = (int32*)m_stackAllocator.Allocate(islandCount * sizeof(int32));
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		order[i] = i;
+	}
+	b2IslandWorkGreater workGreater;
+	workGreater.ranges = ranges;
+	std::sort(order, order + islandCount, workGreater);
+
+	b2ContactListener* listener = m_contactManager.m_contactListener;
+	b2ContactImpulse* impulses = NULL;
+	if (listener)
+	{
+		impulses = (b2ContactImpulse*)m_stackAllocator.Allocate(contactCount * sizeof(b2ContactImpulse));
+	}
+
+	b2SolveIslandsTask task;
+	task.step = &step;
+	task.gravity = m_gravity;
+	task.allowSleep = m_allowSleep;
+	task.ranges = ranges;
+	task.order = order;
+	task.bodies = bodies;
+	task.contacts = contacts;
+	task.joints = joints;
+	task.statics = statics;
+	task.impulses = impulses;
+	task.mainAllocator = &m_stackAllocator;
+	task.workerAllocators = m_workerStackAllocators;
+	m_threadPool->ParallelFor(&task, islandCount, 1);
+
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		b2IslandRange* range = ranges + i;
+		m_profile.solveInit += range->profile.solveInit;
+		m_profile.solveVelocity += range->profile.solveVelocity;
+		m_profile.solvePosition += range->profile.solvePosition;
+
+		// Update the static bodies as solving their island on its own would.
+		bool asleep = bodies[range->bodyStart]->IsAwake() == false;
+		for (int32 j = 0; j < range->staticCount; ++j)
+		{
+			b2Body* b = statics[range->staticStart + j];
+			b->SetAwake(true);
+			b->m_sweep.c0 = b->m_sweep.c;
+			b->m_sweep.a0 = b->m_sweep.a;
+			b->SynchronizeTransform();
+			if (asleep)
 			{
-				continue;
+				b->SetAwake(false);
 			}
+		}
+	}
 
-			// Update fixtures (for broad-phase).
-			b->SynchronizeFixtures();
+	if (listener)
+	{
+		for (int32 i = 0; i < contactCount; ++i)
+		{
+			listener->PostSolve(contacts[i], impulses + i);
 		}
 
-		// Look for new contacts.
-		m_contactManager.FindNewContacts();
-		m_profile.broadphase = timer.GetMilliseconds();
+		m_stackAllocator.Free(impulses);
 	}
+
+	m_stackAllocator.Free(order);
+	m_stackAllocator.Free(statics);
+	m_stackAllocator.Free(joints);
+	m_stackAllocator.Free(contacts);
+	m_stackAllocator.Free(bodies);
+	m_stackAllocator.Free(ranges);
+	m_stackAllocator.Free(stack);
 }
 
 // Find TOI contacts and solve them.
@@ -860,6 +1193,7 @@ void b2World::SolveTOI(const b2TimeStep& step)
 		subStep.positionIterations = 20;
 		subStep.velocityIterations = step.velocityIterations;
 		subStep.warmStarting = false;
+		subStep.wideContactSolver = false;
 		island.SolveTOI(subStep, bA->m_islandIndex, bB->m_islandIndex);
 
 		// Reset island flags and synchronize broad-phase proxies.
@@ -923,6 +1257,7 @@ void b2World::Step(float32 dt, int32 velocityIterations, int32 positionIteration
 	step.dtRatio = m_inv_dt0 * dt;
 
 	step.warmStarting = m_warmStarting;
+	step.wideContactSolver = m_wideContactSolver;
 	
 	// Update contacts. This is where some contacts are destroyed.
 	{
@@ -991,6 +1326,26 @@ void b2World::QueryAABB(b2QueryCallback* callback, const b2AABB& aabb) const
 	m_contactManager.m_broadPhase.Query(&wrapper, aabb);
 }
 
+struct b2WorldBatchQueryWrapper
+{
+	bool QueryCallback(int32 queryIndex, int32 proxyId, int32 threadIndex)
+	{
+		b2FixtureProxy* proxy = (b2FixtureProxy*)broadPhase->GetUserData(proxyId);
+		return callback->ReportFixture(queryIndex, proxy->fixture, threadIndex);
+	}
+
+	const b2BroadPhase* broadPhase;
+	b2BatchQueryCallback* callback;
+};
+
+void b2World::QueryAABBBatch(b2BatchQueryCallback* callback, const b2AABB* aabbs, int32 count) const
+{
+	b2WorldBatchQueryWrapper wrapper;
+	wrapper.broadPhase = &m_contactManager.m_broadPhase;
+	wrapper.callback = callback;
+	m_contactManager.m_broadPhase.QueryBatch(&wrapper, aabbs, count);
+}
+
 struct b2WorldRayCastWrapper
 {
 	float32 RayCastCallback(const b2RayCastInput& input, int32 proxyId)
@@ -1256,6 +1611,53 @@ float32 b2World::GetTreeQuality() const
 	return m_contactManager.m_broadPhase.GetTreeQuality();
 }
 
+float32 b2World::GetTreeAverageDepth() const
+{
+	return m_contactManager.m_broadPhase.GetTreeAverageDepth();
+}
+
+void b2World::GetBlockAllocatorStats(b2BlockAllocatorStats* stats) const
+{
+	m_blockAllocator.GetStats(stats);
+}
+
+void b2World::GetStackAllocatorStats(b2StackAllocatorStats* stats) const
+{
+	m_stackAllocator.GetStats(stats);
+
+	for (int32 i = 0; i < m_workerCount; ++i)
+	{
+		b2StackAllocatorStats workerStats;
+		m_workerStackAllocators[i].GetStats(&workerStats);
+		stats->liveBytes += workerStats.liveBytes;
+		stats->maxLiveBytes += workerStats.maxLiveBytes;
+		stats->capacity += workerStats.capacity;
+		stats->maxEntryCount = b2Max(stats->maxEntryCount, workerStats.maxEntryCount);
+		stats->heapAllocations += workerStats.heapAllocations;
+	}
+}
+
+void b2World::RebuildTree()
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	m_contactManager.m_broadPhase.RebuildTree();
+}
+
+void b2World::SetTreeRefit(bool flag)
+{
+	m_contactManager.m_broadPhase.SetRefitProxies(flag);
+}
+
+bool b2World::GetTreeRefit() const
+{
+	return m_contactManager.m_broadPhase.GetRefitProxies();
+}
+
 void b2World::Dump()
 {
 	if ((m_flags & e_locked) == e_locked)
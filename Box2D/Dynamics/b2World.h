@@ -34,6 +34,9 @@ class b2Body;
 class b2Draw;
 class b2Fixture;
 class b2Joint;
+class b2Island;
+class b2ThreadPool;
+class b2WorldSnapshot;
 
 /// The world class manages all physics entities, dynamic simulation,
 /// and asynchronous queries. The world also contains efficient memory
@@ -66,6 +69,16 @@ public:
 	/// by you and must remain in scope.
 	void SetDebugDraw(b2Draw* debugDraw);
 
+	/// Register a thread pool used to find new pairs, compute contact manifolds and
+	/// solve the islands of a time step concurrently. The pool is owned by you and
+	/// must remain in scope. NULL, the default, runs on the stepping thread only. The
+	/// results do not depend on the pool. Contact listener calls are made on the
+	/// stepping thread in the same order, PostSolve calls after all the islands are
+	/// solved.
+	/// @warning This function is locked during callbacks.
+	void SetThreadPool(b2ThreadPool* threadPool);
+	b2ThreadPool* GetThreadPool() const { return m_threadPool; }
+
 	/// Create a rigid body given a definition. No reference to the definition
 	/// is retained.
 	/// @warning This function is locked during callbacks.
@@ -113,6 +126,15 @@ public:
 	/// @param aabb the query box.
 	void QueryAABB(b2QueryCallback* callback, const b2AABB& aabb) const;
 
+	/// Query the world for the fixtures that potentially overlap each of the provided
+	/// AABBs, such as the sensing volumes of many agents. The queries are split across
+	/// the thread pool set with SetThreadPool, if any, so the callback must then be
+	/// thread safe. Don't modify the world while the queries run.
+	/// @param callback a user implemented callback class.
+	/// @param aabbs the query boxes.
+	/// @param count the number of query boxes.
+	void QueryAABBBatch(b2BatchQueryCallback* callback, const b2AABB* aabbs, int32 count) const;
+
 	/// Ray-cast the world for all fixtures in the path of the ray. Your callback
 	/// controls whether you get the closest point, any point, or n-points.
 	/// The ray-cast ignores shapes that contain the starting point.
@@ -157,6 +179,12 @@ public:
 	void SetSubStepping(bool flag) { m_subStepping = flag; }
 	bool GetSubStepping() const { return m_subStepping; }
 
+	/// Enable/disable the wide contact solver. Contacts that share no dynamic body
+	/// are solved four at a time with SIMD instructions. This changes the order in
+	/// which contacts are solved, so results differ from the default solver.
+	void SetWideContactSolver(bool flag) { m_wideContactSolver = flag; }
+	bool GetWideContactSolver() const { return m_wideContactSolver; }
+
 	/// Get the number of broad-phase proxies.
 	int32 GetProxyCount() const;
 
@@ -179,6 +207,22 @@ public:
 	/// The minimum is 1.
 	float32 GetTreeQuality() const;
 
+	/// Get the average depth of the leaves of the dynamic tree, the number of
+	/// nodes a query visits to reach a fixture.
+	float32 GetTreeAverageDepth() const;
+
+	/// Rebuild the dynamic tree from scratch for better queries. Call this after
+	/// creating many fixtures at once, such as when loading a level.
+	/// @warning This function is locked during callbacks.
+	void RebuildTree();
+
+	/// Enable/disable the refit of the dynamic tree. When enabled, a fixture that
+	/// leaves its fat AABB grows the AABBs of the tree instead of being re-inserted.
+	/// The steps are cheaper, but the queries slow down as the fixtures travel, so
+	/// call RebuildTree once in a while. Disabled by default.
+	void SetTreeRefit(bool flag);
+	bool GetTreeRefit() const;
+
 	/// Change the global gravity vector.
 	void SetGravity(const b2Vec2& gravity);
 	
@@ -200,10 +244,32 @@ public:
 	/// Get the current profile.
 	const b2Profile& GetProfile() const;
 
+	/// Get the memory usage of the allocator for bodies, fixtures, joints and contacts.
+	void GetBlockAllocatorStats(b2BlockAllocatorStats* stats) const;
+
+	/// Get the memory usage of the per step allocators, summed over the stepping
+	/// thread and the thread pool workers.
+	void GetStackAllocatorStats(b2StackAllocatorStats* stats) const;
+
 	/// Dump the world into the log file.
 	/// @warning this should be called outside of a time step.
 	void Dump();
 
+	/// Save the state of the world, for instance to roll it back or to restart a level
+	/// without rebuilding it. The listeners, debug draw, thread pool and solver mode
+	/// are not part of the snapshot.
+	/// @warning This function is locked during callbacks.
+	void SaveSnapshot(b2WorldSnapshot* snapshot);
+
+	/// Replace the bodies, joints and contacts with the ones of a snapshot. Stepping
+	/// continues exactly as it did from the time of the save. This invalidates the
+	/// current body, fixture and joint pointers without calling the destruction
+	/// listener. The body and joint lists keep their order, so the i-th body of
+	/// GetBodyList replaces the i-th body at the time of the save.
+	/// @return false if the snapshot is empty or was saved by a different build.
+	/// @warning This function is locked during callbacks.
+	bool RestoreSnapshot(b2WorldSnapshot* snapshot);
+
 private:
 
 	// m_flags
@@ -220,14 +286,31 @@ private:
 	friend class b2Controller;
 
 	void Solve(const b2TimeStep& step);
+	void SolveParallel(const b2TimeStep& step);
 	void SolveTOI(const b2TimeStep& step);
 
+	void BuildIsland(b2Island* island, b2Body* seed, b2Body** stack, int32 stackSize);
+
+	void SerializeSettings(b2WorldSnapshot* snapshot);
+	void SerializeBody(b2WorldSnapshot* snapshot, b2Body* body);
+	void SerializeFixture(b2WorldSnapshot* snapshot, b2Body* body, b2Fixture* fixture);
+	void SerializeBroadPhase(b2WorldSnapshot* snapshot);
+	b2Joint* SerializeJoint(b2WorldSnapshot* snapshot, b2Joint* joint, b2Body** bodies, b2Joint** joints);
+	void SerializeContact(b2WorldSnapshot* snapshot, b2Contact* contact);
+	void DestroySnapshotObjects();
+
 	void DrawJoint(b2Joint* joint);
 	void DrawShape(b2Fixture* shape, const b2Transform& xf, const b2Color& color);
 
 	b2BlockAllocator m_blockAllocator;
 	b2StackAllocator m_stackAllocator;
 
+	b2ThreadPool* m_threadPool;
+
+	// One per worker thread of m_threadPool, the stepping thread uses m_stackAllocator.
+	b2StackAllocator* m_workerStackAllocators;
+	int32 m_workerCount;
+
 	int32 m_flags;
 
 	b2ContactManager m_contactManager;
@@ -252,6 +335,7 @@ private:
 	bool m_warmStarting;
 	bool m_continuousPhysics;
 	bool m_subStepping;
+	bool m_wideContactSolver;
 
 	bool m_stepComplete;
 
@@ -130,6 +130,20 @@ public:
 	virtual bool ReportFixture(b2Fixture* fixture) = 0;
 };
 
+/// Callback class for batches of AABB queries.
+/// See b2World::QueryAABBBatch
+class b2BatchQueryCallback
+{
+public:
+	virtual ~b2BatchQueryCallback() {}
+
+	/// Called for each fixture found in the query AABB aabbs[queryIndex]. With a world
+	/// thread pool it is called concurrently, threadIndex is the calling thread, in
+	/// [0, b2ThreadPool::GetThreadCount()).
+	/// @return false to terminate this query only.
+	virtual bool ReportFixture(int32 queryIndex, b2Fixture* fixture, int32 threadIndex) = 0;
+};
+
 /// Callback class for ray casts.
 /// See b2World::RayCast
 class b2RayCastCallback
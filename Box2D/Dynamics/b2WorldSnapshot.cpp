@@ -0,0 +1,781 @@
+/*
+* Copyright (c) 2006-2011 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Box2D/Dynamics/b2WorldSnapshot.h>
+#include <Box2D/Dynamics/b2World.h>
+#include <Box2D/Dynamics/b2Body.h>
+#include <Box2D/Dynamics/b2Fixture.h>
+#include <Box2D/Dynamics/Contacts/b2Contact.h>
+#include <Box2D/Dynamics/Joints/b2DistanceJoint.h>
+#include <Box2D/Dynamics/Joints/b2FrictionJoint.h>
+#include <Box2D/Dynamics/Joints/b2GearJoint.h>
+#include <Box2D/Dynamics/Joints/b2MouseJoint.h>
+#include <Box2D/Dynamics/Joints/b2PrismaticJoint.h>
+#include <Box2D/Dynamics/Joints/b2PulleyJoint.h>
+#include <Box2D/Dynamics/Joints/b2RevoluteJoint.h>
+#include <Box2D/Dynamics/Joints/b2RopeJoint.h>
+#include <Box2D/Dynamics/Joints/b2WeldJoint.h>
+#include <Box2D/Dynamics/Joints/b2WheelJoint.h>
+#include <Box2D/Collision/Shapes/b2CircleShape.h>
+#include <Box2D/Collision/Shapes/b2EdgeShape.h>
+#include <Box2D/Collision/Shapes/b2ChainShape.h>
+#include <Box2D/Collision/Shapes/b2PolygonShape.h>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+// Identifies snapshots, "b2ws".
+#define b2_snapshotMagic 0x62327773
+#define b2_snapshotVersion 1
+
+b2WorldSnapshot::b2WorldSnapshot()
+{
+	m_data = NULL;
+	m_size = 0;
+	m_capacity = 0;
+	m_offset = 0;
+	m_restoring = false;
+}
+
+b2WorldSnapshot::~b2WorldSnapshot()
+{
+	b2Free(m_data);
+}
+
+void b2WorldSnapshot::SetData(const void* data, int32 size)
+{
+	if (size > m_capacity)
+	{
+		b2Free(m_data);
+		m_capacity = size;
+		m_data = (uint8*)b2Alloc(m_capacity);
+	}
+
+	memcpy(m_data, data, size);
+	m_size = size;
+	m_offset = 0;
+}
+
+void b2WorldSnapshot::SerializeBytes(void* data, int32 size)
+{
+	if (m_restoring)
+	{
+		b2Assert(m_offset + size <= m_size);
+		if (m_offset + size > m_size)
+		{
+			memset(data, 0, size);
+			return;
+		}
+
+		memcpy(data, m_data + m_offset, size);
+	}
+	else
+	{
+		if (m_offset + size > m_capacity)
+		{
+			uint8* oldData = m_data;
+			m_capacity = b2Max(2 * m_capacity, m_offset + size);
+			m_data = (uint8*)b2Alloc(m_capacity);
+			if (oldData)
+			{
+				memcpy(m_data, oldData, m_offset);
+				b2Free(oldData);
+			}
+		}
+
+		memcpy(m_data + m_offset, data, size);
+		m_size = b2Max(m_size, m_offset + size);
+	}
+
+	m_offset += size;
+}
+
+void b2WorldSnapshot::BeginSave()
+{
+	m_size = 0;
+	m_offset = 0;
+	m_restoring = false;
+}
+
+void b2WorldSnapshot::BeginRestore()
+{
+	m_offset = 0;
+	m_restoring = true;
+}
+
+// The header tells snapshots of a different format or build apart. Returns false
+// if a restored header does not match.
+static bool b2SerializeHeader(b2WorldSnapshot* snapshot, int32 size)
+{
+	int32 header[6];
+	header[0] = b2_snapshotMagic;
+	header[1] = b2_snapshotVersion;
+	header[2] = sizeof(void*);
+	header[3] = sizeof(b2TreeNode);
+	header[4] = sizeof(b2Manifold);
+	header[5] = size;
+
+	if (snapshot->IsRestoring() && snapshot->GetSize() < int32(sizeof(header)))
+	{
+		return false;
+	}
+
+	int32 saved[6];
+	memcpy(saved, header, sizeof(header));
+	snapshot->SerializeBytes(saved, sizeof(saved));
+	return memcmp(saved, header, sizeof(header)) == 0;
+}
+
+static void b2SerializeShape(b2WorldSnapshot* snapshot, b2Shape* shape)
+{
+	snapshot->Serialize(shape->m_radius);
+
+	switch (shape->m_type)
+	{
+	case b2Shape::e_circle:
+		{
+			b2CircleShape* circle = (b2CircleShape*)shape;
+			snapshot->Serialize(circle->m_p);
+		}
+		break;
+
+	case b2Shape::e_edge:
+		{
+			b2EdgeShape* edge = (b2EdgeShape*)shape;
+			snapshot->Serialize(edge->m_vertex1);
+			snapshot->Serialize(edge->m_vertex2);
+			snapshot->Serialize(edge->m_vertex0);
+			snapshot->Serialize(edge->m_vertex3);
+			snapshot->Serialize(edge->m_hasVertex0);
+			snapshot->Serialize(edge->m_hasVertex3);
+		}
+		break;
+
+	case b2Shape::e_polygon:
+		{
+			b2PolygonShape* polygon = (b2PolygonShape*)shape;
+			snapshot->Serialize(polygon->m_centroid);
+			snapshot->Serialize(polygon->m_vertexCount);
+			b2Assert(0 <= polygon->m_vertexCount && polygon->m_vertexCount <= b2_maxPolygonVertices);
+			snapshot->SerializeBytes(polygon->m_vertices, polygon->m_vertexCount * sizeof(b2Vec2));
+			snapshot->SerializeBytes(polygon->m_normals, polygon->m_vertexCount * sizeof(b2Vec2));
+		}
+		break;
+
+	case b2Shape::e_chain:
+		{
+			b2ChainShape* chain = (b2ChainShape*)shape;
+			snapshot->Serialize(chain->m_count);
+			if (snapshot->IsRestoring())
+			{
+				chain->m_vertices = (b2Vec2*)b2Alloc(chain->m_count * sizeof(b2Vec2));
+			}
+			snapshot->SerializeBytes(chain->m_vertices, chain->m_count * sizeof(b2Vec2));
+			snapshot->Serialize(chain->m_prevVertex);
+			snapshot->Serialize(chain->m_nextVertex);
+			snapshot->Serialize(chain->m_hasPrevVertex);
+			snapshot->Serialize(chain->m_hasNextVertex);
+		}
+		break;
+
+	default:
+		b2Assert(false);
+		break;
+	}
+}
+
+void b2World::SerializeFixture(b2WorldSnapshot* snapshot, b2Body* body, b2Fixture* fixture)
+{
+	// The fixture is created from its shape, so the shape comes first.
+	b2CircleShape circle;
+	b2EdgeShape edge;
+	b2PolygonShape polygon;
+	b2ChainShape chain;
+
+	b2Shape* shape;
+	int32 type = fixture ? fixture->m_shape->m_type : b2Shape::e_typeCount;
+	snapshot->Serialize(type);
+	if (fixture)
+	{
+		shape = fixture->m_shape;
+	}
+	else
+	{
+		switch (type)
+		{
+		case b2Shape::e_circle:
+			shape = &circle;
+			break;
+
+		case b2Shape::e_edge:
+			shape = &edge;
+			break;
+
+		case b2Shape::e_polygon:
+			shape = &polygon;
+			break;
+
+		default:
+			b2Assert(type == b2Shape::e_chain);
+			shape = &chain;
+			break;
+		}
+	}
+
+	b2SerializeShape(snapshot, shape);
+
+	if (fixture == NULL)
+	{
+		b2FixtureDef def;
+		def.shape = shape;
+
+		void* mem = m_blockAllocator.Allocate(sizeof(b2Fixture));
+		fixture = new (mem) b2Fixture;
+		fixture->Create(&m_blockAllocator, body, &def);
+		fixture->m_shape->m_radius = shape->m_radius;
+
+		fixture->m_next = body->m_fixtureList;
+		body->m_fixtureList = fixture;
+	}
+
+	snapshot->Serialize(fixture->m_density);
+	snapshot->Serialize(fixture->m_friction);
+	snapshot->Serialize(fixture->m_restitution);
+	snapshot->Serialize(fixture->m_filter);
+	snapshot->Serialize(fixture->m_isSensor);
+	snapshot->Serialize(fixture->m_userData);
+
+	snapshot->Serialize(fixture->m_proxyCount);
+	for (int32 i = 0; i < fixture->m_proxyCount; ++i)
+	{
+		b2FixtureProxy* proxy = fixture->m_proxies + i;
+		snapshot->Serialize(proxy->aabb);
+		snapshot->Serialize(proxy->childIndex);
+		snapshot->Serialize(proxy->proxyId);
+		proxy->fixture = fixture;
+	}
+}
+
+void b2World::SerializeBody(b2WorldSnapshot* snapshot, b2Body* body)
+{
+	snapshot->Serialize(body->m_type);
+	snapshot->Serialize(body->m_flags);
+	snapshot->Serialize(body->m_xf);
+	snapshot->Serialize(body->m_sweep);
+	snapshot->Serialize(body->m_linearVelocity);
+	snapshot->Serialize(body->m_angularVelocity);
+	snapshot->Serialize(body->m_force);
+	snapshot->Serialize(body->m_torque);
+	snapshot->Serialize(body->m_mass);
+	snapshot->Serialize(body->m_invMass);
+	snapshot->Serialize(body->m_I);
+	snapshot->Serialize(body->m_invI);
+	snapshot->Serialize(body->m_linearDamping);
+	snapshot->Serialize(body->m_angularDamping);
+	snapshot->Serialize(body->m_gravityScale);
+	snapshot->Serialize(body->m_sleepTime);
+	snapshot->Serialize(body->m_userData);
+	snapshot->Serialize(body->m_fixtureCount);
+
+	if (snapshot->IsRestoring())
+	{
+		for (int32 i = 0; i < body->m_fixtureCount; ++i)
+		{
+			SerializeFixture(snapshot, body, NULL);
+		}
+		return;
+	}
+
+	// Fixtures are added at the head of the list, so save them from the tail.
+	b2Fixture** fixtures = (b2Fixture**)m_stackAllocator.Allocate(body->m_fixtureCount * sizeof(b2Fixture*));
+	int32 i = body->m_fixtureCount;
+	for (b2Fixture* f = body->m_fixtureList; f; f = f->m_next)
+	{
+		fixtures[--i] = f;
+	}
+
+	for (i = 0; i < body->m_fixtureCount; ++i)
+	{
+		SerializeFixture(snapshot, body, fixtures[i]);
+	}
+
+	m_stackAllocator.Free(fixtures);
+}
+
+b2Joint* b2World::SerializeJoint(b2WorldSnapshot* snapshot, b2Joint* joint, b2Body** bodies, b2Joint** joints)
+{
+	int32 type = e_unknownJoint;
+	int32 indexA = b2_nullNode;
+	int32 indexB = b2_nullNode;
+	int32 index1 = b2_nullNode;
+	int32 index2 = b2_nullNode;
+	bool collideConnected = false;
+	void* userData = NULL;
+
+	if (joint)
+	{
+		type = joint->m_type;
+		indexA = joint->m_bodyA->m_islandIndex;
+		indexB = joint->m_bodyB->m_islandIndex;
+		collideConnected = joint->m_collideConnected;
+		userData = joint->m_userData;
+
+		if (type == e_gearJoint)
+		{
+			b2GearJoint* gear = (b2GearJoint*)joint;
+			index1 = gear->GetJoint1()->m_index;
+			index2 = gear->GetJoint2()->m_index;
+		}
+	}
+
+	snapshot->Serialize(type);
+	snapshot->Serialize(indexA);
+	snapshot->Serialize(indexB);
+	snapshot->Serialize(index1);
+	snapshot->Serialize(index2);
+	snapshot->Serialize(collideConnected);
+	snapshot->Serialize(userData);
+
+	if (joint == NULL)
+	{
+		// Create the joint from a default definition, its state overwrites the rest.
+		b2DistanceJointDef distanceDef;
+		b2FrictionJointDef frictionDef;
+		b2GearJointDef gearDef;
+		b2MouseJointDef mouseDef;
+		b2PrismaticJointDef prismaticDef;
+		b2PulleyJointDef pulleyDef;
+		b2RevoluteJointDef revoluteDef;
+		b2RopeJointDef ropeDef;
+		b2WeldJointDef weldDef;
+		b2WheelJointDef wheelDef;
+
+		b2JointDef* def;
+		switch (type)
+		{
+		case e_distanceJoint:
+			def = &distanceDef;
+			break;
+
+		case e_frictionJoint:
+			def = &frictionDef;
+			break;
+
+		case e_gearJoint:
+			gearDef.joint1 = joints[index1];
+			gearDef.joint2 = joints[index2];
+			def = &gearDef;
+			break;
+
+		case e_mouseJoint:
+			def = &mouseDef;
+			break;
+
+		case e_prismaticJoint:
+			def = &prismaticDef;
+			break;
+
+		case e_pulleyJoint:
+			def = &pulleyDef;
+			break;
+
+		case e_revoluteJoint:
+			def = &revoluteDef;
+			break;
+
+		case e_ropeJoint:
+			def = &ropeDef;
+			break;
+
+		case e_weldJoint:
+			def = &weldDef;
+			break;
+
+		default:
+			b2Assert(type == e_wheelJoint);
+			def = &wheelDef;
+			break;
+		}
+
+		def->bodyA = bodies[indexA];
+		def->bodyB = bodies[indexB];
+		def->collideConnected = collideConnected;
+		def->userData = userData;
+
+		joint = b2Joint::Create(def, &m_blockAllocator);
+
+		// Connect to the world list and to the bodies like CreateJoint.
+		joint->m_prev = NULL;
+		joint->m_next = m_jointList;
+		if (m_jointList)
+		{
+			m_jointList->m_prev = joint;
+		}
+		m_jointList = joint;
+		++m_jointCount;
+
+		joint->m_edgeA.joint = joint;
+		joint->m_edgeA.other = joint->m_bodyB;
+		joint->m_edgeA.prev = NULL;
+		joint->m_edgeA.next = joint->m_bodyA->m_jointList;
+		if (joint->m_bodyA->m_jointList) joint->m_bodyA->m_jointList->prev = &joint->m_edgeA;
+		joint->m_bodyA->m_jointList = &joint->m_edgeA;
+
+		joint->m_edgeB.joint = joint;
+		joint->m_edgeB.other = joint->m_bodyA;
+		joint->m_edgeB.prev = NULL;
+		joint->m_edgeB.next = joint->m_bodyB->m_jointList;
+		if (joint->m_bodyB->m_jointList) joint->m_bodyB->m_jointList->prev = &joint->m_edgeB;
+		joint->m_bodyB->m_jointList = &joint->m_edgeB;
+	}
+
+	joint->SerializeState(snapshot);
+	return joint;
+}
+
+void b2World::SerializeContact(b2WorldSnapshot* snapshot, b2Contact* contact)
+{
+	// Contacts only exist between proxies, which identify the fixtures.
+	int32 proxyIdA = b2_nullNode;
+	int32 proxyIdB = b2_nullNode;
+	if (contact)
+	{
+		proxyIdA = contact->m_fixtureA->m_proxies[contact->m_indexA].proxyId;
+		proxyIdB = contact->m_fixtureB->m_proxies[contact->m_indexB].proxyId;
+	}
+
+	snapshot->Serialize(proxyIdA);
+	snapshot->Serialize(proxyIdB);
+
+	if (contact == NULL)
+	{
+		b2BroadPhase* broadPhase = &m_contactManager.m_broadPhase;
+		b2FixtureProxy* proxyA = (b2FixtureProxy*)broadPhase->GetUserData(proxyIdA);
+		b2FixtureProxy* proxyB = (b2FixtureProxy*)broadPhase->GetUserData(proxyIdB);
+
+		// The fixtures were saved in the order contact creation puts them.
+		contact = b2Contact::Create(proxyA->fixture, proxyA->childIndex, proxyB->fixture, proxyB->childIndex, &m_blockAllocator);
+		b2Assert(contact->m_fixtureA == proxyA->fixture);
+
+		b2Body* bodyA = contact->m_fixtureA->m_body;
+		b2Body* bodyB = contact->m_fixtureB->m_body;
+
+		// Insert into the world and the island graph like b2ContactManager::AddPair.
+		contact->m_prev = NULL;
+		contact->m_next = m_contactManager.m_contactList;
+		if (m_contactManager.m_contactList != NULL)
+		{
+			m_contactManager.m_contactList->m_prev = contact;
+		}
+		m_contactManager.m_contactList = contact;
+
+		contact->m_nodeA.contact = contact;
+		contact->m_nodeA.other = bodyB;
+		contact->m_nodeA.prev = NULL;
+		contact->m_nodeA.next = bodyA->m_contactList;
+		if (bodyA->m_contactList != NULL)
+		{
+			bodyA->m_contactList->prev = &contact->m_nodeA;
+		}
+		bodyA->m_contactList = &contact->m_nodeA;
+
+		contact->m_nodeB.contact = contact;
+		contact->m_nodeB.other = bodyA;
+		contact->m_nodeB.prev = NULL;
+		contact->m_nodeB.next = bodyB->m_contactList;
+		if (bodyB->m_contactList != NULL)
+		{
+			bodyB->m_contactList->prev = &contact->m_nodeB;
+		}
+		bodyB->m_contactList = &contact->m_nodeB;
+
+		++m_contactManager.m_contactCount;
+	}
+
+	snapshot->Serialize(contact->m_flags);
+	snapshot->Serialize(contact->m_manifold);
+	snapshot->Serialize(contact->m_toiCount);
+	snapshot->Serialize(contact->m_toi);
+	snapshot->Serialize(contact->m_friction);
+	snapshot->Serialize(contact->m_restitution);
+}
+
+void b2World::SerializeBroadPhase(b2WorldSnapshot* snapshot)
+{
+	b2BroadPhase* broadPhase = &m_contactManager.m_broadPhase;
+	b2DynamicTree* tree = &broadPhase->m_tree;
+
+	// The nodes are copied as they are, proxy ids stay the same. The user data
+	// pointers in the copy are replaced when restoring.
+	int32 nodeCapacity = tree->m_nodeCapacity;
+	snapshot->Serialize(nodeCapacity);
+	if (snapshot->IsRestoring() && nodeCapacity != tree->m_nodeCapacity)
+	{
+		b2Free(tree->m_nodes);
+		tree->m_nodeCapacity = nodeCapacity;
+		tree->m_nodes = (b2TreeNode*)b2Alloc(nodeCapacity * sizeof(b2TreeNode));
+	}
+	snapshot->SerializeBytes(tree->m_nodes, nodeCapacity * sizeof(b2TreeNode));
+	if (snapshot->IsRestoring() == false)
+	{
+		// Clear the proxy pointers in the copy so equal worlds give equal data.
+		uint8* nodes = snapshot->m_data + snapshot->m_offset - nodeCapacity * sizeof(b2TreeNode);
+		void* userData = NULL;
+		for (int32 i = 0; i < nodeCapacity; ++i)
+		{
+			memcpy(nodes + i * sizeof(b2TreeNode) + offsetof(b2TreeNode, userData), &userData, sizeof(void*));
+		}
+	}
+	snapshot->Serialize(tree->m_root);
+	snapshot->Serialize(tree->m_nodeCount);
+	snapshot->Serialize(tree->m_freeList);
+	snapshot->Serialize(tree->m_path);
+	snapshot->Serialize(tree->m_insertionCount);
+
+	snapshot->Serialize(broadPhase->m_proxyCount);
+
+	int32 moveCount = broadPhase->m_moveCount;
+	snapshot->Serialize(moveCount);
+	if (snapshot->IsRestoring() && moveCount > broadPhase->m_moveCapacity)
+	{
+		b2Free(broadPhase->m_moveBuffer);
+		broadPhase->m_moveCapacity = moveCount;
+		broadPhase->m_moveBuffer = (int32*)b2Alloc(moveCount * sizeof(int32));
+	}
+	broadPhase->m_moveCount = moveCount;
+	snapshot->SerializeBytes(broadPhase->m_moveBuffer, moveCount * sizeof(int32));
+
+	if (snapshot->IsRestoring())
+	{
+		for (int32 i = 0; i < nodeCapacity; ++i)
+		{
+			tree->m_nodes[i].userData = NULL;
+		}
+
+		for (b2Body* b = m_bodyList; b; b = b->m_next)
+		{
+			for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+			{
+				for (int32 i = 0; i < f->m_proxyCount; ++i)
+				{
+					b2FixtureProxy* proxy = f->m_proxies + i;
+					tree->m_nodes[proxy->proxyId].userData = proxy;
+				}
+			}
+		}
+	}
+}
+
+void b2World::SerializeSettings(b2WorldSnapshot* snapshot)
+{
+	int32 flags = m_flags & ~e_locked;
+	snapshot->Serialize(flags);
+	m_flags = flags;
+
+	snapshot->Serialize(m_gravity);
+	snapshot->Serialize(m_allowSleep);
+	snapshot->Serialize(m_warmStarting);
+	snapshot->Serialize(m_continuousPhysics);
+	snapshot->Serialize(m_subStepping);
+	snapshot->Serialize(m_stepComplete);
+	snapshot->Serialize(m_inv_dt0);
+}
+
+// Objects are saved in the order they were created. Lists are built by adding at
+// the head, so restoring them in that order gives every list its old order, and
+// the solver visits the bodies, contacts and joints in the same order.
+void b2World::SaveSnapshot(b2WorldSnapshot* snapshot)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	snapshot->BeginSave();
+	b2SerializeHeader(snapshot, 0);
+
+	SerializeSettings(snapshot);
+
+	// The island indices and joint indices are used to refer to bodies and joints.
+	b2Body** bodies = (b2Body**)m_stackAllocator.Allocate(m_bodyCount * sizeof(b2Body*));
+	int32 i = m_bodyCount;
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		bodies[--i] = b;
+	}
+
+	snapshot->Serialize(m_bodyCount);
+	for (i = 0; i < m_bodyCount; ++i)
+	{
+		bodies[i]->m_islandIndex = i;
+		SerializeBody(snapshot, bodies[i]);
+	}
+
+	SerializeBroadPhase(snapshot);
+
+	b2Joint** joints = (b2Joint**)m_stackAllocator.Allocate(m_jointCount * sizeof(b2Joint*));
+	i = m_jointCount;
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		joints[--i] = j;
+	}
+
+	snapshot->Serialize(m_jointCount);
+	for (i = 0; i < m_jointCount; ++i)
+	{
+		joints[i]->m_index = i;
+		SerializeJoint(snapshot, joints[i], bodies, joints);
+	}
+
+	int32 contactCount = m_contactManager.m_contactCount;
+	b2Contact** contacts = (b2Contact**)m_stackAllocator.Allocate(contactCount * sizeof(b2Contact*));
+	i = contactCount;
+	for (b2Contact* c = m_contactManager.m_contactList; c; c = c->m_next)
+	{
+		contacts[--i] = c;
+	}
+
+	snapshot->Serialize(contactCount);
+	for (i = 0; i < contactCount; ++i)
+	{
+		SerializeContact(snapshot, contacts[i]);
+	}
+
+	m_stackAllocator.Free(contacts);
+	m_stackAllocator.Free(joints);
+	m_stackAllocator.Free(bodies);
+
+	// Now the size is known.
+	int32 size = snapshot->GetSize();
+	snapshot->m_offset = 0;
+	b2SerializeHeader(snapshot, size);
+	snapshot->m_offset = size;
+}
+
+bool b2World::RestoreSnapshot(b2WorldSnapshot* snapshot)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return false;
+	}
+
+	snapshot->BeginRestore();
+	if (b2SerializeHeader(snapshot, snapshot->GetSize()) == false)
+	{
+		return false;
+	}
+
+	DestroySnapshotObjects();
+
+	SerializeSettings(snapshot);
+
+	int32 bodyCount;
+	snapshot->Serialize(bodyCount);
+	b2Body** bodies = (b2Body**)m_stackAllocator.Allocate(bodyCount * sizeof(b2Body*));
+	for (int32 i = 0; i < bodyCount; ++i)
+	{
+		b2BodyDef def;
+		void* mem = m_blockAllocator.Allocate(sizeof(b2Body));
+		b2Body* b = new (mem) b2Body(&def, this);
+
+		b->m_prev = NULL;
+		b->m_next = m_bodyList;
+		if (m_bodyList)
+		{
+			m_bodyList->m_prev = b;
+		}
+		m_bodyList = b;
+		++m_bodyCount;
+
+		SerializeBody(snapshot, b);
+		bodies[i] = b;
+	}
+
+	SerializeBroadPhase(snapshot);
+
+	int32 jointCount;
+	snapshot->Serialize(jointCount);
+	b2Joint** joints = (b2Joint**)m_stackAllocator.Allocate(jointCount * sizeof(b2Joint*));
+	for (int32 i = 0; i < jointCount; ++i)
+	{
+		joints[i] = SerializeJoint(snapshot, NULL, bodies, joints);
+	}
+
+	int32 contactCount;
+	snapshot->Serialize(contactCount);
+	for (int32 i = 0; i < contactCount; ++i)
+	{
+		SerializeContact(snapshot, NULL);
+	}
+
+	m_stackAllocator.Free(joints);
+	m_stackAllocator.Free(bodies);
+
+	b2Assert(snapshot->m_offset == snapshot->GetSize());
+	return true;
+}
+
+// Free the bodies, joints and contacts without calling the destruction listener.
+// The broad-phase is overwritten by the snapshot.
+void b2World::DestroySnapshotObjects()
+{
+	b2Contact* c = m_contactManager.m_contactList;
+	while (c)
+	{
+		b2Contact* cNext = c->m_next;
+		b2Contact::Destroy(c, &m_blockAllocator);
+		c = cNext;
+	}
+	m_contactManager.m_contactList = NULL;
+	m_contactManager.m_contactCount = 0;
+
+	b2Joint* j = m_jointList;
+	while (j)
+	{
+		b2Joint* jNext = j->m_next;
+		b2Joint::Destroy(j, &m_blockAllocator);
+		j = jNext;
+	}
+	m_jointList = NULL;
+	m_jointCount = 0;
+
+	b2Body* b = m_bodyList;
+	while (b)
+	{
+		b2Body* bNext = b->m_next;
+
+		b2Fixture* f = b->m_fixtureList;
+		while (f)
+		{
+			b2Fixture* fNext = f->m_next;
+			f->m_proxyCount = 0;
+			f->Destroy(&m_blockAllocator);
+			f->~b2Fixture();
+			m_blockAllocator.Free(f, sizeof(b2Fixture));
+			f = fNext;
+		}
+
+		b->~b2Body();
+		m_blockAllocator.Free(b, sizeof(b2Body));
+		b = bNext;
+	}
+	m_bodyList = NULL;
+	m_bodyCount = 0;
+}
@@ -0,0 +1,75 @@
+/*
+* Copyright (c) 2006-2011 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef B2_WORLD_SNAPSHOT_H
+#define B2_WORLD_SNAPSHOT_H
+
+#include <Box2D/Common/b2Settings.h>
+
+/// A binary copy of the state of a b2World: bodies, fixtures, joints, contacts
+/// with their warm starting impulses and the broad-phase tree. Restoring it gives
+/// a world that steps bit for bit like the saved one. See b2World::SaveSnapshot.
+/// Pointers in the data are not used when restoring, except the user data which is
+/// kept as is. The data can be stored and loaded again with SetData, but only by
+/// the same build of Box2D.
+/// Reuse a snapshot to avoid allocating memory on every save.
+class b2WorldSnapshot
+{
+public:
+	b2WorldSnapshot();
+	~b2WorldSnapshot();
+
+	/// Get the saved data.
+	const void* GetData() const { return m_data; }
+
+	/// Get the size of the saved data in bytes.
+	int32 GetSize() const { return m_size; }
+
+	/// Replace the data, for instance with data loaded from a file.
+	void SetData(const void* data, int32 size);
+
+	/// Write a value when saving, read it back when restoring. Used by b2World and
+	/// the joints to describe their state once for both directions.
+	template <typename T>
+	void Serialize(T& value)
+	{
+		SerializeBytes(&value, sizeof(T));
+	}
+
+	/// Write or read raw bytes.
+	void SerializeBytes(void* data, int32 size);
+
+	/// Is the snapshot being restored?
+	bool IsRestoring() const { return m_restoring; }
+
+private:
+
+	friend class b2World;
+
+	void BeginSave();
+	void BeginRestore();
+
+	uint8* m_data;
+	int32 m_size;
+	int32 m_capacity;
+
+	int32 m_offset;
+	bool m_restoring;
+};
+
+#endif
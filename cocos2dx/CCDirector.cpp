@@ -34,6 +34,8 @@ THE SOFTWARE.
 #include "CCPointExtension.h"
 #include "CCTransition.h"
 #include "CCTextureCache.h"
+#include "CCRenderQueue.h"
+#include "CCSprite.h"
 //#include "CCTransition.h"
 #include "CCSpriteFrameCache.h"
 #include "CCAutoreleasePool.h"
@@ -42,19 +44,19 @@ THE SOFTWARE.
 #include "CCLabelBMFont.h"
 #include "CCActionManager.h"
 #include "CCLabelTTF.h"
+#include "CCGlyphCache.h"
 #include "CCConfiguration.h"
 #include "CCKeypadDispatcher.h"
 #include "CCGL.h"
 #include "CCAnimationCache.h"
 #include "CCTouch.h"
+#include "CCFileUtils.h"
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_MARMALADE)
 #include "CCUserDefault.h"
 #endif
 
-#if CC_ENABLE_PROFILERS
 #include "support/CCProfiling.h"
-#endif // CC_ENABLE_PROFILERS
 
 #include <string>
 
@@ -177,12 +179,18 @@ void CCDirector::setGLDefaultValues(void)
 // Draw the SCene
 void CCDirector::drawScene(void)
 {
+	if (CCFrameProfiler::isRecording())
+	{
+		CCFrameProfiler::sharedFrameProfiler()->beginFrame();
+	}
+
 	// calculate "global" dt
 	calculateDeltaTime();
 
 	//tick before glClear: issue #533
 	if (! m_bPaused)
 	{
+		CCProfileScope scope(kCCProfilePhaseScheduler);
 		CCScheduler::sharedScheduler()->tick(m_fDeltaTime);
 	}
 	
@@ -200,16 +208,20 @@ void CCDirector::drawScene(void)
 	
 	// By default enable VertexArray, ColorArray, TextureCoordArray and Texture2D
 
-	// draw the scene
-    if (m_pRunningScene)
-    {
-        m_pRunningScene->visit();
-    }
-
-	// draw the notifications node
-	if (m_pNotificationNode)
 	{
-		m_pNotificationNode->visit();
+		CCProfileScope scope(kCCProfilePhaseVisit);
+
+		// draw the scene
+		if (m_pRunningScene)
+		{
+			m_pRunningScene->visit();
+		}
+
+		// draw the notifications node
+		if (m_pNotificationNode)
+		{
+			m_pNotificationNode->visit();
+		}
 	}
 
 	if (m_bDisplayFPS)
@@ -229,8 +241,14 @@ void CCDirector::drawScene(void)
 	// swap buffers
 	if (m_pobOpenGLView)
     {
+		CCProfileScope scope(kCCProfilePhasePresent);
         m_pobOpenGLView->swapBuffers();
     }
+
+	if (CCFrameProfiler::isRecording())
+	{
+		CCFrameProfiler::sharedFrameProfiler()->endFrame();
+	}
 }
 
 void CCDirector::calculateDeltaTime(void)
@@ -293,6 +311,9 @@ void CCDirector::setOpenGLView(CC_GLVIEW *pobOpenGLView)
  		CCTouchDispatcher *pTouchDispatcher = CCTouchDispatcher::sharedDispatcher();
  		m_pobOpenGLView->setTouchDelegate(pTouchDispatcher);
         pTouchDispatcher->setDispatchEvents(true);
+
+		// the scene is recorded in the render queue and drawn by the sprite renderer
+		CCSprite::attachRenderQueue();
 	}
 }
 
@@ -354,7 +375,9 @@ void CCDirector::setProjection(ccDirectorProjection kProjection)
 void CCDirector::purgeCachedData(void)
 {
     CCLabelBMFont::purgeCachedData();
+	CCGlyphCache::purgeSharedGlyphCache();
 	CCTextureCache::sharedTextureCache()->removeUnusedTextures();
+	CCFileUtils::purgeCachedFileData();
 }
 
 float CCDirector::getZEye(void)
@@ -611,16 +634,21 @@ void CCDirector::purgeDirector()
 	// purge bitmap cache
 	CCLabelBMFont::purgeCachedData();
 
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_MARMALADE)
+	// writes the pending changes, and unschedules the auto flush before the scheduler is gone
+	CCUserDefault::purgeSharedUserDefault();
+#endif
+
 	// purge all managers
 	CCAnimationCache::purgeSharedAnimationCache();
  	CCSpriteFrameCache::purgeSharedSpriteFrameCache();
 	CCActionManager::sharedManager()->purgeSharedManager();
 	CCScheduler::purgeSharedScheduler();
+	CCRenderQueue::purgeSharedRenderQueue();
+	CCGlyphCache::purgeSharedGlyphCache();
 	CCTextureCache::purgeSharedTextureCache();
+	CCFrameProfiler::purgeSharedFrameProfiler();
 	
-#if (CC_TARGET_PLATFORM != CC_PLATFORM_MARMALADE)	
-	CCUserDefault::purgeSharedUserDefault();
-#endif
 	// OpenGL view
 	m_pobOpenGLView->release();
 	m_pobOpenGLView = NULL;
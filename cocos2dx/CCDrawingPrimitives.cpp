@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include <cmath>
 #include "DirectXHelper.h"
 #include "BasicLoader.h"
+#include "support/CCProfiling.h"
 
 using namespace std;
 using namespace DirectX;
@@ -583,6 +584,7 @@ void CCDrawingPrimitive::RenderShader()
 	// Render the triangle.
 	//CCID3D11DeviceContext->DrawIndexed( 6, 0, 0 );
 	CCID3D11DeviceContext->Draw( m_vertexAmount, 0 );
+	CCFrameProfiler::addDrawCall(0);
 
 	return;
 }
@@ -590,6 +592,8 @@ void CCDrawingPrimitive::RenderShader()
 
 void CCDrawingPrimitive::Render()
 {
+	CCD3DCLASS->D3DFlushBatch();
+
 	XMMATRIX viewMatrix, projectionMatrix;
 	bool result;
 
@@ -613,6 +617,8 @@ void CCDrawingPrimitive::Render()
 
 void CCDrawingPrimitive::Render3D()
 {
+	CCD3DCLASS->D3DFlushBatch();
+
 	XMMATRIX viewMatrix, projectionMatrix;
 	bool result;
 
@@ -83,8 +83,12 @@ CCTimer::CCTimer()
 : m_pfnSelector(NULL)
 , m_fInterval(0.0f)
 , m_scriptFunc("")
+, m_nHeapIndex(-1)
+, m_dFireTime(0.0)
+, m_uLastTick(0)
 , m_pTarget(NULL)
 , m_fElapsed(0.0f)
+, m_dStartTime(0.0)
 {
 
 }
@@ -171,6 +175,52 @@ void CCTimer::update(ccTime dt)
 	}
 }
 
+void CCTimer::updateAtTime(double dTime)
+{
+	// same rules as update(), the elapsed time is derived from the scheduler time
+	if (m_fElapsed == -1)
+	{
+		m_dStartTime = dTime;
+	}
+	m_fElapsed = (ccTime)(dTime - m_dStartTime);
+
+	if (m_fElapsed >= m_fInterval)
+	{
+		if (0 != m_pfnSelector)
+		{
+			ccTime fElapsed = m_fElapsed;
+			m_fElapsed = 0;
+			m_dStartTime = dTime;
+			(m_pTarget->*m_pfnSelector)(fElapsed);
+		}
+	}
+}
+
+double CCTimer::getNextFireTime(double dNow)
+{
+	if (m_fElapsed == -1)
+	{
+		return dNow;
+	}
+
+	return m_dStartTime + (m_fInterval > 0 ? m_fInterval : 0);
+}
+
+void CCTimer::pauseAtTime(double dTime)
+{
+	if (m_fElapsed != -1)
+	{
+		m_fElapsed = (ccTime)(dTime - m_dStartTime);
+	}
+}
+
+void CCTimer::resumeAtTime(double dTime)
+{
+	if (m_fElapsed != -1)
+	{
+		m_dStartTime = dTime - m_fElapsed;
+	}
+}
 
 // implementation of CCScheduler
 
@@ -186,6 +236,8 @@ CCScheduler::CCScheduler(void)
 , m_pCurrentTarget(NULL)
 , m_bCurrentTargetSalvaged(false)
 , m_pHashForScriptFunctions(NULL)
+, m_dTime(0.0)
+, m_uTickCount(0)
 {
 	CCAssert(pSharedScheduler == NULL, "");
 }
@@ -228,10 +280,97 @@ bool CCScheduler::init(void)
     m_bCurrentTargetSalvaged = false;
 	m_pHashForSelectors = NULL;
 	m_bUpdateHashLocked = false;
+	m_dTime = 0.0;
+	m_uTickCount = 0;
 
 	return true;
 }
 
+// the timer that fires first is on top, timers that already ran in this tick go after the others
+static inline bool timerFiresBefore(CCTimer *pTimer, CCTimer *pOther)
+{
+	if (pTimer->m_dFireTime != pOther->m_dFireTime)
+	{
+		return pTimer->m_dFireTime < pOther->m_dFireTime;
+	}
+	return pTimer->m_uLastTick < pOther->m_uLastTick;
+}
+
+void CCScheduler::timerHeapSiftUp(unsigned int uIndex)
+{
+	CCTimer *pTimer = m_timerHeap[uIndex];
+	while (uIndex > 0)
+	{
+		unsigned int uParent = (uIndex - 1) / 2;
+		if (! timerFiresBefore(pTimer, m_timerHeap[uParent]))
+		{
+			break;
+		}
+		m_timerHeap[uIndex] = m_timerHeap[uParent];
+		m_timerHeap[uIndex]->m_nHeapIndex = (int)uIndex;
+		uIndex = uParent;
+	}
+	m_timerHeap[uIndex] = pTimer;
+	pTimer->m_nHeapIndex = (int)uIndex;
+}
+
+void CCScheduler::timerHeapSiftDown(unsigned int uIndex)
+{
+	unsigned int uCount = (unsigned int)m_timerHeap.size();
+	CCTimer *pTimer = m_timerHeap[uIndex];
+	while (true)
+	{
+		unsigned int uChild = uIndex * 2 + 1;
+		if (uChild >= uCount)
+		{
+			break;
+		}
+		if (uChild + 1 < uCount && timerFiresBefore(m_timerHeap[uChild + 1], m_timerHeap[uChild]))
+		{
+			++uChild;
+		}
+		if (! timerFiresBefore(m_timerHeap[uChild], pTimer))
+		{
+			break;
+		}
+		m_timerHeap[uIndex] = m_timerHeap[uChild];
+		m_timerHeap[uIndex]->m_nHeapIndex = (int)uIndex;
+		uIndex = uChild;
+	}
+	m_timerHeap[uIndex] = pTimer;
+	pTimer->m_nHeapIndex = (int)uIndex;
+}
+
+void CCScheduler::timerHeapPush(CCTimer *pTimer)
+{
+	CCAssert(pTimer->m_nHeapIndex < 0, "timer is already in the heap");
+
+	pTimer->m_dFireTime = pTimer->getNextFireTime(m_dTime);
+	m_timerHeap.push_back(pTimer);
+	timerHeapSiftUp((unsigned int)m_timerHeap.size() - 1);
+}
+
+void CCScheduler::timerHeapRemove(CCTimer *pTimer)
+{
+	if (pTimer->m_nHeapIndex < 0)
+	{
+		return;
+	}
+
+	unsigned int uIndex = (unsigned int)pTimer->m_nHeapIndex;
+	CCTimer *pLast = m_timerHeap.back();
+	m_timerHeap.pop_back();
+	pTimer->m_nHeapIndex = -1;
+
+	if (pLast != pTimer)
+	{
+		m_timerHeap[uIndex] = pLast;
+		pLast->m_nHeapIndex = (int)uIndex;
+		timerHeapSiftUp(uIndex);
+		timerHeapSiftDown((unsigned int)pLast->m_nHeapIndex);
+	}
+}
+
 void CCScheduler::removeHashElement(_hashSelectorEntry *pElement)
 {
 	ccArrayFree(pElement->timers);
@@ -281,6 +420,13 @@ void CCScheduler::scheduleSelector(SEL_SCHEDULE pfnSelector, SelectorProtocol *p
 			{
 				CCLOG("CCSheduler#scheduleSelector. Selector already scheduled.");
 				timer->m_fInterval = fInterval;
+
+				// the fire time depends on the interval
+				if (timer->m_nHeapIndex >= 0)
+				{
+					timerHeapRemove(timer);
+					timerHeapPush(timer);
+				}
 				return;
 			}		
 		}
@@ -291,6 +437,11 @@ void CCScheduler::scheduleSelector(SEL_SCHEDULE pfnSelector, SelectorProtocol *p
 	pTimer->initWithTarget(pTarget, pfnSelector, fInterval);
 	ccArrayAppendObject(pElement->timers, pTimer);
 	pTimer->release();	
+
+	if (! pElement->paused)
+	{
+		timerHeapPush(pTimer);
+	}
 }
 
 void CCScheduler::scheduleScriptFunc(const char *pszFuncName, ccTime fInterval, bool bPaused)
@@ -345,6 +496,7 @@ void CCScheduler::unscheduleSelector(SEL_SCHEDULE pfnSelector, SelectorProtocol
 					pElement->currentTimerSalvaged = true;
 				}
 
+				timerHeapRemove(pTimer);
 				ccArrayRemoveObjectAtIndex(pElement->timers, i );
 
 				// update timerIndex in case we are in tick:, looping over the actions
@@ -600,6 +752,10 @@ void CCScheduler::unscheduleAllSelectorsForTarget(SelectorProtocol *pTarget)
 			pElement->currentTimer->retain();
 			pElement->currentTimerSalvaged = true;
 		}
+		for (unsigned int i = 0; i < pElement->timers->num; ++i)
+		{
+			timerHeapRemove((CCTimer*)pElement->timers->arr[i]);
+		}
 		ccArrayRemoveAllObjects(pElement->timers);
 
 		if (m_pCurrentTarget == pElement)
@@ -623,9 +779,20 @@ void CCScheduler::resumeTarget(SelectorProtocol *pTarget)
 	// custom selectors
 	tHashSelectorEntry *pElement = NULL;
 	HASH_FIND_INT(m_pHashForSelectors, &pTarget, pElement);
-	if (pElement)
+	if (pElement && pElement->paused)
 	{
 		pElement->paused = false;
+
+		for (unsigned int i = 0; i < pElement->timers->num; ++i)
+		{
+			CCTimer *pTimer = (CCTimer*)pElement->timers->arr[i];
+			pTimer->resumeAtTime(m_dTime);
+			// the running timer is put back by tick
+			if (pTimer != pElement->currentTimer)
+			{
+				timerHeapPush(pTimer);
+			}
+		}
 	}
 
 	// update selector
@@ -645,9 +812,16 @@ void CCScheduler::pauseTarget(SelectorProtocol *pTarget)
 	// custom selectors
 	tHashSelectorEntry *pElement = NULL;
 	HASH_FIND_INT(m_pHashForSelectors, &pTarget, pElement);
-	if (pElement)
+	if (pElement && ! pElement->paused)
 	{
 		pElement->paused = true;
+
+		for (unsigned int i = 0; i < pElement->timers->num; ++i)
+		{
+			CCTimer *pTimer = (CCTimer*)pElement->timers->arr[i];
+			pTimer->pauseAtTime(m_dTime);
+			timerHeapRemove(pTimer);
+		}
 	}
 
 	// update selector
@@ -714,37 +888,44 @@ void CCScheduler::tick(ccTime dt)
 		}
 	}
 
-	// Interate all over the custom selectors
-	for (tHashSelectorEntry *elt = m_pHashForSelectors; elt != NULL; )
+	// Only visit the custom selectors that are due.
+	// Paused targets have no timers in the heap, and a timer never runs twice in the same tick.
+	m_dTime += dt;
+	++m_uTickCount;
+	while (! m_timerHeap.empty()
+		&& m_timerHeap[0]->m_dFireTime <= m_dTime
+		&& m_timerHeap[0]->m_uLastTick != m_uTickCount)
 	{
+		CCTimer *pTimer = m_timerHeap[0];
+		timerHeapRemove(pTimer);
+		pTimer->m_uLastTick = m_uTickCount;
+
+		SelectorProtocol *pTarget = pTimer->getTarget();
+		tHashSelectorEntry *elt = NULL;
+		HASH_FIND_INT(m_pHashForSelectors, &pTarget, elt);
+		CCAssert(elt != NULL, "timer without target entry");
+
 		m_pCurrentTarget = elt;
 		m_bCurrentTargetSalvaged = false;
 
-		if (! m_pCurrentTarget->paused)
-		{
-			// The 'timers' array may change while inside this loop
-			for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
-			{
-				elt->currentTimer = (CCTimer*)(elt->timers->arr[elt->timerIndex]);
-				elt->currentTimerSalvaged = false;
-
-				elt->currentTimer->update(dt);
+		elt->currentTimer = pTimer;
+		elt->currentTimerSalvaged = false;
 
-				if (elt->currentTimerSalvaged)
-				{
-					// The currentTimer told the remove itself. To prevent the timer from
-					// accidentally deallocating itself before finishing its step, we retained
-					// it. Now that step is done, it's safe to release it.
-					elt->currentTimer->release();
-				}
+		pTimer->updateAtTime(m_dTime);
 
-				elt->currentTimer = NULL;
-			}
+		if (elt->currentTimerSalvaged)
+		{
+			// The currentTimer told the remove itself. To prevent the timer from
+			// accidentally deallocating itself before finishing its step, we retained
+			// it. Now that step is done, it's safe to release it.
+			pTimer->release();
+		}
+		else if (! elt->paused && pTimer->m_nHeapIndex < 0)
+		{
+			timerHeapPush(pTimer);
 		}
 
-		// elt, at this moment, is still valid
-		// so it is safe to ask this here (issue #490)
-		elt = (tHashSelectorEntry *)elt->hh.next;
+		elt->currentTimer = NULL;
 
 		// only delete currentTarget if no actions were scheduled during the cycle (issue #481)
 		if (m_bCurrentTargetSalvaged && m_pCurrentTarget->timers->num == 0)
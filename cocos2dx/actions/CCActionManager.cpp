@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "ccMacros.h"
 #include "support/data_support/ccCArray.h"
 #include "support/data_support/uthash.h"
+#include "support/CCProfiling.h"
 
 namespace cocos2d {
 //
@@ -349,6 +350,8 @@ unsigned int CCActionManager::numberOfRunningActionsInTarget(CCObject *pTarget)
 // main loop
 void CCActionManager::update(ccTime dt)
 {
+	CCProfileScope scope(kCCProfilePhaseActions);
+
 	for (tHashElement *elt = m_pTargets; elt != NULL; )
 	{
 		m_pCurrentTarget = elt;
@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "CCScheduler.h"
 #include "CCTouch.h"
 #include "CCActionManager.h"
+#include "CCRenderQueue.h"
 
 #if CC_COCOSNODE_RENDER_SUBPIXEL
 #define RENDER_IN_SUBPIXEL
@@ -70,8 +71,14 @@ CCNode::CCNode(void)
 , m_nTag(kCCNodeTagInvalid)
 // userData is always inited as nil
 , m_pUserData(NULL)
+, m_bSortsChildrenByState(false)
+, m_uWorldTransformVersion(0)
+, m_uParentWorldTransformVersion(0)
+, m_uWorldTransformEpoch(0)
 , m_bIsTransformDirty(true)
 , m_bIsInverseDirty(true)
+, m_bIsWorldTransformDirty(true)
+, m_bIsTransformIdentity(false)
 #ifdef CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
 , m_bIsTransformGLDirty(true)
 #endif
@@ -104,6 +111,21 @@ CCNode::~CCNode()
 	CC_SAFE_RELEASE(m_pChildren);
 }
 
+// bumped whenever any node's local transform or parent changes, so a cached
+// world transform validated in the current epoch can be returned without
+// walking the parent chain
+static unsigned int s_uTransformEpoch = 0;
+
+void CCNode::setTransformDirty(void)
+{
+	m_bIsTransformDirty = m_bIsInverseDirty = true;
+	m_bIsWorldTransformDirty = true;
+	++s_uTransformEpoch;
+#if CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
+	m_bIsTransformGLDirty = true;
+#endif
+}
+
 void CCNode::arrayMakeObjectsPerformSelector(CCArray* pArray, callbackFunc func)
 {
 	if(pArray && pArray->count() > 0)
@@ -128,19 +150,12 @@ float CCNode::getSkewX()
 void CCNode::setSkewX(float newSkewX)
 {
 	m_fSkewX = newSkewX;
-	m_bIsTransformDirty = m_bIsInverseDirty = true;
-#if CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
-	m_bIsTransformGLDirty = true;
-#endif
+	setTransformDirty();
 }
 
 float CCNode::getSkewY()
 {
 	return m_fSkewY;
-	m_bIsTransformDirty = m_bIsInverseDirty = true;
-#if CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
-	m_bIsTransformGLDirty = true;
-#endif
 }
 
 void CCNode::setSkewY(float newSkewY)
@@ -185,10 +200,7 @@ float CCNode::getRotation()
 void CCNode::setRotation(float newRotation)
 {
 	m_fRotation = newRotation;
-	m_bIsTransformDirty = m_bIsInverseDirty = true;
-#ifdef CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
-	m_bIsTransformGLDirty = true;
-#endif
+	setTransformDirty();
 }
 
 /// scale getter
@@ -202,10 +214,7 @@ float CCNode::getScale(void)
 void CCNode::setScale(float scale)
 {
 	m_fScaleX = m_fScaleY = scale;
-	m_bIsTransformDirty = m_bIsInverseDirty = true;
-#ifdef CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
-	m_bIsTransformGLDirty = true;
-#endif
+	setTransformDirty();
 }
 
 /// scaleX getter
@@ -218,10 +227,7 @@ float CCNode::getScaleX()
 void CCNode::setScaleX(float newScaleX)
 {
 	m_fScaleX = newScaleX;
-	m_bIsTransformDirty = m_bIsInverseDirty = true;
-#ifdef CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
-	m_bIsTransformGLDirty = true;
-#endif
+	setTransformDirty();
 }
 
 /// scaleY getter
@@ -234,10 +240,7 @@ float CCNode::getScaleY()
 void CCNode::setScaleY(float newScaleY)
 {
 	m_fScaleY = newScaleY;
-	m_bIsTransformDirty = m_bIsInverseDirty = true;
-#ifdef CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
-	m_bIsTransformGLDirty = true;
-#endif
+	setTransformDirty();
 }
 
 /// position getter
@@ -259,10 +262,23 @@ void CCNode::setPosition(const CCPoint& newPosition)
 		m_tPositionInPixels = ccpMult(newPosition, CC_CONTENT_SCALE_FACTOR());
 	}
 
-	m_bIsTransformDirty = m_bIsInverseDirty = true;
-#ifdef CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
-	m_bIsTransformGLDirty = true;
-#endif
+	setTransformDirty();
+}
+
+void CCNode::setPositionAndRotation(const CCPoint& newPosition, float newRotation)
+{
+	m_tPosition = newPosition;
+	if (CC_CONTENT_SCALE_FACTOR() == 1)
+	{
+		m_tPositionInPixels = m_tPosition;
+	}
+	else
+	{
+		m_tPositionInPixels = ccpMult(newPosition, CC_CONTENT_SCALE_FACTOR());
+	}
+	m_fRotation = newRotation;
+
+	setTransformDirty();
 }
 
 void CCNode::setPositionInPixels(const CCPoint& newPosition)
@@ -278,11 +294,7 @@ void CCNode::setPositionInPixels(const CCPoint& newPosition)
 		m_tPosition = ccpMult(newPosition, 1/CC_CONTENT_SCALE_FACTOR());
 	}
 
-	m_bIsTransformDirty = m_bIsInverseDirty = true;
-
-#if CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
-	m_bIsTransformGLDirty = true;
-#endif // CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
+	setTransformDirty();
 }
 
 const CCPoint& CCNode::getPositionInPixels()
@@ -307,6 +319,11 @@ CCCamera* CCNode::getCamera()
 	return m_pCamera;
 }
 
+bool CCNode::isCameraMoved()
+{
+	return m_pCamera && m_pCamera->getDirty();
+}
+
 
 /// grid getter
 CCGridBase* CCNode::getGrid()
@@ -348,10 +365,7 @@ void CCNode::setAnchorPoint(const CCPoint& point)
 	{
 		m_tAnchorPoint = point;
 		m_tAnchorPointInPixels = ccp( m_tContentSizeInPixels.width * m_tAnchorPoint.x, m_tContentSizeInPixels.height * m_tAnchorPoint.y );
-		m_bIsTransformDirty = m_bIsInverseDirty = true;
-#ifdef CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
-		m_bIsTransformGLDirty = true;
-#endif
+		setTransformDirty();
 	}
 }
 
@@ -383,10 +397,7 @@ void CCNode::setContentSize(const CCSize& size)
         }
 
 		m_tAnchorPointInPixels = ccp( m_tContentSizeInPixels.width * m_tAnchorPoint.x, m_tContentSizeInPixels.height * m_tAnchorPoint.y );
-		m_bIsTransformDirty = m_bIsInverseDirty = true;
-#ifdef CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
-		m_bIsTransformGLDirty = true;
-#endif
+		setTransformDirty();
 	}
 }
 
@@ -406,11 +417,7 @@ void CCNode::setContentSizeInPixels(const CCSize& size)
 		}
 
 		m_tAnchorPointInPixels = ccp(m_tContentSizeInPixels.width * m_tAnchorPoint.x, m_tContentSizeInPixels.height * m_tAnchorPoint.y);
-		m_bIsTransformDirty = m_bIsInverseDirty = true;
-
-#if CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
-		m_bIsTransformGLDirty = true;
-#endif // CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
+		setTransformDirty();
 	}
 }
 
@@ -436,6 +443,8 @@ CCNode * CCNode::getParent()
 void CCNode::setParent(CCNode * var)
 {
 	m_pParent = var;
+	m_bIsWorldTransformDirty = true;
+	++s_uTransformEpoch;
 }
 
 /// isRelativeAnchorPoint getter
@@ -447,10 +456,7 @@ bool CCNode::getIsRelativeAnchorPoint()
 void CCNode::setIsRelativeAnchorPoint(bool newValue)
 {
 	m_bIsRelativeAnchorPoint = newValue;
-	m_bIsTransformDirty = m_bIsInverseDirty = true;
-#ifdef CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
-	m_bIsTransformGLDirty = true;
-#endif
+	setTransformDirty();
 }
 
 /// tag getter
@@ -740,19 +746,36 @@ void CCNode::visit()
 
 	this->transform();
 
+	// top-down pass: only subtrees whose transform changed are recomputed
+	if (m_bIsWorldTransformDirty || m_uWorldTransformEpoch != s_uTransformEpoch)
+	{
+		this->updateWorldTransform();
+	}
+
     CCNode* pNode = NULL;
     unsigned int i = 0;
 
+	// the children of the same z order may be reordered by state, this node is drawn between the two groups
+	CCRenderQueue *pQueue = m_bSortsChildrenByState ? CCRenderQueue::sharedRenderQueue() : NULL;
+
 	if(m_pChildren && m_pChildren->count() > 0)
 	{
 		// draw children zOrder < 0
         ccArray *arrayData = m_pChildren->data;
+		if (pQueue)
+		{
+			pQueue->beginSortGroup();
+		}
         for( ; i < arrayData->num; i++ )
         {
             pNode = (CCNode*) arrayData->arr[i];
 
 			if ( pNode && pNode->m_nZOrder < 0 ) 
 			{
+				if (pQueue)
+				{
+					pQueue->setSortKey(pNode->m_nZOrder);
+				}
 				pNode->visit();
 			}
 			else
@@ -760,24 +783,40 @@ void CCNode::visit()
 				break;
 			}
 		}
+		if (pQueue)
+		{
+			pQueue->endSortGroup();
+		}
     }
 
 	// self draw
-	this->draw();
+	this->queueDraw();
 
 
 	// draw children zOrder >= 0
     if (m_pChildren && m_pChildren->count() > 0)
     {
         ccArray *arrayData = m_pChildren->data;
+		if (pQueue)
+		{
+			pQueue->beginSortGroup();
+		}
         for( ; i < arrayData->num; i++ )
         {
             pNode = (CCNode*) arrayData->arr[i];
             if (pNode)
             {
+				if (pQueue)
+				{
+					pQueue->setSortKey(pNode->m_nZOrder);
+				}
                 pNode->visit();
             }
 		}		
+		if (pQueue)
+		{
+			pQueue->endSortGroup();
+		}
 	}
 
  	if (m_pGrid && m_pGrid->isActive())
@@ -787,6 +826,18 @@ void CCNode::visit()
 	CCD3DCLASS->D3DPopMatrix();
 }
 
+void CCNode::queueDraw()
+{
+	DirectX::XMMATRIX viewMatrix, projectionMatrix;
+	CCD3DCLASS->GetViewMatrix(viewMatrix);
+	CCD3DCLASS->GetProjectionMatrix(projectionMatrix);
+
+	DirectX::XMFLOAT4X4 view, projection;
+	DirectX::XMStoreFloat4x4(&view, viewMatrix);
+	DirectX::XMStoreFloat4x4(&projection, projectionMatrix);
+	CCRenderQueue::sharedRenderQueue()->addNode(this, &view.m[0][0], &projection.m[0][0]);
+}
+
 void CCNode::transformAncestors()
 {
 	if( m_pParent != NULL  )
@@ -805,10 +856,15 @@ void CCNode::transform()
 	if( m_bIsTransformGLDirty ) {
 		CCAffineTransform t = this->nodeToParentTransform();
 		CGAffineToGL(&t, m_pTransformGL);
+		m_bIsTransformIdentity = CCAffineTransformEqualToTransform(t, CCAffineTransformIdentity);
 		m_bIsTransformGLDirty = false;
 	}
 
-	CCD3DCLASS->D3DMultMatrix(m_pTransformGL);
+	// containers and layers usually sit at the origin, skip the multiply for them
+	if( ! m_bIsTransformIdentity )
+	{
+		CCD3DCLASS->D3DMultMatrix(m_pTransformGL);
+	}
 	if( m_fVertexZ )
 	{
 		CCD3DCLASS->D3DTranslate(0, 0, m_fVertexZ);
@@ -1052,14 +1108,41 @@ CCAffineTransform CCNode::parentToNodeTransform(void)
 	return m_tInverse;
 }
 
-CCAffineTransform CCNode::nodeToWorldTransform()
+void CCNode::updateWorldTransform(void)
 {
-	CCAffineTransform t = this->nodeToParentTransform();
+	if (m_pParent)
+	{
+		if (m_pParent->m_bIsWorldTransformDirty || m_pParent->m_uWorldTransformEpoch != s_uTransformEpoch)
+		{
+			m_pParent->updateWorldTransform();
+		}
+
+		// the parent's version only changes when its world transform was recomputed
+		if (m_bIsWorldTransformDirty || m_uParentWorldTransformVersion != m_pParent->m_uWorldTransformVersion)
+		{
+			m_tWorldTransform = CCAffineTransformConcat(this->nodeToParentTransform(), m_pParent->m_tWorldTransform);
+			m_uParentWorldTransformVersion = m_pParent->m_uWorldTransformVersion;
+			++m_uWorldTransformVersion;
+		}
+	}
+	else if (m_bIsWorldTransformDirty)
+	{
+		m_tWorldTransform = this->nodeToParentTransform();
+		++m_uWorldTransformVersion;
+	}
 
-	for (CCNode *p = m_pParent; p != NULL; p = p->getParent())
-		t = CCAffineTransformConcat(t, p->nodeToParentTransform());
+	m_bIsWorldTransformDirty = false;
+	m_uWorldTransformEpoch = s_uTransformEpoch;
+}
+
+CCAffineTransform CCNode::nodeToWorldTransform()
+{
+	if (m_bIsWorldTransformDirty || m_uWorldTransformEpoch != s_uTransformEpoch)
+	{
+		this->updateWorldTransform();
+	}
 
-	return t;
+	return m_tWorldTransform;
 }
 
 CCAffineTransform CCNode::worldToNodeTransform(void)
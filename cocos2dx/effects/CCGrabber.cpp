@@ -44,6 +44,7 @@ namespace cocos2d
 	
 	void CCGrabber::beforeRender(CCTexture2D *pTexture)
 	{
+		CCD3DCLASS->D3DFlushBatch();
 		CCID3D11DeviceContext->OMSetRenderTargets(1, &m_renderTargetView, m_depthStencilView);
 		CCD3DCLASS->D3DClearColor(0.0f,0.0f,0.0f,1.0f);
 		CCD3DCLASS->clearRender(m_renderTargetView);
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "CCFileUtils.h"
 #include "DirectXHelper.h"
 #include "BasicLoader.h"
+#include "support/CCProfiling.h"
 
 using namespace std;
 using namespace DirectX;
@@ -565,10 +566,13 @@ namespace cocos2d
 		CCID3D11DeviceContext->PSSetShader(m_pixelShader, NULL, 0);
 		CCID3D11DeviceContext->PSSetSamplers(0, 1, m_pTexture->GetSamplerState());
 		CCID3D11DeviceContext->DrawIndexed( m_indexCount, 0, 0 );
+		CCFrameProfiler::addDrawCall(m_indexCount / 6);
 	}
 
 	void CCGridBase::Render()
 	{
+		CCD3DCLASS->D3DFlushBatch();
+
 // 		if ( getIsDepthTest())
 // 		{
 // 			CCDirector::sharedDirector()->setDepthTest(true);
@@ -0,0 +1,142 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+Copyright (c) 2008-2010 Ricardo Quesada
+Copyright (c) 2011      Zynga Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+****************************************************************************/
+#ifndef __CCBMFONT_CONFIGURATION_H__
+#define __CCBMFONT_CONFIGURATION_H__
+#include "CCObject.h"
+#include "CCGeometry.h"
+#include <string>
+#include <vector>
+namespace cocos2d{
+
+	/**
+    @struct ccBMFontDef
+    BMFont definition
+	*/
+	typedef struct _BMFontDef {
+		//! ID of the character
+		unsigned int charID;
+		//! origin and size of the font
+		CCRect rect;
+		//! The X amount the image should be offset when drawing the image (in pixels)
+		int xOffset;
+		//! The Y amount the image should be offset when drawing the image (in pixels)
+		int yOffset;
+		//! The amount to move the current position after drawing the character (in pixels)
+		int xAdvance;
+	} ccBMFontDef;
+
+    /** @struct ccBMFontPadding
+    BMFont padding
+	@since v0.8.2
+	*/
+	typedef struct _BMFontPadding {
+		/// padding left
+		int	left;
+		/// padding top
+		int top;
+		/// padding right
+		int right;
+		/// padding bottom
+		int bottom;
+	} ccBMFontPadding;
+
+	/** @struct ccBMFontKerning
+	BMFont kerning pair
+	@since v1.0
+	*/
+	typedef struct _BMFontKerning {
+		//! the first character in the high 16 bits, the second one in the low 16 bits
+		unsigned int key;
+		//! the amount added to the advance of the first character (in pixels)
+		int amount;
+	} ccBMFontKerning;
+
+	enum {
+		// how many characters are supported, the IDs are 16 bits
+		kCCBMFontMaxChars = 65536,
+	};
+
+	/** @brief CCBMFontConfiguration has parsed configuration of the the .fnt file
+
+	Both the text and the binary (version 3) .fnt files of the AngelCode editor are read.
+	The characters are stored densely, with a table from the character ID to the character,
+	so fonts with thousands of CJK characters only cost memory for the characters they have.
+	The configurations are shared by all the labels through FNTConfigLoadFile().
+	@since v0.8
+	*/
+	class CC_DLL CCBMFontConfiguration : public CCObject
+	{
+	public://@public
+		//! FNTConfig: Common Height
+		unsigned int m_uCommonHeight;
+		//! Padding
+		ccBMFontPadding	m_tPadding;
+		//! atlas name
+		std::string m_sAtlasName;
+		//! values for kerning, sorted by key
+		std::vector<ccBMFontKerning> m_tKernings;
+	protected:
+		//! The characters building up the font
+		std::vector<ccBMFontDef> m_tCharacters;
+		//! the index + 1 in m_tCharacters of each character ID, 0 for the missing ones
+		std::vector<unsigned int> m_tCharacterIndices;
+	public:
+		CCBMFontConfiguration()
+			: m_uCommonHeight(0)
+		{}
+		virtual ~CCBMFontConfiguration();
+		char * description();
+		/** allocates a CCBMFontConfiguration with a FNT file */
+		static CCBMFontConfiguration * configurationWithFNTFile(const char *FNTfile);
+		/** initializes a BitmapFontConfiguration with a FNT file
+		@return false if the file can't be read or has no page
+		*/
+		bool initWithFNTfile(const char *FNTfile);
+		/** the definition of a character, NULL if the font doesn't have it */
+		inline const ccBMFontDef* characterDefinition(unsigned int charID)
+		{
+			if (charID >= m_tCharacterIndices.size() || m_tCharacterIndices[charID] == 0)
+			{
+				return NULL;
+			}
+			return &m_tCharacters[m_tCharacterIndices[charID] - 1];
+		}
+		/** the number of characters of the font */
+		unsigned int getCharacterCount() { return (unsigned int)m_tCharacters.size(); }
+		/** the kerning amount between two characters, 0 if they have no kerning pair */
+		int kerningAmountForPair(unsigned int first, unsigned int second);
+	private:
+		bool parseConfigFile(const char *controlFile);
+		bool parseTextConfigFile(const char *pBuffer, unsigned long nSize, const char *controlFile);
+		bool parseBinaryConfigFile(const unsigned char *pBuffer, unsigned long nSize, const char *controlFile);
+		void addCharacterDefinition(const ccBMFontDef& characterDefinition);
+		void addKerning(unsigned int first, unsigned int second, int amount);
+	};
+
+}// namespace cocos2d
+
+#endif //__CCBMFONT_CONFIGURATION_H__
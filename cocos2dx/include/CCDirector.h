@@ -201,6 +201,11 @@ public:
     
     /** How many frames were called since the director started */
     inline unsigned int getFrames(void) { return m_uFrames; }
+
+    /** How many frames were drawn since the director started, it is never reset
+     @since v1.0
+     */
+    inline unsigned int getTotalFrames(void) { return m_uTotalFrames; }
     
 	/** Sets an OpenGL projection
 	 @since v0.8.2
@@ -0,0 +1,90 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CC_GLYPH_CACHE_H__
+#define __CC_GLYPH_CACHE_H__
+
+#include "CCObject.h"
+#include "support/CCGlyphAtlas.h"
+
+namespace cocos2d
+{
+	class CCTexture2D;
+
+	/** @brief CCGlyphRasterizer drawing the characters with CCImage::initWithString().
+	The coverage is the alpha of the image. Spaces that the platform draws without width
+	advance by a quarter of the font size.
+	@since v1.0
+	*/
+	class CC_DLL CCImageGlyphRasterizer : public CCGlyphRasterizer
+	{
+	public:
+		virtual bool rasterizeGlyph(const char *pszFontName, unsigned int uFontSize, unsigned int uCodePoint, ccGlyphBitmap *pBitmap);
+	};
+
+	/** @brief Singleton that keeps the characters drawn by the CCLabelTTF labels.
+
+	The characters are stored in a CCGlyphAtlas, and its texture is shared by all the labels,
+	so labels drawn one after the other are sent to the GPU in a single draw call.
+	Only the parts of the texture that changed are uploaded again.
+	@since v1.0
+	*/
+	class CC_DLL CCGlyphCache : public CCObject
+	{
+	public:
+		CCGlyphCache();
+		~CCGlyphCache();
+
+		/** returns the shared instance of the glyph cache */
+		static CCGlyphCache* sharedGlyphCache(void);
+
+		/** Purges the cache. The labels draw their characters again the next time they are drawn. */
+		static void purgeSharedGlyphCache(void);
+
+		/** the characters, the rows of its pixels are the rows of the texture */
+		CCGlyphAtlas* getAtlas(void) { return &m_tAtlas; }
+
+		/** the texture of the characters, with the changes of the atlas uploaded */
+		CCTexture2D* getTexture(void);
+
+		/** uploads the pixels of the atlas changed since the last upload */
+		void updateTexture(void);
+
+		/** Sets the rasterizer drawing the characters, NULL for the CCImageGlyphRasterizer.
+		The rasterizer is not retained. The characters already drawn are removed.
+		*/
+		void setRasterizer(CCGlyphRasterizer *pRasterizer);
+
+		/** the tick of the atlas, the number of frames drawn by the director */
+		unsigned int getTick(void);
+
+	private:
+		CCGlyphAtlas m_tAtlas;
+		CCImageGlyphRasterizer m_tImageRasterizer;
+		CCTexture2D *m_pTexture;
+
+		static CCGlyphCache *s_pSharedGlyphCache;
+	};
+}
+
+#endif // __CC_GLYPH_CACHE_H__
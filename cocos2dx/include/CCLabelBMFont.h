@@ -33,89 +33,18 @@ Use any of these editors to generate BMFonts:
 #ifndef __CCBITMAP_FONT_ATLAS_H__
 #define __CCBITMAP_FONT_ATLAS_H__
 #include "CCSpriteBatchNode.h"
+#include "CCBMFontConfiguration.h"
+#include <vector>
 namespace cocos2d{
 
-	struct _KerningHashElement;
-
-	/**
-    @struct ccBMFontDef
-    BMFont definition
-	*/
-	typedef struct _BMFontDef {
-		//! ID of the character
-		unsigned int charID;
-		//! origin and size of the font
-		CCRect rect;
-		//! The X amount the image should be offset when drawing the image (in pixels)
-		int xOffset;
-		//! The Y amount the image should be offset when drawing the image (in pixels)
-		int yOffset;
-		//! The amount to move the current position after drawing the character (in pixels)
-		int xAdvance;
-	} ccBMFontDef;
-
-    /** @struct ccBMFontPadding
-    BMFont padding
-	@since v0.8.2
-	*/
-	typedef struct _BMFontPadding {
-		/// padding left
-		int	left;
-		/// padding top
-		int top;
-		/// padding right
-		int right;
-		/// padding bottom
-		int bottom;
-	} ccBMFontPadding;
-
-	enum {
-		// how many characters are supported
-		kCCBMFontMaxChars = 2048, //256,
-	};
-
-	/** @brief CCBMFontConfiguration has parsed configuration of the the .fnt file
-	@since v0.8
-	*/
-	class CC_DLL CCBMFontConfiguration : public CCObject
-	{
-		// XXX: Creating a public interface so that the bitmapFontArray[] is accesible
-	public://@public
-		//! The characters building up the font
-		ccBMFontDef	m_pBitmapFontArray[kCCBMFontMaxChars];
-		//! FNTConfig: Common Height
-		unsigned int m_uCommonHeight;
-		//! Padding
-		ccBMFontPadding	m_tPadding;
-		//! atlas name
-		std::string m_sAtlasName;
-		//! values for kerning
-		struct _KerningHashElement	*m_pKerningDictionary;
-	public:
-		CCBMFontConfiguration()
-			: m_uCommonHeight(0)
-            , m_pKerningDictionary(NULL)
-		{}
-		virtual ~CCBMFontConfiguration();
-		char * description();
-		/** allocates a CCBMFontConfiguration with a FNT file */
-		static CCBMFontConfiguration * configurationWithFNTFile(const char *FNTfile);
-		/** initializes a BitmapFontConfiguration with a FNT file */
-		bool initWithFNTfile(const char *FNTfile);
-	private:
-		void parseConfigFile(const char *controlFile);
-		void parseCharacterDefinition(std::string line, ccBMFontDef *characterDefinition);
-		void parseInfoArguments(std::string line);
-		void parseCommonArguments(std::string line);
-		void parseImageFileName(std::string line, const char *fntFile);
-		void parseKerningCapacity(std::string line);
-		void parseKerningEntry(std::string line);
-		void purgeKerningDictionary();
-	};
-
 	/** @brief CCLabelBMFont is a subclass of CCSpriteSheet.
 
-	Features:
+	By default the characters are quads written straight into the texture atlas, and setString()
+	only rewrites the quads that changed, so labels updated every frame are cheap.
+	With setIsUsingCharSprites(true) each character is a CCSprite child instead, tagged with
+	its index among the characters drawn, which is slower but gives the features below.
+
+	Features of the character sprites:
 	- Treats each character like a CCSprite. This means that each individual character can be:
 	- rotated
 	- scaled
@@ -151,16 +80,27 @@ namespace cocos2d{
 		CC_PROPERTY_PASS_BY_REF(ccColor3B, m_tColor, Color)
 		/** conforms to CCRGBAProtocol protocol */
 		CC_PROPERTY(bool, m_bIsOpacityModifyRGB, IsOpacityModifyRGB)
+		/** whether each character is a CCSprite child. The sprites are tagged with their index
+		among the characters of the string the font has, the newlines don't have a sprite.
+		Adding a child to a label that doesn't use character sprites makes it use them.
+		The default is CC_LABELBMFONT_CHAR_SPRITES.
+		@since v1.0
+		*/
+		CC_PROPERTY(bool, m_bIsUsingCharSprites, IsUsingCharSprites)
 	protected:
 		// string to render
 		std::string m_sString;
 		CCBMFontConfiguration *m_pConfiguration;
+		// number of quads written for the characters when they are not sprites
+		unsigned int m_uGlyphCount;
 	public:
 		CCLabelBMFont()
 			: m_cOpacity(0)           
 			, m_bIsOpacityModifyRGB(false)
+			, m_bIsUsingCharSprites(false)
 			, m_sString("")
              , m_pConfiguration(NULL)
+			, m_uGlyphCount(0)
 		{}
 		virtual ~CCLabelBMFont();
 		/** Purges the cached data.
@@ -180,17 +120,27 @@ namespace cocos2d{
 		virtual const char* getString(void);
         virtual void setCString(const char *label);
 		virtual void setAnchorPoint(const CCPoint& var);
+		/** the children follow the character sprites, the label switches to them if it doesn't use them */
+		virtual void addChild(CCNode * child);
+		virtual void addChild(CCNode * child, int zOrder);
+		virtual void addChild(CCNode * child, int zOrder, int tag);
 
 #if CC_LABELBMFONT_DEBUG_DRAW
 		virtual void draw();
 #endif // CC_LABELBMFONT_DEBUG_DRAW
 	private:
 		char * atlasNameFromFntFile(const char *fntFile);
-		int kerningAmountForFirst(unsigned short first, unsigned short second);
+		int kerningAmountForFirst(unsigned int first, unsigned int second);
+		void createCharSprites();
+		void createGlyphQuads();
+		void updateGlyphColors();
+		ccColor4B glyphColor();
 
 	};
 
-	/** Free function that parses a FNT file a place it on the cache
+	/** Free function that parses a FNT file a place it on the cache.
+	The cache is keyed by the full path of the file and can be used from any thread.
+	@return NULL if the file can't be parsed
 	*/
 	CC_DLL CCBMFontConfiguration * FNTConfigLoadFile( const char *file );
 	/** Purges the FNT config cache
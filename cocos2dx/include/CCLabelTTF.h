@@ -26,6 +26,7 @@ THE SOFTWARE.
 #define __CCLABEL_H__
 #include "CCSprite.h"
 #include "CCTexture2D.h"
+#include <vector>
 
 namespace cocos2d{
 
@@ -33,7 +34,11 @@ namespace cocos2d{
 	*
 	* All features from CCTextureNode are valid in CCLabelTTF
 	*
-	* CCLabelTTF objects are slow. Consider using CCLabelAtlas or CCLabelBMFont instead.
+	* By default the characters are drawn once into the texture of the shared CCGlyphCache,
+	* and the label draws one quad per character, batched with the other labels.
+	* Changing the string only lays the characters out again.
+	* With setIsUsingGlyphCache(false) the whole string is drawn into a texture of its own,
+	* which is slow: each new string creates and uploads a texture.
 	*/
 	class CC_DLL CCLabelTTF : public CCSprite, public CCLabelProtocol
 	{
@@ -51,18 +56,42 @@ namespace cocos2d{
 		bool initWithString(const char *label, const char *fontName, float fontSize);
 
 		/** changes the string to render
-		* @warning Changing the string is as expensive as creating a new CCLabelTTF. To obtain better performance use CCLabelAtlas
+		* @warning Without the glyph cache, changing the string is as expensive as creating a new CCLabelTTF.
 		*/
 		virtual void setString(const char *label);
 		virtual const char* getString(void);
 
 		virtual CCLabelProtocol* convertToLabelProtocol() { return (CCLabelProtocol*)this; }
+
+		virtual void draw(void);
+
+		/** whether the characters are drawn from the shared CCGlyphCache.
+		The default is CC_LABELTTF_GLYPH_CACHE.
+		@since v1.0
+		*/
+		CC_PROPERTY(bool, m_bIsUsingGlyphCache, IsUsingGlyphCache)
 	protected:
 		CCSize m_tDimensions;
 		CCTextAlignment m_eAlignment;
         std::string * m_pFontName;
 		float m_fFontSize;
         std::string * m_pString;
+
+		// quads of the characters, in pixels, when the glyph cache is used
+		std::vector<ccV3F_C4B_T2F_Quad> m_tGlyphQuads;
+		// shelves of the glyph atlas holding the characters, marked as used when the label is drawn
+		std::vector<unsigned short> m_tGlyphShelves;
+		// generation of the glyph atlas when the quads were made
+		unsigned int m_uGlyphGeneration;
+		ccColor4B m_tGlyphColor;
+		// flips of the label when the quads were made
+		bool m_bGlyphFlipX;
+		bool m_bGlyphFlipY;
+
+	private:
+		void updateStringTexture();
+		void updateGlyphQuads();
+		void updateGlyphColors();
 	};
 
 } //namespace cocos2d
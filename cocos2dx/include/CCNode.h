@@ -140,6 +140,12 @@ namespace   cocos2d {
 			CC_PROPERTY_PASS_BY_REF(CCPoint, m_tPosition, Position)
 			CC_PROPERTY_PASS_BY_REF(CCPoint, m_tPositionInPixels, PositionInPixels)
 
+			/** Sets the position and the rotation at once, invalidating the transform only once.
+			Used by CCPhysicsNode to sync bodies.
+			@since v1.0
+			*/
+			virtual void setPositionAndRotation(const CCPoint& newPosition, float newRotation);
+
             /** The X skew angle of the node in degrees.
             This angle describes the shear distortion in the X direction.
             Thus, it is the angle between the Y axis and the left edge of the shape
@@ -160,6 +166,12 @@ namespace   cocos2d {
 			*/
 			CC_PROPERTY_READONLY(CCCamera *, m_pCamera, Camera)
 
+			/** returns true if the camera of the node was moved from its default position.
+			Unlike getCamera(), it doesn't create the camera.
+			@since v1.0
+			*/
+			bool isCameraMoved(void);
+
 			/** A CCGrid object that is used when applying effects */
 			CC_PROPERTY(CCGridBase *, m_pGrid, Grid)
 
@@ -212,6 +224,13 @@ namespace   cocos2d {
 			/** A custom user data pointer */
 			CC_PROPERTY(void *, m_pUserData, UserData)
 
+			/** If true, the quads drawn by the children of the same z order, and by their descendants, may be reordered
+			by texture and blend function in the CCRenderQueue, so they are batched. Only set it when none of them overlap.
+			Default is false.
+			@since v1.0
+			*/
+			CC_SYNTHESIZE(bool, m_bSortsChildrenByState, SortsChildrenByState)
+
 	protected:
 
 		// transform
@@ -220,9 +239,17 @@ namespace   cocos2d {
 #ifdef	CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
 		CCfloat	m_pTransformGL[16];
 #endif
+		// cached nodeToWorldTransform, validated against the parent's version
+		CCAffineTransform m_tWorldTransform;
+		unsigned int m_uWorldTransformVersion;
+		unsigned int m_uParentWorldTransformVersion;
+		unsigned int m_uWorldTransformEpoch;
+
 		// To reduce memory, place bools that are not properties here:
 		bool m_bIsTransformDirty;
 		bool m_bIsInverseDirty;
+		bool m_bIsWorldTransformDirty;
+		bool m_bIsTransformIdentity;
 
 #ifdef	CC_NODE_TRANSFORM_USING_AFFINE_MATRIX
 		bool m_bIsTransformGLDirty;
@@ -245,6 +272,12 @@ namespace   cocos2d {
 
 		void arrayMakeObjectsPerformSelector(CCArray* pArray, callbackFunc func);
 
+		//! marks the local transform as changed, invalidating the cached world transforms
+		void setTransformDirty(void);
+
+		//! recomputes the cached world transform if the node or one of its ancestors moved
+		void updateWorldTransform(void);
+
 		CCPoint convertToWindowSpace(const CCPoint& nodePoint);
 
 	public:
@@ -355,6 +388,12 @@ namespace   cocos2d {
 		*/
 		virtual void draw(void);
 
+		/** records the drawing of the node in the shared CCRenderQueue, visit() calls it instead of draw().
+		The default records a command that calls draw() with the current matrices when the queue is flushed.
+		@since v1.0
+		*/
+		virtual void queueDraw(void);
+
 		/** recursive method that visit its children and draw them */
 		virtual void visit(void);
 
@@ -501,6 +540,7 @@ namespace   cocos2d {
 		CCAffineTransform parentToNodeTransform(void);
 
 		/** Retrusn the world affine transform matrix. The matrix is in Pixels.
+		The matrix is cached and only recomputed when the node or one of its ancestors moved.
 		@since v0.7.1
 		*/
 		CCAffineTransform nodeToWorldTransform(void);
@@ -0,0 +1,130 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CCPARTICLE_STORE_H__
+#define __CCPARTICLE_STORE_H__
+
+#include "ccTypes.h"
+#include "CCGeometry.h"
+
+namespace cocos2d {
+
+struct sCCParticle;
+
+//* @enum
+/** Attributes of the particles kept by a CCParticleStore. Each one is an array of floats.
+*/
+enum {
+	kCCParticlePosX,
+	kCCParticlePosY,
+	kCCParticleStartPosX,
+	kCCParticleStartPosY,
+	kCCParticleColorR,
+	kCCParticleColorG,
+	kCCParticleColorB,
+	kCCParticleColorA,
+	kCCParticleDeltaColorR,
+	kCCParticleDeltaColorG,
+	kCCParticleDeltaColorB,
+	kCCParticleDeltaColorA,
+	kCCParticleSize,
+	kCCParticleDeltaSize,
+	kCCParticleRotation,
+	kCCParticleDeltaRotation,
+	kCCParticleTimeToLive,
+	//! Mode A: gravity
+	kCCParticleDirX,
+	kCCParticleDirY,
+	kCCParticleRadialAccel,
+	kCCParticleTangentialAccel,
+	//! Mode B: radius
+	kCCParticleAngle,
+	kCCParticleDegreesPerSecond,
+	kCCParticleRadius,
+	kCCParticleDeltaRadius,
+
+	kCCParticleAttributeCount,
+};
+
+/** @brief Structure-of-arrays storage of the particles of a CCParticleSystem.
+
+Every attribute of the particles lives in its own array, so the update methods
+walk memory linearly and, when CC_PARTICLE_SYSTEM_SIMD is enabled, process 4
+particles per instruction.
+The arrays share one allocation and are padded to a multiple of 4 particles.
+@since v1.0
+*/
+class CC_DLL CCParticleStore
+{
+public:
+	CCParticleStore();
+	~CCParticleStore();
+
+	/** allocates room for uCapacity particles. The previous particles are discarded.
+	@return false if there is not enough memory
+	*/
+	bool initWithCapacity(unsigned int uCapacity);
+	/** number of particles the store can hold */
+	inline unsigned int getCapacity() { return m_uCapacity; }
+	/** array of one attribute, indexed by particle */
+	inline float* getAttribute(int nAttribute) { return m_pAttributes[nAttribute]; }
+
+	/** stores particle at index uIndex */
+	void setParticle(unsigned int uIndex, const struct sCCParticle *particle);
+	/** loads the particle at index uIndex */
+	void getParticle(unsigned int uIndex, struct sCCParticle *particle);
+	/** copies the particle at index uSrc over the one at index uDst */
+	void copyParticle(unsigned int uDst, unsigned int uSrc);
+
+	/** subtracts dt from the life of the first uCount particles */
+	void updateLife(unsigned int uCount, ccTime dt);
+	/** removes the particles whose life is over, moving the last particle into their slot
+	@return the number of particles left
+	*/
+	unsigned int removeDeadParticles(unsigned int uCount);
+	/** moves the particles with the Gravity mode: gravity, direction, radial and tangential acceleration */
+	void updateGravityMode(unsigned int uCount, ccTime dt, const CCPoint& gravity);
+	/** moves the particles with the Radius mode */
+	void updateRadiusMode(unsigned int uCount, ccTime dt);
+	/** integrates color, size and rotation */
+	void updateColorSizeRotation(unsigned int uCount, ccTime dt);
+
+	/** writes the vertices and colors of the first uCount particles into pQuads.
+	If bRelative is true the particles are translated by their start position minus currentPosition.
+	Texture coordinates are left untouched.
+	*/
+	void updateQuads(ccV2F_C4B_T2F_Quad *pQuads, unsigned int uCount, bool bRelative, const CCPoint& currentPosition);
+
+private:
+	CCParticleStore(const CCParticleStore&);
+	CCParticleStore& operator=(const CCParticleStore&);
+
+protected:
+	float			*m_pBuffer;
+	float			*m_pAttributes[kCCParticleAttributeCount];
+	unsigned int	m_uCapacity;
+};
+
+}// namespace cocos2d
+
+#endif //__CCPARTICLE_STORE_H__
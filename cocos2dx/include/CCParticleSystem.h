@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "CCNode.h"
 #include "CCMutableDictionary.h"
 #include "CCString.h"
+#include "CCParticleStore.h"
 
 namespace cocos2d {
 
@@ -86,7 +87,9 @@ enum {
 }; 
 
 /**
-Structure that contains the values of each particle
+Structure that contains the values of each particle.
+The particles of a system are kept in a CCParticleStore, this structure is used to
+initialize a particle and to pass it to updateQuadWithParticle.
 */
 typedef struct sCCParticle {
 	CCPoint     pos;
@@ -209,8 +212,8 @@ protected:
 		float rotatePerSecondVar;
 	} modeB;
 
-	//! Array of particles
-	tCCParticle *m_pParticles;
+	//! Particles, one array per attribute
+	CCParticleStore m_tParticleStore;
 
 	// color modulate
 	//	BOOL colorModulate;
@@ -373,6 +376,12 @@ public:
 
 	//! should be overriden by subclasses
 	virtual void updateQuadWithParticle(tCCParticle* particle, const CCPoint& newPosition);
+	/** updates the quads of all the living particles.
+	The default implementation calls updateQuadWithParticle for each particle.
+	Subclasses can override it to read the particle store directly.
+	@since v1.0
+	*/
+	virtual void updateQuadsWithParticles(const CCPoint& currentPosition);
 	//! should be overriden by subclasses
 	virtual void postStep();
 
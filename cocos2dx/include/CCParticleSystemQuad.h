@@ -85,6 +85,7 @@ public:
 	virtual bool initWithTotalParticles(unsigned int numberOfParticles);
 	virtual void setTexture(CCTexture2D* texture);
 	virtual void updateQuadWithParticle(tCCParticle* particle, const CCPoint& newPosition);
+	virtual void updateQuadsWithParticles(const CCPoint& currentPosition);
 	virtual void postStep();
 	virtual void draw();
 
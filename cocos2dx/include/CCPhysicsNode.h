@@ -0,0 +1,137 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CCPHYSICS_NODE_H__
+#define __CCPHYSICS_NODE_H__
+
+#include "ccConfig.h"
+
+#if CC_ENABLE_BOX2D_INTEGRATION
+
+#include "CCNode.h"
+#include "Box2D/Box2D.h"
+#include <vector>
+
+namespace cocos2d {
+
+	class CCSprite;
+
+	/** @brief CCPhysicsNode steps a Box2D world at a fixed rate and moves the sprites bound to its bodies.
+
+	Each frame the delta time of the director is accumulated and the world is stepped in
+	steps of fixedTimeStep, at most maxSubSteps times, so the simulation does not depend on
+	the frame rate. Time that is left over is kept for the next frame, or dropped when the
+	frame took longer than maxSubSteps steps.
+
+	After stepping, the bound sprites are moved in one pass. Their transforms are interpolated
+	between the last two steps by the fraction of a step left in the accumulator, so the motion
+	is smooth when the frame rate and the step rate differ. Sprites of bodies that did not move
+	are left untouched.
+
+	The node does not own the world, nor the bodies. Unbind a body before destroying it.
+	Forces applied before the frame are kept for all its steps.
+
+	This file is not included by cocos2d.h, include "CCPhysicsNode.h" to use it.
+	@since v1.0
+	*/
+	class CC_DLL CCPhysicsNode : public CCNode
+	{
+		/** the length of a step in seconds, 1/60 by default */
+		CC_SYNTHESIZE(ccTime, m_fFixedTimeStep, FixedTimeStep)
+		/** the maximum number of steps in a frame, 5 by default */
+		CC_SYNTHESIZE(int, m_nMaxSubSteps, MaxSubSteps)
+		/** the velocity iterations passed to b2World::Step, 8 by default */
+		CC_SYNTHESIZE(int, m_nVelocityIterations, VelocityIterations)
+		/** the position iterations passed to b2World::Step, 3 by default */
+		CC_SYNTHESIZE(int, m_nPositionIterations, PositionIterations)
+		/** number of points per meter, 32 by default */
+		CC_SYNTHESIZE(float, m_fPtmRatio, PtmRatio)
+		/** whether the sprites are interpolated between steps, true by default */
+		CC_SYNTHESIZE(bool, m_bIsInterpolating, IsInterpolating)
+		/** the stepped world */
+		CC_SYNTHESIZE_READONLY(b2World*, m_pWorld, World)
+		/** the number of steps taken in the last frame */
+		CC_SYNTHESIZE_READONLY(int, m_nLastStepCount, LastStepCount)
+
+	public:
+		CCPhysicsNode();
+		virtual ~CCPhysicsNode();
+
+		/** creates a node that steps a world, with ptmRatio points per meter */
+		static CCPhysicsNode* nodeWithWorld(b2World* pWorld, float fPtmRatio);
+
+		/** initializes a node that steps a world, with ptmRatio points per meter */
+		bool initWithWorld(b2World* pWorld, float fPtmRatio);
+
+		/** Binds a sprite to a body. The sprite is retained and moved to the body position,
+		in the coordinates of its parent.
+		*/
+		void bindSprite(CCSprite* pSprite, b2Body* pBody);
+
+		/** Removes the binding of a sprite. */
+		void unbindSprite(CCSprite* pSprite);
+
+		/** Removes the binding of a body, call it before destroying the body. */
+		void unbindBody(b2Body* pBody);
+
+		/** Removes all the bindings. */
+		void unbindAll();
+
+		/** the number of bound sprites */
+		unsigned int getBindingCount() { return (unsigned int)m_tBindings.size(); }
+
+		/** the fraction of a step accumulated but not simulated yet, in [0, 1) */
+		float getInterpolationAlpha();
+
+		/** Moves the sprites to the current body transforms, without interpolation.
+		Call it after moving bodies by hand.
+		*/
+		void syncSprites();
+
+		/** accumulates dt, steps the world and moves the sprites */
+		virtual void update(ccTime dt);
+
+	protected:
+		struct ccPhysicsBinding
+		{
+			CCSprite* pSprite;
+			b2Body* pBody;
+			// the body transform before the last step
+			b2Vec2 tPreviousPosition;
+			float32 fPreviousAngle;
+			// what was last written into the sprite
+			CCPoint tSpritePosition;
+			float fSpriteRotation;
+		};
+
+		void updateSprites(float fAlpha);
+
+		std::vector<ccPhysicsBinding> m_tBindings;
+		ccTime m_fAccumulator;
+	};
+
+} // namespace cocos2d
+
+#endif // CC_ENABLE_BOX2D_INTEGRATION
+
+#endif // __CCPHYSICS_NODE_H__
@@ -0,0 +1,231 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCRENDER_QUEUE_H__
+#define __CCRENDER_QUEUE_H__
+
+#include <vector>
+#include "ccTypes.h"
+
+namespace   cocos2d {
+
+class CCTexture2D;
+class CCNode;
+
+/** @brief A draw request recorded by the CCRenderQueue.
+A command draws either quads or a node. The quads of a command are stored already
+transformed to view space, so commands that share the texture, the blend function and
+the projection can be merged. A node command calls CCNode::draw() with the matrices
+that were current when it was recorded.
+@since v1.0
+*/
+typedef struct _ccRenderCommand
+{
+	//! node drawn by the command, NULL for the quad commands
+	CCNode			*node;
+	//! texture of the quads, it can be NULL
+	CCTexture2D		*texture;
+	//! blend function of the quads
+	ccBlendFunc		blendFunc;
+	//! index of the projection matrix in the queue
+	unsigned int	projection;
+	//! index of the view matrix in the queue, only used by the node commands
+	unsigned int	view;
+	//! commands are only reordered inside the same sort group
+	unsigned int	sortGroup;
+	//! inside a sort group, the commands are ordered by key first, then by state
+	int				sortKey;
+	//! first quad of the command in the quads of the queue
+	unsigned int	quadStart;
+	//! number of quads of the command
+	unsigned int	quadCount;
+} ccRenderCommand;
+
+/** @brief Executes the commands of a CCRenderQueue.
+@since v1.0
+*/
+class CC_DLL CCRenderBackend
+{
+public:
+	virtual ~CCRenderBackend(void) {}
+
+	/** draws the quads of a command.
+	projection is a row major 4x4 matrix, the layout of DirectX::XMMATRIX.
+	*/
+	virtual void drawQuads(const ccRenderCommand& command, const float *projection, const ccV3F_C4B_T2F_Quad *quads) = 0;
+
+	/** draws the node of a command with the matrices it was recorded with.
+	The commands the node records while it draws are executed right after it.
+	*/
+	virtual void drawNode(const ccRenderCommand& command, const float *view, const float *projection) = 0;
+};
+
+/** @brief CCRenderBackend that doesn't use the device.
+It only counts the draw calls, the quads and the nodes, so the scene traversal can be measured
+and tested without a GPU.
+@since v1.0
+*/
+class CC_DLL CCNullRenderBackend : public CCRenderBackend
+{
+public:
+	CCNullRenderBackend(void) : m_uDrawCalls(0), m_uQuads(0), m_uNodes(0) {}
+
+	virtual void drawQuads(const ccRenderCommand& command, const float *projection, const ccV3F_C4B_T2F_Quad *quads)
+	{
+		++m_uDrawCalls;
+		m_uQuads += command.quadCount;
+	}
+
+	virtual void drawNode(const ccRenderCommand& command, const float *view, const float *projection)
+	{
+		++m_uNodes;
+	}
+
+	inline unsigned int getDrawCalls(void) { return m_uDrawCalls; }
+	inline unsigned int getQuads(void) { return m_uQuads; }
+	inline unsigned int getNodes(void) { return m_uNodes; }
+	inline void reset(void) { m_uDrawCalls = 0; m_uQuads = 0; m_uNodes = 0; }
+
+protected:
+	unsigned int m_uDrawCalls;
+	unsigned int m_uQuads;
+	unsigned int m_uNodes;
+};
+
+/** @brief Singleton that records the draws of the nodes while the scene is visited.
+
+CCNode::visit() records the nodes with CCNode::queueDraw(): sprites drawn outside of a
+CCSpriteBatchNode record their quad, the other nodes record a command that draws them.
+The commands are executed by the backend when the queue is flushed: before the device
+state changes, when a renderer draws immediately, and at the end of the frame.
+Consecutive quad commands with the same state are merged into one draw call. Commands
+recorded between beginSortGroup() and endSortGroup() may also be reordered by sort key,
+texture and blend function, use it only for nodes that don't overlap; node commands are
+never reordered and the quads are never moved across them.
+The queue can be flushed while it is flushed: the commands recorded by a node while it
+draws, like the scenes of a transition, are executed right after that node.
+@since v1.0
+*/
+class CC_DLL CCRenderQueue
+{
+public:
+	CCRenderQueue(void);
+	~CCRenderQueue(void);
+
+	/** returns the shared render queue */
+	static CCRenderQueue* sharedRenderQueue(void);
+
+	/** purges the shared render queue */
+	static void purgeSharedRenderQueue(void);
+
+	/** sets the backend that executes the commands. The queue doesn't retain it. */
+	void setBackend(CCRenderBackend *pBackend);
+	CCRenderBackend* getBackend(void);
+
+	/** records a quad.
+	view and projection are row major 4x4 matrices, the layout of DirectX::XMMATRIX.
+	The quad is transformed by view before it is stored.
+	*/
+	void addQuad(CCTexture2D *pTexture, const ccBlendFunc& blendFunc, const ccV3F_C4B_T2F_Quad& quad, const float *view, const float *projection);
+
+	/** records a command that draws a node. The node is retained until the command is executed.
+	view and projection are row major 4x4 matrices, the layout of DirectX::XMMATRIX.
+	*/
+	void addNode(CCNode *pNode, const float *view, const float *projection);
+
+	/** the commands recorded until endSortGroup() can be reordered by state.
+	The groups can be nested, the nested ones belong to the outermost group.
+	*/
+	void beginSortGroup(void);
+	void endSortGroup(void);
+
+	/** sets the key of the commands recorded next in the outermost sort group,
+	the commands with a lower key are drawn first. The keys of the nested groups are ignored.
+	*/
+	void setSortKey(int nKey);
+
+	/** the most quads of a command, a command that reaches it is followed by a new one.
+	0, the default, for no limit.
+	*/
+	void setBatchCapacity(unsigned int uCapacity);
+	inline unsigned int getBatchCapacity(void) { return m_uBatchCapacity; }
+
+	/** executes the recorded commands and clears the queue */
+	void flush(void);
+
+	/** number of commands recorded since the last flush */
+	inline unsigned int getCommandCount(void) { return (unsigned int)m_tRecording.commands.size(); }
+
+	/** number of draw calls, quads and nodes sent to the backend since the last resetStats() */
+	inline unsigned int getDrawCalls(void) { return m_uDrawCalls; }
+	inline unsigned int getQuadsDrawn(void) { return m_uQuadsDrawn; }
+	inline unsigned int getNodesDrawn(void) { return m_uNodesDrawn; }
+	void resetStats(void);
+
+protected:
+	// the commands recorded between two flushes
+	struct Batch
+	{
+		std::vector<ccRenderCommand> commands;
+		std::vector<ccV3F_C4B_T2F_Quad> quads;
+		// quads of the commands in the order they are executed, only used when a sort group was recorded
+		std::vector<ccV3F_C4B_T2F_Quad> sortedQuads;
+		// 16 floats per matrix
+		std::vector<float> projections;
+		std::vector<float> views;
+		bool hasSortGroups;
+
+		Batch(void) : hasSortGroups(false) {}
+		void swap(Batch& other);
+	};
+
+	unsigned int addProjection(const float *projection);
+	void execute(Batch& batch);
+	void sortCommands(Batch& batch);
+	void mergeCommands(Batch& batch);
+	void clear(Batch& batch);
+
+protected:
+	CCRenderBackend *m_pBackend;
+
+	Batch m_tRecording;
+	// the batches being executed, one per nested flush; they keep their memory
+	std::vector<Batch*> m_pExecuting;
+	unsigned int m_uFlushDepth;
+
+	// sort group of the commands being recorded, odd groups can be reordered
+	unsigned int m_uCurrentSortGroup;
+	unsigned int m_uSortGroupDepth;
+	int m_nSortKey;
+
+	unsigned int m_uBatchCapacity;
+
+	unsigned int m_uDrawCalls;
+	unsigned int m_uQuadsDrawn;
+	unsigned int m_uNodesDrawn;
+};
+
+}//namespace   cocos2d 
+
+#endif // __CCRENDER_QUEUE_H__
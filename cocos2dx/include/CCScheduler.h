@@ -28,6 +28,7 @@ THE SOFTWARE.
 #define __CCSCHEDULER_H__
 
 #include <string>
+#include <vector>
 #include "CCObject.h"
 #include "selector_protocol.h"
 #include "support/data_support/uthash.h"
@@ -48,6 +49,9 @@ public:
 	/** set interval in seconds */
 	inline void setInterval(ccTime fInterval){ m_fInterval = fInterval; }
 
+	/** get the target of the selector */
+	inline SelectorProtocol* getTarget(void) { return m_pTarget; }
+
     /** Initializes a timer with a target and a selector. */
 	bool initWithTarget(SelectorProtocol *pTarget, SEL_SCHEDULE pfnSelector);
 
@@ -59,6 +63,16 @@ public:
 	/** triggers the timer */
 	void update(ccTime dt);
 
+	/** triggers the timer if it is due at the scheduler time dTime. Used by CCScheduler for the interval selectors. */
+	void updateAtTime(double dTime);
+
+	/** returns the scheduler time at which the timer is due, dNow if it hasn't run yet */
+	double getNextFireTime(double dNow);
+
+	/** stops/resumes counting the elapsed time while the target is paused */
+	void pauseAtTime(double dTime);
+	void resumeAtTime(double dTime);
+
 public:
 	/** Allocates a timer with a target and a selector. */
 	static CCTimer* timerWithTarget(SelectorProtocol *pTarget, SEL_SCHEDULE pfnSelector);
@@ -74,9 +88,15 @@ public:
 	ccTime m_fInterval;
 	std::string m_scriptFunc;
 
+	// managed by CCScheduler: position in the timer heap (-1 when not in it), heap key and last tick it ran
+	int m_nHeapIndex;
+	double m_dFireTime;
+	unsigned int m_uLastTick;
+
 protected:
 	SelectorProtocol *m_pTarget;	
 	ccTime m_fElapsed;	
+	double m_dStartTime;
 };
 
 //
@@ -97,6 +117,9 @@ There are 2 different types of callbacks (selectors):
 
 The 'custom selectors' should be avoided when possible. It is faster, and consumes less memory to use the 'update selector'.
 
+The custom selectors are kept in a heap ordered by their next fire time, so a tick only costs
+something for the selectors that are due.
+
 */
 class CC_DLL CCScheduler : public CCObject
 {
@@ -202,6 +225,13 @@ private:
 	void priorityIn(struct _listEntry **ppList, SelectorProtocol *pTarget, int nPriority, bool bPaused);
 	void appendIn(struct _listEntry **ppList, SelectorProtocol *pTarget, bool bPaused);
 
+	// timer heap, ordered by the next fire time
+
+	void timerHeapPush(CCTimer *pTimer);
+	void timerHeapRemove(CCTimer *pTimer);
+	void timerHeapSiftUp(unsigned int uIndex);
+	void timerHeapSiftDown(unsigned int uIndex);
+
 protected:
 	ccTime m_fTimeScale;
 
@@ -220,6 +250,12 @@ protected:
 	// If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
 	bool m_bUpdateHashLocked;
 
+	// The interval timers of the running targets, so tick only visits the timers that are due
+	std::vector<CCTimer*> m_timerHeap;
+	// scaled time accumulated by tick, the timers' fire times are relative to it
+	double m_dTime;
+	unsigned int m_uTickCount;
+
 	// Used for "script function call back with interval"
 	struct _hashScriptFuncEntry *m_pHashForScriptFunctions;
 };
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "CCTextureAtlas.h"
 #include "ccTypes.h"
 #include "CCMutableDictionary.h"
+#include "CCRenderQueue.h"
 #include <string>
 #include <fstream>
 
@@ -100,6 +101,7 @@ class CC_DLL CCSprite : public CCNode, public CCTextureProtocol, public CCRGBAPr
 	CC_PROPERTY_PASS_BY_REF(ccColor3B, m_sColor, Color);
 public:
 	virtual void draw(void);
+	virtual void queueDraw(void);
 
 public:
 	// attributes
@@ -214,6 +216,7 @@ public:
 	virtual void setPosition(const CCPoint& pos);
 	virtual void setPositionInPixels(const CCPoint& pos);
 	virtual void setRotation(float fRotation);
+	virtual void setPositionAndRotation(const CCPoint& pos, float fRotation);
     virtual void setSkewX(float sx);
     virtual void setSkewY(float sy);
 	virtual void setScaleX(float fScaleX);
@@ -335,6 +338,18 @@ public:
 	*/
 	void setDisplayFrameWithAnimationName(const char *animationName, int frameIndex);
 
+	/** draws the sprites recorded in the shared CCRenderQueue and not submitted yet.
+	The renderers call it through CCEGLView::D3DFlushBatch, see CC_SPRITE_AUTO_BATCH.
+	@since v1.0
+	*/
+	static void flushBatchedDraws(void);
+
+	/** makes the sprite renderer the backend of the shared CCRenderQueue and flushes the queue from
+	CCEGLView::D3DFlushBatch. CCDirector calls it when its view is set.
+	@since v1.0
+	*/
+	static void attachRenderQueue(void);
+
 protected:
 	void updateTextureCoords(const CCRect& rect);
 	void updateBlendFunc(void);
@@ -391,7 +406,7 @@ protected:
 	static CCDXSprite mDXSprite;
 };
 
-class CC_DLL CCDXSprite
+class CC_DLL CCDXSprite : public CCRenderBackend
 {
 private:
 	_declspec(align(16)) struct MatrixBufferType
@@ -411,6 +426,9 @@ private:
 	};
 
 	bool mIsInit;
+
+	// vertices of the render queue commands are converted here before the upload
+	VertexType* m_pBatchVertices;
 public:
 	ID3D11Buffer *m_vertexBuffer;
 	ID3D11Buffer* m_indexBuffer;
@@ -431,6 +449,13 @@ public:
 	bool SetShaderParameters( DirectX::XMMATRIX &viewMatrix, DirectX::XMMATRIX &projectionMatrix, ID3D11ShaderResourceView* texture);
 	void RenderShader(CCTexture2D *texture);
 	void Render(CCTexture2D *texture,ccV3F_C4B_T2F_Quad quad);
+
+	/** records a quad in the shared CCRenderQueue with the current view and projection matrices */
+	void Append(CCTexture2D *texture,const ccBlendFunc& blendFunc,const ccV3F_C4B_T2F_Quad& quad);
+
+	// CCRenderBackend
+	virtual void drawQuads(const ccRenderCommand& command, const float *projection, const ccV3F_C4B_T2F_Quad *quads);
+	virtual void drawNode(const ccRenderCommand& command, const float *view, const float *projection);
 };
 }//namespace   cocos2d 
 
@@ -28,12 +28,12 @@ THE SOFTWARE.
 #include "CCTMXObjectGroup.h"
 #include "CCAtlasNode.h"
 #include "CCSpriteBatchNode.h"
+#include <vector>
 namespace cocos2d {
 
 	class CCTMXMapInfo;
 	class CCTMXLayerInfo;
 	class CCTMXTilesetInfo;
-	struct _ccCArray;
 
 	/** @brief CCTMXLayer represents the TMX layer.
 
@@ -42,6 +42,12 @@ namespace cocos2d {
 	The benefits of using CCSprite objects as tiles are:
 	- tiles (CCSprite) can be rotated/scaled/moved with a nice API
 
+	The tiles are split into chunks of CC_TMX_LAYER_CHUNK_SIZE x CC_TMX_LAYER_CHUNK_SIZE tiles.
+	The quads of a chunk are created the first time the chunk is on the screen, and each frame only
+	the chunks on the screen, and the chunks that have CCSprite tiles, are drawn. The quads of chunks
+	that left the screen are reused for the chunks that come into it, so the memory used by the quads
+	depends on the size of the screen, not on the size of the layer.
+
 	If the layer contains a property named "cc_vertexz" with an integer (in can be positive or negative),
 	then all the tiles belonging to the layer will use that value as their OpenGL vertex Z for depth.
 
@@ -85,6 +91,8 @@ namespace cocos2d {
 		/** dealloc the map that contains the tile position from memory.
 		Unless you want to know at runtime the tiles positions, you can safely call this method.
 		If you are going to call layer->tileGIDAt() then, don't release the map
+		@warning The chunks are created from the map, so all of them are created before it is released
+		and are kept until the layer is deallocated. Don't release the map of large layers.
 		*/
 		void releaseMap();
 
@@ -127,6 +135,8 @@ namespace cocos2d {
 		virtual void addChild(CCNode * child, int zOrder, int tag);
 		// super method
 		void removeChild(CCNode* child, bool cleanup);
+		/** removes the tile sprites and their tiles */
+		virtual void removeAllChildrenWithCleanup(bool cleanup);
 		void draw();
 
 		inline const char* getLayerName(){ return m_sLayerName.c_str(); }
@@ -147,10 +157,30 @@ namespace cocos2d {
 		void parseInternalProperties();
 		int vertexZForPos(const CCPoint& pos);
 
-		// index
-		unsigned int atlasIndexForExistantZ(unsigned int z);
-		unsigned int atlasIndexForNewZ(int z);
+		void setupReusedTileForGID(unsigned int gid, const CCPoint& pos);
+		void clearQuadAtIndex(unsigned int index);
+		void removeTileSprite(CCSprite* sprite, bool cleanup);
+
+		// chunks
+		unsigned int chunkForTile(unsigned int x, unsigned int y);
+		unsigned int atlasIndexForTile(unsigned int x, unsigned int y);
+		void buildChunk(unsigned int chunk);
+		unsigned int slotForNewChunk();
+		bool canCullTiles();
+		void visibleTileRange(int& x0, int& y0, int& x1, int& y1);
 	protected:
+		struct ccTMXLayerChunk
+		{
+			// slot of the quads in the texture atlas, -1 if the quads were not created
+			int nSlot;
+			// number of non empty tiles
+			unsigned int uTileCount;
+			// number of tiles that are CCSprite children
+			unsigned int uSpriteCount;
+			// last frame the chunk was drawn
+			unsigned int uLastDrawnFrame;
+		};
+
 		//! name of the layer
 		std::string m_sLayerName;
 		//! TMX Layer supports opacity
@@ -166,7 +196,18 @@ namespace cocos2d {
 
 		//! used for optimization
 		CCSprite			*m_pReusedTile;
-		_ccCArray			*m_pAtlasIndexArray;
+
+		//! size of a chunk in tiles, and number of chunks in a row and in a column
+		unsigned int		m_uChunkWidth;
+		unsigned int		m_uChunkHeight;
+		unsigned int		m_uChunkColumns;
+		unsigned int		m_uChunkRows;
+		std::vector<ccTMXLayerChunk> m_tChunks;
+		//! chunk using each slot of the texture atlas, -1 for free slots
+		std::vector<int>	m_tSlotChunks;
+		//! chunks drawn in the current frame
+		std::vector<unsigned int> m_tDrawnChunks;
+		unsigned int		m_uFrame;
         
         // used for retina display
         float               m_fContentScaleFactor;
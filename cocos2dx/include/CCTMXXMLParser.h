@@ -36,6 +36,7 @@ THE SOFTWARE.
 namespace cocos2d {
 
 	class CCTMXObjectGroup;
+	class CCTMXTileDataDecoder;
 
 	/** @file
 	* Internal TMX parser
@@ -183,6 +184,8 @@ namespace cocos2d {
 		std::string m_sCurrentString;
 		//! tile properties
 		CCDictionary<int, CCStringToStringDictionary*>* m_pTileProperties;
+		//! decodes the tiles of the current <data> element
+		CCTMXTileDataDecoder* m_pTileDataDecoder;
 	};
 
 }// namespace cocos2d
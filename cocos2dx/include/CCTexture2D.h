@@ -136,6 +136,13 @@ public:
 	/** Intializes with a texture2d with data */
 	bool initWithData(const void* data, CCTexture2DPixelFormat pixelFormat, unsigned int pixelsWide, unsigned int pixelsHigh, const CCSize& contentSize);
 
+	/** Replaces a rectangle of the texture with data in its pixel format.
+	dataRowPitch is the distance between two rows of data in bytes, so the rectangle can be
+	taken from a larger image.
+	@since v1.0
+	*/
+	void updateWithData(const void* data, unsigned int dataRowPitch, unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+
 	/**
 	Drawing extensions to make it easy to draw basic quads using a CCTexture2D object.
 	These functions require CC_TEXTURE_2D and both CC_VERTEX_ARRAY and CC_TEXTURE_COORD_ARRAY client states to be enabled.
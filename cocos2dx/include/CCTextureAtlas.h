@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "ccTypes.h"
 #include "CCObject.h"
 #include "ccConfig.h"
+#include "support/CCQuadUploader.h"
 
 namespace   cocos2d {
 class CCTexture2D;
@@ -55,6 +56,13 @@ protected:
 	CCuint				m_pBuffersVBO[2]; //0: vertex  1: indices
 	bool				m_bDirty; //indicates whether or not the array buffer of the VBO needs to be updated
 #endif // CC_USES_VBO
+	// vertex and index buffers kept on the GPU across frames
+	ID3D11Buffer		*m_pVertexBuffer;
+	ID3D11Buffer		*m_pIndexBuffer;
+	// number of quads the GPU buffers were created for
+	unsigned int		m_uBufferCapacity;
+	// quads that changed since the last upload
+	CCQuadUploader		m_tQuadUploader;
 
 	/** quantity of quads that are going to be drawn */
 	CC_PROPERTY_READONLY(unsigned int, m_uTotalQuads, TotalQuads)
@@ -154,9 +162,18 @@ public:
 	*/
 	void drawQuads();
 
+	/** sets the color of all the quads. Only the quads whose color changes are marked as modified.
+	*/
 	void SetColor(UINT r,UINT g,UINT b,UINT a);
+
+	/** marks the quads in [start, end) as modified, so they are uploaded to the GPU on the next draw.
+	Call it after writing into the array returned by getQuads() directly.
+	@since v1.0
+	*/
+	void setDirtyRange(unsigned int start, unsigned int end);
 private:
 	void initIndices();
+	void releaseBuffers();
 	
 	static CCDXTextureAtlas mDXTextureAtlas;
 };
@@ -164,8 +181,6 @@ private:
 class CC_DLL CCDXTextureAtlas
 {
 public:
-	ID3D11Buffer *m_vertexBuffer;
-	ID3D11Buffer* m_indexBuffer;
 	ID3D11VertexShader* m_vertexShader;
 	ID3D11PixelShader* m_pixelShader;
 	ID3D11InputLayout* m_layout;
@@ -175,19 +190,21 @@ public:
 	~CCDXTextureAtlas();
 	void FreeBuffer();
 	void setIsInit(bool isInit);
-	void initVertexBuffer(unsigned short* indices,unsigned int capacity);
-	void RenderVertexBuffer(ccV3F_C4B_T2F_Quad* quads,unsigned int capacity);
+	bool initVertexBuffer(unsigned short* indices,unsigned int capacity,ID3D11Buffer** vertexBuffer,ID3D11Buffer** indexBuffer);
+	void UpdateVertexBuffer(ID3D11Buffer* vertexBuffer,const ccV3F_C4F_T2F* vertices,unsigned int first,unsigned int count);
+	void RenderVertexBuffer(ID3D11Buffer* vertexBuffer,ID3D11Buffer* indexBuffer);
 	void OutputShaderErrorMessage(ID3D10Blob* errorMessage, HWND hwnd, WCHAR* shaderFilename);
 	bool InitializeShader();
 	bool SetShaderParameters( DirectX::XMMATRIX &viewMatrix, DirectX::XMMATRIX &projectionMatrix, ID3D11ShaderResourceView* texture);
 	void RenderShader(CCTexture2D* texture,unsigned int n, unsigned int start);
-	void Render(ccV3F_C4B_T2F_Quad* quads,unsigned short* indices,unsigned int capacity,CCTexture2D* texture,unsigned int n, unsigned int start);
+	void Render(ID3D11Buffer* vertexBuffer,ID3D11Buffer* indexBuffer,CCTexture2D* texture,unsigned int n, unsigned int start);
 private:
 	struct MatrixBufferType
 	{
 		DirectX::XMMATRIX view;
 		DirectX::XMMATRIX projection;
 	};
+	// the layout of ccV3F_C4F_T2F
 	struct VertexType
 	{
 		DirectX::XMFLOAT3 position;
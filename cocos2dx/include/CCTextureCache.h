@@ -57,6 +57,9 @@ private:
 	// @todo void addImageWithAsyncObject(CCAsyncObject* async);
     void addImageAsyncCallBack(ccTime dt);
 
+	// stops the loading threads and drops the requests that are still pending
+	void stopAsyncLoading(void);
+
 public:
 
 	CCTextureCache();
@@ -86,6 +89,7 @@ public:
 	* If the file image was not previously loaded, it will create a new CCTexture2D object and it will return it.
 	* Otherwise it will load a texture in a new thread, and when the image is loaded, the callback will be called with the Texture2D as a parameter.
 	* The callback will be called from the main thread, so it is safe to create any cocos2d object from the callback.
+	* Requests for a file that is already being loaded share the same load.
 	* Supported image extensions: .png, .jpg
 	* @since v0.8
 	*/
@@ -25,8 +25,11 @@ THE SOFTWARE.
 #define __SUPPORT_CCUSERDEFAULT_H__
 
 #include "CCPlatformMacros.h"
+#include "selector_protocol.h"
+#include "CCObject.h"
 
 #include <string>
+#include <unordered_map>
 
 
 NS_CC_BEGIN;
@@ -38,8 +41,12 @@ NS_CC_BEGIN;
  * 
  * It supports the following base types:
  * bool, int, float, double, string
+ *
+ * The file is read once, values are served from memory and changes are only
+ * written back by flush(), by the auto flush timer or when it is purged.
+ * It is a CCObject so that the scheduler can retain it while the auto flush timer runs.
  */
-class CC_DLL CCUserDefault
+class CC_DLL CCUserDefault : public SelectorProtocol, public CCObject
 {
 public:
 	~CCUserDefault();
@@ -95,12 +102,29 @@ public:
 	*/
 	void	setStringForKey(const char* pKey, const std::string & value);
 
+	/**
+	@brief Write the pending changes to the xml file.
+	 The file is written to a temporary file first which then replaces it in one step,
+	 so a crash during the write never leaves a truncated or missing file behind.
+	*/
+	void	flush();
+	/**
+	@brief Flush the pending changes every fInterval seconds using the scheduler.
+	 0 disables the timer, which is the default.
+	*/
+	void	setAutoFlushInterval(ccTime fInterval);
+
 	static CCUserDefault* sharedUserDefault();
 	static void purgeSharedUserDefault();
 	const static std::string& getXMLFilePath();
 
 private:
-	CCUserDefault() {}
+	CCUserDefault();
+	void loadXMLFile();
+	const char* getValueForKey(const char* pKey);
+	void setValueForKey(const char* pKey, const char* pValue);
+	void autoFlush(ccTime dt);
+
 	static bool createXMLFile();
 	static bool isXMLFileExist();
 	static void initXMLFilePath();
@@ -108,6 +132,10 @@ private:
 	static CCUserDefault* m_spUserDefault;
 	static std::string m_sFilePath;
 	static bool m_sbIsFilePathInitialized;
+
+	std::unordered_map<std::string, std::string> m_values;
+	bool m_bIsDirty;
+	ccTime m_fAutoFlushInterval;
 };
 
 NS_CC_END;
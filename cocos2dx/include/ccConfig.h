@@ -259,6 +259,30 @@ Platforms: Only used on ARM Neon architectures like iPhone 3GS or newer and iPad
 #define CC_USE_LA88_LABELS_ON_NEON_ARCH 0
 #endif
 
+/** @def CC_SPRITE_AUTO_BATCH
+ If enabled, CCSprite objects that are not rendered by a CCSpriteBatchNode are still batched:
+ sprites drawn one after the other with the same texture and blend function are sent to the
+ GPU in a single draw call. The batch is submitted when the texture, the blend function or the
+ projection changes, when another node draws, or at the end of the frame.
+
+ To disable set it to 0. Enabled by default.
+
+ @since v1.0
+ */
+#ifndef CC_SPRITE_AUTO_BATCH
+#define CC_SPRITE_AUTO_BATCH 1
+#endif
+
+/** @def CC_SPRITE_AUTO_BATCH_CAPACITY
+ Maximum number of quads of a sprite draw call, longer batches are split.
+ It can't be greater than 16384, the indices are 16 bits.
+
+ @since v1.0
+ */
+#ifndef CC_SPRITE_AUTO_BATCH_CAPACITY
+#define CC_SPRITE_AUTO_BATCH_CAPACITY 512
+#endif
+
 /** @def CC_SPRITE_DEBUG_DRAW
  If enabled, all subclasses of CCSprite will draw a bounding box
  Useful for debugging purposes only. It is recommened to leave it disabled.
@@ -275,6 +299,125 @@ Platforms: Only used on ARM Neon architectures like iPhone 3GS or newer and iPad
 #define CC_SPRITE_DEBUG_DRAW 0
 #endif
 
+/** @def CC_TEXTURE_CACHE_ASYNC_THREADS
+ Number of worker threads CCTextureCache::addImageAsync uses to read and decode images.
+ The threads are created with the first asynchronous request.
+
+ @since v1.0
+ */
+#ifndef CC_TEXTURE_CACHE_ASYNC_THREADS
+#define CC_TEXTURE_CACHE_ASYNC_THREADS 2
+#endif
+
+/** @def CC_PARTICLE_SYSTEM_SIMD
+ If enabled, the particle systems are updated 4 particles at a time with SSE instructions
+ on x86 and x64 CPUs. Other CPUs use the scalar loops, which give the same results.
+
+ To disable set it to 0. Enabled by default.
+
+ @since v1.0
+ */
+#ifndef CC_PARTICLE_SYSTEM_SIMD
+#define CC_PARTICLE_SYSTEM_SIMD 1
+#endif
+
+/** @def CC_PIXEL_CONVERT_SIMD
+ If enabled, the pixel conversions used to load images (premultiplied alpha, RGBA8888
+ to 16 bits and A8) convert 4 to 16 pixels at a time with SSE2 instructions on x86 and
+ x64 CPUs. Other CPUs use the scalar loops, which give the same results.
+
+ To disable set it to 0. Enabled by default.
+
+ @since v1.0
+ */
+#ifndef CC_PIXEL_CONVERT_SIMD
+#define CC_PIXEL_CONVERT_SIMD 1
+#endif
+
+/** @def CC_TMX_LAYER_CHUNK_SIZE
+ Width and height, in tiles, of the chunks CCTMXLayer splits its tiles into.
+ The quads of a chunk are only created when the chunk comes into view, and only the
+ chunks in view are drawn. Larger chunks mean fewer draw calls but more quads
+ drawn outside of the screen.
+
+ @since v1.0
+ */
+#ifndef CC_TMX_LAYER_CHUNK_SIZE
+#define CC_TMX_LAYER_CHUNK_SIZE 16
+#endif
+
+/** @def CC_LABELBMFONT_CHAR_SPRITES
+ If enabled, the characters of new CCLabelBMFont labels are CCSprite children that can be
+ moved, rotated or tinted one by one. Otherwise they are only quads of the label's texture
+ atlas, which is much faster when the string changes often.
+ Labels can still switch with CCLabelBMFont::setIsUsingCharSprites().
+
+ To enable set it to a value different than 0. Disabled by default.
+
+ @since v1.0
+ */
+#ifndef CC_LABELBMFONT_CHAR_SPRITES
+#define CC_LABELBMFONT_CHAR_SPRITES 0
+#endif
+
+/** @def CC_LABELTTF_GLYPH_CACHE
+ If enabled, new CCLabelTTF labels draw their characters from the shared CCGlyphCache:
+ each character of a font and size is drawn once into a texture shared by all the labels,
+ and changing the string only lays the characters out again. Otherwise each string is
+ drawn into a texture of its own, which is slow when the string changes often.
+ Labels can still switch with CCLabelTTF::setIsUsingGlyphCache().
+
+ To disable set it to 0. Enabled by default.
+
+ @since v1.0
+ */
+#ifndef CC_LABELTTF_GLYPH_CACHE
+#define CC_LABELTTF_GLYPH_CACHE 1
+#endif
+
+/** @def CC_GLYPH_CACHE_TEXTURE_SIZE
+ Width and height, in pixels, of the texture of the CCGlyphCache.
+ When it is full, the characters used the longest time ago are dropped to make room.
+
+ @since v1.0
+ */
+#ifndef CC_GLYPH_CACHE_TEXTURE_SIZE
+#define CC_GLYPH_CACHE_TEXTURE_SIZE 1024
+#endif
+
+/** @def CC_FILE_CACHE_SIZE
+ Default number of bytes of file data CCFileUtils keeps in memory.
+ The least recently used files are dropped when the cache is full.
+ It can be changed at runtime with CCFileUtils::setFileCacheSize().
+
+ @since v1.0
+ */
+#ifndef CC_FILE_CACHE_SIZE
+#define CC_FILE_CACHE_SIZE (4 * 1024 * 1024)
+#endif
+
+/** @def CC_FRAME_PROFILER_HISTORY
+ Number of frames whose timings and counters CCFrameProfiler keeps.
+ It can be changed at runtime with CCFrameProfiler::setHistorySize().
+
+ @since v1.0
+ */
+#ifndef CC_FRAME_PROFILER_HISTORY
+#define CC_FRAME_PROFILER_HISTORY 300
+#endif
+
+/** @def CC_ENABLE_BOX2D_INTEGRATION
+ If enabled, CCPhysicsNode is available. It steps a Box2D world at a fixed rate and
+ moves the sprites bound to its bodies. Box2D must be built with cocos2d.
+
+ To disable set it to 0. Enabled by default.
+
+ @since v1.0
+ */
+#ifndef CC_ENABLE_BOX2D_INTEGRATION
+#define CC_ENABLE_BOX2D_INTEGRATION 1
+#endif
+
 /** @def CC_SPRITEBATCHNODE_DEBUG_DRAW
 If enabled, all subclasses of CCSprite that are rendered using an CCSpriteBatchNode draw a bounding box.
 Useful for debugging purposes only. It is recommened to leave it disabled.
@@ -249,6 +249,20 @@ typedef struct _ccV3F_C4B_T2F
 	ccTex2F			texCoords;			// 8 byts
 } ccV3F_C4B_T2F;
 
+/** a Point with a vertex point, a tex coord point and a color 4F,
+the layout of the vertex buffers of the Direct3D renderers
+@since v1.0
+*/
+typedef struct _ccV3F_C4F_T2F
+{
+	//! vertices (3F)
+	ccVertex3F		vertices;
+	//! colors (4F)
+	ccColor4F		colors;
+	//! tex coords (2F)
+	ccTex2F			texCoords;
+} ccV3F_C4F_T2F;
+
 //! 4 ccVertex2FTex2FColor4B Quad
 typedef struct _ccV2F_C4B_T2F_Quad
 {
@@ -51,6 +51,7 @@ THE SOFTWARE.
 #include "CCActionInterval.h"
 #include "CCActionEase.h"
 #include "CCLabelTTF.h"
+#include "CCGlyphCache.h"
 #include "CCLayer.h"
 #include "CCMenu.h"
 #include "CCMenuItem.h"
@@ -64,6 +65,7 @@ THE SOFTWARE.
 #include "CCTextureCache.h"
 #include "CCTransition.h"
 #include "CCTextureAtlas.h"
+#include "CCRenderQueue.h"
 #include "CCLabelAtlas.h"
 #include "CCAtlasNode.h"
 #include "CCActionTiledGrid.h"
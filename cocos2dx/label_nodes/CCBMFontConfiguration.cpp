@@ -0,0 +1,530 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+Copyright (c) 2008-2010 Ricardo Quesada
+Copyright (c) 2011      Zynga Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+****************************************************************************/
+#include "CCBMFontConfiguration.h"
+
+#include "CCConfiguration.h"
+#include "CCFileUtils.h"
+#include "ccMacros.h"
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+namespace cocos2d{
+
+	//
+	//BitmapFontConfiguration
+	//
+	static bool compareKerningKeys(const ccBMFontKerning& kerning, unsigned int key)
+	{
+		return kerning.key < key;
+	}
+	static bool compareKernings(const ccBMFontKerning& a, const ccBMFontKerning& b)
+	{
+		return a.key < b.key;
+	}
+
+	//
+	// text .fnt files are made of lines like
+	// char id=32 x=0 y=0 width=0 height=0 xoffset=0 yoffset=44 xadvance=14 page=0 chnl=0
+	// they are read straight from the file buffer, without copying the lines nor the values
+	//
+	static inline bool isFNTSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+	static inline bool isFNTToken(const char *p, const char *end, const char *token, unsigned int tokenLength)
+	{
+		return (unsigned int)(end - p) == tokenLength && memcmp(p, token, tokenLength) == 0;
+	}
+	#define FNT_TOKEN_IS(__p__, __end__, __token__) isFNTToken(__p__, __end__, __token__, sizeof(__token__) - 1)
+
+	static int parseFNTInt(const char *p, const char *end)
+	{
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+'))
+		{
+			negative = *p == '-';
+			++p;
+		}
+
+		int value = 0;
+		for (; p < end && *p >= '0' && *p <= '9'; ++p)
+		{
+			value = value * 10 + (*p - '0');
+		}
+		return negative ? -value : value;
+	}
+	// parses values separated by commas, like padding=1,4,3,2
+	static void parseFNTIntList(const char *p, const char *end, int *pValues, int nCount)
+	{
+		for (int i = 0; i < nCount; ++i)
+		{
+			const char *comma = (const char*)memchr(p, ',', end - p);
+			const char *valueEnd = comma ? comma : end;
+			pValues[i] = parseFNTInt(p, valueEnd);
+			p = comma ? comma + 1 : end;
+		}
+	}
+	// the next key=value of a line, the quotes of the value are removed
+	static bool nextFNTAttribute(const char *&p, const char *end, const char *&key, const char *&keyEnd, const char *&value, const char *&valueEnd)
+	{
+		while (p < end && isFNTSpace(*p))
+		{
+			++p;
+		}
+		if (p >= end)
+		{
+			return false;
+		}
+
+		key = p;
+		while (p < end && *p != '=' && ! isFNTSpace(*p))
+		{
+			++p;
+		}
+		keyEnd = p;
+
+		value = valueEnd = p;
+		if (p < end && *p == '=')
+		{
+			++p;
+			if (p < end && *p == '"')
+			{
+				value = ++p;
+				while (p < end && *p != '"')
+				{
+					++p;
+				}
+				valueEnd = p;
+				if (p < end)
+				{
+					++p;
+				}
+			}
+			else
+			{
+				value = p;
+				while (p < end && ! isFNTSpace(*p))
+				{
+					++p;
+				}
+				valueEnd = p;
+			}
+		}
+		return true;
+	}
+
+	//
+	// binary .fnt files, version 3: "BMF" 3, then blocks of a type byte, a 32 bits size and the data.
+	// http://www.angelcode.com/products/bmfont/doc/file_format.html
+	//
+	enum {
+		kFNTBinaryBlockInfo = 1,
+		kFNTBinaryBlockCommon = 2,
+		kFNTBinaryBlockPages = 3,
+		kFNTBinaryBlockChars = 4,
+		kFNTBinaryBlockKerningPairs = 5,
+
+		kFNTBinaryCharSize = 20,
+		kFNTBinaryKerningPairSize = 10,
+	};
+	static inline unsigned int readFNTUInt16(const unsigned char *p)
+	{
+		return p[0] | (p[1] << 8);
+	}
+	static inline int readFNTInt16(const unsigned char *p)
+	{
+		return (short)(p[0] | (p[1] << 8));
+	}
+	static inline unsigned int readFNTUInt32(const unsigned char *p)
+	{
+		return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+	}
+
+	CCBMFontConfiguration * CCBMFontConfiguration::configurationWithFNTFile(const char *FNTfile)
+	{
+		CCBMFontConfiguration * pRet = new CCBMFontConfiguration();
+		if (pRet->initWithFNTfile(FNTfile))
+		{
+			pRet->autorelease();
+			return pRet;
+		}
+		CC_SAFE_DELETE(pRet);
+		return NULL;
+	}
+	bool CCBMFontConfiguration::initWithFNTfile(const char *FNTfile)
+	{
+		CCAssert(FNTfile != NULL && strlen(FNTfile)!=0, "");
+		m_tCharacters.clear();
+		m_tCharacterIndices.clear();
+		m_tKernings.clear();
+		if (! this->parseConfigFile(FNTfile))
+		{
+			return false;
+		}
+
+		// the kernings are searched with a binary search
+		std::stable_sort(m_tKernings.begin(), m_tKernings.end(), compareKernings);
+		return true;
+	}
+	CCBMFontConfiguration::~CCBMFontConfiguration()
+	{
+		CCLOGINFO( "cocos2d: deallocing CCBMFontConfiguration" );
+		m_sAtlasName.clear();
+	}
+	char * CCBMFontConfiguration::description(void)
+	{
+		char *ret = new char[100];
+		sprintf(ret, "<CCBMFontConfiguration | Kernings:%d | Image = %s>", (int)m_tKernings.size(), m_sAtlasName.c_str());
+		return ret;
+	}
+	int CCBMFontConfiguration::kerningAmountForPair(unsigned int first, unsigned int second)
+	{
+		if (first >= kCCBMFontMaxChars || second >= kCCBMFontMaxChars)
+		{
+			return 0;
+		}
+
+		unsigned int key = (first<<16) | (second & 0xffff);
+
+		std::vector<ccBMFontKerning>::const_iterator it = std::lower_bound(m_tKernings.begin(), m_tKernings.end(), key, compareKerningKeys);
+		if( it != m_tKernings.end() && it->key == key )
+		{
+			return it->amount;
+		}
+		return 0;
+	}
+	void CCBMFontConfiguration::addCharacterDefinition(const ccBMFontDef& characterDefinition)
+	{
+		unsigned int charID = characterDefinition.charID;
+		if (charID >= kCCBMFontMaxChars)
+		{
+			CCLOG("cocos2d: CCBMFontConfiguration: character %u ignored, the IDs are 16 bits", charID);
+			return;
+		}
+
+		if (charID >= m_tCharacterIndices.size())
+		{
+			m_tCharacterIndices.resize(charID + 1, 0);
+		}
+		if (m_tCharacterIndices[charID] != 0)
+		{
+			m_tCharacters[m_tCharacterIndices[charID] - 1] = characterDefinition;
+		}
+		else
+		{
+			m_tCharacters.push_back(characterDefinition);
+			m_tCharacterIndices[charID] = m_tCharacters.size();
+		}
+	}
+	void CCBMFontConfiguration::addKerning(unsigned int first, unsigned int second, int amount)
+	{
+		if (first >= kCCBMFontMaxChars || second >= kCCBMFontMaxChars)
+		{
+			return;
+		}
+
+		ccBMFontKerning kerning;
+		kerning.amount = amount;
+		kerning.key = (first<<16) | (second&0xffff);
+		m_tKernings.push_back(kerning);
+	}
+	bool CCBMFontConfiguration::parseConfigFile(const char *controlFile)
+	{	
+		std::string fullpath = CCFileUtils::fullPathFromRelativePath(controlFile);
+
+        CCFileData data(fullpath.c_str(), "rb");
+        unsigned long nBufSize = data.getSize();
+        const unsigned char* pBuffer = data.getBuffer();
+
+        CCAssert(pBuffer, "CCBMFontConfiguration::parseConfigFile | Open file error.");
+
+        if (!pBuffer)
+        {
+            return false;
+        }
+
+        bool bRet = false;
+        if (nBufSize >= 4 && memcmp(pBuffer, "BMF", 3) == 0)
+        {
+            bRet = this->parseBinaryConfigFile(pBuffer, nBufSize, controlFile);
+        }
+        else
+        {
+            bRet = this->parseTextConfigFile((const char*)pBuffer, nBufSize, controlFile);
+        }
+
+        if (bRet && m_sAtlasName.empty())
+        {
+            CCLOG("cocos2d: CCBMFontConfiguration: %s has no page", controlFile);
+            bRet = false;
+        }
+        return bRet;
+	}
+	bool CCBMFontConfiguration::parseTextConfigFile(const char *pBuffer, unsigned long nSize, const char *controlFile)
+	{
+		const char *key, *keyEnd, *value, *valueEnd;
+
+		const char* pLineStart = pBuffer;
+		const char* pBufferEnd = pBuffer + nSize;
+		while (pLineStart < pBufferEnd)
+		{
+			const char* pLineEnd = (const char*) memchr(pLineStart, '\n', pBufferEnd - pLineStart);
+			if (! pLineEnd)
+			{
+				// get the left data
+				pLineEnd = pBufferEnd;
+			}
+			const char* p = pLineStart;
+			pLineStart = pLineEnd + 1;
+
+			// the first word of the line tells what it defines
+			while (p < pLineEnd && isFNTSpace(*p))
+			{
+				++p;
+			}
+			const char* pTag = p;
+			while (p < pLineEnd && ! isFNTSpace(*p))
+			{
+				++p;
+			}
+			const char* pTagEnd = p;
+
+			if (FNT_TOKEN_IS(pTag, pTagEnd, "char"))
+			{
+				ccBMFontDef characterDefinition;
+				characterDefinition.charID = 0;
+				characterDefinition.xOffset = 0;
+				characterDefinition.yOffset = 0;
+				characterDefinition.xAdvance = 0;
+
+				while (nextFNTAttribute(p, pLineEnd, key, keyEnd, value, valueEnd))
+				{
+					int n = parseFNTInt(value, valueEnd);
+					if (FNT_TOKEN_IS(key, keyEnd, "id"))
+						characterDefinition.charID = (unsigned int)n;
+					else if (FNT_TOKEN_IS(key, keyEnd, "x"))
+						characterDefinition.rect.origin.x = (float)n;
+					else if (FNT_TOKEN_IS(key, keyEnd, "y"))
+						characterDefinition.rect.origin.y = (float)n;
+					else if (FNT_TOKEN_IS(key, keyEnd, "width"))
+						characterDefinition.rect.size.width = (float)n;
+					else if (FNT_TOKEN_IS(key, keyEnd, "height"))
+						characterDefinition.rect.size.height = (float)n;
+					else if (FNT_TOKEN_IS(key, keyEnd, "xoffset"))
+						characterDefinition.xOffset = n;
+					else if (FNT_TOKEN_IS(key, keyEnd, "yoffset"))
+						characterDefinition.yOffset = n;
+					else if (FNT_TOKEN_IS(key, keyEnd, "xadvance"))
+						characterDefinition.xAdvance = n;
+				}
+				this->addCharacterDefinition(characterDefinition);
+			}
+			else if (FNT_TOKEN_IS(pTag, pTagEnd, "kerning"))
+			{
+				int first = 0, second = 0, amount = 0;
+				while (nextFNTAttribute(p, pLineEnd, key, keyEnd, value, valueEnd))
+				{
+					if (FNT_TOKEN_IS(key, keyEnd, "first"))
+						first = parseFNTInt(value, valueEnd);
+					else if (FNT_TOKEN_IS(key, keyEnd, "second"))
+						second = parseFNTInt(value, valueEnd);
+					else if (FNT_TOKEN_IS(key, keyEnd, "amount"))
+						amount = parseFNTInt(value, valueEnd);
+				}
+				this->addKerning((unsigned int)first, (unsigned int)second, amount);
+			}
+			else if (FNT_TOKEN_IS(pTag, pTagEnd, "info"))
+			{
+				// XXX: info parsing is incomplete
+				// Not needed for the Hiero editors, but needed for the AngelCode editor
+				while (nextFNTAttribute(p, pLineEnd, key, keyEnd, value, valueEnd))
+				{
+					if (FNT_TOKEN_IS(key, keyEnd, "padding"))
+					{
+						int padding[4];
+						parseFNTIntList(value, valueEnd, padding, 4);
+						m_tPadding.top = padding[0];
+						m_tPadding.right = padding[1];
+						m_tPadding.bottom = padding[2];
+						m_tPadding.left = padding[3];
+						CCLOG("cocos2d: padding: %d,%d,%d,%d", m_tPadding.left, m_tPadding.top, m_tPadding.right, m_tPadding.bottom);
+					}
+				}
+			}
+			else if (FNT_TOKEN_IS(pTag, pTagEnd, "common"))
+			{
+				while (nextFNTAttribute(p, pLineEnd, key, keyEnd, value, valueEnd))
+				{
+					if (FNT_TOKEN_IS(key, keyEnd, "lineHeight"))
+					{
+						m_uCommonHeight = (unsigned int)parseFNTInt(value, valueEnd);
+					}
+					else if (FNT_TOKEN_IS(key, keyEnd, "scaleW") || FNT_TOKEN_IS(key, keyEnd, "scaleH"))
+					{
+						CCAssert(parseFNTInt(value, valueEnd) <= CCConfiguration::sharedConfiguration()->getMaxTextureSize(), "CCLabelBMFont: page can't be larger than supported");
+					}
+					else if (FNT_TOKEN_IS(key, keyEnd, "pages"))
+					{
+						CCAssert(parseFNTInt(value, valueEnd) == 1, "CCBitfontAtlas: only supports 1 page");
+					}
+				}
+			}
+			else if (FNT_TOKEN_IS(pTag, pTagEnd, "page"))
+			{
+				while (nextFNTAttribute(p, pLineEnd, key, keyEnd, value, valueEnd))
+				{
+					if (FNT_TOKEN_IS(key, keyEnd, "id"))
+					{
+						CCAssert(parseFNTInt(value, valueEnd) == 0, "LabelBMFont file could not be found");
+					}
+					else if (FNT_TOKEN_IS(key, keyEnd, "file"))
+					{
+						std::string file(value, valueEnd - value);
+						m_sAtlasName = CCFileUtils::fullPathFromRelativeFile(file.c_str(), controlFile);
+					}
+				}
+			}
+			else if (FNT_TOKEN_IS(pTag, pTagEnd, "chars"))
+			{
+				while (nextFNTAttribute(p, pLineEnd, key, keyEnd, value, valueEnd))
+				{
+					if (FNT_TOKEN_IS(key, keyEnd, "count"))
+					{
+						m_tCharacters.reserve(MAX(parseFNTInt(value, valueEnd), 0));
+					}
+				}
+			}
+			else if (FNT_TOKEN_IS(pTag, pTagEnd, "kernings"))
+			{
+				while (nextFNTAttribute(p, pLineEnd, key, keyEnd, value, valueEnd))
+				{
+					if (FNT_TOKEN_IS(key, keyEnd, "count"))
+					{
+						m_tKernings.reserve(MAX(parseFNTInt(value, valueEnd), 0));
+					}
+				}
+			}
+		}
+		return true;
+	}
+	bool CCBMFontConfiguration::parseBinaryConfigFile(const unsigned char *pBuffer, unsigned long nSize, const char *controlFile)
+	{
+		if (pBuffer[3] != 3)
+		{
+			CCLOG("cocos2d: CCBMFontConfiguration: %s uses the unsupported binary version %d", controlFile, (int)pBuffer[3]);
+			return false;
+		}
+
+		const unsigned char *p = pBuffer + 4;
+		const unsigned char *pEnd = pBuffer + nSize;
+		while (pEnd - p >= 5)
+		{
+			unsigned char type = p[0];
+			unsigned long size = readFNTUInt32(p + 1);
+			p += 5;
+			if (size > (unsigned long)(pEnd - p))
+			{
+				CCLOG("cocos2d: CCBMFontConfiguration: %s is truncated", controlFile);
+				return false;
+			}
+			const unsigned char *pBlock = p;
+			p += size;
+
+			switch (type)
+			{
+			case kFNTBinaryBlockInfo:
+				// fontSize, bitField, charSet, stretchH, aa, then the padding
+				if (size >= 11)
+				{
+					m_tPadding.top = pBlock[7];
+					m_tPadding.right = pBlock[8];
+					m_tPadding.bottom = pBlock[9];
+					m_tPadding.left = pBlock[10];
+				}
+				break;
+			case kFNTBinaryBlockCommon:
+				// lineHeight, base, scaleW, scaleH, pages
+				if (size < 10)
+				{
+					return false;
+				}
+				m_uCommonHeight = readFNTUInt16(pBlock);
+				CCAssert((int)readFNTUInt16(pBlock + 4) <= CCConfiguration::sharedConfiguration()->getMaxTextureSize(), "CCLabelBMFont: page can't be larger than supported");
+				CCAssert((int)readFNTUInt16(pBlock + 6) <= CCConfiguration::sharedConfiguration()->getMaxTextureSize(), "CCLabelBMFont: page can't be larger than supported");
+				CCAssert(readFNTUInt16(pBlock + 8) == 1, "CCBitfontAtlas: only supports 1 page");
+				break;
+			case kFNTBinaryBlockPages:
+				{
+					// zero terminated names, the first one is page 0
+					const char *pName = (const char*)pBlock;
+					const char *pNameEnd = (const char*)memchr(pName, 0, size);
+					if (! pNameEnd)
+					{
+						return false;
+					}
+					std::string file(pName, pNameEnd - pName);
+					m_sAtlasName = CCFileUtils::fullPathFromRelativeFile(file.c_str(), controlFile);
+				}
+				break;
+			case kFNTBinaryBlockChars:
+				{
+					unsigned long count = size / kFNTBinaryCharSize;
+					m_tCharacters.reserve(m_tCharacters.size() + count);
+					for (unsigned long i = 0; i < count; ++i)
+					{
+						const unsigned char *pChar = pBlock + i * kFNTBinaryCharSize;
+						ccBMFontDef characterDefinition;
+						characterDefinition.charID = readFNTUInt32(pChar);
+						characterDefinition.rect = CCRectMake((float)readFNTUInt16(pChar + 4), (float)readFNTUInt16(pChar + 6),
+							(float)readFNTUInt16(pChar + 8), (float)readFNTUInt16(pChar + 10));
+						characterDefinition.xOffset = readFNTInt16(pChar + 12);
+						characterDefinition.yOffset = readFNTInt16(pChar + 14);
+						characterDefinition.xAdvance = readFNTInt16(pChar + 16);
+						this->addCharacterDefinition(characterDefinition);
+					}
+				}
+				break;
+			case kFNTBinaryBlockKerningPairs:
+				{
+					unsigned long count = size / kFNTBinaryKerningPairSize;
+					m_tKernings.reserve(m_tKernings.size() + count);
+					for (unsigned long i = 0; i < count; ++i)
+					{
+						const unsigned char *pPair = pBlock + i * kFNTBinaryKerningPairSize;
+						this->addKerning(readFNTUInt32(pPair), readFNTUInt32(pPair + 4), readFNTInt16(pPair + 8));
+					}
+				}
+				break;
+			default:
+				break;
+			}
+		}
+		return true;
+	}
+
+}// namespace cocos2d
@@ -0,0 +1,192 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CCGlyphCache.h"
+#include "CCTexture2D.h"
+#include "CCTextureCache.h"
+#include "CCDirector.h"
+#include "CCImage.h"
+#include "ccMacros.h"
+#include "support/image_support/ccPixelConvert.h"
+
+namespace cocos2d
+{
+	//
+	// CCImageGlyphRasterizer
+	//
+	static unsigned int encodeUTF8(unsigned int uCodePoint, char *pszText)
+	{
+		unsigned int uLength = 0;
+		if (uCodePoint < 0x80)
+		{
+			pszText[uLength++] = (char)uCodePoint;
+		}
+		else if (uCodePoint < 0x800)
+		{
+			pszText[uLength++] = (char)(0xc0 | (uCodePoint >> 6));
+			pszText[uLength++] = (char)(0x80 | (uCodePoint & 0x3f));
+		}
+		else if (uCodePoint < 0x10000)
+		{
+			pszText[uLength++] = (char)(0xe0 | (uCodePoint >> 12));
+			pszText[uLength++] = (char)(0x80 | ((uCodePoint >> 6) & 0x3f));
+			pszText[uLength++] = (char)(0x80 | (uCodePoint & 0x3f));
+		}
+		else
+		{
+			pszText[uLength++] = (char)(0xf0 | (uCodePoint >> 18));
+			pszText[uLength++] = (char)(0x80 | ((uCodePoint >> 12) & 0x3f));
+			pszText[uLength++] = (char)(0x80 | ((uCodePoint >> 6) & 0x3f));
+			pszText[uLength++] = (char)(0x80 | (uCodePoint & 0x3f));
+		}
+		pszText[uLength] = 0;
+		return uLength;
+	}
+
+	// the advance of the spaces the platform measures without their trailing width
+	static int spaceAdvance(unsigned int uCodePoint, unsigned int uFontSize)
+	{
+		switch (uCodePoint)
+		{
+		case ' ':
+		case 0xa0:
+			return MAX(1, (int)uFontSize / 4);
+		case '\t':
+		case 0x3000:
+			return (int)uFontSize;
+		default:
+			return 0;
+		}
+	}
+
+	bool CCImageGlyphRasterizer::rasterizeGlyph(const char *pszFontName, unsigned int uFontSize, unsigned int uCodePoint, ccGlyphBitmap *pBitmap)
+	{
+		char szText[8];
+		encodeUTF8(uCodePoint, szText);
+
+		CCImage image;
+		if (! image.initWithString(szText, 0, 0, CCImage::kAlignLeft, pszFontName, (int)uFontSize)
+			|| ! image.hasAlpha() || ! image.getData())
+		{
+			pBitmap->nAdvance = spaceAdvance(uCodePoint, uFontSize);
+			return pBitmap->nAdvance > 0;
+		}
+
+		unsigned int uWidth = (unsigned int)image.getWidth();
+		unsigned int uHeight = (unsigned int)image.getHeight();
+
+		pBitmap->uWidth = uWidth;
+		pBitmap->uHeight = uHeight;
+		pBitmap->nLeft = 0;
+		pBitmap->nTop = 0;
+		pBitmap->nAdvance = uWidth > 0 ? (int)uWidth : spaceAdvance(uCodePoint, uFontSize);
+		pBitmap->uLineHeight = uHeight;
+		pBitmap->tCoverage.resize(uWidth * uHeight);
+		if (uWidth * uHeight > 0)
+		{
+			ccPixelRGBA8888ToA8(image.getData(), &pBitmap->tCoverage[0], uWidth * uHeight);
+		}
+		return true;
+	}
+
+	//
+	// CCGlyphCache
+	//
+	CCGlyphCache* CCGlyphCache::s_pSharedGlyphCache = NULL;
+
+	CCGlyphCache* CCGlyphCache::sharedGlyphCache(void)
+	{
+		if (! s_pSharedGlyphCache)
+		{
+			s_pSharedGlyphCache = new CCGlyphCache();
+		}
+		return s_pSharedGlyphCache;
+	}
+
+	void CCGlyphCache::purgeSharedGlyphCache(void)
+	{
+		CC_SAFE_RELEASE_NULL(s_pSharedGlyphCache);
+	}
+
+	CCGlyphCache::CCGlyphCache()
+		: m_tAtlas(CC_GLYPH_CACHE_TEXTURE_SIZE, CC_GLYPH_CACHE_TEXTURE_SIZE)
+		, m_pTexture(NULL)
+	{
+		m_tAtlas.setRasterizer(&m_tImageRasterizer);
+	}
+
+	CCGlyphCache::~CCGlyphCache()
+	{
+		CCLOGINFO("cocos2d: deallocing CCGlyphCache.");
+#if CC_ENABLE_CACHE_TEXTTURE_DATA
+		// the labels can keep the texture, it must not be reloaded from the pixels of the atlas freed here
+		if (m_pTexture)
+		{
+			VolatileTexture::removeTexture(m_pTexture);
+		}
+#endif
+		CC_SAFE_RELEASE(m_pTexture);
+	}
+
+	CCTexture2D* CCGlyphCache::getTexture(void)
+	{
+		if (! m_pTexture)
+		{
+			m_pTexture = new CCTexture2D();
+			CCSize size = CCSizeMake((float)m_tAtlas.getWidth(), (float)m_tAtlas.getHeight());
+			m_pTexture->initWithData(m_tAtlas.getPixels(), kCCTexture2DPixelFormat_RGBA8888, m_tAtlas.getWidth(), m_tAtlas.getHeight(), size);
+#if CC_ENABLE_CACHE_TEXTTURE_DATA
+			// the pixels of the atlas stay where they are, and up to date
+			VolatileTexture::addDataTexture(m_pTexture, (void*)m_tAtlas.getPixels(), kCCTexture2DPixelFormat_RGBA8888, size);
+#endif
+			m_tAtlas.clearDirtyRect();
+		}
+
+		updateTexture();
+		return m_pTexture;
+	}
+
+	void CCGlyphCache::updateTexture(void)
+	{
+		unsigned int x, y, width, height;
+		if (! m_pTexture || ! m_tAtlas.getDirtyRect(&x, &y, &width, &height))
+		{
+			return;
+		}
+
+		unsigned int uRowPitch = m_tAtlas.getWidth() * 4;
+		m_pTexture->updateWithData(m_tAtlas.getPixels() + y * uRowPitch + x * 4, uRowPitch, x, y, width, height);
+		m_tAtlas.clearDirtyRect();
+	}
+
+	void CCGlyphCache::setRasterizer(CCGlyphRasterizer *pRasterizer)
+	{
+		m_tAtlas.setRasterizer(pRasterizer ? pRasterizer : &m_tImageRasterizer);
+		m_tAtlas.removeAllGlyphs();
+	}
+
+	unsigned int CCGlyphCache::getTick(void)
+	{
+		return CCDirector::sharedDirector()->getTotalFrames();
+	}
+}
@@ -40,7 +40,10 @@ http://www.angelcode.com/products/bmfont/ (Free, Windows only)
 #include "CCPointExtension.h"
 
 #include "CCFileUtils.h"
-#include "support/data_support/uthash.h"
+#include "ccConfig.h"
+#include "support/ccUTF8.h"
+#include <algorithm>
+#include <mutex>
 
 namespace cocos2d{
 	
@@ -48,20 +51,34 @@ namespace cocos2d{
 	//FNTConfig Cache - free functions
 	//
 	CCMutableDictionary<std::string, CCBMFontConfiguration*> *configurations = NULL;
+	static std::mutex s_configurationsMutex;
+
 	CCBMFontConfiguration* FNTConfigLoadFile( const char *fntFile)
 	{
 		CCBMFontConfiguration *pRet = NULL;
 
+		// keyed by the full path, so a file is parsed once whatever the path used to name it
+		std::string key = CCFileUtils::fullPathFromRelativePath(fntFile);
+
+		std::lock_guard<std::mutex> lock(s_configurationsMutex);
 		if( configurations == NULL )
 		{
 			configurations = new CCMutableDictionary<std::string, CCBMFontConfiguration*>();
 		}
-		std::string key(fntFile);
 		pRet = configurations->objectForKey(key);
 		if( pRet == NULL )
 		{
-			pRet = CCBMFontConfiguration::configurationWithFNTFile(fntFile);
-			configurations->setObject(pRet, key);
+			// not autoreleased, it can be loaded from any thread
+			pRet = new CCBMFontConfiguration();
+			if( pRet->initWithFNTfile(fntFile) )
+			{
+				configurations->setObject(pRet, key);
+				pRet->release();
+			}
+			else
+			{
+				CC_SAFE_DELETE(pRet);
+			}
 		}
 
 		return pRet;
@@ -69,6 +86,7 @@ namespace cocos2d{
 
 	void FNTConfigRemoveCache( void )
 	{
+		std::lock_guard<std::mutex> lock(s_configurationsMutex);
 		if (configurations)
 		{
 			configurations->removeAllObjects();
@@ -76,301 +94,6 @@ namespace cocos2d{
 		}
 	}
 	//
-	//Hash Element
-	//
-	// Equal function for targetSet.
-	typedef struct _KerningHashElement
-	{	
-		int				key;		// key for the hash. 16-bit for 1st element, 16-bit for 2nd element
-		int				amount;
-		UT_hash_handle	hh;
-	} tKerningHashElement;
-	//
-	//BitmapFontConfiguration
-	//
-
-	CCBMFontConfiguration * CCBMFontConfiguration::configurationWithFNTFile(const char *FNTfile)
-	{
-		CCBMFontConfiguration * pRet = new CCBMFontConfiguration();
-		if (pRet->initWithFNTfile(FNTfile))
-		{
-			pRet->autorelease();
-			return pRet;
-		}
-		CC_SAFE_DELETE(pRet);
-		return NULL;
-	}
-	bool CCBMFontConfiguration::initWithFNTfile(const char *FNTfile)
-	{
-		CCAssert(FNTfile != NULL && strlen(FNTfile)!=0, "");
-		m_pKerningDictionary = NULL;
-		this->parseConfigFile(FNTfile);
-		return true;
-	}
-	CCBMFontConfiguration::~CCBMFontConfiguration()
-	{
-		CCLOGINFO( "cocos2d: deallocing CCBMFontConfiguration" );
-		this->purgeKerningDictionary();
-		m_sAtlasName.clear();
-	}
-	char * CCBMFontConfiguration::description(void)
-	{
-		char *ret = new char[100];
-		sprintf(ret, "<CCBMFontConfiguration | Kernings:%d | Image = %s>", HASH_COUNT(m_pKerningDictionary), m_sAtlasName.c_str());
-		return ret;
-	}
-	void CCBMFontConfiguration::purgeKerningDictionary()
-	{
-		tKerningHashElement *current;
-		while(m_pKerningDictionary) 
-		{
-			current = m_pKerningDictionary; 
-			HASH_DEL(m_pKerningDictionary,current);
-			free(current);
-		}
-	}
-	void CCBMFontConfiguration::parseConfigFile(const char *controlFile)
-	{	
-		std::string fullpath = CCFileUtils::fullPathFromRelativePath(controlFile);
-
-        CCFileData data(fullpath.c_str(), "rb");
-        unsigned long nBufSize = data.getSize();
-        char* pBuffer = (char*) data.getBuffer();
-
-        CCAssert(pBuffer, "CCBMFontConfiguration::parseConfigFile | Open file error.");
-
-        if (!pBuffer)
-        {
-            return;
-        }
-
-        // parse spacing / padding
-        std::string line;
-        std::string strLeft(pBuffer, nBufSize);
-        while (strLeft.length() > 0)
-        {
-            int pos = strLeft.find('\n');
-
-            if (pos != (int)std::string::npos)
-            {
-                // the data is more than a line.get one line
-                line = strLeft.substr(0, pos);
-                strLeft = strLeft.substr(pos + 1);
-            }
-            else
-            {
-                // get the left data
-                line = strLeft;
-                strLeft.erase();
-            }
-
-            if(line.substr(0,strlen("info face")) == "info face") 
-            {
-                // XXX: info parsing is incomplete
-                // Not needed for the Hiero editors, but needed for the AngelCode editor
-                //			[self parseInfoArguments:line];
-                this->parseInfoArguments(line);
-            }
-            // Check to see if the start of the line is something we are interested in
-            else if(line.substr(0,strlen("common lineHeight")) == "common lineHeight")
-            {
-                this->parseCommonArguments(line);
-            }
-            else if(line.substr(0,strlen("page id")) == "page id")
-            {
-                this->parseImageFileName(line, controlFile);
-            }
-            else if(line.substr(0,strlen("chars c")) == "chars c")
-            {
-                // Ignore this line
-            }
-            else if(line.substr(0,strlen("char")) == "char")
-            {
-                // Parse the current line and create a new CharDef
-                ccBMFontDef characterDefinition;
-                this->parseCharacterDefinition(line, &characterDefinition);
-
-                // Add the CharDef returned to the charArray
-                m_pBitmapFontArray[ characterDefinition.charID ] = characterDefinition;
-            }
-            else if(line.substr(0,strlen("kernings count")) == "kernings count")
-            {
-                this->parseKerningCapacity(line);
-            }
-            else if(line.substr(0,strlen("kerning first")) == "kerning first")
-            {
-                this->parseKerningEntry(line);
-            }
-        }
-	}
-	void CCBMFontConfiguration::parseImageFileName(std::string line, const char *fntFile)
-	{
-		//////////////////////////////////////////////////////////////////////////
-		// line to parse:
-		// page id=0 file="bitmapFontTest.png"
-		//////////////////////////////////////////////////////////////////////////
-
-		// page ID. Sanity check
-		int index = line.find('=')+1;
-		int index2 = line.find(' ', index);
-		std::string value = line.substr(index, index2-index);
-		CCAssert(atoi(value.c_str()) == 0, "LabelBMFont file could not be found");
-		// file 
-		index = line.find('"')+1;
-		index2 = line.find('"', index);
-		value = line.substr(index, index2-index);
-
-		m_sAtlasName = CCFileUtils::fullPathFromRelativeFile(value.c_str(), fntFile);
-	}
-	void CCBMFontConfiguration::parseInfoArguments(std::string line)
-	{
-		//////////////////////////////////////////////////////////////////////////
-		// possible lines to parse:
-		// info face="Script" size=32 bold=0 italic=0 charset="" unicode=1 stretchH=100 smooth=1 aa=1 padding=1,4,3,2 spacing=0,0 outline=0
-		// info face="Cracked" size=36 bold=0 italic=0 charset="" unicode=0 stretchH=100 smooth=1 aa=1 padding=0,0,0,0 spacing=1,1
-		//////////////////////////////////////////////////////////////////////////
-
-		// padding
-		int index = line.find("padding=");
-		int index2 = line.find(' ', index);
-		std::string value = line.substr(index, index2-index);
-		sscanf(value.c_str(), "padding=%d,%d,%d,%d", &m_tPadding.top, &m_tPadding.right, &m_tPadding.bottom, &m_tPadding.left);
-		CCLOG("cocos2d: padding: %d,%d,%d,%d", m_tPadding.left, m_tPadding.top, m_tPadding.right, m_tPadding.bottom);
-	}
-	void CCBMFontConfiguration::parseCommonArguments(std::string line)
-	{
-		//////////////////////////////////////////////////////////////////////////
-		// line to parse:
-		// common lineHeight=104 base=26 scaleW=1024 scaleH=512 pages=1 packed=0
-		//////////////////////////////////////////////////////////////////////////
-		
-		// Height
-		int index = line.find("lineHeight=");
-		int index2 = line.find(' ', index);
-		std::string value = line.substr(index, index2-index);
-		sscanf(value.c_str(), "lineHeight=%u", &m_uCommonHeight);
-		// scaleW. sanity check
-		index = line.find("scaleW=") + strlen("scaleW=");
-		index2 = line.find(' ', index);
-		value = line.substr(index, index2-index);
-		CCAssert(atoi(value.c_str()) <= CCConfiguration::sharedConfiguration()->getMaxTextureSize(), "CCLabelBMFont: page can't be larger than supported");
-		// scaleH. sanity check
-		index = line.find("scaleH=") + strlen("scaleH=");
-		index2 = line.find(' ', index);
-		value = line.substr(index, index2-index);
-		CCAssert(atoi(value.c_str()) <= CCConfiguration::sharedConfiguration()->getMaxTextureSize(), "CCLabelBMFont: page can't be larger than supported");
-		// pages. sanity check
-		index = line.find("pages=") + strlen("pages=");
-		index2 = line.find(' ', index);
-		value = line.substr(index, index2-index);
-		CCAssert(atoi(value.c_str()) == 1, "CCBitfontAtlas: only supports 1 page");
-
-		// packed (ignore) What does this mean ??
-	}
-	void CCBMFontConfiguration::parseCharacterDefinition(std::string line, ccBMFontDef *characterDefinition)
-	{	
-		//////////////////////////////////////////////////////////////////////////
-		// line to parse:
-		// char id=32   x=0     y=0     width=0     height=0     xoffset=0     yoffset=44    xadvance=14     page=0  chnl=0 
-		//////////////////////////////////////////////////////////////////////////
-
-		// Character ID
-		int index = line.find("id=");
-		int index2 = line.find(' ', index);
-		std::string value = line.substr(index, index2-index);
-		sscanf(value.c_str(), "id=%u", &characterDefinition->charID);
-		CCAssert(characterDefinition->charID < kCCBMFontMaxChars, "BitmpaFontAtlas: CharID bigger than supported");
-		// Character x
-		index = line.find("x=");
-		index2 = line.find(' ', index);
-		value = line.substr(index, index2-index);
-		sscanf(value.c_str(), "x=%f", &characterDefinition->rect.origin.x);
-		// Character y
-		index = line.find("y=");
-		index2 = line.find(' ', index);
-		value = line.substr(index, index2-index);
-		sscanf(value.c_str(), "y=%f", &characterDefinition->rect.origin.y);
-		// Character width
-		index = line.find("width=");
-		index2 = line.find(' ', index);
-		value = line.substr(index, index2-index);
-		sscanf(value.c_str(), "width=%f", &characterDefinition->rect.size.width);
-		// Character height
-		index = line.find("height=");
-		index2 = line.find(' ', index);
-		value = line.substr(index, index2-index);
-		sscanf(value.c_str(), "height=%f", &characterDefinition->rect.size.height);
-		// Character xoffset
-		index = line.find("xoffset=");
-		index2 = line.find(' ', index);
-		value = line.substr(index, index2-index);
-		sscanf(value.c_str(), "xoffset=%d", &characterDefinition->xOffset);
-		// Character yoffset
-		index = line.find("yoffset=");
-		index2 = line.find(' ', index);
-		value = line.substr(index, index2-index);
-		sscanf(value.c_str(), "yoffset=%d", &characterDefinition->yOffset);
-		// Character xadvance
-		index = line.find("xadvance=");
-		index2 = line.find(' ', index);
-		value = line.substr(index, index2-index);
-		sscanf(value.c_str(), "xadvance=%d", &characterDefinition->xAdvance);
-	}
-	void CCBMFontConfiguration::parseKerningCapacity(std::string line)
-	{
-		// When using uthash there is not need to parse the capacity.
-
-		//	CCAssert(!kerningDictionary, @"dictionary already initialized");
-		//	
-		//	// Break the values for this line up using =
-		//	CCMutableArray *values = [line componentsSeparatedByString:@"="];
-		//	NSEnumerator *nse = [values objectEnumerator];	
-		//	CCString *propertyValue;
-		//	
-		//	// We need to move past the first entry in the array before we start assigning values
-		//	[nse nextObject];
-		//	
-		//	// count
-		//	propertyValue = [nse nextObject];
-		//	int capacity = [propertyValue intValue];
-		//	
-		//	if( capacity != -1 )
-		//		kerningDictionary = ccHashSetNew(capacity, targetSetEql);
-	}
-	void CCBMFontConfiguration::parseKerningEntry(std::string line)
-	{		
-		//////////////////////////////////////////////////////////////////////////
-		// line to parse:
-		// kerning first=121  second=44  amount=-7
-		//////////////////////////////////////////////////////////////////////////
-
-		// first
-		int first;
-		int index = line.find("first=");
-		int index2 = line.find(' ', index);
-		std::string value = line.substr(index, index2-index);
-		sscanf(value.c_str(), "first=%d", &first);
-
-		// second
-		int second;
-		index = line.find("second=");
-		index2 = line.find(' ', index);
-		value = line.substr(index, index2-index);
-		sscanf(value.c_str(), "second=%d", &second);
-
-		// amount
-		int amount;
-		index = line.find("amount=");
-		index2 = line.find(' ', index);
-		value = line.substr(index, index2-index);
-		sscanf(value.c_str(), "amount=%d", &amount);
-
-		tKerningHashElement *element = (tKerningHashElement *)calloc( sizeof( *element ), 1 );
-		element->amount = amount;
-		element->key = (first<<16) | (second&0xffff);
-		HASH_ADD_INT(m_pKerningDictionary,key, element);
-	}
-	//
 	//CCLabelBMFont
 	//
 
@@ -398,8 +121,12 @@ namespace cocos2d{
 		CCAssert(theString != NULL, "");
 		CC_SAFE_RELEASE(m_pConfiguration);// allow re-init
 		m_pConfiguration = FNTConfigLoadFile(fntFile);
-		m_pConfiguration->retain();
 		CCAssert( m_pConfiguration, "Error creating config for LabelBMFont");
+		if (! m_pConfiguration)
+		{
+			return false;
+		}
+		m_pConfiguration->retain();
 
 		if (CCSpriteBatchNode::initWithFile(m_pConfiguration->m_sAtlasName.c_str(), strlen(theString)))
 		{
@@ -407,6 +134,8 @@ namespace cocos2d{
 			m_tColor = ccWHITE;
 			m_tContentSize = CCSizeZero;
 			m_bIsOpacityModifyRGB = m_pobTextureAtlas->getTexture()->getHasPremultipliedAlpha();
+			m_bIsUsingCharSprites = CC_LABELBMFONT_CHAR_SPRITES != 0;
+			m_uGlyphCount = 0;
 			setAnchorPoint(ccp(0.5f, 0.5f));
 			this->setString(theString);
 			return true;
@@ -420,24 +149,26 @@ namespace cocos2d{
 	}
 
 	// LabelBMFont - Atlas generation
-	int CCLabelBMFont::kerningAmountForFirst(unsigned short first, unsigned short second)
+	int CCLabelBMFont::kerningAmountForFirst(unsigned int first, unsigned int second)
 	{
-		int ret = 0;
-		unsigned int key = (first<<16) | (second & 0xffff);
-
-		if( m_pConfiguration->m_pKerningDictionary ) {
-			tKerningHashElement *element = NULL;
-			HASH_FIND_INT(m_pConfiguration->m_pKerningDictionary, &key, element);		
-			if(element)
-				ret = element->amount;
-		}
-		return ret;
+		return m_pConfiguration->kerningAmountForPair(first, second);
 	}
 	void CCLabelBMFont::createFontChars()
+	{
+		if( m_bIsUsingCharSprites )
+		{
+			this->createCharSprites();
+		}
+		else
+		{
+			this->createGlyphQuads();
+		}
+	}
+	void CCLabelBMFont::createCharSprites()
 	{
 		int nextFontPositionX = 0;
         int nextFontPositionY = 0;
-		unsigned short prev = -1;
+		unsigned int prev = (unsigned int)-1;
 		int kerningAmount = 0;
 
 		CCSize tmpSize = CCSizeZero;
@@ -466,10 +197,13 @@ namespace cocos2d{
         totalHeight = m_pConfiguration->m_uCommonHeight * quantityOfLines;
         nextFontPositionY = -((long)(m_pConfiguration->m_uCommonHeight) - (long)(m_pConfiguration->m_uCommonHeight * quantityOfLines));
 
-		for (unsigned int i= 0; i < stringLen; i++)
+		// the string is UTF-8, the sprites are the characters of the font in the order of the string
+		const char *p = m_sString.c_str();
+		const char *pEnd = p + stringLen;
+		unsigned int spriteIndex = 0;
+		while (p < pEnd)
 		{
-			unsigned short c = m_sString[i];
-			CCAssert( c < kCCBMFontMaxChars, "LabelBMFont: character outside bounds");
+			unsigned int c = ccNextUTF8CodePoint(p);
 
             if (c == '\n')
             {
@@ -478,20 +212,34 @@ namespace cocos2d{
                 continue;
             }
             
-			kerningAmount = this->kerningAmountForFirst(prev, c);
+			const ccBMFontDef *pFontDef = m_pConfiguration->characterDefinition(c);
+			if (! pFontDef)
+			{
+				// the font doesn't have the character
+				continue;
+			}
+			const ccBMFontDef& fontDef = *pFontDef;
 
-			const ccBMFontDef& fontDef = m_pConfiguration->m_pBitmapFontArray[c];
+			kerningAmount = this->kerningAmountForFirst(prev, c);
 
 			CCRect rect = fontDef.rect;
 
-			CCSprite *fontChar;
+			CCSprite *fontChar = NULL;
 
-			fontChar = (CCSprite*)(this->getChildByTag(i));
+			// the sprites are the first children, each one is tagged with its index
+			if( m_pChildren && spriteIndex < m_pChildren->count() )
+			{
+				fontChar = (CCSprite*)(m_pChildren->objectAtIndex(spriteIndex));
+				if( fontChar->getTag() != (int)spriteIndex )
+				{
+					fontChar = (CCSprite*)(this->getChildByTag(spriteIndex));
+				}
+			}
 			if( ! fontChar )
 			{
 				fontChar = new CCSprite();
 				fontChar->initWithBatchNodeRectInPixels(this, rect);
-				this->addChild(fontChar, 0, i);
+				this->addChild(fontChar, 0, spriteIndex);
 				fontChar->release();
 			}
 			else
@@ -511,8 +259,9 @@ namespace cocos2d{
 			//		NSLog(@"position.y: %f", fontChar.position.y);
 
 			// update kerning
-			nextFontPositionX += m_pConfiguration->m_pBitmapFontArray[c].xAdvance + kerningAmount;
+			nextFontPositionX += fontDef.xAdvance + kerningAmount;
 			prev = c;
+			spriteIndex++;
 
 			// Apply label properties
 			fontChar->setIsOpacityModifyRGB(m_bIsOpacityModifyRGB);
@@ -538,13 +287,172 @@ namespace cocos2d{
 		this->setContentSizeInPixels(tmpSize);
 	}
 
+	void CCLabelBMFont::createGlyphQuads()
+	{
+		int nextFontPositionX = 0;
+		int nextFontPositionY = 0;
+		unsigned int prev = (unsigned int)-1;
+		int kerningAmount = 0;
+
+		int longestLine = 0;
+		unsigned int quantityOfLines = 1;
+		unsigned int quantityOfGlyphs = 0;
+
+		unsigned int stringLen = m_sString.length();
+
+		// the string is UTF-8, decoded as the characters are below
+		const char *pEnd = m_sString.c_str() + stringLen;
+		for (const char *p = m_sString.c_str(); p < pEnd; )
+		{
+			if (ccNextUTF8CodePoint(p) != '\n')
+			{
+				quantityOfGlyphs++;
+			}
+			else if (p < pEnd)
+			{
+				quantityOfLines++;
+			}
+		}
+
+		if (quantityOfGlyphs > m_pobTextureAtlas->getCapacity())
+		{
+			m_pobTextureAtlas->resizeCapacity(MAX(quantityOfGlyphs, (m_pobTextureAtlas->getCapacity() + 1) * 4 / 3));
+		}
+
+		CCTexture2D *texture = m_pobTextureAtlas->getTexture();
+		float atlasWidth = (float)texture->getPixelsWide();
+		float atlasHeight = (float)texture->getPixelsHigh();
+
+		ccColor4B color = this->glyphColor();
+
+		nextFontPositionY = -((long)(m_pConfiguration->m_uCommonHeight) - (long)(m_pConfiguration->m_uCommonHeight * quantityOfLines));
+
+		// the quads are compared with the ones of the previous string, only the different ones are written
+		ccV3F_C4B_T2F_Quad *quads = m_pobTextureAtlas->getQuads();
+		unsigned int totalQuads = m_pobTextureAtlas->getTotalQuads();
+		unsigned int glyph = 0;
+
+		const char *p = m_sString.c_str();
+		while (p < pEnd)
+		{
+			unsigned int c = ccNextUTF8CodePoint(p);
+
+			if (c == '\n')
+			{
+				nextFontPositionX = 0;
+				nextFontPositionY -= m_pConfiguration->m_uCommonHeight;
+				continue;
+			}
+
+			const ccBMFontDef *pFontDef = m_pConfiguration->characterDefinition(c);
+			if (! pFontDef)
+			{
+				// the font doesn't have the character
+				continue;
+			}
+			const ccBMFontDef& fontDef = *pFontDef;
+
+			kerningAmount = this->kerningAmountForFirst(prev, c);
+			const CCRect& rect = fontDef.rect;
+
+			// same place and texture coordinates as a CCSprite with an anchor point of (0.5, 0.5)
+			float left = (float)(nextFontPositionX + fontDef.xOffset + kerningAmount);
+			float bottom = (float)(nextFontPositionY + (int)m_pConfiguration->m_uCommonHeight - fontDef.yOffset) - rect.size.height;
+			float right = left + rect.size.width;
+			float top = bottom + rect.size.height;
+
+#if CC_FIX_ARTIFACTS_BY_STRECHING_TEXEL
+			float texLeft = (2*rect.origin.x+1)/(2*atlasWidth);
+			float texRight = texLeft + (rect.size.width*2-2)/(2*atlasWidth);
+			float texTop = (2*rect.origin.y+1)/(2*atlasHeight);
+			float texBottom = texTop + (rect.size.height*2-2)/(2*atlasHeight);
+#else
+			float texLeft = rect.origin.x/atlasWidth;
+			float texRight = texLeft + rect.size.width/atlasWidth;
+			float texTop = rect.origin.y/atlasHeight;
+			float texBottom = texTop + rect.size.height/atlasHeight;
+#endif // ! CC_FIX_ARTIFACTS_BY_STRECHING_TEXEL
+
+			ccV3F_C4B_T2F_Quad quad;
+			quad.bl.vertices = vertex3((float)RENDER_IN_SUBPIXEL(left), (float)RENDER_IN_SUBPIXEL(bottom), 0);
+			quad.br.vertices = vertex3((float)RENDER_IN_SUBPIXEL(right), (float)RENDER_IN_SUBPIXEL(bottom), 0);
+			quad.tl.vertices = vertex3((float)RENDER_IN_SUBPIXEL(left), (float)RENDER_IN_SUBPIXEL(top), 0);
+			quad.tr.vertices = vertex3((float)RENDER_IN_SUBPIXEL(right), (float)RENDER_IN_SUBPIXEL(top), 0);
+			quad.bl.texCoords.u = texLeft;
+			quad.bl.texCoords.v = texBottom;
+			quad.br.texCoords.u = texRight;
+			quad.br.texCoords.v = texBottom;
+			quad.tl.texCoords.u = texLeft;
+			quad.tl.texCoords.v = texTop;
+			quad.tr.texCoords.u = texRight;
+			quad.tr.texCoords.v = texTop;
+			quad.bl.colors = quad.br.colors = quad.tl.colors = quad.tr.colors = color;
+
+			if (glyph >= totalQuads || memcmp(&quads[glyph], &quad, sizeof(quad)) != 0)
+			{
+				m_pobTextureAtlas->updateQuad(&quad, glyph);
+			}
+			glyph++;
+
+			// update kerning
+			nextFontPositionX += fontDef.xAdvance + kerningAmount;
+			prev = c;
+
+			if (longestLine < nextFontPositionX)
+			{
+				longestLine = nextFontPositionX;
+			}
+		}
+
+		// the quads of the previous string past the end of this one aren't drawn anymore
+		while (m_pobTextureAtlas->getTotalQuads() > glyph)
+		{
+			m_pobTextureAtlas->removeQuadAtIndex(m_pobTextureAtlas->getTotalQuads() - 1);
+		}
+		m_uGlyphCount = glyph;
+
+		CCSize tmpSize;
+		tmpSize.width  = (float) longestLine;
+		tmpSize.height = (float) (m_pConfiguration->m_uCommonHeight * quantityOfLines);
+
+		this->setContentSizeInPixels(tmpSize);
+	}
+	// the color of the quads, like the one of a CCSprite
+	ccColor4B CCLabelBMFont::glyphColor()
+	{
+		ccColor4B color = { m_tColor.r, m_tColor.g, m_tColor.b, m_cOpacity };
+		if (m_bIsOpacityModifyRGB)
+		{
+			color.r = (CCubyte)(m_tColor.r * m_cOpacity / 255);
+			color.g = (CCubyte)(m_tColor.g * m_cOpacity / 255);
+			color.b = (CCubyte)(m_tColor.b * m_cOpacity / 255);
+		}
+		return color;
+	}
+	void CCLabelBMFont::updateGlyphColors()
+	{
+		if (m_bIsUsingCharSprites || m_uGlyphCount == 0)
+		{
+			return;
+		}
+
+		ccColor4B color = this->glyphColor();
+
+		ccV3F_C4B_T2F_Quad *quads = m_pobTextureAtlas->getQuads();
+		for (unsigned int i = 0; i < m_uGlyphCount; i++)
+		{
+			quads[i].bl.colors = quads[i].br.colors = quads[i].tl.colors = quads[i].tr.colors = color;
+		}
+		m_pobTextureAtlas->setDirtyRange(0, m_uGlyphCount);
+	}
+
 	//LabelBMFont - CCLabelProtocol protocol
 	void CCLabelBMFont::setString(const char *newString)
 	{	
 		m_sString.clear();
 		m_sString = newString;
 
-		if (m_pChildren && m_pChildren->count() != 0)
+		if (m_bIsUsingCharSprites && m_pChildren && m_pChildren->count() != 0)
 		{
             CCObject* child;
             CCARRAY_FOREACH(m_pChildren, child)
@@ -573,6 +481,7 @@ namespace cocos2d{
 	void CCLabelBMFont::setColor(const ccColor3B& var)
 	{
 		m_tColor = var;
+		updateGlyphColors();
 		if (m_pChildren && m_pChildren->count() != 0)
 		{
             CCObject* child;
@@ -593,6 +502,7 @@ namespace cocos2d{
 	void CCLabelBMFont::setOpacity(CCubyte var)
 	{
 		m_cOpacity = var;
+		updateGlyphColors();
 
 		if (m_pChildren && m_pChildren->count() != 0)
 		{
@@ -618,6 +528,7 @@ namespace cocos2d{
 	void CCLabelBMFont::setIsOpacityModifyRGB(bool var)
 	{
 		m_bIsOpacityModifyRGB = var;
+		updateGlyphColors();
 		if (m_pChildren && m_pChildren->count() != 0)
 		{
             CCObject* child;
@@ -639,6 +550,50 @@ namespace cocos2d{
 	{
 		return m_bIsOpacityModifyRGB;
 	}
+	void CCLabelBMFont::setIsUsingCharSprites(bool var)
+	{
+		if (var == m_bIsUsingCharSprites)
+		{
+			return;
+		}
+
+		m_bIsUsingCharSprites = var;
+		if (m_bIsUsingCharSprites)
+		{
+			// the sprites insert their own quads
+			m_pobTextureAtlas->removeAllQuads();
+			m_uGlyphCount = 0;
+		}
+		else
+		{
+			removeAllChildrenWithCleanup(true);
+		}
+		this->createFontChars();
+	}
+	bool CCLabelBMFont::getIsUsingCharSprites()
+	{
+		return m_bIsUsingCharSprites;
+	}
+
+	// LabelBMFont - children
+	void CCLabelBMFont::addChild(CCNode *child)
+	{
+		CCSpriteBatchNode::addChild(child);
+	}
+	void CCLabelBMFont::addChild(CCNode *child, int zOrder)
+	{
+		CCSpriteBatchNode::addChild(child, zOrder);
+	}
+	void CCLabelBMFont::addChild(CCNode *child, int zOrder, int tag)
+	{
+		// a sprite would insert its quad before the quads of the characters, they become sprites first
+		if (! m_bIsUsingCharSprites)
+		{
+			CCLOG("cocos2d: CCLabelBMFont: adding a child switches the label to character sprites");
+			setIsUsingCharSprites(true);
+		}
+		CCSpriteBatchNode::addChild(child, zOrder, tag);
+	}
 
 	// LabelBMFont - AnchorPoint
 	void CCLabelBMFont::setAnchorPoint(const CCPoint& point)
@@ -24,8 +24,14 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "CCLabelTTF.h"
 #include "CCDirector.h"
+#include "CCGlyphCache.h"
+#include "ccConfig.h"
+#include <algorithm>
 
 namespace cocos2d{
+	// reused by all the labels to lay their strings out
+	static std::vector<ccGlyphPlacement> s_tGlyphPlacements;
+
 	//
 	//CCLabelTTF
 	//
@@ -34,7 +40,12 @@ namespace cocos2d{
         , m_pFontName(NULL)
         , m_fFontSize(0.0)
         , m_pString(NULL)
+        , m_bIsUsingGlyphCache(CC_LABELTTF_GLYPH_CACHE != 0)
+        , m_uGlyphGeneration(0)
+        , m_bGlyphFlipX(false)
+        , m_bGlyphFlipY(false)
     {
+        m_tGlyphColor.r = m_tGlyphColor.g = m_tGlyphColor.b = m_tGlyphColor.a = 255;
     }
 
     CCLabelTTF::~CCLabelTTF()
@@ -115,7 +126,21 @@ namespace cocos2d{
             m_pString = NULL;
         }
         m_pString = new std::string(label);
-        
+
+		if (m_bIsUsingGlyphCache)
+		{
+			this->updateGlyphQuads();
+		}
+		else
+		{
+			this->updateStringTexture();
+		}
+	}
+
+	void CCLabelTTF::updateStringTexture()
+	{
+		const char *label = m_pString->c_str();
+
 		CCTexture2D *texture;
 		if( CCSize::CCSizeEqualToSize( m_tDimensions, CCSizeZero ) )
 		{
@@ -140,6 +165,179 @@ namespace cocos2d{
 		return m_pString->c_str();
 	}
 
+	void CCLabelTTF::updateGlyphQuads()
+	{
+		CCGlyphCache *pCache = CCGlyphCache::sharedGlyphCache();
+		CCGlyphAtlas *pAtlas = pCache->getAtlas();
+		CCTexture2D *pTexture = pCache->getTexture();
+		if (m_pobTexture != pTexture)
+		{
+			this->setTexture(pTexture);
+		}
+
+		float width = 0, height = 0;
+		pAtlas->layoutString(m_pString->c_str(), pAtlas->fontID(m_pFontName->c_str()), (unsigned int)m_fFontSize, pCache->getTick(),
+			m_tDimensions.width, m_tDimensions.height, (ccGlyphAlignment)m_eAlignment, s_tGlyphPlacements, &width, &height);
+		m_uGlyphGeneration = pAtlas->getGeneration();
+
+		float atlasWidth = (float)pAtlas->getWidth();
+		float atlasHeight = (float)pAtlas->getHeight();
+		ccColor4B color = m_sQuad.bl.colors;
+
+		m_tGlyphQuads.resize(s_tGlyphPlacements.size());
+		m_tGlyphShelves.clear();
+		for (unsigned int i = 0; i < s_tGlyphPlacements.size(); ++i)
+		{
+			const ccGlyphPlacement& placement = s_tGlyphPlacements[i];
+			const ccGlyph& glyph = placement.glyph;
+			ccV3F_C4B_T2F_Quad& quad = m_tGlyphQuads[i];
+
+			float left = placement.fLeft;
+			float bottom = placement.fBottom;
+			float right = left + glyph.uWidth;
+			float top = bottom + glyph.uHeight;
+			float texLeft = glyph.uX / atlasWidth;
+			float texRight = (glyph.uX + glyph.uWidth) / atlasWidth;
+			float texTop = glyph.uY / atlasHeight;
+			float texBottom = (glyph.uY + glyph.uHeight) / atlasHeight;
+
+			// like the texture of a sprite, the label is mirrored inside its content size
+			if (m_bFlipX)
+			{
+				float flippedLeft = width - right;
+				right = width - left;
+				left = flippedLeft;
+				std::swap(texLeft, texRight);
+			}
+			if (m_bFlipY)
+			{
+				float flippedBottom = height - top;
+				top = height - bottom;
+				bottom = flippedBottom;
+				std::swap(texTop, texBottom);
+			}
+
+			quad.bl.vertices = vertex3(left, bottom, 0);
+			quad.br.vertices = vertex3(right, bottom, 0);
+			quad.tl.vertices = vertex3(left, top, 0);
+			quad.tr.vertices = vertex3(right, top, 0);
+			quad.bl.texCoords.u = texLeft;
+			quad.bl.texCoords.v = texBottom;
+			quad.br.texCoords.u = texRight;
+			quad.br.texCoords.v = texBottom;
+			quad.tl.texCoords.u = texLeft;
+			quad.tl.texCoords.v = texTop;
+			quad.tr.texCoords.u = texRight;
+			quad.tr.texCoords.v = texTop;
+			quad.bl.colors = quad.br.colors = quad.tl.colors = quad.tr.colors = color;
+
+			if (std::find(m_tGlyphShelves.begin(), m_tGlyphShelves.end(), glyph.uShelf) == m_tGlyphShelves.end())
+			{
+				m_tGlyphShelves.push_back(glyph.uShelf);
+			}
+		}
+		m_tGlyphColor = color;
+		m_bGlyphFlipX = m_bFlipX;
+		m_bGlyphFlipY = m_bFlipY;
+
+		this->setContentSizeInPixels(CCSizeMake(width, height));
+	}
+
+	void CCLabelTTF::updateGlyphColors()
+	{
+		ccColor4B color = m_sQuad.bl.colors;
+		for (unsigned int i = 0; i < m_tGlyphQuads.size(); ++i)
+		{
+			ccV3F_C4B_T2F_Quad& quad = m_tGlyphQuads[i];
+			quad.bl.colors = quad.br.colors = quad.tl.colors = quad.tr.colors = color;
+		}
+		m_tGlyphColor = color;
+	}
+
+	void CCLabelTTF::draw(void)
+	{
+		if (! m_bIsUsingGlyphCache)
+		{
+			CCSprite::draw();
+			return;
+		}
+
+		CCNode::draw();
+
+		CCGlyphCache *pCache = CCGlyphCache::sharedGlyphCache();
+		if (m_pobTexture != pCache->getTexture() || m_uGlyphGeneration != pCache->getAtlas()->getGeneration()
+			|| m_bFlipX != m_bGlyphFlipX || m_bFlipY != m_bGlyphFlipY)
+		{
+			// characters were dropped from the cache, or the label was flipped, since the quads were made
+			this->updateGlyphQuads();
+		}
+		else
+		{
+			// the characters drawn during the frame are kept until it ends
+			unsigned int uTick = pCache->getTick();
+			for (unsigned int i = 0; i < m_tGlyphShelves.size(); ++i)
+			{
+				pCache->getAtlas()->touchShelf(m_tGlyphShelves[i], uTick);
+			}
+		}
+		// the characters added by the labels drawn before
+		pCache->updateTexture();
+
+		if (m_tGlyphQuads.empty())
+		{
+			return;
+		}
+
+		const ccColor4B& color = m_sQuad.bl.colors;
+		if (color.r != m_tGlyphColor.r || color.g != m_tGlyphColor.g || color.b != m_tGlyphColor.b || color.a != m_tGlyphColor.a)
+		{
+			this->updateGlyphColors();
+		}
+
+#if CC_SPRITE_AUTO_BATCH
+		for (unsigned int i = 0; i < m_tGlyphQuads.size(); ++i)
+		{
+			mDXSprite.Append(m_pobTexture, m_sBlendFunc, m_tGlyphQuads[i]);
+		}
+#else
+		bool newBlend = m_sBlendFunc.src != CC_BLEND_SRC || m_sBlendFunc.dst != CC_BLEND_DST;
+		if (newBlend)
+		{
+			CCD3DCLASS->D3DBlendFunc(m_sBlendFunc.src, m_sBlendFunc.dst);
+		}
+		for (unsigned int i = 0; i < m_tGlyphQuads.size(); ++i)
+		{
+			mDXSprite.Render(m_pobTexture, m_tGlyphQuads[i]);
+		}
+		if (newBlend)
+		{
+			CCD3DCLASS->D3DBlendFunc(CC_BLEND_SRC, CC_BLEND_DST);
+		}
+#endif // CC_SPRITE_AUTO_BATCH
+	}
+
+	bool CCLabelTTF::getIsUsingGlyphCache()
+	{
+		return m_bIsUsingGlyphCache;
+	}
+
+	void CCLabelTTF::setIsUsingGlyphCache(bool bIsUsingGlyphCache)
+	{
+		if (m_bIsUsingGlyphCache == bIsUsingGlyphCache)
+		{
+			return;
+		}
+
+		m_bIsUsingGlyphCache = bIsUsingGlyphCache;
+		m_tGlyphQuads.clear();
+		m_tGlyphShelves.clear();
+		if (m_pString)
+		{
+			std::string label = *m_pString;
+			this->setString(label.c_str());
+		}
+	}
+
 	char * CCLabelTTF::description()
 	{
 		char *ret = new char[100] ;
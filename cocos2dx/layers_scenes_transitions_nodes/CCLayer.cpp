@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "DirectXHelper.h"
 #include <fstream>
 #include "BasicLoader.h"
+#include "support/CCProfiling.h"
 
 using namespace std;
 using namespace DirectX;
@@ -686,11 +687,14 @@ void CCDXLayerColor::RenderShader()
 	CCID3D11DeviceContext->VSSetShader(m_vertexShader, NULL, 0);
 	CCID3D11DeviceContext->PSSetShader(m_pixelShader, NULL, 0);
 	CCID3D11DeviceContext->Draw(4,0);
+	CCFrameProfiler::addDrawCall(1);
 }
 
 
 void CCDXLayerColor::Render(ccVertex2F* squareVertices,ccColor4B* squareColors)
 {
+	CCD3DCLASS->D3DFlushBatch();
+
 	if ( !mIsInit )
 	{
 		mIsInit = TRUE;
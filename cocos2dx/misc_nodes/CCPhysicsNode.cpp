@@ -0,0 +1,240 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CCPhysicsNode.h"
+
+#if CC_ENABLE_BOX2D_INTEGRATION
+
+#include "CCSprite.h"
+#include "ccMacros.h"
+
+namespace cocos2d {
+
+CCPhysicsNode::CCPhysicsNode()
+: m_fFixedTimeStep(1.0f / 60.0f)
+, m_nMaxSubSteps(5)
+, m_nVelocityIterations(8)
+, m_nPositionIterations(3)
+, m_fPtmRatio(32.0f)
+, m_bIsInterpolating(true)
+, m_pWorld(NULL)
+, m_nLastStepCount(0)
+, m_fAccumulator(0)
+{
+}
+
+CCPhysicsNode::~CCPhysicsNode()
+{
+	unbindAll();
+}
+
+CCPhysicsNode* CCPhysicsNode::nodeWithWorld(b2World* pWorld, float fPtmRatio)
+{
+	CCPhysicsNode *pRet = new CCPhysicsNode();
+	if (pRet && pRet->initWithWorld(pWorld, fPtmRatio))
+	{
+		pRet->autorelease();
+		return pRet;
+	}
+	CC_SAFE_DELETE(pRet);
+	return NULL;
+}
+
+bool CCPhysicsNode::initWithWorld(b2World* pWorld, float fPtmRatio)
+{
+	CCAssert(pWorld != NULL, "CCPhysicsNode: world must not be NULL");
+	CCAssert(fPtmRatio > 0, "CCPhysicsNode: ptmRatio must be positive");
+
+	m_pWorld = pWorld;
+	m_fPtmRatio = fPtmRatio;
+	m_fAccumulator = 0;
+
+	// paused until the node enters the stage
+	scheduleUpdate();
+	return true;
+}
+
+void CCPhysicsNode::bindSprite(CCSprite* pSprite, b2Body* pBody)
+{
+	CCAssert(pSprite != NULL && pBody != NULL, "CCPhysicsNode: sprite and body must not be NULL");
+
+	pSprite->retain();
+	unbindSprite(pSprite);
+
+	ccPhysicsBinding binding;
+	binding.pSprite = pSprite;
+	binding.pBody = pBody;
+	binding.tPreviousPosition = pBody->GetPosition();
+	binding.fPreviousAngle = pBody->GetAngle();
+	binding.tSpritePosition = CCPointMake(pBody->GetPosition().x * m_fPtmRatio, pBody->GetPosition().y * m_fPtmRatio);
+	binding.fSpriteRotation = -CC_RADIANS_TO_DEGREES(pBody->GetAngle());
+	pSprite->setPositionAndRotation(binding.tSpritePosition, binding.fSpriteRotation);
+
+	m_tBindings.push_back(binding);
+}
+
+void CCPhysicsNode::unbindSprite(CCSprite* pSprite)
+{
+	for (unsigned int i = 0; i < m_tBindings.size(); ++i)
+	{
+		if (m_tBindings[i].pSprite == pSprite)
+		{
+			// the order of the bindings does not matter
+			m_tBindings[i] = m_tBindings.back();
+			m_tBindings.pop_back();
+			pSprite->release();
+			return;
+		}
+	}
+}
+
+void CCPhysicsNode::unbindBody(b2Body* pBody)
+{
+	for (unsigned int i = 0; i < m_tBindings.size(); )
+	{
+		if (m_tBindings[i].pBody == pBody)
+		{
+			CCSprite* pSprite = m_tBindings[i].pSprite;
+			m_tBindings[i] = m_tBindings.back();
+			m_tBindings.pop_back();
+			pSprite->release();
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+void CCPhysicsNode::unbindAll()
+{
+	for (unsigned int i = 0; i < m_tBindings.size(); ++i)
+	{
+		m_tBindings[i].pSprite->release();
+	}
+	m_tBindings.clear();
+}
+
+float CCPhysicsNode::getInterpolationAlpha()
+{
+	return m_fAccumulator / m_fFixedTimeStep;
+}
+
+void CCPhysicsNode::update(ccTime dt)
+{
+	CCAssert(m_fFixedTimeStep > 0, "CCPhysicsNode: fixedTimeStep must be positive");
+
+	m_fAccumulator += dt;
+
+	int nSteps = (int)(m_fAccumulator / m_fFixedTimeStep);
+	if (nSteps > m_nMaxSubSteps)
+	{
+		// the simulation can't keep up, slow it down instead of spiraling
+		nSteps = m_nMaxSubSteps;
+		m_fAccumulator = nSteps * m_fFixedTimeStep;
+	}
+	m_fAccumulator -= nSteps * m_fFixedTimeStep;
+	if (m_fAccumulator < 0)
+	{
+		m_fAccumulator = 0;
+	}
+	m_nLastStepCount = nSteps;
+
+	if (nSteps > 0)
+	{
+		// the forces of the frame apply to all its steps
+		bool bAutoClearForces = m_pWorld->GetAutoClearForces();
+		m_pWorld->SetAutoClearForces(false);
+
+		for (int i = 0; i < nSteps; ++i)
+		{
+			if (i == nSteps - 1)
+			{
+				for (unsigned int j = 0; j < m_tBindings.size(); ++j)
+				{
+					ccPhysicsBinding& binding = m_tBindings[j];
+					binding.tPreviousPosition = binding.pBody->GetPosition();
+					binding.fPreviousAngle = binding.pBody->GetAngle();
+				}
+			}
+
+			m_pWorld->Step(m_fFixedTimeStep, m_nVelocityIterations, m_nPositionIterations);
+		}
+
+		m_pWorld->SetAutoClearForces(bAutoClearForces);
+		if (bAutoClearForces)
+		{
+			m_pWorld->ClearForces();
+		}
+	}
+
+	updateSprites(m_bIsInterpolating ? getInterpolationAlpha() : 1.0f);
+}
+
+void CCPhysicsNode::syncSprites()
+{
+	for (unsigned int i = 0; i < m_tBindings.size(); ++i)
+	{
+		ccPhysicsBinding& binding = m_tBindings[i];
+		binding.tPreviousPosition = binding.pBody->GetPosition();
+		binding.fPreviousAngle = binding.pBody->GetAngle();
+	}
+
+	updateSprites(1.0f);
+}
+
+void CCPhysicsNode::updateSprites(float fAlpha)
+{
+	float fBeta = 1.0f - fAlpha;
+
+	for (unsigned int i = 0; i < m_tBindings.size(); ++i)
+	{
+		ccPhysicsBinding& binding = m_tBindings[i];
+
+		b2Vec2 position = binding.pBody->GetPosition();
+		float32 angle = binding.pBody->GetAngle();
+		if (fAlpha < 1.0f && (!(position == binding.tPreviousPosition) || angle != binding.fPreviousAngle))
+		{
+			position = fBeta * binding.tPreviousPosition + fAlpha * position;
+			angle = fBeta * binding.fPreviousAngle + fAlpha * angle;
+		}
+
+		CCPoint tSpritePosition = CCPointMake(position.x * m_fPtmRatio, position.y * m_fPtmRatio);
+		float fSpriteRotation = -CC_RADIANS_TO_DEGREES(angle);
+
+		// sleeping and static bodies don't dirty their sprites
+		if (tSpritePosition.x == binding.tSpritePosition.x && tSpritePosition.y == binding.tSpritePosition.y
+			&& fSpriteRotation == binding.fSpriteRotation)
+		{
+			continue;
+		}
+
+		binding.tSpritePosition = tSpritePosition;
+		binding.fSpriteRotation = fSpriteRotation;
+		binding.pSprite->setPositionAndRotation(tSpritePosition, fSpriteRotation);
+	}
+}
+
+} // namespace cocos2d
+
+#endif // CC_ENABLE_BOX2D_INTEGRATION
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "CCFileUtils.h"
 #include "DirectXHelper.h"
 #include "BasicLoader.h"
+#include "support/CCProfiling.h"
 
 using namespace std;
 using namespace DirectX;
@@ -914,12 +915,15 @@ void CCDXProgressTimer::RenderShader(int& vertexDataCount,CCSprite *pSprite)
 	CCID3D11DeviceContext->PSSetShader(m_pixelShader, NULL, 0);
 	CCID3D11DeviceContext->PSSetSamplers(0, 1, pSprite->getTexture()->GetSamplerState());
 	CCID3D11DeviceContext->Draw(vertexDataCount,0);
+	CCFrameProfiler::addDrawCall(0);
 	return;
 }
 
 
 void CCDXProgressTimer::Render(ccV2F_C4B_T2F *vertexData,int& vertexDataCount,CCProgressTimerType eType,CCSprite *pSprite)
 {
+	CCD3DCLASS->D3DFlushBatch();
+
 	if ( !mIsInit )
 	{
 		mIsInit = TRUE;
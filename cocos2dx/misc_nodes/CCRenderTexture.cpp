@@ -535,6 +535,8 @@ void CCRenderTexture::Shutdown()
 
 void CCRenderTexture::SetRenderTarget(ID3D11DeviceContext* deviceContext, ID3D11DepthStencilView* depthStencilView)
 {
+	CCD3DCLASS->D3DFlushBatch();
+
 	// Bind the render target view and depth stencil buffer to the output render pipeline.
 	deviceContext->OMSetRenderTargets(1, &m_renderTargetView, depthStencilView);
 
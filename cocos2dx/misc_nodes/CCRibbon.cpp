@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "DirectXHelper.h"
 #include <fstream>
 #include "BasicLoader.h"
+#include "support/CCProfiling.h"
 
 using namespace std;
 using namespace DirectX;
@@ -638,6 +639,7 @@ void CCDXRibbonSegment::RenderShader(unsigned int begin,unsigned int end,CCTextu
 	CCID3D11DeviceContext->PSSetShader(m_pixelShader, NULL, 0);
 	CCID3D11DeviceContext->PSSetSamplers(0, 1, texture->GetSamplerState());
 	CCID3D11DeviceContext->Draw((end - begin)*2,begin*2);
+	CCFrameProfiler::addDrawCall(0);
 
 	return;
 }
@@ -645,6 +647,7 @@ void CCDXRibbonSegment::RenderShader(unsigned int begin,unsigned int end,CCTextu
 
 void CCDXRibbonSegment::Render(CCfloat* verts,CCfloat* coords,CCubyte* colors,unsigned int begin,unsigned int end,CCTexture2D* texture)
 {
+	CCD3DCLASS->D3DFlushBatch();
 
 	if ( !mIsInit )
 	{
@@ -0,0 +1,409 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CCParticleStore.h"
+#include "CCParticleSystem.h"
+#include "ccConfig.h"
+#include "ccMacros.h"
+#include <math.h>
+#include <string.h>
+
+#if CC_PARTICLE_SYSTEM_SIMD && (defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__))
+#define CC_PARTICLE_USE_SSE 1
+#include <xmmintrin.h>
+#else
+#define CC_PARTICLE_USE_SSE 0
+#endif
+
+namespace cocos2d {
+
+CCParticleStore::CCParticleStore()
+: m_pBuffer(NULL)
+, m_uCapacity(0)
+{
+	memset(m_pAttributes, 0, sizeof(m_pAttributes));
+}
+
+CCParticleStore::~CCParticleStore()
+{
+	CC_SAFE_DELETE_ARRAY(m_pBuffer);
+}
+
+bool CCParticleStore::initWithCapacity(unsigned int uCapacity)
+{
+	CC_SAFE_DELETE_ARRAY(m_pBuffer);
+	memset(m_pAttributes, 0, sizeof(m_pAttributes));
+	m_uCapacity = 0;
+
+	// every array starts on a 16 bytes boundary
+	unsigned int uStride = (uCapacity + 3) & ~3u;
+	m_pBuffer = new float[uStride * kCCParticleAttributeCount + 3];
+	if (! m_pBuffer)
+	{
+		return false;
+	}
+	memset(m_pBuffer, 0, sizeof(float) * (uStride * kCCParticleAttributeCount + 3));
+
+	float *pAligned = (float*)(((size_t)m_pBuffer + 15) & ~(size_t)15);
+	for (int i = 0; i < kCCParticleAttributeCount; ++i)
+	{
+		m_pAttributes[i] = pAligned + i * uStride;
+	}
+	m_uCapacity = uCapacity;
+
+	return true;
+}
+
+void CCParticleStore::setParticle(unsigned int uIndex, const tCCParticle *particle)
+{
+	CCAssert(uIndex < m_uCapacity, "particle index out of range");
+
+	float **a = m_pAttributes;
+	a[kCCParticlePosX][uIndex] = particle->pos.x;
+	a[kCCParticlePosY][uIndex] = particle->pos.y;
+	a[kCCParticleStartPosX][uIndex] = particle->startPos.x;
+	a[kCCParticleStartPosY][uIndex] = particle->startPos.y;
+	a[kCCParticleColorR][uIndex] = particle->color.r;
+	a[kCCParticleColorG][uIndex] = particle->color.g;
+	a[kCCParticleColorB][uIndex] = particle->color.b;
+	a[kCCParticleColorA][uIndex] = particle->color.a;
+	a[kCCParticleDeltaColorR][uIndex] = particle->deltaColor.r;
+	a[kCCParticleDeltaColorG][uIndex] = particle->deltaColor.g;
+	a[kCCParticleDeltaColorB][uIndex] = particle->deltaColor.b;
+	a[kCCParticleDeltaColorA][uIndex] = particle->deltaColor.a;
+	a[kCCParticleSize][uIndex] = particle->size;
+	a[kCCParticleDeltaSize][uIndex] = particle->deltaSize;
+	a[kCCParticleRotation][uIndex] = particle->rotation;
+	a[kCCParticleDeltaRotation][uIndex] = particle->deltaRotation;
+	a[kCCParticleTimeToLive][uIndex] = particle->timeToLive;
+	a[kCCParticleDirX][uIndex] = particle->modeA.dir.x;
+	a[kCCParticleDirY][uIndex] = particle->modeA.dir.y;
+	a[kCCParticleRadialAccel][uIndex] = particle->modeA.radialAccel;
+	a[kCCParticleTangentialAccel][uIndex] = particle->modeA.tangentialAccel;
+	a[kCCParticleAngle][uIndex] = particle->modeB.angle;
+	a[kCCParticleDegreesPerSecond][uIndex] = particle->modeB.degreesPerSecond;
+	a[kCCParticleRadius][uIndex] = particle->modeB.radius;
+	a[kCCParticleDeltaRadius][uIndex] = particle->modeB.deltaRadius;
+}
+
+void CCParticleStore::getParticle(unsigned int uIndex, tCCParticle *particle)
+{
+	CCAssert(uIndex < m_uCapacity, "particle index out of range");
+
+	float **a = m_pAttributes;
+	particle->pos.x = a[kCCParticlePosX][uIndex];
+	particle->pos.y = a[kCCParticlePosY][uIndex];
+	particle->startPos.x = a[kCCParticleStartPosX][uIndex];
+	particle->startPos.y = a[kCCParticleStartPosY][uIndex];
+	particle->color.r = a[kCCParticleColorR][uIndex];
+	particle->color.g = a[kCCParticleColorG][uIndex];
+	particle->color.b = a[kCCParticleColorB][uIndex];
+	particle->color.a = a[kCCParticleColorA][uIndex];
+	particle->deltaColor.r = a[kCCParticleDeltaColorR][uIndex];
+	particle->deltaColor.g = a[kCCParticleDeltaColorG][uIndex];
+	particle->deltaColor.b = a[kCCParticleDeltaColorB][uIndex];
+	particle->deltaColor.a = a[kCCParticleDeltaColorA][uIndex];
+	particle->size = a[kCCParticleSize][uIndex];
+	particle->deltaSize = a[kCCParticleDeltaSize][uIndex];
+	particle->rotation = a[kCCParticleRotation][uIndex];
+	particle->deltaRotation = a[kCCParticleDeltaRotation][uIndex];
+	particle->timeToLive = a[kCCParticleTimeToLive][uIndex];
+	particle->modeA.dir.x = a[kCCParticleDirX][uIndex];
+	particle->modeA.dir.y = a[kCCParticleDirY][uIndex];
+	particle->modeA.radialAccel = a[kCCParticleRadialAccel][uIndex];
+	particle->modeA.tangentialAccel = a[kCCParticleTangentialAccel][uIndex];
+	particle->modeB.angle = a[kCCParticleAngle][uIndex];
+	particle->modeB.degreesPerSecond = a[kCCParticleDegreesPerSecond][uIndex];
+	particle->modeB.radius = a[kCCParticleRadius][uIndex];
+	particle->modeB.deltaRadius = a[kCCParticleDeltaRadius][uIndex];
+}
+
+void CCParticleStore::copyParticle(unsigned int uDst, unsigned int uSrc)
+{
+	for (int i = 0; i < kCCParticleAttributeCount; ++i)
+	{
+		m_pAttributes[i][uDst] = m_pAttributes[i][uSrc];
+	}
+}
+
+void CCParticleStore::updateLife(unsigned int uCount, ccTime dt)
+{
+	float *timeToLive = m_pAttributes[kCCParticleTimeToLive];
+	unsigned int i = 0;
+
+#if CC_PARTICLE_USE_SSE
+	__m128 vdt = _mm_set1_ps(dt);
+	for (; i + 4 <= uCount; i += 4)
+	{
+		_mm_store_ps(timeToLive + i, _mm_sub_ps(_mm_load_ps(timeToLive + i), vdt));
+	}
+#endif
+
+	for (; i < uCount; ++i)
+	{
+		timeToLive[i] -= dt;
+	}
+}
+
+unsigned int CCParticleStore::removeDeadParticles(unsigned int uCount)
+{
+	const float *timeToLive = m_pAttributes[kCCParticleTimeToLive];
+	unsigned int i = 0;
+	while (i < uCount)
+	{
+		if (timeToLive[i] > 0)
+		{
+			++i;
+		}
+		else
+		{
+			// same order as the former per particle loop: the last particle takes the slot
+			if (i != uCount - 1)
+			{
+				copyParticle(i, uCount - 1);
+			}
+			--uCount;
+		}
+	}
+
+	return uCount;
+}
+
+void CCParticleStore::updateGravityMode(unsigned int uCount, ccTime dt, const CCPoint& gravity)
+{
+	float *posX = m_pAttributes[kCCParticlePosX];
+	float *posY = m_pAttributes[kCCParticlePosY];
+	float *dirX = m_pAttributes[kCCParticleDirX];
+	float *dirY = m_pAttributes[kCCParticleDirY];
+	const float *radialAccel = m_pAttributes[kCCParticleRadialAccel];
+	const float *tangentialAccel = m_pAttributes[kCCParticleTangentialAccel];
+	unsigned int i = 0;
+
+#if CC_PARTICLE_USE_SSE
+	const __m128 vzero = _mm_setzero_ps();
+	const __m128 vone = _mm_set1_ps(1.0f);
+	const __m128 vsign = _mm_set1_ps(-0.0f);
+	const __m128 vdt = _mm_set1_ps(dt);
+	const __m128 vgx = _mm_set1_ps(gravity.x);
+	const __m128 vgy = _mm_set1_ps(gravity.y);
+	for (; i + 4 <= uCount; i += 4)
+	{
+		__m128 px = _mm_load_ps(posX + i);
+		__m128 py = _mm_load_ps(posY + i);
+
+		// radial = normalize(pos), or zero at the origin
+		__m128 mask = _mm_or_ps(_mm_cmpneq_ps(px, vzero), _mm_cmpneq_ps(py, vzero));
+		__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(px, px), _mm_mul_ps(py, py)));
+		__m128 inv = _mm_div_ps(vone, length);
+		__m128 rx = _mm_and_ps(_mm_mul_ps(px, inv), mask);
+		__m128 ry = _mm_and_ps(_mm_mul_ps(py, inv), mask);
+
+		// tangential = perpendicular of radial
+		__m128 ta = _mm_load_ps(tangentialAccel + i);
+		__m128 tx = _mm_mul_ps(_mm_xor_ps(ry, vsign), ta);
+		__m128 ty = _mm_mul_ps(rx, ta);
+
+		__m128 ra = _mm_load_ps(radialAccel + i);
+		rx = _mm_mul_ps(rx, ra);
+		ry = _mm_mul_ps(ry, ra);
+
+		// (gravity + radial + tangential) * dt
+		__m128 ax = _mm_mul_ps(_mm_add_ps(_mm_add_ps(rx, tx), vgx), vdt);
+		__m128 ay = _mm_mul_ps(_mm_add_ps(_mm_add_ps(ry, ty), vgy), vdt);
+
+		__m128 dx = _mm_add_ps(_mm_load_ps(dirX + i), ax);
+		__m128 dy = _mm_add_ps(_mm_load_ps(dirY + i), ay);
+		_mm_store_ps(dirX + i, dx);
+		_mm_store_ps(dirY + i, dy);
+		_mm_store_ps(posX + i, _mm_add_ps(px, _mm_mul_ps(dx, vdt)));
+		_mm_store_ps(posY + i, _mm_add_ps(py, _mm_mul_ps(dy, vdt)));
+	}
+#endif
+
+	for (; i < uCount; ++i)
+	{
+		float px = posX[i];
+		float py = posY[i];
+
+		// radial acceleration
+		float rx = 0;
+		float ry = 0;
+		if (px || py)
+		{
+			float inv = 1.0f / sqrtf(px * px + py * py);
+			rx = px * inv;
+			ry = py * inv;
+		}
+
+		// tangential acceleration
+		float tx = -ry * tangentialAccel[i];
+		float ty = rx * tangentialAccel[i];
+		rx *= radialAccel[i];
+		ry *= radialAccel[i];
+
+		// (gravity + radial + tangential) * dt
+		dirX[i] += (rx + tx + gravity.x) * dt;
+		dirY[i] += (ry + ty + gravity.y) * dt;
+		posX[i] = px + dirX[i] * dt;
+		posY[i] = py + dirY[i] * dt;
+	}
+}
+
+void CCParticleStore::updateRadiusMode(unsigned int uCount, ccTime dt)
+{
+	float *posX = m_pAttributes[kCCParticlePosX];
+	float *posY = m_pAttributes[kCCParticlePosY];
+	float *angle = m_pAttributes[kCCParticleAngle];
+	float *radius = m_pAttributes[kCCParticleRadius];
+	const float *degreesPerSecond = m_pAttributes[kCCParticleDegreesPerSecond];
+	const float *deltaRadius = m_pAttributes[kCCParticleDeltaRadius];
+
+	// there is no vector sine, the loop is kept branch free so the compiler can schedule it
+	for (unsigned int i = 0; i < uCount; ++i)
+	{
+		angle[i] += degreesPerSecond[i] * dt;
+		radius[i] += deltaRadius[i] * dt;
+
+		posX[i] = - cosf(angle[i]) * radius[i];
+		posY[i] = - sinf(angle[i]) * radius[i];
+	}
+}
+
+void CCParticleStore::updateColorSizeRotation(unsigned int uCount, ccTime dt)
+{
+	static const int s_nIntegrated[][2] = {
+		{ kCCParticleColorR, kCCParticleDeltaColorR },
+		{ kCCParticleColorG, kCCParticleDeltaColorG },
+		{ kCCParticleColorB, kCCParticleDeltaColorB },
+		{ kCCParticleColorA, kCCParticleDeltaColorA },
+		{ kCCParticleRotation, kCCParticleDeltaRotation },
+	};
+
+	for (unsigned int n = 0; n < sizeof(s_nIntegrated) / sizeof(s_nIntegrated[0]); ++n)
+	{
+		float *value = m_pAttributes[s_nIntegrated[n][0]];
+		const float *delta = m_pAttributes[s_nIntegrated[n][1]];
+		unsigned int i = 0;
+
+#if CC_PARTICLE_USE_SSE
+		__m128 vdt = _mm_set1_ps(dt);
+		for (; i + 4 <= uCount; i += 4)
+		{
+			_mm_store_ps(value + i, _mm_add_ps(_mm_load_ps(value + i), _mm_mul_ps(_mm_load_ps(delta + i), vdt)));
+		}
+#endif
+
+		for (; i < uCount; ++i)
+		{
+			value[i] += delta[i] * dt;
+		}
+	}
+
+	// size, no negative values
+	float *size = m_pAttributes[kCCParticleSize];
+	const float *deltaSize = m_pAttributes[kCCParticleDeltaSize];
+	unsigned int i = 0;
+
+#if CC_PARTICLE_USE_SSE
+	const __m128 vzero = _mm_setzero_ps();
+	const __m128 vdt = _mm_set1_ps(dt);
+	for (; i + 4 <= uCount; i += 4)
+	{
+		__m128 s = _mm_add_ps(_mm_load_ps(size + i), _mm_mul_ps(_mm_load_ps(deltaSize + i), vdt));
+		_mm_store_ps(size + i, _mm_max_ps(s, vzero));
+	}
+#endif
+
+	for (; i < uCount; ++i)
+	{
+		size[i] += deltaSize[i] * dt;
+		size[i] = MAX(0, size[i]);
+	}
+}
+
+void CCParticleStore::updateQuads(ccV2F_C4B_T2F_Quad *pQuads, unsigned int uCount, bool bRelative, const CCPoint& currentPosition)
+{
+	const float *posX = m_pAttributes[kCCParticlePosX];
+	const float *posY = m_pAttributes[kCCParticlePosY];
+	const float *startPosX = m_pAttributes[kCCParticleStartPosX];
+	const float *startPosY = m_pAttributes[kCCParticleStartPosY];
+	const float *colorR = m_pAttributes[kCCParticleColorR];
+	const float *colorG = m_pAttributes[kCCParticleColorG];
+	const float *colorB = m_pAttributes[kCCParticleColorB];
+	const float *colorA = m_pAttributes[kCCParticleColorA];
+	const float *size = m_pAttributes[kCCParticleSize];
+	const float *rotation = m_pAttributes[kCCParticleRotation];
+
+	for (unsigned int i = 0; i < uCount; ++i)
+	{
+		ccV2F_C4B_T2F_Quad *quad = &pQuads[i];
+
+		float x = posX[i];
+		float y = posY[i];
+		if (bRelative)
+		{
+			x -= currentPosition.x - startPosX[i];
+			y -= currentPosition.y - startPosY[i];
+		}
+
+		// colors
+		ccColor4B color = {(CCubyte)(colorR[i] * 255), (CCubyte)(colorG[i] * 255), (CCubyte)(colorB[i] * 255),
+			(CCubyte)(colorA[i] * 255)};
+		quad->bl.colors = color;
+		quad->br.colors = color;
+		quad->tl.colors = color;
+		quad->tr.colors = color;
+
+		// vertices
+		float size_2 = size[i] / 2;
+		if (rotation[i])
+		{
+			float r = (float)-CC_DEGREES_TO_RADIANS(rotation[i]);
+			float cr = cosf(r);
+			float sr = sinf(r);
+
+			// corners (-size_2, -size_2), (size_2, -size_2), (size_2, size_2), (-size_2, size_2)
+			quad->bl.vertices.x = -size_2 * cr + size_2 * sr + x;
+			quad->bl.vertices.y = -size_2 * sr - size_2 * cr + y;
+			quad->br.vertices.x = size_2 * cr + size_2 * sr + x;
+			quad->br.vertices.y = size_2 * sr - size_2 * cr + y;
+			quad->tr.vertices.x = size_2 * cr - size_2 * sr + x;
+			quad->tr.vertices.y = size_2 * sr + size_2 * cr + y;
+			quad->tl.vertices.x = -size_2 * cr - size_2 * sr + x;
+			quad->tl.vertices.y = -size_2 * sr + size_2 * cr + y;
+		}
+		else
+		{
+			quad->bl.vertices.x = x - size_2;
+			quad->bl.vertices.y = y - size_2;
+			quad->br.vertices.x = x + size_2;
+			quad->br.vertices.y = y - size_2;
+			quad->tl.vertices.x = x - size_2;
+			quad->tl.vertices.y = y + size_2;
+			quad->tr.vertices.x = x + size_2;
+			quad->tr.vertices.y = y + size_2;
+		}
+	}
+}
+
+}// namespace cocos2d
@@ -55,9 +55,7 @@ THE SOFTWARE.
 // opengl
 #include "platform/CCGL.h"
 
-#if CC_ENABLE_PROFILERS
-#include "Support/CCProfiling.h"
-#endif
+#include "support/CCProfiling.h"
 
 namespace cocos2d {
 
@@ -81,7 +79,6 @@ namespace cocos2d {
 CCParticleSystem::CCParticleSystem()
 	:m_sPlistFile("")
 	,m_fElapsed(0)
-	,m_pParticles(NULL)
 	,m_fEmitCounter(0)
 	,m_uParticleIdx(0)
 #if CC_ENABLE_PROFILERS
@@ -330,11 +327,7 @@ bool CCParticleSystem::initWithTotalParticles(unsigned int numberOfParticles)
 {
 	m_uTotalParticles = numberOfParticles;
 
-    CC_SAFE_DELETE_ARRAY(m_pParticles);
-	
-	m_pParticles = new tCCParticle[m_uTotalParticles];
-
-	if( ! m_pParticles )
+	if( ! m_tParticleStore.initWithCapacity(m_uTotalParticles) )
 	{
 		CCLOG("Particle system: not enough memory");
 		this->release();
@@ -377,7 +370,6 @@ bool CCParticleSystem::initWithTotalParticles(unsigned int numberOfParticles)
 
 CCParticleSystem::~CCParticleSystem()
 {
-    CC_SAFE_DELETE_ARRAY(m_pParticles);
 	CC_SAFE_RELEASE(m_pTexture)
 	// profiling
 #if CC_ENABLE_PROFILERS
@@ -391,8 +383,9 @@ bool CCParticleSystem::addParticle()
 		return false;
 	}
 
-	tCCParticle * particle = &m_pParticles[ m_uParticleCount ];
-	this->initParticle(particle);
+	tCCParticle particle;
+	this->initParticle(&particle);
+	m_tParticleStore.setParticle(m_uParticleCount, &particle);
 	++m_uParticleCount;
 
 	return true;
@@ -516,10 +509,10 @@ void CCParticleSystem::resetSystem()
 {
 	m_bIsActive = true;
 	m_fElapsed = 0;
+	float *timeToLive = m_tParticleStore.getAttribute(kCCParticleTimeToLive);
 	for (m_uParticleIdx = 0; m_uParticleIdx < m_uParticleCount; ++m_uParticleIdx)
 	{
-		tCCParticle *p = &m_pParticles[m_uParticleIdx];
-		p->timeToLive = 0;
+		timeToLive[m_uParticleIdx] = 0;
 	}
 }
 bool CCParticleSystem::isFull()
@@ -530,6 +523,8 @@ bool CCParticleSystem::isFull()
 // ParticleSystem - MainLoop
 void CCParticleSystem::update(ccTime dt)
 {
+	CCProfileScope scope(kCCProfilePhaseParticles);
+
 	if( m_bIsActive && m_fEmissionRate )
 	{
 		float rate = 1.0f / m_fEmissionRate;
@@ -550,11 +545,6 @@ void CCParticleSystem::update(ccTime dt)
 	m_uParticleIdx = 0;
 
 
-#if CC_ENABLE_PROFILERS
-	/// @todo CCProfilingBeginTimingBlock(_profilingTimer);
-#endif
-
-
 	CCPoint currentPosition = CCPointZero;
 	if( m_ePositionType == kCCPositionTypeFree )
 	{
@@ -569,108 +559,40 @@ void CCParticleSystem::update(ccTime dt)
         currentPosition.y *= CC_CONTENT_SCALE_FACTOR();
     }
 
-	while( m_uParticleIdx < m_uParticleCount )
-	{
-		tCCParticle *p = &m_pParticles[m_uParticleIdx];
+	// life
+	m_tParticleStore.updateLife(m_uParticleCount, dt);
 
-		// life
-		p->timeToLive -= dt;
+	unsigned int uLiving = m_tParticleStore.removeDeadParticles(m_uParticleCount);
+	if( uLiving != m_uParticleCount )
+	{
+		m_uParticleCount = uLiving;
 
-		if( p->timeToLive > 0 ) 
+		if( m_uParticleCount == 0 && m_bIsAutoRemoveOnFinish )
 		{
-			// Mode A: gravity, direction, tangential accel & radial accel
-			if( m_nEmitterMode == kCCParticleModeGravity ) 
-			{
-				CCPoint tmp, radial, tangential;
-
-				radial = CCPointZero;
-				// radial acceleration
-				if(p->pos.x || p->pos.y)
-					radial = ccpNormalize(p->pos);
-				tangential = radial;
-				radial = ccpMult(radial, p->modeA.radialAccel);
-
-				// tangential acceleration
-				float newy = tangential.x;
-				tangential.x = -tangential.y;
-				tangential.y = newy;
-				tangential = ccpMult(tangential, p->modeA.tangentialAccel);
-
-				// (gravity + radial + tangential) * dt
-				tmp = ccpAdd( ccpAdd( radial, tangential), modeA.gravity);
-				tmp = ccpMult( tmp, dt);
-				p->modeA.dir = ccpAdd( p->modeA.dir, tmp);
-				tmp = ccpMult(p->modeA.dir, dt);
-				p->pos = ccpAdd( p->pos, tmp );
-			}
-
-			// Mode B: radius movement
-			else {				
-				// Update the angle and radius of the particle.
-				p->modeB.angle += p->modeB.degreesPerSecond * dt;
-				p->modeB.radius += p->modeB.deltaRadius * dt;
-
-				p->pos.x = - cosf(p->modeB.angle) * p->modeB.radius;
-				p->pos.y = - sinf(p->modeB.angle) * p->modeB.radius;
-			}
-
-			// color
-			p->color.r += (p->deltaColor.r * dt);
-			p->color.g += (p->deltaColor.g * dt);
-			p->color.b += (p->deltaColor.b * dt);
-			p->color.a += (p->deltaColor.a * dt);
-
-			// size
-			p->size += (p->deltaSize * dt);
-			p->size = MAX( 0, p->size );
-
-			// angle
-			p->rotation += (p->deltaRotation * dt);
-
-			//
-			// update values in quad
-			//
-
-			CCPoint	newPos;
-
-			if( m_ePositionType == kCCPositionTypeFree || m_ePositionType == kCCPositionTypeRelative ) 
-			{
-				CCPoint diff = ccpSub( currentPosition, p->startPos );
-				newPos = ccpSub(p->pos, diff);
-			} 
-			else
-			{
-				newPos = p->pos;
-			}
-
-			updateQuadWithParticle(p, newPos);
-			//updateParticleImp(self, updateParticleSel, p, newPos);
-
-			// update particle counter
-			++m_uParticleIdx;
+			this->unscheduleUpdate();
+			m_pParent->removeChild(this, true);
+			return;
+		}
+	}
 
-		} 
-		else 
-		{
-			// life < 0
-			if( m_uParticleIdx != m_uParticleCount-1 )
-			{
-				m_pParticles[m_uParticleIdx] = m_pParticles[m_uParticleCount-1];
-			}
-			--m_uParticleCount;
+	// Mode A: gravity, direction, tangential accel & radial accel
+	if( m_nEmitterMode == kCCParticleModeGravity ) 
+	{
+		m_tParticleStore.updateGravityMode(m_uParticleCount, dt, modeA.gravity);
+	}
 
-			if( m_uParticleCount == 0 && m_bIsAutoRemoveOnFinish )
-			{
-				this->unscheduleUpdate();
-				m_pParent->removeChild(this, true);
-				return;
-			}
-		}
+	// Mode B: radius movement
+	else {
+		m_tParticleStore.updateRadiusMode(m_uParticleCount, dt);
 	}
 
-#if CC_ENABLE_PROFILERS
-	/// @todo CCProfilingEndTimingBlock(_profilingTimer);
-#endif
+	// color, size and angle
+	m_tParticleStore.updateColorSizeRotation(m_uParticleCount, dt);
+
+	//
+	// update values in quad
+	//
+	this->updateQuadsWithParticles(currentPosition);
 
 //#ifdef CC_USES_VBO
 	this->postStep();
@@ -682,6 +604,25 @@ void CCParticleSystem::updateQuadWithParticle(tCCParticle* particle, const CCPoi
     CC_UNUSED_PARAM(newPosition);
 	// should be overriden
 }
+void CCParticleSystem::updateQuadsWithParticles(const CCPoint& currentPosition)
+{
+	bool bRelative = (m_ePositionType == kCCPositionTypeFree || m_ePositionType == kCCPositionTypeRelative);
+
+	tCCParticle particle;
+	for (m_uParticleIdx = 0; m_uParticleIdx < m_uParticleCount; ++m_uParticleIdx)
+	{
+		m_tParticleStore.getParticle(m_uParticleIdx, &particle);
+
+		CCPoint	newPos = particle.pos;
+		if( bRelative )
+		{
+			CCPoint diff = ccpSub( currentPosition, particle.startPos );
+			newPos = ccpSub( particle.pos, diff );
+		}
+
+		updateQuadWithParticle(&particle, newPos);
+	}
+}
 void CCParticleSystem::postStep()
 {
 	// should be overriden
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "CCFileUtils.h"
 #include "DirectXHelper.h"
 #include "BasicLoader.h"
+#include "support/CCProfiling.h"
 
 using namespace std;
 using namespace DirectX;
@@ -286,6 +287,13 @@ void CCParticleSystemQuad::updateQuadWithParticle(tCCParticle* particle, const C
 		quad->tr.vertices.y = newPosition.y + size_2;				
 	}
 }
+void CCParticleSystemQuad::updateQuadsWithParticles(const CCPoint& currentPosition)
+{
+	// the quads are written straight from the particle store, updateQuadWithParticle is not called
+	bool bRelative = (m_ePositionType == kCCPositionTypeFree || m_ePositionType == kCCPositionTypeRelative);
+	m_tParticleStore.updateQuads(m_pQuads, m_uParticleCount, bRelative, currentPosition);
+	m_uParticleIdx = m_uParticleCount;
+}
 void CCParticleSystemQuad::postStep()
 {
 #if CC_USES_VBO
@@ -626,12 +634,14 @@ void CCDXParticleSystemQuad::RenderShader(unsigned int particleIdx,CCTexture2D*
 	//CCLog("CCDXParticleSystemQuad:RenderShader(idx:%d, m_indexCount:)",particleIdx);
 	// Render the triangle.
 	CCID3D11DeviceContext->DrawIndexed((particleIdx*6),0, 0 );
+	CCFrameProfiler::addDrawCall(particleIdx);
 
 	return;
 }
 
 void CCDXParticleSystemQuad::Render(ccV2F_C4B_T2F_Quad *quad,unsigned short* indices,unsigned int uTotalParticles,unsigned int particleIdx,CCTexture2D* texture)
 {
+	CCD3DCLASS->D3DFlushBatch();
 
 	if ( !m_bIsInit )
 	{
@@ -28,6 +28,10 @@ THE SOFTWARE.
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS) && (CC_TARGET_PLATFORM != CC_PLATFORM_AIRPLAY)
 
 #include <stack>
+#include <map>
+#include <set>
+#include <list>
+#include <mutex>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 #include <libxml/xmlmemory.h>
@@ -35,6 +39,7 @@ THE SOFTWARE.
 #include "CCString.h"
 #include "CCSAXParser.h"
 #include "support/zip_support/unzip.h"
+#include "support/zip_support/CCZipArchive.h"
 
 NS_CC_BEGIN;
 
@@ -356,124 +361,345 @@ CCMutableArray<CCObject*>* CCFileUtils::arrayWithContentsOfFile(const char* pFil
     return ret;
 }
 
-unsigned int BKDRHash(char *str)
+//////////////////////////////////////////////////////////////////////////
+// Shared file buffers
+//////////////////////////////////////////////////////////////////////////
+
+CCFileBuffer::CCFileBuffer(unsigned char* pBytes, unsigned long uSize)
+: m_pBytes(pBytes)
+, m_uSize(uSize)
+, m_nReferenceCount(1)
+{
+}
+
+CCFileBuffer::~CCFileBuffer()
+{
+    CC_SAFE_DELETE_ARRAY(m_pBytes);
+}
+
+void CCFileBuffer::retain()
 {
-    unsigned int seed = 131; // 31 131 1313 13131 131313 etc..
-    unsigned int hash = 0;
+    ++m_nReferenceCount;
+}
 
-    while (*str)
+void CCFileBuffer::release()
+{
+    CCAssert(m_nReferenceCount > 0, "reference count should greater than 0");
+    if (--m_nReferenceCount == 0)
     {
-        hash = hash * seed + (*str++);
+        delete this;
     }
-
-    return (hash & 0x7FFFFFFF);
 }
 
-class CacheDataInfo
+// files are cached by full path and read mode: "rt" and "rb" may not give the same bytes
+typedef std::pair<std::string, std::string> CCFileCacheKey;
+
+class CCFileCache
 {
+    struct Entry
+    {
+        CCFileBuffer* pBuffer;
+        std::list<CCFileCacheKey>::iterator lruPosition;
+    };
+
+    std::mutex m_mutex;
+    std::map<CCFileCacheKey, Entry> m_entries;
+    // most recently used first
+    std::list<CCFileCacheKey> m_lru;
+    unsigned long m_uCachedSize;
+    unsigned long m_uCacheSize;
+    // the files written at runtime are under this path, they aren't cached
+    std::string m_sWriteablePath;
+    bool m_bWriteablePathInitialized;
+
 public:
-    CacheDataInfo()
-    : data(NULL)
-    , size(0)
+    CCFileCache()
+    : m_uCachedSize(0)
+    , m_uCacheSize(CC_FILE_CACHE_SIZE)
+    , m_bWriteablePathInitialized(false)
     {
     }
 
-    ~CacheDataInfo()
+    ~CCFileCache()
     {
-        CC_SAFE_DELETE_ARRAY(data);
+        purge();
     }
 
-    unsigned char* data;
-    unsigned long size;
-};
+    CCFileBuffer* getFileBuffer(const char* pszFileName, const char* pszMode)
+    {
+        CCFileCacheKey key(CCFileUtils::fullPathFromRelativePathThreadSafe(pszFileName), pszMode);
 
-class CacheHandler
-{
-    std::map<unsigned int, CacheDataInfo*> * s_pCache;
-public:
-    CacheHandler() : s_pCache(0)
+        CCFileBuffer* pBuffer = lookUp(key);
+        if (pBuffer)
+        {
+            return pBuffer;
+        }
+
+        // read without holding the lock, the texture loading threads may be reading other files
+        unsigned long uSize = 0;
+        unsigned char* pBytes = CCFileUtils::getFileDataPlatform(key.first.c_str(), pszMode, &uSize);
+        if (! pBytes)
+        {
+            return NULL;
+        }
+        pBuffer = new CCFileBuffer(pBytes, uSize);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (isWriteable(key.first))
+        {
+            return pBuffer;
+        }
+
+        // another thread may have read the same file meanwhile
+        std::map<CCFileCacheKey, Entry>::iterator it = m_entries.find(key);
+        if (it != m_entries.end())
+        {
+            pBuffer->release();
+            return retainEntry(it->second);
+        }
+
+        if (uSize <= m_uCacheSize)
+        {
+            m_lru.push_front(key);
+            Entry entry = { pBuffer, m_lru.begin() };
+            m_entries.insert(std::make_pair(key, entry));
+            m_uCachedSize += uSize;
+            // the cache keeps its own reference
+            pBuffer->retain();
+            trim();
+        }
+        return pBuffer;
+    }
+
+    void purge()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::map<CCFileCacheKey, Entry>::iterator it;
+        for (it = m_entries.begin(); it != m_entries.end(); ++it)
+        {
+            it->second.pBuffer->release();
+        }
+        m_entries.clear();
+        m_lru.clear();
+        m_uCachedSize = 0;
+    }
+
+    // drops the file, in all the read modes
+    void remove(const char* pszFileName)
+    {
+        std::string fullPath = CCFileUtils::fullPathFromRelativePathThreadSafe(pszFileName);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::map<CCFileCacheKey, Entry>::iterator it = m_entries.lower_bound(CCFileCacheKey(fullPath, std::string()));
+        while (it != m_entries.end() && it->first.first == fullPath)
+        {
+            m_uCachedSize -= it->second.pBuffer->getSize();
+            it->second.pBuffer->release();
+            m_lru.erase(it->second.lruPosition);
+            m_entries.erase(it++);
+        }
+    }
+
+    void setCacheSize(unsigned long uBytes)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_uCacheSize = uBytes;
+        trim();
+    }
+
+    unsigned long getCacheSize()
     {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_uCacheSize;
+    }
 
+private:
+    CCFileBuffer* lookUp(const CCFileCacheKey& key)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::map<CCFileCacheKey, Entry>::iterator it = m_entries.find(key);
+        if (it == m_entries.end())
+        {
+            return NULL;
+        }
+        return retainEntry(it->second);
     }
 
-    ~CacheHandler()
+    // the lock must be held
+    bool isWriteable(const std::string& fullPath)
     {
-        CCFileUtils::purgeCachedFileData();
-        delete s_pCache;
+        if (! m_bWriteablePathInitialized)
+        {
+            m_sWriteablePath = CCFileUtils::getWriteablePath();
+            m_bWriteablePathInitialized = true;
+        }
+        return ! m_sWriteablePath.empty() && fullPath.compare(0, m_sWriteablePath.size(), m_sWriteablePath) == 0;
     }
 
-    std::map<unsigned int, CacheDataInfo*>& getCache()
+    // the lock must be held
+    CCFileBuffer* retainEntry(Entry& entry)
     {
-        if (! s_pCache)
+        m_lru.splice(m_lru.begin(), m_lru, entry.lruPosition);
+        entry.pBuffer->retain();
+        return entry.pBuffer;
+    }
+
+    // drops the least recently used files until the cache fits, the lock must be held.
+    // Buffers still borrowed by somebody stay alive until they are released.
+    void trim()
+    {
+        while (m_uCachedSize > m_uCacheSize && ! m_lru.empty())
         {
-            s_pCache = new std::map<unsigned int, CacheDataInfo*>;
+            std::map<CCFileCacheKey, Entry>::iterator it = m_entries.find(m_lru.back());
+            m_uCachedSize -= it->second.pBuffer->getSize();
+            it->second.pBuffer->release();
+            m_entries.erase(it);
+            m_lru.pop_back();
         }
-        return *s_pCache;
     }
 };
 
-static CacheHandler s_CacheHandler;
+static CCFileCache s_FileCache;
+
+CCFileBuffer* CCFileUtils::getFileBuffer(const char* pszFileName, const char* pszMode)
+{
+    return s_FileCache.getFileBuffer(pszFileName, pszMode);
+}
+
+void CCFileUtils::removeCachedFileData(const char* pszFileName)
+{
+    if (pszFileName)
+    {
+        s_FileCache.remove(pszFileName);
+    }
+}
+
+void CCFileUtils::setFileCacheSize(unsigned long uBytes)
+{
+    s_FileCache.setCacheSize(uBytes);
+}
+
+unsigned long CCFileUtils::getFileCacheSize()
+{
+    return s_FileCache.getCacheSize();
+}
 
 unsigned char* CCFileUtils::getFileData(const char* pszFileName, const char* pszMode, unsigned long * pSize)
 {
-    unsigned char * pBuffer = NULL;
-    std::string strFileName = pszFileName;
-    std::string extension = "";
-    int nExPos = strFileName.rfind('.');
-    if (nExPos != std::string::npos)
+    *pSize = 0;
+
+    CCFileBuffer* pFile = getFileBuffer(pszFileName, pszMode);
+    if (! pFile)
     {
-        extension = strFileName.substr(nExPos);
+        return NULL;
     }
 
-    do 
+    // the caller owns the returned buffer, give it a copy of the shared bytes
+    unsigned char* pBuffer = new unsigned char[pFile->getSize()];
+    memcpy(pBuffer, pFile->getBytes(), pFile->getSize());
+    *pSize = pFile->getSize();
+    pFile->release();
+
+    return pBuffer;
+}
+
+// the zip archives opened by getZipArchive(), by path
+class CCZipArchiveCache
+{
+    std::mutex m_mutex;
+    std::map<std::string, CCZipArchive*> m_archives;
+    // the archives that can't be indexed, they aren't read again until the cache is purged
+    std::set<std::string> m_failedPaths;
+
+public:
+    ~CCZipArchiveCache()
     {
-        // only cache plist file data now
-        if (0 != extension.compare(".plist"))
+        purge();
+    }
+
+    CCZipArchive* getZipArchive(const char* pszZipFilePath)
+    {
+        std::string path(pszZipFilePath);
+
         {
-            pBuffer = getFileDataPlatform(pszFileName, pszMode, pSize);
-            break;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::map<std::string, CCZipArchive*>::iterator it = m_archives.find(path);
+            if (it != m_archives.end())
+            {
+                it->second->retain();
+                return it->second;
+            }
+            if (m_failedPaths.count(path))
+            {
+                return NULL;
+            }
         }
 
-        // get data from cache 
-        unsigned int hashKey = BKDRHash((char*)pszFileName);
-        CacheDataInfo* pTemp = NULL;
-        std::map<unsigned int, CacheDataInfo*>::iterator it = s_CacheHandler.getCache().find(hashKey);
-        if (it != s_CacheHandler.getCache().end())
+        // index without holding the lock, the other archives stay readable
+        CCZipArchive* pArchive = CCZipArchive::archiveWithFile(pszZipFilePath);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (! pArchive)
         {
-            pTemp = it->second;
-            pBuffer = new unsigned char[pTemp->size];
-            memcpy(pBuffer, pTemp->data, pTemp->size);
-            *pSize = pTemp->size;
-            CCLOG("------------- get %s data from cache --------------", pszFileName);
-            break;
+            m_failedPaths.insert(path);
+            return NULL;
+        }
+
+        // another thread may have opened the same archive meanwhile
+        std::map<std::string, CCZipArchive*>::iterator it = m_archives.find(path);
+        if (it != m_archives.end())
+        {
+            pArchive->release();
+            pArchive = it->second;
+        }
+        else
+        {
+            m_archives.insert(std::make_pair(path, pArchive));
         }
+        // one reference for the cache, one for the caller
+        pArchive->retain();
+        return pArchive;
+    }
 
+    // archives still borrowed by somebody stay open until they are released
+    void purge()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
 
-        CCLOG("------------- get %s data from file--------------", pszFileName);
-        // get data from file, and cache the data
-        pBuffer = getFileDataPlatform(pszFileName, pszMode, pSize);
-        CacheDataInfo* pCache = new CacheDataInfo();
-        pCache->data = new unsigned char[*pSize];
-        pCache->size = *pSize;
-        memcpy(pCache->data, pBuffer, pCache->size);
-        s_CacheHandler.getCache().insert(std::pair<unsigned int, CacheDataInfo*>(hashKey, pCache));
-    } while (0);
+        std::map<std::string, CCZipArchive*>::iterator it;
+        for (it = m_archives.begin(); it != m_archives.end(); ++it)
+        {
+            it->second->release();
+        }
+        m_archives.clear();
+        m_failedPaths.clear();
+    }
+};
 
-    return pBuffer;
-}
+static CCZipArchiveCache s_ZipArchiveCache;
 
 void CCFileUtils::purgeCachedFileData()
 {
-    std::map<unsigned int, CacheDataInfo*>::iterator it;
-    for (it = s_CacheHandler.getCache().begin(); it != s_CacheHandler.getCache().end(); it++)
+    s_FileCache.purge();
+    s_ZipArchiveCache.purge();
+}
+
+CCZipArchive* CCFileUtils::getZipArchive(const char* pszZipFilePath)
+{
+    if (! pszZipFilePath || strlen(pszZipFilePath) == 0)
     {
-        CacheDataInfo* pCache = it->second;
-        CC_SAFE_DELETE(pCache);
+        return NULL;
     }
-    s_CacheHandler.getCache().clear();
+    return s_ZipArchiveCache.getZipArchive(pszZipFilePath);
 }
 
-unsigned char* CCFileUtils::getFileDataFromZip(const char* pszZipFilePath, const char* pszFileName, unsigned long * pSize)
+// reads a file with unzip, for the archives and the files CCZipArchive can't read
+static unsigned char* getFileDataFromUnindexedZip(const char* pszZipFilePath, const char* pszFileName, unsigned long * pSize)
 {
     unsigned char * pBuffer = NULL;
     unzFile pFile = NULL;
@@ -481,9 +707,6 @@ unsigned char* CCFileUtils::getFileDataFromZip(const char* pszZipFilePath, const
 
     do 
     {
-        CC_BREAK_IF(!pszZipFilePath || !pszFileName);
-        CC_BREAK_IF(strlen(pszZipFilePath) == 0);
-
         pFile = unzOpen(pszZipFilePath);
         CC_BREAK_IF(!pFile);
 
@@ -515,6 +738,31 @@ unsigned char* CCFileUtils::getFileDataFromZip(const char* pszZipFilePath, const
     return pBuffer;
 }
 
+unsigned char* CCFileUtils::getFileDataFromZip(const char* pszZipFilePath, const char* pszFileName, unsigned long * pSize)
+{
+    *pSize = 0;
+
+    if (!pszZipFilePath || !pszFileName || strlen(pszZipFilePath) == 0)
+    {
+        return NULL;
+    }
+
+    CCZipArchive* pArchive = getZipArchive(pszZipFilePath);
+    if (pArchive)
+    {
+        bool bContainsFile = pArchive->containsFile(pszFileName);
+        unsigned char* pBuffer = pArchive->getFileData(pszFileName, pSize);
+        pArchive->release();
+
+        if (pBuffer || ! bContainsFile)
+        {
+            return pBuffer;
+        }
+    }
+
+    return getFileDataFromUnindexedZip(pszZipFilePath, pszFileName, pSize);
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Notification support when getFileData from invalid file path.
 //////////////////////////////////////////////////////////////////////////
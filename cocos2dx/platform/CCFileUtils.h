@@ -25,10 +25,40 @@ THE SOFTWARE.
 #define __CC_FILEUTILS_PLATFORM_H__
 
 #include <string>
+#include <atomic>
 #include "CCMutableDictionary.h"
 
 NS_CC_BEGIN;
 
+class CCZipArchive;
+
+/**
+@brief Read-only contents of a file, shared by everybody that reads the file while it is cached.
+The reference count is atomic, a buffer can be retained and released from any thread.
+@since v1.0
+*/
+class CC_DLL CCFileBuffer
+{
+public:
+    /** takes ownership of pBytes, which must have been allocated with new[]. The reference count starts at 1. */
+    CCFileBuffer(unsigned char* pBytes, unsigned long uSize);
+
+    inline const unsigned char* getBytes() { return m_pBytes; }
+    inline unsigned long getSize() { return m_uSize; }
+
+    void retain();
+    void release();
+
+private:
+    ~CCFileBuffer();
+    CCFileBuffer(const CCFileBuffer&);
+    CCFileBuffer& operator=(const CCFileBuffer&);
+
+    unsigned char*      m_pBytes;
+    unsigned long       m_uSize;
+    std::atomic<int>    m_nReferenceCount;
+};
+
 //! @brief  Helper class to handle file operations
 class CC_DLL CCFileUtils
 {
@@ -52,6 +82,35 @@ public:
     static unsigned char* getFileDataPlatform(const char* pszFileName, const char* pszMode, unsigned long * pSize);
     static void purgeCachedFileData();
 
+    /**
+    @brief Get the shared contents of a file without copying them
+    @param[in]  pszFileName The resource file name which contain the path
+    @param[in]  pszMode The read mode of the file
+    @return a retained buffer, call release() when it is not needed any more. NULL if the file can't be read
+    @warning The bytes are shared with the other readers of the file, they must not be modified.
+    The file is read once and kept in a least recently used cache, see setFileCacheSize().
+    The cache is keyed by the full path of the file. It is meant for the read-only resources:
+    the files under getWriteablePath() are never cached. Call removeCachedFileData() after
+    writing a file somewhere else that was read before.
+    @since v1.0
+    */
+    static CCFileBuffer* getFileBuffer(const char* pszFileName, const char* pszMode);
+
+    /**
+    @brief Drop a file from the cache of getFileBuffer() and getFileData(), in all the read modes
+    @param[in]  pszFileName The relative or full path of the file
+    @since v1.0
+    */
+    static void removeCachedFileData(const char* pszFileName);
+
+    /**
+    @brief Set/Get the number of bytes of file data kept in the cache.
+    Files bigger than the cache are never cached. Default is CC_FILE_CACHE_SIZE.
+    @since v1.0
+    */
+    static void setFileCacheSize(unsigned long uBytes);
+    static unsigned long getFileCacheSize();
+
     /**
     @brief Get resource file data from zip file
     @param[in]  pszFileName The resource file name which contain the relative path of zip file
@@ -61,6 +120,16 @@ public:
     */
     static unsigned char* getFileDataFromZip(const char* pszZipFilePath, const char* pszFileName, unsigned long * pSize);
 
+    /**
+    @brief Get an open zip archive, to read many files from it
+    @param[in]  pszZipFilePath The path of the zip file
+    @return a retained archive, call release() when it is not needed any more. NULL if the file is not a zip archive
+    @warning The archives are opened once and kept open until purgeCachedFileData() is called,
+    getFileDataFromZip() reads from them as well.
+    @since v1.0
+    */
+    static CCZipArchive* getZipArchive(const char* pszZipFilePath);
+
     /** removes the HD suffix from a path
     @returns const char * without the HD suffix
     @since v0.99.5
@@ -77,6 +146,13 @@ public:
     */
     static const char* fullPathFromRelativePath(const char *pszRelativePath);
 
+    /**
+    @brief The same as fullPathFromRelativePath(), but it returns a string instead of autoreleasing one,
+           so any thread can call it.
+    @since v1.0
+    */
+    static std::string fullPathFromRelativePathThreadSafe(const char *pszRelativePath);
+
     /// @cond
     static const char* fullPathFromRelativeFile(const char *pszFilename, const char *pszRelativeFile);
     /// @endcond
@@ -142,28 +218,44 @@ public:
  //   static int ccLoadFileIntoMemory(const char *filename, unsigned char **out);
 };
 
+/**
+@brief Borrows the contents of a file from the file cache for the lifetime of the object.
+@warning The buffer is shared, it must not be modified.
+*/
 class CCFileData
 {
 public:
     CCFileData(const char* pszFileName, const char* pszMode)
-        : m_pBuffer(0)
+        : m_pFile(0)
+        , m_pBuffer(0)
         , m_uSize(0)
     {
-        m_pBuffer = CCFileUtils::getFileData(pszFileName, pszMode, &m_uSize);
+        reset(pszFileName, pszMode);
     }
     ~CCFileData()
     {
-        CC_SAFE_DELETE_ARRAY(m_pBuffer);
+        CC_SAFE_RELEASE(m_pFile);
     }
 
     bool reset(const char* pszFileName, const char* pszMode)
     {
-        CC_SAFE_DELETE_ARRAY(m_pBuffer);
+        CC_SAFE_RELEASE_NULL(m_pFile);
+        m_pBuffer = 0;
         m_uSize = 0;
-        m_pBuffer = CCFileUtils::getFileData(pszFileName, pszMode, &m_uSize);
+        m_pFile = CCFileUtils::getFileBuffer(pszFileName, pszMode);
+        if (m_pFile)
+        {
+            m_pBuffer = (unsigned char*)m_pFile->getBytes();
+            m_uSize = m_pFile->getSize();
+        }
         return (m_pBuffer) ? true : false;
     }
 
+private:
+    CCFileBuffer* m_pFile;
+
+public:
+
     CC_SYNTHESIZE_READONLY(unsigned char *, m_pBuffer, Buffer);
     CC_SYNTHESIZE_READONLY(unsigned long ,  m_uSize,   Size);
 };
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "CCStdC.h"
 #include "CCFileUtils.h"
 #include "png.h"
+#include "support/image_support/ccPixelConvert.h"
 #include <string>
 #include <ctype.h>
 
@@ -38,12 +39,6 @@ THE SOFTWARE.
 #include "jpeglib.h"
 #undef   QGLOBAL_H
 
-#define CC_RGB_PREMULTIPLY_APLHA(vr, vg, vb, va) \
-    (unsigned)(((unsigned)((unsigned char)(vr) * ((unsigned char)(va) + 1)) >> 8) | \
-    ((unsigned)((unsigned char)(vg) * ((unsigned char)(va) + 1) >> 8) << 8) | \
-    ((unsigned)((unsigned char)(vb) * ((unsigned char)(va) + 1) >> 8) << 16) | \
-    ((unsigned)(unsigned char)(va) << 24))
-
 typedef struct 
 {
     unsigned char* data;
@@ -271,14 +266,9 @@ bool CCImage::_initWithPngData(void * pData, int nDatalen)
         int bytesPerRow = nWidth * bytesPerComponent;
         if(m_bHasAlpha)
         {
-            unsigned int *tmp = (unsigned int *)pImateData;
             for(unsigned int i = 0; i < nHeight; i++)
             {
-                for(int j = 0; j < bytesPerRow; j += 4)
-                {
-                    *tmp++ = CC_RGB_PREMULTIPLY_APLHA( rowPointers[i][j], rowPointers[i][j + 1], 
-                        rowPointers[i][j + 2], rowPointers[i][j + 3]);
-                }
+                ccPixelPremultiplyRGBA8888(rowPointers[i], pImateData + i * bytesPerRow, nWidth);
             }
         }
         else
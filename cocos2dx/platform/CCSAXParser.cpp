@@ -73,21 +73,13 @@ bool CCSAXParser::parse(const char *pszFile)
 	saxHandler.endElement = &CCSAXParser::endElement;
 	saxHandler.characters = &CCSAXParser::textHandler;
 	
+	// The global state of libxml2 is kept between the parses, xmlCleanupParser() would free it
+	// only for the next parse to build it again. It may only be called once nothing parses any more.
 	int result = xmlSAXUserParseMemory( &saxHandler, this, pBuffer, size );
 	if ( result != 0 )
 	{
 		return false;
 	}
-	/*
-	 * Cleanup function for the XML library.
-	 */
-	xmlCleanupParser();
-	/*
-	 * this is to debug memory for regression tests
-	 */
-#if (CC_TARGET_PLATFORM != CC_PLATFORM_BADA)
-	xmlMemoryDump();
-#endif
 	
 	return true;
 }
@@ -37,6 +37,8 @@ CCEGLView::CCEGLView()
     m_projectionMatrix = XMMatrixIdentity();
 	m_viewMatrix = XMMatrixIdentity();
 	mMatrixMode = -1;
+
+	m_pfnFlushBatch = NULL;
 }
 
 CCEGLView::~CCEGLView()
@@ -120,6 +122,7 @@ void CCEGLView::setTouchDelegate(EGLTouchDelegate * pDelegate)
 
 void CCEGLView::swapBuffers()
 {
+	D3DFlushBatch();
     DirectXRender::SharedDXRender()->Present();
 }
 
@@ -202,6 +205,7 @@ void CCEGLView::setDesignResolution(int dx, int dy)
 
 void CCEGLView::SetBackBufferRenderTarget()
 {
+	D3DFlushBatch();
     m_d3dContext->OMSetRenderTargets(1, &m_renderTargetView, m_depthStencilView);
 }
 
@@ -267,6 +271,8 @@ void CCEGLView::D3DLoadIdentity()
 
 void CCEGLView::D3DViewport(int x, int y, int width, int height)
 {
+	D3DFlushBatch();
+
 	D3D11_VIEWPORT viewport;
 
 	// Setup the viewport for rendering.
@@ -283,6 +289,8 @@ void CCEGLView::D3DViewport(int x, int y, int width, int height)
 
 void CCEGLView::D3DScissor(int x,int y,int w,int h)
 {
+	D3DFlushBatch();
+
 	D3D11_RECT scissorRects;
 
 	scissorRects.top = y;
@@ -422,6 +430,8 @@ void CCEGLView::D3DMultMatrix(const float *m)
 
 void CCEGLView::D3DDepthFunc(int func)
 {
+	D3DFlushBatch();
+
 	ID3D11DepthStencilState *dss0 = 0;
 	ID3D11DepthStencilState *dss1 = 0;
 	D3D11_DEPTH_STENCIL_DESC dsd;
@@ -482,6 +492,8 @@ void CCEGLView::D3DDepthFunc(int func)
 
 void CCEGLView::D3DBlendFunc(int sfactor, int dfactor)
 {
+	D3DFlushBatch();
+
 	int sfactor2 = sfactor;
 	int dfactor2 = dfactor;
 	switch(sfactor)
@@ -563,6 +575,8 @@ void CCEGLView::D3DBlendFunc(int sfactor, int dfactor)
 
 void CCEGLView::clearRender(ID3D11RenderTargetView* renderTargetView)
 {
+	D3DFlushBatch();
+
 	float color[4]={0.f,0.f,0.f,1.f};
 	if ( !renderTargetView )
 	{
@@ -591,6 +605,20 @@ void CCEGLView::GetClearColor(float* color)
 	color[3] = m_color[3];
 }
 
+void CCEGLView::D3DFlushBatch()
+{
+	// the render queue can be flushed while it is flushed, by the renderers it executes
+	if ( m_pfnFlushBatch )
+	{
+		m_pfnFlushBatch();
+	}
+}
+
+void CCEGLView::D3DSetFlushBatchFunc(void (*pfnFlushBatch)())
+{
+	m_pfnFlushBatch = pfnFlushBatch;
+}
+
 CCEGLView& CCEGLView::sharedOpenGLView()
 {
     CC_ASSERT(s_pMainWindow);
@@ -156,6 +156,12 @@ public:
 	void D3DDepthFunc(int func);
 	void D3DClearColor(float r, float b, float g, float a);
 
+	/** executes the commands recorded in the CCRenderQueue before the device state changes
+	 or another renderer draws. Every renderer calls it before issuing its own draw call.
+	*/
+	void D3DFlushBatch();
+	void D3DSetFlushBatchFunc(void (*pfnFlushBatch)());
+
     // static function
     /**
     @brief	get the shared main open gl window
@@ -210,6 +216,8 @@ private:
 	std::stack<MatrixStruct> m_MatrixStack;
 #endif
     int m_oldViewState;
+
+	void (*m_pfnFlushBatch)();
 };
 
 NS_CC_END;
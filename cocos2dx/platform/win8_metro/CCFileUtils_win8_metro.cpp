@@ -85,30 +85,37 @@ bool CCFileUtils::isFileExist(const char * resPath)
     return ret;
 }
 
-const char* CCFileUtils::fullPathFromRelativePath(const char *pszRelativePath)
+std::string CCFileUtils::fullPathFromRelativePathThreadSafe(const char *pszRelativePath)
 {
 	_CheckPath();
 
-    CCString * pRet = new CCString();
-    pRet->autorelease();
+    std::string ret;
     if ((strlen(pszRelativePath) > 1 && pszRelativePath[1] == ':'))
     {
         // path start with "x:", is absolute path
-        pRet->m_sString = pszRelativePath;
+        ret = pszRelativePath;
     }
     else if (strlen(pszRelativePath) > 0 
         && ('/' == pszRelativePath[0] || '\\' == pszRelativePath[0]))
     {
         // path start with '/' or '\', is absolute path without driver name
 		char szDriver[3] = {s_pszResourcePath[0], s_pszResourcePath[1], 0};
-        pRet->m_sString = szDriver;
-        pRet->m_sString += pszRelativePath;
+        ret = szDriver;
+        ret += pszRelativePath;
     }
     else
     {
-        pRet->m_sString = s_pszResourcePath;
-        pRet->m_sString += pszRelativePath;
+        ret = s_pszResourcePath;
+        ret += pszRelativePath;
     }
+    return ret;
+}
+
+const char* CCFileUtils::fullPathFromRelativePath(const char *pszRelativePath)
+{
+    CCString * pRet = new CCString();
+    pRet->autorelease();
+    pRet->m_sString = fullPathFromRelativePathThreadSafe(pszRelativePath);
 //#if (CC_IS_RETINA_DISPLAY_SUPPORTED)
 //    if (CC_CONTENT_SCALE_FACTOR() != 1.0f)
 //    {
@@ -149,7 +156,8 @@ const char *CCFileUtils::fullPathFromRelativeFile(const char *pszFilename, const
 
 unsigned char* CCFileUtils::getFileDataPlatform(const char* pszFileName, const char* pszMode, unsigned long * pSize)
 {
-    const char *pszPath = fullPathFromRelativePath(pszFileName);
+    std::string strPath = fullPathFromRelativePathThreadSafe(pszFileName);
+    const char *pszPath = strPath.c_str();
 
 	FILE_STANDARD_INFO fileStandardInfo = { 0 };
 	HANDLE hFile;
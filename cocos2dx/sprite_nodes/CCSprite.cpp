@@ -41,6 +41,7 @@ THE SOFTWARE.
 #include "DirectXHelper.h"
 #include <string.h>
 #include "BasicLoader.h"
+#include "support/CCProfiling.h"
 
 using namespace std;
 using namespace DirectX;
@@ -53,6 +54,13 @@ namespace   cocos2d {
 #define RENDER_IN_SUBPIXEL(__A__) ( (int)(__A__))
 #endif
 
+// quads the shared vertex buffer can hold
+#if CC_SPRITE_AUTO_BATCH
+#define CC_SPRITE_BUFFER_QUADS CC_SPRITE_AUTO_BATCH_CAPACITY
+#else
+#define CC_SPRITE_BUFFER_QUADS 1
+#endif
+
 // XXX: Optmization
 struct transformValues_ {
 	CCPoint pos;		// position x and y
@@ -65,6 +73,20 @@ struct transformValues_ {
 
 CCDXSprite CCSprite::mDXSprite;
 
+void CCSprite::flushBatchedDraws(void)
+{
+	CCRenderQueue::sharedRenderQueue()->flush();
+}
+
+void CCSprite::attachRenderQueue(void)
+{
+	CCRenderQueue* pQueue = CCRenderQueue::sharedRenderQueue();
+	pQueue->setBackend(&mDXSprite);
+	// a command never needs more quads than the vertex buffer holds
+	pQueue->setBatchCapacity(CC_SPRITE_BUFFER_QUADS);
+	CCD3DCLASS->D3DSetFlushBatchFunc(&CCSprite::flushBatchedDraws);
+}
+
 CCSprite* CCSprite::spriteWithBatchNode(CCSpriteBatchNode *batchNode, const CCRect& rect)
 {
 	CCSprite *pobSprite = new CCSprite();
@@ -651,12 +673,25 @@ void CCSprite::getTransformValues(struct transformValues_ *tv)
 
 // draw
 
+void CCSprite::queueDraw(void)
+{
+#if CC_SPRITE_AUTO_BATCH
+	// draw() records the quad
+	draw();
+#else
+	CCNode::queueDraw();
+#endif // CC_SPRITE_AUTO_BATCH
+}
+
 void CCSprite::draw(void)
 {
 	CCNode::draw();
 
 	CCAssert(! m_bUsesBatchNode, "");
 	
+#if CC_SPRITE_AUTO_BATCH
+	mDXSprite.Append(m_pobTexture, m_sBlendFunc, m_sQuad);
+#else
 	bool newBlend = m_sBlendFunc.src != CC_BLEND_SRC || m_sBlendFunc.dst != CC_BLEND_DST;
 	if (newBlend)
 	{
@@ -669,6 +704,7 @@ void CCSprite::draw(void)
 	{
 		CCD3DCLASS->D3DBlendFunc(CC_BLEND_SRC, CC_BLEND_DST);
 	}
+#endif // CC_SPRITE_AUTO_BATCH
 	
 	
 #if CC_SPRITE_DEBUG_DRAW == 1
@@ -823,6 +859,12 @@ void CCSprite::setRotation(float fRotation)
 	SET_DIRTY_RECURSIVELY();
 }
 
+void CCSprite::setPositionAndRotation(const CCPoint& pos, float fRotation)
+{
+	CCNode::setPositionAndRotation(pos, fRotation);
+	SET_DIRTY_RECURSIVELY();
+}
+
 void CCSprite::setSkewX(float sx)
 {
     CCNode::setSkewX(sx);
@@ -1097,12 +1139,15 @@ CCDXSprite::CCDXSprite()
 	m_vertexBuffer = 0;
 	m_textureColorBuffer = 0;
 
+	m_pBatchVertices = 0;
+
 	mIsInit = FALSE;
 }
 
 CCDXSprite::~CCDXSprite()
 {
 	FreeBuffer();
+	CC_SAFE_DELETE_ARRAY(m_pBatchVertices);
 }
 
 void CCDXSprite::FreeBuffer()
@@ -1128,7 +1173,7 @@ void CCDXSprite::initVertexBuffer()
 
 	// Set up the description of the static vertex buffer.
 	vertexBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
-	vertexBufferDesc.ByteWidth = sizeof(VertexType)*4;
+	vertexBufferDesc.ByteWidth = sizeof(VertexType)*4*CC_SPRITE_BUFFER_QUADS;
 	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 	vertexBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
 	vertexBufferDesc.MiscFlags = 0;
@@ -1142,10 +1187,17 @@ void CCDXSprite::initVertexBuffer()
 		return ;
 	}
 
-    CCushort indices[] = {
-		0, 1, 2,
-		0, 2, 3,
-	};
+	// a single sprite only uses the first quad
+	CCushort indices[CC_SPRITE_BUFFER_QUADS*6];
+	for ( int i=0; i<CC_SPRITE_BUFFER_QUADS; i++ )
+	{
+		indices[i*6+0] = (CCushort)(i*4+0);
+		indices[i*6+1] = (CCushort)(i*4+1);
+		indices[i*6+2] = (CCushort)(i*4+2);
+		indices[i*6+3] = (CCushort)(i*4+0);
+		indices[i*6+4] = (CCushort)(i*4+2);
+		indices[i*6+5] = (CCushort)(i*4+3);
+	}
 
 	D3D11_BUFFER_DESC indexBufferDesc;
 	D3D11_SUBRESOURCE_DATA indexData;
@@ -1362,6 +1414,7 @@ void CCDXSprite::RenderShader(CCTexture2D *texture)
 
 	// Render the triangle.
 	CCID3D11DeviceContext->DrawIndexed( 6, 0, 0 );
+	CCFrameProfiler::addDrawCall(1);
 
 	return;
 }
@@ -1369,6 +1422,7 @@ void CCDXSprite::RenderShader(CCTexture2D *texture)
 
 void CCDXSprite::Render(CCTexture2D *texture,ccV3F_C4B_T2F_Quad quad)
 {
+	CCD3DCLASS->D3DFlushBatch();
 
 	if ( !mIsInit )
 	{
@@ -1394,4 +1448,109 @@ void CCDXSprite::Render(CCTexture2D *texture,ccV3F_C4B_T2F_Quad quad)
 	RenderShader(texture);
 }
 
-}//namespace   cocos2d 
+void CCDXSprite::Append(CCTexture2D *texture,const ccBlendFunc& blendFunc,const ccV3F_C4B_T2F_Quad& quad)
+{
+	CCRenderQueue* pQueue = CCRenderQueue::sharedRenderQueue();
+
+	XMMATRIX viewMatrix, projectionMatrix;
+	CCD3DCLASS->GetViewMatrix(viewMatrix);
+	CCD3DCLASS->GetProjectionMatrix(projectionMatrix);
+
+	XMFLOAT4X4 view, projection;
+	XMStoreFloat4x4(&view, viewMatrix);
+	XMStoreFloat4x4(&projection, projectionMatrix);
+	pQueue->addQuad(texture, blendFunc, quad, &view.m[0][0], &projection.m[0][0]);
+}
+
+void CCDXSprite::drawQuads(const ccRenderCommand& command, const float *projection, const ccV3F_C4B_T2F_Quad *quads)
+{
+	if ( !mIsInit )
+	{
+		mIsInit = TRUE;
+		FreeBuffer();
+		initVertexBuffer();
+		InitializeShader();
+	}
+
+	if ( !m_pBatchVertices )
+	{
+		m_pBatchVertices = new VertexType[4*CC_SPRITE_BUFFER_QUADS];
+	}
+
+	bool newBlend = command.blendFunc.src != CC_BLEND_SRC || command.blendFunc.dst != CC_BLEND_DST;
+	if (newBlend)
+	{
+		CCD3DCLASS->D3DBlendFunc(command.blendFunc.src, command.blendFunc.dst);
+	}
+
+	// the quads are already in view space
+	XMMATRIX viewMatrix = XMMatrixIdentity();
+	XMMATRIX projectionMatrix = XMLoadFloat4x4((const XMFLOAT4X4*)projection);
+	SetShaderParameters(viewMatrix, projectionMatrix, (command.texture ? command.texture->getTextureResource() : NULL));
+
+	CCID3D11DeviceContext->IASetInputLayout(m_layout);
+	CCID3D11DeviceContext->VSSetShader(m_vertexShader, NULL, 0);
+	CCID3D11DeviceContext->PSSetShader(m_pixelShader, NULL, 0);
+	if ( command.texture )
+	{
+		CCID3D11DeviceContext->PSSetSamplers(0, 1, command.texture->GetSamplerState());
+	}
+
+	unsigned int stride = sizeof(VertexType);
+	unsigned int offset = 0;
+	CCID3D11DeviceContext->IASetVertexBuffers(0, 1, &m_vertexBuffer, &stride, &offset);
+	CCID3D11DeviceContext->IASetIndexBuffer( m_indexBuffer, DXGI_FORMAT_R16_UINT, 0);
+	CCID3D11DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	// commands bigger than the vertex buffer are drawn in several parts
+	unsigned int drawn = 0;
+	while ( drawn < command.quadCount )
+	{
+		unsigned int count = min(command.quadCount - drawn, (unsigned int)CC_SPRITE_BUFFER_QUADS);
+		const ccV3F_C4B_T2F_Quad* quad = quads + drawn;
+		VertexType* vertices = m_pBatchVertices;
+		for ( unsigned int i=0; i<count; i++ )
+		{
+			const ccV3F_C4B_T2F* corners[4] = { &quad->tl, &quad->tr, &quad->br, &quad->bl };
+			for ( int j=0; j<4; j++ )
+			{
+				const ccV3F_C4B_T2F* corner = corners[j];
+				vertices[j].position = XMFLOAT3(corner->vertices.x, corner->vertices.y, corner->vertices.z);
+				vertices[j].color = XMFLOAT4(corner->colors.r/255.0f, corner->colors.g/255.0f, corner->colors.b/255.0f, corner->colors.a/255.0f);
+				vertices[j].texture = XMFLOAT2(corner->texCoords.u, corner->texCoords.v);
+			}
+			vertices += 4;
+			quad++;
+		}
+
+		D3D11_MAPPED_SUBRESOURCE mappedResource;
+		if(FAILED(CCID3D11DeviceContext->Map(m_vertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource)))
+		{
+			break;
+		}
+		memcpy(mappedResource.pData, (void*)m_pBatchVertices, (sizeof(VertexType) * 4 * count));
+		CCID3D11DeviceContext->Unmap(m_vertexBuffer, 0);
+
+		CCID3D11DeviceContext->DrawIndexed( count*6, 0, 0 );
+		CCFrameProfiler::addDrawCall(count);
+		drawn += count;
+	}
+
+	if( newBlend )
+	{
+		CCD3DCLASS->D3DBlendFunc(CC_BLEND_SRC, CC_BLEND_DST);
+	}
+}
+
+void CCDXSprite::drawNode(const ccRenderCommand& command, const float *view, const float *projection)
+{
+	CCD3DCLASS->D3DPushMatrix();
+	CCD3DCLASS->SetViewMatrix(XMLoadFloat4x4((const XMFLOAT4X4*)view));
+	CCD3DCLASS->SetProjectionMatrix(XMLoadFloat4x4((const XMFLOAT4X4*)projection));
+
+	command.node->draw();
+
+	CCD3DCLASS->D3DPopMatrix();
+}
+
+}//namespace   cocos2d
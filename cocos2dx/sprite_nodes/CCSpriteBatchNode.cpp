@@ -140,7 +140,7 @@ namespace cocos2d
 
 		transform();
 
-		draw();
+		queueDraw();
 
 		if (m_pGrid && m_pGrid->isActive())
 		{
@@ -0,0 +1,500 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CCGlyphAtlas.h"
+#include "ccUTF8.h"
+#include <math.h>
+
+namespace cocos2d
+{
+	enum {
+		// transparent pixels on the right and below each glyph, so the filtering doesn't mix glyphs
+		kGlyphPadding = 1,
+	};
+
+	// the pixels without glyphs are white and transparent, so the filtered edges stay white
+	static void clearPixels(unsigned char *pPixels, unsigned int uCount)
+	{
+		for (unsigned int i = 0; i < uCount; ++i)
+		{
+			pPixels[0] = pPixels[1] = pPixels[2] = 0xff;
+			pPixels[3] = 0;
+			pPixels += 4;
+		}
+	}
+
+	static inline unsigned long long glyphKey(unsigned int uFontID, unsigned int uFontSize, unsigned int uCodePoint)
+	{
+		return ((unsigned long long)(uFontID & 0xffff) << 48) | ((unsigned long long)(uFontSize & 0xffff) << 32) | uCodePoint;
+	}
+
+	CCGlyphAtlas::CCGlyphAtlas(unsigned int uWidth, unsigned int uHeight)
+		: m_uWidth(uWidth)
+		, m_uHeight(uHeight)
+		, m_pRasterizer(NULL)
+		, m_uNextShelfY(0)
+		, m_uGeneration(0)
+		, m_uRasterizedCount(0)
+		, m_uEvictedShelfCount(0)
+		, m_uDirtyLeft(0)
+		, m_uDirtyTop(0)
+		, m_uDirtyRight(0)
+		, m_uDirtyBottom(0)
+	{
+		m_tPixels.resize(uWidth * uHeight * 4);
+		clearPixels(&m_tPixels[0], uWidth * uHeight);
+	}
+
+	CCGlyphAtlas::~CCGlyphAtlas()
+	{
+	}
+
+	unsigned int CCGlyphAtlas::fontID(const char *pszFontName)
+	{
+		std::string name(pszFontName ? pszFontName : "");
+		std::unordered_map<std::string, unsigned int>::iterator it = m_tFontIDs.find(name);
+		if (it != m_tFontIDs.end())
+		{
+			return it->second;
+		}
+
+		unsigned int uID = (unsigned int)m_tFontNames.size();
+		m_tFontIDs[name] = uID;
+		m_tFontNames.push_back(name);
+		return uID;
+	}
+
+	const ccGlyph* CCGlyphAtlas::glyph(unsigned int uFontID, unsigned int uFontSize, unsigned int uCodePoint, unsigned int uTick)
+	{
+		if (uFontID >= m_tFontNames.size())
+		{
+			return NULL;
+		}
+
+		unsigned long long key = glyphKey(uFontID, uFontSize, uCodePoint);
+		std::unordered_map<unsigned long long, ccGlyph>::iterator it = m_tGlyphs.find(key);
+		if (it != m_tGlyphs.end())
+		{
+			if (it->second.uShelf != kCCGlyphNoShelf)
+			{
+				m_tShelves[it->second.uShelf].uLastUsed = uTick;
+			}
+			return &it->second;
+		}
+
+		ccGlyph newGlyph;
+		if (! addGlyph(key, m_tFontNames[uFontID].c_str(), uFontSize, uCodePoint, uTick, &newGlyph))
+		{
+			return NULL;
+		}
+		// the references to the elements of an unordered_map stay valid when it grows
+		ccGlyph& storedGlyph = m_tGlyphs[key];
+		storedGlyph = newGlyph;
+		return &storedGlyph;
+	}
+
+	void CCGlyphAtlas::touchShelf(unsigned int uShelf, unsigned int uTick)
+	{
+		if (uShelf < m_tShelves.size())
+		{
+			m_tShelves[uShelf].uLastUsed = uTick;
+		}
+	}
+
+	bool CCGlyphAtlas::addGlyph(unsigned long long key, const char *pszFontName, unsigned int uFontSize, unsigned int uCodePoint, unsigned int uTick, ccGlyph *pGlyph)
+	{
+		ccGlyphBitmap& bitmap = m_tBitmap;
+		bitmap.uWidth = bitmap.uHeight = 0;
+		bitmap.nLeft = bitmap.nTop = bitmap.nAdvance = 0;
+		bitmap.uLineHeight = uFontSize;
+		bitmap.tCoverage.clear();
+
+		if (m_pRasterizer && m_pRasterizer->rasterizeGlyph(pszFontName, uFontSize, uCodePoint, &bitmap))
+		{
+			++m_uRasterizedCount;
+		}
+		if (bitmap.tCoverage.size() < bitmap.uWidth * bitmap.uHeight)
+		{
+			bitmap.uWidth = bitmap.uHeight = 0;
+		}
+
+		// trim the transparent borders
+		unsigned int left = bitmap.uWidth, right = 0, top = bitmap.uHeight, bottom = 0;
+		for (unsigned int y = 0; y < bitmap.uHeight; ++y)
+		{
+			const unsigned char *pRow = &bitmap.tCoverage[y * bitmap.uWidth];
+			for (unsigned int x = 0; x < bitmap.uWidth; ++x)
+			{
+				if (pRow[x])
+				{
+					left = x < left ? x : left;
+					right = x + 1 > right ? x + 1 : right;
+					top = y < top ? y : top;
+					bottom = y + 1;
+				}
+			}
+		}
+
+		pGlyph->uX = pGlyph->uY = 0;
+		pGlyph->uWidth = pGlyph->uHeight = 0;
+		pGlyph->nLeft = (short)bitmap.nLeft;
+		pGlyph->nTop = (short)bitmap.nTop;
+		pGlyph->nAdvance = (short)bitmap.nAdvance;
+		pGlyph->uLineHeight = (unsigned short)bitmap.uLineHeight;
+		pGlyph->uShelf = kCCGlyphNoShelf;
+
+		if (left >= right)
+		{
+			// nothing to draw, like a space
+			return true;
+		}
+
+		unsigned int uWidth = right - left;
+		unsigned int uHeight = bottom - top;
+		int nShelf = shelfForGlyph(uWidth + kGlyphPadding, uHeight + kGlyphPadding, uTick);
+		if (nShelf < 0)
+		{
+			return false;
+		}
+
+		Shelf& shelf = m_tShelves[nShelf];
+		pGlyph->uX = (unsigned short)shelf.uUsedWidth;
+		pGlyph->uY = (unsigned short)shelf.uY;
+		pGlyph->uWidth = (unsigned short)uWidth;
+		pGlyph->uHeight = (unsigned short)uHeight;
+		pGlyph->nLeft = (short)(bitmap.nLeft + (int)left);
+		pGlyph->nTop = (short)(bitmap.nTop + (int)top);
+		pGlyph->uShelf = (unsigned short)nShelf;
+
+		shelf.uUsedWidth += uWidth + kGlyphPadding;
+		shelf.uLastUsed = uTick;
+		shelf.tKeys.push_back(key);
+
+		for (unsigned int y = 0; y < uHeight; ++y)
+		{
+			const unsigned char *pIn = &bitmap.tCoverage[(top + y) * bitmap.uWidth + left];
+			unsigned char *pOut = &m_tPixels[((pGlyph->uY + y) * m_uWidth + pGlyph->uX) * 4];
+			for (unsigned int x = 0; x < uWidth; ++x)
+			{
+				pOut[3] = pIn[x];
+				pOut += 4;
+			}
+		}
+		markDirty(pGlyph->uX, pGlyph->uY, uWidth, uHeight);
+		return true;
+	}
+
+	int CCGlyphAtlas::shelfForGlyph(unsigned int uWidth, unsigned int uHeight, unsigned int uTick)
+	{
+		if (uWidth > m_uWidth || uHeight > m_uHeight)
+		{
+			return -1;
+		}
+
+		// the lowest shelf with room that doesn't waste too much height
+		int best = -1;
+		for (unsigned int i = 0; i < m_tShelves.size(); ++i)
+		{
+			const Shelf& shelf = m_tShelves[i];
+			if (shelf.uHeight >= uHeight && shelf.uHeight <= uHeight + uHeight / 4 + 2 && m_uWidth - shelf.uUsedWidth >= uWidth
+				&& (best < 0 || shelf.uHeight < m_tShelves[best].uHeight))
+			{
+				best = i;
+			}
+		}
+		if (best >= 0)
+		{
+			return best;
+		}
+
+		// a new shelf
+		if (m_uHeight - m_uNextShelfY >= uHeight)
+		{
+			Shelf shelf;
+			shelf.uY = m_uNextShelfY;
+			shelf.uHeight = uHeight;
+			shelf.uUsedWidth = 0;
+			shelf.uLastUsed = uTick;
+			m_tShelves.push_back(shelf);
+			m_uNextShelfY += uHeight;
+			return (int)m_tShelves.size() - 1;
+		}
+
+		// any shelf with room
+		for (unsigned int i = 0; i < m_tShelves.size(); ++i)
+		{
+			const Shelf& shelf = m_tShelves[i];
+			if (shelf.uHeight >= uHeight && m_uWidth - shelf.uUsedWidth >= uWidth
+				&& (best < 0 || shelf.uHeight < m_tShelves[best].uHeight))
+			{
+				best = i;
+			}
+		}
+		if (best >= 0)
+		{
+			return best;
+		}
+
+		// the atlas is full, empty the shelf used the longest time ago
+		bool bUsedDuringTick = false;
+		for (unsigned int i = 0; i < m_tShelves.size(); ++i)
+		{
+			const Shelf& shelf = m_tShelves[i];
+			bUsedDuringTick = bUsedDuringTick || shelf.uLastUsed == uTick;
+			if (shelf.uHeight >= uHeight && shelf.uLastUsed != uTick
+				&& (best < 0 || uTick - shelf.uLastUsed > uTick - m_tShelves[best].uLastUsed))
+			{
+				best = i;
+			}
+		}
+		if (best >= 0)
+		{
+			evictShelf(best);
+			return best;
+		}
+
+		// no shelf is high enough, start again if none is in use
+		if (! bUsedDuringTick)
+		{
+			removeAllGlyphs();
+			return shelfForGlyph(uWidth, uHeight, uTick);
+		}
+		return -1;
+	}
+
+	void CCGlyphAtlas::evictShelf(unsigned int uShelf)
+	{
+		Shelf& shelf = m_tShelves[uShelf];
+		for (unsigned int i = 0; i < shelf.tKeys.size(); ++i)
+		{
+			m_tGlyphs.erase(shelf.tKeys[i]);
+		}
+		shelf.tKeys.clear();
+
+		for (unsigned int y = 0; y < shelf.uHeight; ++y)
+		{
+			clearPixels(&m_tPixels[(shelf.uY + y) * m_uWidth * 4], shelf.uUsedWidth);
+		}
+		markDirty(0, shelf.uY, shelf.uUsedWidth, shelf.uHeight);
+
+		shelf.uUsedWidth = 0;
+		++m_uGeneration;
+		++m_uEvictedShelfCount;
+	}
+
+	void CCGlyphAtlas::removeAllGlyphs()
+	{
+		if (m_tShelves.empty())
+		{
+			return;
+		}
+
+		m_tGlyphs.clear();
+		m_tShelves.clear();
+		m_uNextShelfY = 0;
+
+		clearPixels(&m_tPixels[0], m_uWidth * m_uHeight);
+		markDirty(0, 0, m_uWidth, m_uHeight);
+		++m_uGeneration;
+	}
+
+	void CCGlyphAtlas::layoutString(const char *pszText, unsigned int uFontID, unsigned int uFontSize, unsigned int uTick,
+									float fBoxWidth, float fBoxHeight, ccGlyphAlignment alignment,
+									std::vector<ccGlyphPlacement>& tPlacements, float *pWidth, float *pHeight)
+	{
+		tPlacements.clear();
+
+		// first the glyphs of each line, fLeft is the pen position
+		std::vector<unsigned int> tLineStarts(1, 0);
+		unsigned int uLineHeight = 0;
+		unsigned int uBreak = 0;
+		float fPenX = 0;
+
+		const char *p = pszText ? pszText : "";
+		while (*p)
+		{
+			unsigned int uCodePoint = ccNextUTF8CodePoint(p);
+			if (uCodePoint == '\n')
+			{
+				tLineStarts.push_back((unsigned int)tPlacements.size());
+				fPenX = 0;
+				uBreak = 0;
+				continue;
+			}
+			if (uCodePoint == '\r')
+			{
+				continue;
+			}
+
+			const ccGlyph *pGlyph = glyph(uFontID, uFontSize, uCodePoint, uTick);
+			if (! pGlyph)
+			{
+				continue;
+			}
+			uLineHeight = pGlyph->uLineHeight > uLineHeight ? pGlyph->uLineHeight : uLineHeight;
+
+			// wraps the line after its last space, or before the glyph in a word longer than the box
+			if (fBoxWidth > 0 && uCodePoint != ' ' && fPenX > 0 && fPenX + pGlyph->nLeft + pGlyph->uWidth > fBoxWidth)
+			{
+				unsigned int uLineStart = tLineStarts.back();
+				if (uBreak > uLineStart && uBreak < tPlacements.size())
+				{
+					float fShift = tPlacements[uBreak].fLeft;
+					for (unsigned int i = uBreak; i < tPlacements.size(); ++i)
+					{
+						tPlacements[i].fLeft -= fShift;
+					}
+					tLineStarts.push_back(uBreak);
+					fPenX -= fShift;
+				}
+				else
+				{
+					tLineStarts.push_back((unsigned int)tPlacements.size());
+					fPenX = 0;
+				}
+				uBreak = 0;
+			}
+
+			ccGlyphPlacement placement;
+			placement.glyph = *pGlyph;
+			placement.fLeft = fPenX;
+			placement.fBottom = 0;
+			tPlacements.push_back(placement);
+
+			fPenX += pGlyph->nAdvance;
+			if (uCodePoint == ' ')
+			{
+				uBreak = (unsigned int)tPlacements.size();
+			}
+		}
+
+		if (uLineHeight == 0)
+		{
+			uLineHeight = uFontSize;
+		}
+
+		// the width of the lines, without their trailing spaces
+		unsigned int uLineCount = (unsigned int)tLineStarts.size();
+		tLineStarts.push_back((unsigned int)tPlacements.size());
+		std::vector<float> tLineWidths(uLineCount, 0.0f);
+		float fTextWidth = 0;
+		for (unsigned int line = 0; line < uLineCount; ++line)
+		{
+			for (unsigned int i = tLineStarts[line]; i < tLineStarts[line + 1]; ++i)
+			{
+				const ccGlyphPlacement& placement = tPlacements[i];
+				float fRight = placement.fLeft + placement.glyph.nAdvance;
+				if (placement.glyph.uShelf != kCCGlyphNoShelf && fRight > tLineWidths[line])
+				{
+					tLineWidths[line] = fRight;
+				}
+			}
+			fTextWidth = tLineWidths[line] > fTextWidth ? tLineWidths[line] : fTextWidth;
+		}
+
+		float fTextHeight = (float)(uLineCount * uLineHeight);
+		float fWidth = fBoxWidth > 0 ? fBoxWidth : fTextWidth;
+		float fHeight = fBoxHeight > 0 ? fBoxHeight : fTextHeight;
+		float fTop = fHeight - floorf((fHeight - fTextHeight) / 2);
+
+		// then the glyphs are placed, on whole pixels, and the ones without pixels are dropped
+		unsigned int uCount = 0;
+		for (unsigned int line = 0; line < uLineCount; ++line)
+		{
+			float fOffsetX = 0;
+			if (alignment == kCCGlyphAlignmentCenter)
+			{
+				fOffsetX = floorf((fWidth - tLineWidths[line]) / 2);
+			}
+			else if (alignment == kCCGlyphAlignmentRight)
+			{
+				fOffsetX = fWidth - tLineWidths[line];
+			}
+			float fLineTop = fTop - (float)(line * uLineHeight);
+
+			for (unsigned int i = tLineStarts[line]; i < tLineStarts[line + 1]; ++i)
+			{
+				ccGlyphPlacement placement = tPlacements[i];
+				if (placement.glyph.uShelf == kCCGlyphNoShelf)
+				{
+					continue;
+				}
+				placement.fLeft = floorf(fOffsetX + placement.fLeft) + placement.glyph.nLeft;
+				placement.fBottom = fLineTop - placement.glyph.nTop - placement.glyph.uHeight;
+				tPlacements[uCount++] = placement;
+			}
+		}
+		tPlacements.resize(uCount);
+
+		if (pWidth)
+		{
+			*pWidth = fWidth;
+		}
+		if (pHeight)
+		{
+			*pHeight = fHeight;
+		}
+	}
+
+	void CCGlyphAtlas::markDirty(unsigned int uX, unsigned int uY, unsigned int uWidth, unsigned int uHeight)
+	{
+		if (uWidth == 0 || uHeight == 0)
+		{
+			return;
+		}
+
+		if (m_uDirtyLeft >= m_uDirtyRight)
+		{
+			m_uDirtyLeft = uX;
+			m_uDirtyTop = uY;
+			m_uDirtyRight = uX + uWidth;
+			m_uDirtyBottom = uY + uHeight;
+			return;
+		}
+
+		m_uDirtyLeft = uX < m_uDirtyLeft ? uX : m_uDirtyLeft;
+		m_uDirtyTop = uY < m_uDirtyTop ? uY : m_uDirtyTop;
+		m_uDirtyRight = uX + uWidth > m_uDirtyRight ? uX + uWidth : m_uDirtyRight;
+		m_uDirtyBottom = uY + uHeight > m_uDirtyBottom ? uY + uHeight : m_uDirtyBottom;
+	}
+
+	bool CCGlyphAtlas::getDirtyRect(unsigned int *pX, unsigned int *pY, unsigned int *pWidth, unsigned int *pHeight)
+	{
+		if (m_uDirtyLeft >= m_uDirtyRight)
+		{
+			return false;
+		}
+
+		*pX = m_uDirtyLeft;
+		*pY = m_uDirtyTop;
+		*pWidth = m_uDirtyRight - m_uDirtyLeft;
+		*pHeight = m_uDirtyBottom - m_uDirtyTop;
+		return true;
+	}
+
+	void CCGlyphAtlas::clearDirtyRect()
+	{
+		m_uDirtyLeft = m_uDirtyTop = m_uDirtyRight = m_uDirtyBottom = 0;
+	}
+
+} // end of namespace cocos2d
@@ -0,0 +1,234 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __SUPPORT_CCGLYPHATLAS_H__
+#define __SUPPORT_CCGLYPHATLAS_H__
+
+#include "CCPlatformMacros.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace cocos2d
+{
+	/** @struct ccGlyphBitmap
+	A glyph drawn by a CCGlyphRasterizer, in pixels.
+	@since v1.0
+	*/
+	typedef struct _ccGlyphBitmap
+	{
+		//! size of the bitmap
+		unsigned int uWidth;
+		unsigned int uHeight;
+		//! position of the bitmap from the top left corner of the glyph's line
+		int nLeft;
+		int nTop;
+		//! horizontal advance to the next glyph
+		int nAdvance;
+		//! height of a line of the font
+		unsigned int uLineHeight;
+		//! 8 bits coverage, uWidth * uHeight bytes, the rows from the top
+		std::vector<unsigned char> tCoverage;
+	} ccGlyphBitmap;
+
+	/** @brief Draws the glyphs stored by a CCGlyphAtlas.
+	@since v1.0
+	*/
+	class CC_DLL CCGlyphRasterizer
+	{
+	public:
+		virtual ~CCGlyphRasterizer() {}
+
+		/** draws a character of a font.
+		The bitmap can be larger than the glyph, the transparent borders are trimmed by the atlas.
+		@return false if the character can't be drawn, it is then stored as an empty glyph
+		*/
+		virtual bool rasterizeGlyph(const char *pszFontName, unsigned int uFontSize, unsigned int uCodePoint, ccGlyphBitmap *pBitmap) = 0;
+	};
+
+	/** @struct ccGlyph
+	A glyph stored in a CCGlyphAtlas, in pixels.
+	@since v1.0
+	*/
+	typedef struct _ccGlyph
+	{
+		//! rectangle of the glyph in the atlas
+		unsigned short uX;
+		unsigned short uY;
+		unsigned short uWidth;
+		unsigned short uHeight;
+		//! position of the glyph from the top left corner of its line
+		short nLeft;
+		short nTop;
+		//! horizontal advance to the next glyph
+		short nAdvance;
+		//! height of a line of the font
+		unsigned short uLineHeight;
+		//! shelf of the atlas holding the pixels, kCCGlyphNoShelf for the empty glyphs
+		unsigned short uShelf;
+	} ccGlyph;
+
+	enum {
+		//! shelf of the glyphs without pixels, like the spaces
+		kCCGlyphNoShelf = 0xffff,
+	};
+
+	/** horizontal alignment of the lines, with the values of CCTextAlignment */
+	typedef enum
+	{
+		kCCGlyphAlignmentLeft,
+		kCCGlyphAlignmentCenter,
+		kCCGlyphAlignmentRight,
+	} ccGlyphAlignment;
+
+	/** @struct ccGlyphPlacement
+	A glyph of a string laid out by CCGlyphAtlas::layoutString().
+	@since v1.0
+	*/
+	typedef struct _ccGlyphPlacement
+	{
+		//! the glyph, copied from the atlas
+		ccGlyph glyph;
+		//! bottom left corner of the glyph in the string, the y axis goes up
+		float fLeft;
+		float fBottom;
+	} ccGlyphPlacement;
+
+	/**
+	@brief The glyphs of the fonts drawn into a single RGBA8888 image.
+
+	Each (font, size, character) is drawn once by the rasterizer and kept in the image,
+	white with the coverage in the alpha channel. The glyphs are packed on shelves, rows
+	as high as their tallest glyph. When the image is full, the shelf that was used the
+	longest time ago is emptied and reused, and the generation changes so that the users
+	of the atlas look their glyphs up again.
+
+	A tick, usually the frame number, tells when the glyphs are used. Shelves used during
+	the current tick are never emptied, so the glyphs drawn during a frame stay valid until
+	the frame ends.
+
+	The atlas doesn't use the GPU: the owner uploads getDirtyRect() to its texture.
+	@since v1.0
+	*/
+	class CC_DLL CCGlyphAtlas
+	{
+	public:
+		CCGlyphAtlas(unsigned int uWidth, unsigned int uHeight);
+		~CCGlyphAtlas();
+
+		/** the rasterizer drawing the new glyphs. It isn't owned by the atlas. */
+		void setRasterizer(CCGlyphRasterizer *pRasterizer) { m_pRasterizer = pRasterizer; }
+		CCGlyphRasterizer* getRasterizer() { return m_pRasterizer; }
+
+		/** a number for a font name, to look its glyphs up faster */
+		unsigned int fontID(const char *pszFontName);
+
+		/** finds a glyph, or draws and stores it.
+		@return NULL if the glyph can't fit in the atlas. The glyph is valid until the generation changes.
+		*/
+		const ccGlyph* glyph(unsigned int uFontID, unsigned int uFontSize, unsigned int uCodePoint, unsigned int uTick);
+
+		/** marks the glyphs of a shelf as used during the tick */
+		void touchShelf(unsigned int uShelf, unsigned int uTick);
+
+		/** Lays a UTF-8 string out, in lines split by '\n'.
+		With a box width, the lines are also wrapped at the spaces to fit in it, and aligned in it.
+		With a box height, the text is centered vertically in it.
+		@param pWidth, pHeight the size of the text, or of the box
+		*/
+		void layoutString(const char *pszText, unsigned int uFontID, unsigned int uFontSize, unsigned int uTick,
+						  float fBoxWidth, float fBoxHeight, ccGlyphAlignment alignment,
+						  std::vector<ccGlyphPlacement>& tPlacements, float *pWidth, float *pHeight);
+
+		/** removes all the glyphs */
+		void removeAllGlyphs();
+
+		/** changes each time glyphs are removed */
+		unsigned int getGeneration() { return m_uGeneration; }
+
+		unsigned int getWidth() { return m_uWidth; }
+		unsigned int getHeight() { return m_uHeight; }
+		unsigned int getGlyphCount() { return (unsigned int)m_tGlyphs.size(); }
+		unsigned int getShelfCount() { return (unsigned int)m_tShelves.size(); }
+		/** number of glyphs drawn by the rasterizer, and of shelves emptied to make room */
+		unsigned int getRasterizedCount() { return m_uRasterizedCount; }
+		unsigned int getEvictedShelfCount() { return m_uEvictedShelfCount; }
+
+		/** the RGBA8888 pixels, the rows from the top */
+		const unsigned char* getPixels() { return &m_tPixels[0]; }
+
+		/** the pixels modified since clearDirtyRect().
+		@return false if none were
+		*/
+		bool getDirtyRect(unsigned int *pX, unsigned int *pY, unsigned int *pWidth, unsigned int *pHeight);
+		void clearDirtyRect();
+
+	private:
+		struct Shelf
+		{
+			unsigned int uY;
+			unsigned int uHeight;
+			unsigned int uUsedWidth;
+			unsigned int uLastUsed;
+			std::vector<unsigned long long> tKeys;
+		};
+
+		CCGlyphAtlas(const CCGlyphAtlas&);
+		CCGlyphAtlas& operator=(const CCGlyphAtlas&);
+
+		bool addGlyph(unsigned long long key, const char *pszFontName, unsigned int uFontSize, unsigned int uCodePoint, unsigned int uTick, ccGlyph *pGlyph);
+		int shelfForGlyph(unsigned int uWidth, unsigned int uHeight, unsigned int uTick);
+		void evictShelf(unsigned int uShelf);
+		void markDirty(unsigned int uX, unsigned int uY, unsigned int uWidth, unsigned int uHeight);
+
+		unsigned int m_uWidth;
+		unsigned int m_uHeight;
+		std::vector<unsigned char> m_tPixels;
+
+		CCGlyphRasterizer *m_pRasterizer;
+
+		std::unordered_map<unsigned long long, ccGlyph> m_tGlyphs;
+		std::vector<Shelf> m_tShelves;
+		// top of the space without shelves
+		unsigned int m_uNextShelfY;
+
+		std::unordered_map<std::string, unsigned int> m_tFontIDs;
+		std::vector<std::string> m_tFontNames;
+
+		unsigned int m_uGeneration;
+		unsigned int m_uRasterizedCount;
+		unsigned int m_uEvictedShelfCount;
+
+		// dirty rectangle, empty when m_uDirtyLeft >= m_uDirtyRight
+		unsigned int m_uDirtyLeft;
+		unsigned int m_uDirtyTop;
+		unsigned int m_uDirtyRight;
+		unsigned int m_uDirtyBottom;
+
+		// reused by addGlyph()
+		ccGlyphBitmap m_tBitmap;
+	};
+
+} // end of namespace cocos2d
+
+#endif // __SUPPORT_CCGLYPHATLAS_H__
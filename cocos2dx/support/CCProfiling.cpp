@@ -133,3 +133,358 @@ namespace cocos2d
 } // end of namespace cocos2d
 
 #endif // CC_ENABLE_PROFILERS
+
+#include <algorithm>
+#include <stdio.h>
+#include "ccConfig.h"
+#include "CCCommon.h"
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WIN8_METRO)
+#include <windows.h>
+#else
+#include <chrono>
+#endif
+
+namespace cocos2d
+{
+	CCFrameProfiler* CCFrameProfiler::s_pSharedFrameProfiler = NULL;
+
+	static const char* s_pszPhaseNames[kCCProfilePhaseCount] =
+	{
+		"frame",
+		"scheduler",
+		"actions",
+		"particles",
+		"visit",
+		"renderQueue",
+		"present",
+		"textureUpload",
+	};
+
+	static const char* s_pszCounterNames[kCCProfileCounterCount] =
+	{
+		"drawCalls",
+		"quads",
+		"textureUploads",
+		"textureBytes",
+	};
+
+	CCFrameProfiler* CCFrameProfiler::sharedFrameProfiler(void)
+	{
+		if (! s_pSharedFrameProfiler)
+		{
+			s_pSharedFrameProfiler = new CCFrameProfiler();
+		}
+
+		return s_pSharedFrameProfiler;
+	}
+
+	void CCFrameProfiler::purgeSharedFrameProfiler(void)
+	{
+		CC_SAFE_DELETE(s_pSharedFrameProfiler);
+	}
+
+	CCFrameProfiler::CCFrameProfiler(void)
+	: m_bIsEnabled(false)
+	, m_uTotalFrames(0)
+	, m_pCurrentFrame(&m_tPendingFrame)
+	{
+		resetFrame(&m_tPendingFrame);
+		setHistorySize(CC_FRAME_PROFILER_HISTORY);
+	}
+
+	CCFrameProfiler::~CCFrameProfiler(void)
+	{
+	}
+
+	const char* CCFrameProfiler::nameForPhase(ccProfilePhase ePhase)
+	{
+		return s_pszPhaseNames[ePhase];
+	}
+
+	const char* CCFrameProfiler::nameForCounter(ccProfileCounter eCounter)
+	{
+		return s_pszCounterNames[eCounter];
+	}
+
+	double CCFrameProfiler::currentTime(void)
+	{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WIN8_METRO)
+		static LARGE_INTEGER s_frequency = { 0 };
+		if (! s_frequency.QuadPart)
+		{
+			QueryPerformanceFrequency(&s_frequency);
+		}
+
+		LARGE_INTEGER now;
+		QueryPerformanceCounter(&now);
+		return now.QuadPart * 1000000.0 / s_frequency.QuadPart;
+#else
+		return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	void CCFrameProfiler::resetFrame(Frame *pFrame)
+	{
+		pFrame->start = 0;
+		for (int i = 0; i < kCCProfilePhaseCount; ++i)
+		{
+			pFrame->phaseTimes[i] = 0;
+		}
+		for (int i = 0; i < kCCProfileCounterCount; ++i)
+		{
+			pFrame->counters[i] = 0;
+		}
+		// keeps its memory for the next time the frame is used
+		pFrame->events.clear();
+	}
+
+	void CCFrameProfiler::setIsEnabled(bool bEnabled)
+	{
+		m_bIsEnabled = bEnabled;
+
+		// a frame that was being recorded is dropped
+		m_pCurrentFrame = &m_tPendingFrame;
+		resetFrame(&m_tPendingFrame);
+	}
+
+	void CCFrameProfiler::setHistorySize(unsigned int uFrames)
+	{
+		m_frames.clear();
+		m_frames.resize(uFrames > 0 ? uFrames : 1);
+		for (unsigned int i = 0; i < m_frames.size(); ++i)
+		{
+			resetFrame(&m_frames[i]);
+		}
+		m_uTotalFrames = 0;
+		m_pCurrentFrame = &m_tPendingFrame;
+	}
+
+	unsigned int CCFrameProfiler::getFrameCount(void)
+	{
+		return std::min(m_uTotalFrames, (unsigned int)m_frames.size());
+	}
+
+	void CCFrameProfiler::clear(void)
+	{
+		setHistorySize((unsigned int)m_frames.size());
+	}
+
+	CCFrameProfiler::Frame& CCFrameProfiler::frameAt(unsigned int uIndex)
+	{
+		unsigned int uFirst = m_uTotalFrames - getFrameCount();
+		return m_frames[(uFirst + uIndex) % m_frames.size()];
+	}
+
+	void CCFrameProfiler::beginFrame(void)
+	{
+		if (! m_bIsEnabled)
+		{
+			return;
+		}
+
+		Frame& frame = m_frames[m_uTotalFrames % m_frames.size()];
+		resetFrame(&frame);
+		frame.start = currentTime();
+
+		// what was recorded since the last frame belongs to this one
+		for (int i = 0; i < kCCProfilePhaseCount; ++i)
+		{
+			frame.phaseTimes[i] = m_tPendingFrame.phaseTimes[i];
+		}
+		for (int i = 0; i < kCCProfileCounterCount; ++i)
+		{
+			frame.counters[i] = m_tPendingFrame.counters[i];
+		}
+		frame.events.swap(m_tPendingFrame.events);
+		resetFrame(&m_tPendingFrame);
+
+		m_pCurrentFrame = &frame;
+	}
+
+	void CCFrameProfiler::endFrame(void)
+	{
+		if (! m_bIsEnabled || m_pCurrentFrame == &m_tPendingFrame)
+		{
+			return;
+		}
+
+		endPhase(kCCProfilePhaseFrame, m_pCurrentFrame->start);
+
+		++m_uTotalFrames;
+		m_pCurrentFrame = &m_tPendingFrame;
+	}
+
+	double CCFrameProfiler::beginPhase(ccProfilePhase ePhase)
+	{
+		CC_UNUSED_PARAM(ePhase);
+		return currentTime();
+	}
+
+	void CCFrameProfiler::endPhase(ccProfilePhase ePhase, double dStartTime)
+	{
+		Event event;
+		event.phase = ePhase;
+		event.start = dStartTime;
+		event.duration = currentTime() - dStartTime;
+
+		m_pCurrentFrame->phaseTimes[ePhase] += event.duration;
+		m_pCurrentFrame->events.push_back(event);
+	}
+
+	ccProfileStats CCFrameProfiler::computeStats(std::vector<double>& values)
+	{
+		ccProfileStats stats = { 0, 0, 0, 0 };
+		if (values.empty())
+		{
+			return stats;
+		}
+
+		double sum = 0;
+		stats.min = values[0];
+		stats.max = values[0];
+		for (unsigned int i = 0; i < values.size(); ++i)
+		{
+			sum += values[i];
+			stats.min = std::min(stats.min, values[i]);
+			stats.max = std::max(stats.max, values[i]);
+		}
+		stats.avg = sum / values.size();
+
+		// nearest rank
+		unsigned int uRank = (unsigned int)((values.size() * 99 + 99) / 100) - 1;
+		std::nth_element(values.begin(), values.begin() + uRank, values.end());
+		stats.p99 = values[uRank];
+
+		return stats;
+	}
+
+	ccProfileStats CCFrameProfiler::getPhaseStats(ccProfilePhase ePhase)
+	{
+		std::vector<double> values(getFrameCount());
+		for (unsigned int i = 0; i < values.size(); ++i)
+		{
+			values[i] = frameAt(i).phaseTimes[ePhase] / 1000.0;
+		}
+		return computeStats(values);
+	}
+
+	ccProfileStats CCFrameProfiler::getCounterStats(ccProfileCounter eCounter)
+	{
+		std::vector<double> values(getFrameCount());
+		for (unsigned int i = 0; i < values.size(); ++i)
+		{
+			values[i] = frameAt(i).counters[eCounter];
+		}
+		return computeStats(values);
+	}
+
+	static void writeStats(FILE *fp, const char *pszName, const ccProfileStats& stats, bool bLast)
+	{
+		fprintf(fp, "\t\t\"%s\": {\"min\": %.4f, \"avg\": %.4f, \"p99\": %.4f, \"max\": %.4f}%s\n",
+			pszName, stats.min, stats.avg, stats.p99, stats.max, bLast ? "" : ",");
+	}
+
+	bool CCFrameProfiler::dumpStatsToFile(const char *pszFilePath)
+	{
+		FILE *fp = fopen(pszFilePath, "w");
+		if (! fp)
+		{
+			CCLOG("cocos2d: CCFrameProfiler: can't write %s", pszFilePath);
+			return false;
+		}
+
+		unsigned int uFrames = getFrameCount();
+		fprintf(fp, "{\n\t\"frames\": %u,\n", uFrames);
+
+		// milliseconds
+		fprintf(fp, "\t\"phases\": {\n");
+		for (int i = 0; i < kCCProfilePhaseCount; ++i)
+		{
+			writeStats(fp, s_pszPhaseNames[i], getPhaseStats((ccProfilePhase)i), i == kCCProfilePhaseCount - 1);
+		}
+		fprintf(fp, "\t},\n");
+
+		fprintf(fp, "\t\"counters\": {\n");
+		for (int i = 0; i < kCCProfileCounterCount; ++i)
+		{
+			writeStats(fp, s_pszCounterNames[i], getCounterStats((ccProfileCounter)i), i == kCCProfileCounterCount - 1);
+		}
+		fprintf(fp, "\t},\n");
+
+		// one object per frame, oldest first
+		fprintf(fp, "\t\"history\": [\n");
+		for (unsigned int n = 0; n < uFrames; ++n)
+		{
+			Frame& frame = frameAt(n);
+			fprintf(fp, "\t\t{");
+			for (int i = 0; i < kCCProfilePhaseCount; ++i)
+			{
+				fprintf(fp, "\"%s\": %.4f, ", s_pszPhaseNames[i], frame.phaseTimes[i] / 1000.0);
+			}
+			for (int i = 0; i < kCCProfileCounterCount; ++i)
+			{
+				fprintf(fp, "\"%s\": %u%s", s_pszCounterNames[i], frame.counters[i], i == kCCProfileCounterCount - 1 ? "" : ", ");
+			}
+			fprintf(fp, "}%s\n", n == uFrames - 1 ? "" : ",");
+		}
+		fprintf(fp, "\t]\n}\n");
+
+		fclose(fp);
+		return true;
+	}
+
+	bool CCFrameProfiler::dumpChromeTraceToFile(const char *pszFilePath)
+	{
+		FILE *fp = fopen(pszFilePath, "w");
+		if (! fp)
+		{
+			CCLOG("cocos2d: CCFrameProfiler: can't write %s", pszFilePath);
+			return false;
+		}
+
+		unsigned int uFrames = getFrameCount();
+
+		// timestamps start at the first recorded event
+		double dOrigin = 0;
+		for (unsigned int n = 0; n < uFrames; ++n)
+		{
+			Frame& frame = frameAt(n);
+			for (unsigned int i = 0; i < frame.events.size(); ++i)
+			{
+				if ((n == 0 && i == 0) || frame.events[i].start < dOrigin)
+				{
+					dOrigin = frame.events[i].start;
+				}
+			}
+		}
+
+		fprintf(fp, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+		bool bFirst = true;
+		for (unsigned int n = 0; n < uFrames; ++n)
+		{
+			Frame& frame = frameAt(n);
+			for (unsigned int i = 0; i < frame.events.size(); ++i)
+			{
+				const Event& event = frame.events[i];
+				fprintf(fp, "%s{\"name\": \"%s\", \"cat\": \"cocos2d\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": %.3f, \"dur\": %.3f}",
+					bFirst ? "" : ",\n", s_pszPhaseNames[event.phase], event.start - dOrigin, event.duration);
+				bFirst = false;
+			}
+
+			// the counters of the frame, drawn as graphs
+			fprintf(fp, "%s{\"name\": \"counters\", \"ph\": \"C\", \"pid\": 1, \"ts\": %.3f, \"args\": {", bFirst ? "" : ",\n", frame.start - dOrigin);
+			for (int i = 0; i < kCCProfileCounterCount; ++i)
+			{
+				fprintf(fp, "\"%s\": %u%s", s_pszCounterNames[i], frame.counters[i], i == kCCProfileCounterCount - 1 ? "" : ", ");
+			}
+			fprintf(fp, "}}");
+			bFirst = false;
+		}
+		fprintf(fp, "\n]}\n");
+
+		fclose(fp);
+		return true;
+	}
+
+} // end of namespace cocos2d
@@ -77,4 +77,198 @@ namespace cocos2d
 } // end of namespace cocos2d
 
 #endif // CC_ENABLE_PROFILERS
+
+#include <vector>
+#include "CCPlatformMacros.h"
+
+namespace cocos2d
+{
+	//* @enum
+	/** Phases of a frame timed by CCFrameProfiler. Phases nest, the time of a phase includes its inner phases. */
+	typedef enum
+	{
+		//! CCDirector::drawScene
+		kCCProfilePhaseFrame,
+		//! CCScheduler::tick, which runs the actions and the particle systems
+		kCCProfilePhaseScheduler,
+		//! CCActionManager::update
+		kCCProfilePhaseActions,
+		//! CCParticleSystem::update
+		kCCProfilePhaseParticles,
+		//! visit and draw of the scene graph
+		kCCProfilePhaseVisit,
+		//! execution of the CCRenderQueue commands
+		kCCProfilePhaseRenderQueue,
+		//! CCEGLView::swapBuffers, the last batch of draws and the present, which may wait for vsync
+		kCCProfilePhasePresent,
+		//! creation of textures from pixel data
+		kCCProfilePhaseTextureUpload,
+
+		kCCProfilePhaseCount,
+	} ccProfilePhase;
+
+	//* @enum
+	/** Counters reset at the beginning of every frame */
+	typedef enum
+	{
+		kCCProfileCounterDrawCalls,
+		kCCProfileCounterQuads,
+		kCCProfileCounterTextureUploads,
+		kCCProfileCounterTextureBytes,
+
+		kCCProfileCounterCount,
+	} ccProfileCounter;
+
+	/** Statistics of a phase or a counter over the frames kept by CCFrameProfiler.
+	Phase times are in milliseconds.
+	*/
+	typedef struct _ccProfileStats
+	{
+		double min;
+		double avg;
+		double p99;
+		double max;
+	} ccProfileStats;
+
+	/** @brief Records the time spent in each phase of the last frames, and the draw calls, quads and
+	texture uploads of those frames.
+
+	The profiler is always compiled in and costs a flag test per hook while it is disabled.
+	It must only be used from the main thread. CCDirector calls beginFrame() and endFrame()
+	around every frame; work done between two frames, like in touch handlers, is accounted
+	to the next frame.
+	The history can be written as JSON statistics or as a Chrome trace (chrome://tracing).
+	@since v1.0
+	*/
+	class CC_DLL CCFrameProfiler
+	{
+	public:
+		~CCFrameProfiler(void);
+
+		static CCFrameProfiler* sharedFrameProfiler(void);
+		static void purgeSharedFrameProfiler(void);
+
+		/** true if the shared profiler exists and is enabled, checked by every hook */
+		static inline bool isRecording(void) { return s_pSharedFrameProfiler && s_pSharedFrameProfiler->m_bIsEnabled; }
+
+		/** adds n to a counter of the current frame */
+		static inline void addCount(ccProfileCounter eCounter, unsigned int n)
+		{
+			if (isRecording())
+			{
+				s_pSharedFrameProfiler->m_pCurrentFrame->counters[eCounter] += n;
+			}
+		}
+		/** counts a draw call of uQuads quads */
+		static inline void addDrawCall(unsigned int uQuads)
+		{
+			if (isRecording())
+			{
+				s_pSharedFrameProfiler->m_pCurrentFrame->counters[kCCProfileCounterDrawCalls] += 1;
+				s_pSharedFrameProfiler->m_pCurrentFrame->counters[kCCProfileCounterQuads] += uQuads;
+			}
+		}
+
+		/** enables or disables the profiler, the history is kept */
+		void setIsEnabled(bool bEnabled);
+		bool getIsEnabled(void) { return m_bIsEnabled; }
+
+		/** number of frames kept in the history, CC_FRAME_PROFILER_HISTORY by default. Clears the history. */
+		void setHistorySize(unsigned int uFrames);
+		unsigned int getHistorySize(void) { return (unsigned int)m_frames.size(); }
+		/** number of frames in the history */
+		unsigned int getFrameCount(void);
+		/** forgets the recorded frames */
+		void clear(void);
+
+		void beginFrame(void);
+		void endFrame(void);
+
+		/** starts a phase, returns the start time to pass to endPhase */
+		double beginPhase(ccProfilePhase ePhase);
+		void endPhase(ccProfilePhase ePhase, double dStartTime);
+
+		ccProfileStats getPhaseStats(ccProfilePhase ePhase);
+		ccProfileStats getCounterStats(ccProfileCounter eCounter);
+
+		/** writes min/avg/p99/max of every phase and counter, and the per frame history, as JSON
+		@return false if the file can't be written
+		*/
+		bool dumpStatsToFile(const char *pszFilePath);
+		/** writes the history in the Chrome trace event format
+		@return false if the file can't be written
+		*/
+		bool dumpChromeTraceToFile(const char *pszFilePath);
+
+		static const char* nameForPhase(ccProfilePhase ePhase);
+		static const char* nameForCounter(ccProfileCounter eCounter);
+
+	protected:
+		CCFrameProfiler(void);
+
+		struct Event
+		{
+			ccProfilePhase phase;
+			// microseconds, from currentTime()
+			double start;
+			double duration;
+		};
+
+		struct Frame
+		{
+			double start;
+			double phaseTimes[kCCProfilePhaseCount];
+			unsigned int counters[kCCProfileCounterCount];
+			std::vector<Event> events;
+		};
+
+		static double currentTime(void);
+		void resetFrame(Frame *pFrame);
+		ccProfileStats computeStats(std::vector<double>& values);
+		Frame& frameAt(unsigned int uIndex);
+
+	protected:
+		static CCFrameProfiler *s_pSharedFrameProfiler;
+
+		bool m_bIsEnabled;
+		std::vector<Frame> m_frames;
+		// frames recorded so far, the last getHistorySize() are kept
+		unsigned int m_uTotalFrames;
+		// collects what happens between two frames
+		Frame m_tPendingFrame;
+		// frame being recorded, m_tPendingFrame outside of beginFrame()/endFrame()
+		Frame *m_pCurrentFrame;
+	};
+
+	/** @brief Times a phase from its construction to the end of the scope
+	@since v1.0
+	*/
+	class CCProfileScope
+	{
+	public:
+		inline CCProfileScope(ccProfilePhase ePhase)
+		: m_ePhase(ePhase)
+		, m_dStartTime(-1)
+		{
+			if (CCFrameProfiler::isRecording())
+			{
+				m_dStartTime = CCFrameProfiler::sharedFrameProfiler()->beginPhase(ePhase);
+			}
+		}
+
+		inline ~CCProfileScope(void)
+		{
+			if (m_dStartTime >= 0 && CCFrameProfiler::isRecording())
+			{
+				CCFrameProfiler::sharedFrameProfiler()->endPhase(m_ePhase, m_dStartTime);
+			}
+		}
+
+	private:
+		ccProfilePhase m_ePhase;
+		double m_dStartTime;
+	};
+
+} // end of namespace cocos2d
+
 #endif // __SUPPORT_CCPROFILING_H__
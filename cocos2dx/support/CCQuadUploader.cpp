@@ -0,0 +1,111 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CCQuadUploader.h"
+
+namespace cocos2d
+{
+	CCQuadUploader::CCQuadUploader()
+		: m_uCapacity(0)
+		, m_uDirtyStart(0)
+		, m_uDirtyEnd(0)
+	{
+	}
+
+	void CCQuadUploader::setCapacity(unsigned int uCapacity)
+	{
+		m_uCapacity = uCapacity;
+		m_uDirtyEnd = m_uDirtyEnd < uCapacity ? m_uDirtyEnd : uCapacity;
+	}
+
+	void CCQuadUploader::setDirtyRange(unsigned int uStart, unsigned int uEnd)
+	{
+		uEnd = uEnd < m_uCapacity ? uEnd : m_uCapacity;
+		if (uStart >= uEnd)
+		{
+			return;
+		}
+
+		if (m_uDirtyStart >= m_uDirtyEnd)
+		{
+			m_uDirtyStart = uStart;
+			m_uDirtyEnd = uEnd;
+		}
+		else
+		{
+			m_uDirtyStart = uStart < m_uDirtyStart ? uStart : m_uDirtyStart;
+			m_uDirtyEnd = uEnd > m_uDirtyEnd ? uEnd : m_uDirtyEnd;
+		}
+	}
+
+	bool CCQuadUploader::getDirtyRange(unsigned int *pStart, unsigned int *pEnd)
+	{
+		if (m_uDirtyStart >= m_uDirtyEnd)
+		{
+			return false;
+		}
+
+		*pStart = m_uDirtyStart;
+		*pEnd = m_uDirtyEnd;
+		return true;
+	}
+
+	unsigned int CCQuadUploader::upload(const ccV3F_C4B_T2F_Quad *pQuads, unsigned int uEnd, CCVertexBufferTarget *pTarget)
+	{
+		uEnd = uEnd < m_uDirtyEnd ? uEnd : m_uDirtyEnd;
+		if (m_uDirtyStart >= uEnd)
+		{
+			return 0;
+		}
+
+		unsigned int uCount = uEnd - m_uDirtyStart;
+		if (m_tVertices.size() < uCount * 4)
+		{
+			m_tVertices.resize(uCount * 4);
+		}
+
+		const float inv255 = 1.0f / 255.0f;
+		const ccV3F_C4B_T2F_Quad *pQuad = pQuads + m_uDirtyStart;
+		ccV3F_C4F_T2F *pVertex = &m_tVertices[0];
+		for (unsigned int i = 0; i < uCount; ++i)
+		{
+			const ccV3F_C4B_T2F *corners[4] = { &pQuad->tl, &pQuad->tr, &pQuad->br, &pQuad->bl };
+			for (int j = 0; j < 4; ++j)
+			{
+				const ccV3F_C4B_T2F *pCorner = corners[j];
+				pVertex->vertices = pCorner->vertices;
+				pVertex->colors.r = pCorner->colors.r * inv255;
+				pVertex->colors.g = pCorner->colors.g * inv255;
+				pVertex->colors.b = pCorner->colors.b * inv255;
+				pVertex->colors.a = pCorner->colors.a * inv255;
+				pVertex->texCoords = pCorner->texCoords;
+				++pVertex;
+			}
+			++pQuad;
+		}
+
+		pTarget->updateVertices(&m_tVertices[0], m_uDirtyStart * 4, uCount * 4);
+		m_uDirtyStart = uEnd;
+		return uCount;
+	}
+} // end of namespace cocos2d
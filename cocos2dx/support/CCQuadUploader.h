@@ -0,0 +1,83 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __SUPPORT_CCQUADUPLOADER_H__
+#define __SUPPORT_CCQUADUPLOADER_H__
+
+#include "ccTypes.h"
+#include <vector>
+
+namespace cocos2d
+{
+	/** @brief Receives the vertices uploaded by a CCQuadUploader, usually a vertex buffer of the GPU.
+	@since v1.0
+	*/
+	class CC_DLL CCVertexBufferTarget
+	{
+	public:
+		virtual ~CCVertexBufferTarget() {}
+
+		/** writes uCount vertices into the buffer, from the vertex uFirst */
+		virtual void updateVertices(const ccV3F_C4F_T2F *pVertices, unsigned int uFirst, unsigned int uCount) = 0;
+	};
+
+	/**
+	@brief The quads of a CCTextureAtlas that changed since they were uploaded to the GPU.
+
+	The modified quads are kept as a single range. A draw uploads only the part of that range
+	it is going to draw, the rest stays pending. The quads are converted to ccV3F_C4F_T2F
+	vertices, four per quad in the order tl, tr, br, bl, in an array that only grows.
+	@since v1.0
+	*/
+	class CC_DLL CCQuadUploader
+	{
+	public:
+		CCQuadUploader();
+
+		/** the number of quads of the buffer, the dirty range is clamped to it */
+		void setCapacity(unsigned int uCapacity);
+		unsigned int getCapacity() { return m_uCapacity; }
+
+		/** marks the quads in [uStart, uEnd) as modified */
+		void setDirtyRange(unsigned int uStart, unsigned int uEnd);
+
+		/** the modified quads that weren't uploaded yet.
+		@return false if there are none
+		*/
+		bool getDirtyRange(unsigned int *pStart, unsigned int *pEnd);
+
+		/** uploads the modified quads below uEnd.
+		@return the number of quads uploaded
+		*/
+		unsigned int upload(const ccV3F_C4B_T2F_Quad *pQuads, unsigned int uEnd, CCVertexBufferTarget *pTarget);
+
+	private:
+		unsigned int m_uCapacity;
+		// range [m_uDirtyStart, m_uDirtyEnd) of quads that changed since the last upload
+		unsigned int m_uDirtyStart;
+		unsigned int m_uDirtyEnd;
+		std::vector<ccV3F_C4F_T2F> m_tVertices;
+	};
+} // end of namespace cocos2d
+
+#endif // __SUPPORT_CCQUADUPLOADER_H__
@@ -0,0 +1,413 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "CCRenderQueue.h"
+#include "CCTexture2D.h"
+#include "CCNode.h"
+#include "ccMacros.h"
+#include "CCProfiling.h"
+#include <algorithm>
+#include <string.h>
+
+namespace   cocos2d {
+
+static CCRenderQueue *s_pSharedRenderQueue = NULL;
+
+// only the quad commands are merged
+static inline bool ccRenderCommandStateEqual(const ccRenderCommand& a, const ccRenderCommand& b)
+{
+	return ! a.node && ! b.node
+		&& a.texture == b.texture
+		&& a.blendFunc.src == b.blendFunc.src
+		&& a.blendFunc.dst == b.blendFunc.dst
+		&& a.projection == b.projection;
+}
+
+// orders the commands of a sort group by key, then by state
+static bool ccRenderCommandStateLess(const ccRenderCommand& a, const ccRenderCommand& b)
+{
+	if (a.sortKey != b.sortKey)
+	{
+		return a.sortKey < b.sortKey;
+	}
+	if (a.texture != b.texture)
+	{
+		return a.texture < b.texture;
+	}
+	if (a.blendFunc.src != b.blendFunc.src)
+	{
+		return a.blendFunc.src < b.blendFunc.src;
+	}
+	if (a.blendFunc.dst != b.blendFunc.dst)
+	{
+		return a.blendFunc.dst < b.blendFunc.dst;
+	}
+	return a.projection < b.projection;
+}
+
+static inline void ccTransformVertex(ccVertex3F& v, const float *m)
+{
+	float x = v.x, y = v.y, z = v.z;
+	v.x = x * m[0] + y * m[4] + z * m[8] + m[12];
+	v.y = x * m[1] + y * m[5] + z * m[9] + m[13];
+	v.z = x * m[2] + y * m[6] + z * m[10] + m[14];
+}
+
+void CCRenderQueue::Batch::swap(Batch& other)
+{
+	commands.swap(other.commands);
+	quads.swap(other.quads);
+	sortedQuads.swap(other.sortedQuads);
+	projections.swap(other.projections);
+	views.swap(other.views);
+	std::swap(hasSortGroups, other.hasSortGroups);
+}
+
+CCRenderQueue::CCRenderQueue(void)
+: m_pBackend(NULL)
+, m_uFlushDepth(0)
+, m_uCurrentSortGroup(0)
+, m_uSortGroupDepth(0)
+, m_nSortKey(0)
+, m_uBatchCapacity(0)
+, m_uDrawCalls(0)
+, m_uQuadsDrawn(0)
+, m_uNodesDrawn(0)
+{
+}
+
+CCRenderQueue::~CCRenderQueue(void)
+{
+	clear(m_tRecording);
+	for (std::vector<Batch*>::iterator it = m_pExecuting.begin(); it != m_pExecuting.end(); ++it)
+	{
+		delete *it;
+	}
+}
+
+CCRenderQueue* CCRenderQueue::sharedRenderQueue(void)
+{
+	if (! s_pSharedRenderQueue)
+	{
+		s_pSharedRenderQueue = new CCRenderQueue();
+	}
+
+	return s_pSharedRenderQueue;
+}
+
+void CCRenderQueue::purgeSharedRenderQueue(void)
+{
+	CC_SAFE_DELETE(s_pSharedRenderQueue);
+}
+
+void CCRenderQueue::setBackend(CCRenderBackend *pBackend)
+{
+	if (pBackend != m_pBackend)
+	{
+		// the recorded commands belong to the previous backend
+		flush();
+		m_pBackend = pBackend;
+	}
+}
+
+CCRenderBackend* CCRenderQueue::getBackend(void)
+{
+	return m_pBackend;
+}
+
+unsigned int CCRenderQueue::addProjection(const float *projection)
+{
+	std::vector<float>& projections = m_tRecording.projections;
+	unsigned int projectionCount = (unsigned int)projections.size() / 16;
+	if (projectionCount > 0 && memcmp(&projections[16 * (projectionCount - 1)], projection, sizeof(float) * 16) == 0)
+	{
+		return projectionCount - 1;
+	}
+
+	projections.insert(projections.end(), projection, projection + 16);
+	return projectionCount;
+}
+
+void CCRenderQueue::addQuad(CCTexture2D *pTexture, const ccBlendFunc& blendFunc, const ccV3F_C4B_T2F_Quad& quad, const float *view, const float *projection)
+{
+	ccV3F_C4B_T2F_Quad transformed = quad;
+	ccTransformVertex(transformed.tl.vertices, view);
+	ccTransformVertex(transformed.tr.vertices, view);
+	ccTransformVertex(transformed.br.vertices, view);
+	ccTransformVertex(transformed.bl.vertices, view);
+	m_tRecording.quads.push_back(transformed);
+
+	ccRenderCommand command;
+	command.node = NULL;
+	command.texture = pTexture;
+	command.blendFunc = blendFunc;
+	command.projection = addProjection(projection);
+	command.view = 0;
+	command.sortGroup = m_uCurrentSortGroup;
+	command.sortKey = m_nSortKey;
+	command.quadStart = (unsigned int)m_tRecording.quads.size() - 1;
+	command.quadCount = 1;
+
+	std::vector<ccRenderCommand>& commands = m_tRecording.commands;
+	if (! commands.empty())
+	{
+		ccRenderCommand& last = commands.back();
+		if (last.sortGroup == command.sortGroup && last.sortKey == command.sortKey && ccRenderCommandStateEqual(last, command)
+			&& (m_uBatchCapacity == 0 || last.quadCount < m_uBatchCapacity))
+		{
+			++last.quadCount;
+			return;
+		}
+	}
+
+	if (command.sortGroup & 1)
+	{
+		m_tRecording.hasSortGroups = true;
+	}
+
+	// the texture is retained until the command is executed
+	CC_SAFE_RETAIN(pTexture);
+	commands.push_back(command);
+}
+
+void CCRenderQueue::addNode(CCNode *pNode, const float *view, const float *projection)
+{
+	CCAssert(pNode, "node should not be null");
+
+	std::vector<float>& views = m_tRecording.views;
+
+	ccRenderCommand command;
+	command.node = pNode;
+	command.texture = NULL;
+	command.blendFunc.src = CC_BLEND_SRC;
+	command.blendFunc.dst = CC_BLEND_DST;
+	command.projection = addProjection(projection);
+	command.view = (unsigned int)views.size() / 16;
+	command.sortGroup = m_uCurrentSortGroup;
+	command.sortKey = m_nSortKey;
+	command.quadStart = (unsigned int)m_tRecording.quads.size();
+	command.quadCount = 0;
+	views.insert(views.end(), view, view + 16);
+
+	// the node is retained until the command is executed
+	pNode->retain();
+	m_tRecording.commands.push_back(command);
+}
+
+void CCRenderQueue::beginSortGroup(void)
+{
+	if (m_uSortGroupDepth++ == 0)
+	{
+		++m_uCurrentSortGroup;
+		m_nSortKey = 0;
+	}
+}
+
+void CCRenderQueue::endSortGroup(void)
+{
+	CCAssert(m_uSortGroupDepth > 0, "endSortGroup without beginSortGroup");
+	if (--m_uSortGroupDepth == 0)
+	{
+		++m_uCurrentSortGroup;
+		m_nSortKey = 0;
+	}
+}
+
+void CCRenderQueue::setSortKey(int nKey)
+{
+	// the keys of a nested group would reorder the commands of the outermost one
+	if (m_uSortGroupDepth == 1)
+	{
+		m_nSortKey = nKey;
+	}
+}
+
+void CCRenderQueue::setBatchCapacity(unsigned int uCapacity)
+{
+	m_uBatchCapacity = uCapacity;
+}
+
+void CCRenderQueue::sortCommands(Batch& batch)
+{
+	std::vector<ccRenderCommand>& commands = batch.commands;
+	unsigned int count = (unsigned int)commands.size();
+	unsigned int begin = 0;
+	while (begin < count)
+	{
+		// the node commands end the runs that are sorted
+		unsigned int end = begin + 1;
+		if (! commands[begin].node)
+		{
+			while (end < count && ! commands[end].node && commands[end].sortGroup == commands[begin].sortGroup)
+			{
+				++end;
+			}
+		}
+
+		if ((commands[begin].sortGroup & 1) && end - begin > 1)
+		{
+			std::stable_sort(commands.begin() + begin, commands.begin() + end, ccRenderCommandStateLess);
+		}
+		begin = end;
+	}
+
+	// lay the quads out in execution order, so the sorted commands can be merged
+	batch.sortedQuads.resize(batch.quads.size());
+	unsigned int offset = 0;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		ccRenderCommand& command = commands[i];
+		if (command.quadCount > 0)
+		{
+			memcpy(&batch.sortedQuads[offset], &batch.quads[command.quadStart], sizeof(ccV3F_C4B_T2F_Quad) * command.quadCount);
+		}
+		command.quadStart = offset;
+		offset += command.quadCount;
+	}
+}
+
+void CCRenderQueue::mergeCommands(Batch& batch)
+{
+	std::vector<ccRenderCommand>& commands = batch.commands;
+	unsigned int count = (unsigned int)commands.size();
+	if (count == 0)
+	{
+		return;
+	}
+
+	unsigned int last = 0;
+	for (unsigned int i = 1; i < count; ++i)
+	{
+		ccRenderCommand& command = commands[i];
+		if (ccRenderCommandStateEqual(commands[last], command)
+			&& commands[last].quadStart + commands[last].quadCount == command.quadStart
+			&& (m_uBatchCapacity == 0 || commands[last].quadCount + command.quadCount <= m_uBatchCapacity))
+		{
+			commands[last].quadCount += command.quadCount;
+			CC_SAFE_RELEASE(command.texture);
+		}
+		else
+		{
+			commands[++last] = command;
+		}
+	}
+	commands.resize(last + 1);
+}
+
+void CCRenderQueue::flush(void)
+{
+	if (m_tRecording.commands.empty())
+	{
+		return;
+	}
+
+	// the commands recorded while these ones are executed go to an empty batch
+	if (m_uFlushDepth == m_pExecuting.size())
+	{
+		m_pExecuting.push_back(new Batch());
+	}
+	Batch *pBatch = m_pExecuting[m_uFlushDepth++];
+	pBatch->swap(m_tRecording);
+
+	if (m_uFlushDepth == 1)
+	{
+		CCProfileScope scope(kCCProfilePhaseRenderQueue);
+		execute(*pBatch);
+	}
+	else
+	{
+		execute(*pBatch);
+	}
+
+	clear(*pBatch);
+	--m_uFlushDepth;
+
+	if (m_uFlushDepth == 0 && m_uSortGroupDepth == 0)
+	{
+		m_uCurrentSortGroup = 0;
+	}
+}
+
+void CCRenderQueue::execute(Batch& batch)
+{
+	if (! m_pBackend)
+	{
+		return;
+	}
+
+	const ccV3F_C4B_T2F_Quad *quads = batch.quads.empty() ? NULL : &batch.quads[0];
+	if (batch.hasSortGroups)
+	{
+		sortCommands(batch);
+		mergeCommands(batch);
+		quads = batch.sortedQuads.empty() ? NULL : &batch.sortedQuads[0];
+	}
+
+	unsigned int count = (unsigned int)batch.commands.size();
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const ccRenderCommand& command = batch.commands[i];
+		const float *projection = &batch.projections[16 * command.projection];
+		if (command.node)
+		{
+			m_pBackend->drawNode(command, &batch.views[16 * command.view], projection);
+			++m_uNodesDrawn;
+
+			// what the node recorded while it was drawn, like the scenes of a transition, is drawn over it
+			flush();
+		}
+		else
+		{
+			m_pBackend->drawQuads(command, projection, quads + command.quadStart);
+			++m_uDrawCalls;
+			m_uQuadsDrawn += command.quadCount;
+		}
+	}
+}
+
+void CCRenderQueue::resetStats(void)
+{
+	m_uDrawCalls = 0;
+	m_uQuadsDrawn = 0;
+	m_uNodesDrawn = 0;
+}
+
+void CCRenderQueue::clear(Batch& batch)
+{
+	for (std::vector<ccRenderCommand>::iterator it = batch.commands.begin(); it != batch.commands.end(); ++it)
+	{
+		CC_SAFE_RELEASE(it->texture);
+		CC_SAFE_RELEASE(it->node);
+	}
+
+	// the vectors keep their memory for the next frame
+	batch.commands.clear();
+	batch.quads.clear();
+	batch.sortedQuads.clear();
+	batch.projections.clear();
+	batch.views.clear();
+	batch.hasSortGroups = false;
+}
+
+}//namespace   cocos2d 
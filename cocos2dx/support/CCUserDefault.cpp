@@ -22,8 +22,13 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 #include "CCUserDefault.h"
+#include "CCScheduler.h"
 #include "platform/CCFileUtils.h"
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_WIN8_METRO)
+#include <windows.h>
+#endif
+
 //#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
 #include <libxml/parser.h>
 #include <libxml/tree.h>
@@ -38,143 +43,217 @@ THE SOFTWARE.
 
 #define XML_FILE_NAME "UserDefault.xml"
 
+// the file is written here first and renamed once it is complete
+#define XML_TEMP_FILE_SUFFIX ".tmp"
+
 using namespace std;
 
 NS_CC_BEGIN;
 
+// replaces destPath by srcPath in one step, so the file is never missing
+static bool replaceFile(const string& srcPath, const string& destPath)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN8_METRO)
+	return MoveFileExW(CCUtf8ToUnicode(srcPath.c_str()).c_str(), CCUtf8ToUnicode(destPath.c_str()).c_str(),
+		MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE;
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+	// rename doesn't replace an existing file on windows
+	return MoveFileExA(srcPath.c_str(), destPath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE;
+#else
+	return rename(srcPath.c_str(), destPath.c_str()) == 0;
+#endif
+}
+
 /**
- * define the functions here because we don't want to
- * export xmlNodePtr and other types in "CCUserDefault.h"
+ * implements of CCUserDefault
  */
 
-static xmlNodePtr getXMLNodeForKey(const char* pKey, xmlNodePtr *rootNode, xmlDocPtr *doc)
+CCUserDefault* CCUserDefault::m_spUserDefault = 0;
+string CCUserDefault::m_sFilePath = string("");
+bool CCUserDefault::m_sbIsFilePathInitialized = false;
+
+CCUserDefault::CCUserDefault()
+: m_bIsDirty(false)
+, m_fAutoFlushInterval(0)
 {
-	xmlNodePtr curNode = NULL;
+	loadXMLFile();
+}
 
-	// check the key value
-	if (! pKey)
+/**
+ * If the user invoke delete CCUserDefault::sharedUserDefault(), should set m_spUserDefault
+ * to null to avoid error when he invoke CCUserDefault::sharedUserDefault() later.
+ */
+CCUserDefault::~CCUserDefault()
+{
+	setAutoFlushInterval(0);
+	flush();
+
+	m_spUserDefault = NULL;
+}
+
+void CCUserDefault::loadXMLFile()
+{
+	xmlDocPtr doc = xmlReadFile(m_sFilePath.c_str(), "utf-8", XML_PARSE_RECOVER);
+	if (NULL == doc)
 	{
-		return NULL;
+		CCLOG("can not read xml file");
+		return;
 	}
 
-	do 
+	xmlNodePtr rootNode = xmlDocGetRootElement(doc);
+	if (NULL == rootNode)
 	{
-		// read doc
-		*doc = xmlReadFile(CCUserDefault::sharedUserDefault()->getXMLFilePath().c_str(), "utf-8", XML_PARSE_RECOVER);
-		if (NULL == *doc)
-		{
-			CCLOG("can not read xml file");
-			break;
-		}
+		CCLOG("read root node error");
+		xmlFreeDoc(doc);
+		return;
+	}
 
-		// get root node
-		*rootNode = xmlDocGetRootElement(*doc);
-		if (NULL == *rootNode)
+	for (xmlNodePtr curNode = rootNode->xmlChildrenNode; NULL != curNode; curNode = curNode->next)
+	{
+		if (curNode->type != XML_ELEMENT_NODE)
 		{
-			CCLOG("read root node error");
-			break;
+			continue;
 		}
 
-		// find the node
-		curNode = (*rootNode)->xmlChildrenNode;
-		while (NULL != curNode)
+		xmlChar* content = xmlNodeGetContent(curNode);
+		// the first node wins, as the linear search used to do
+		m_values.insert(make_pair(string((const char*)curNode->name), string(content ? (const char*)content : "")));
+		if (content)
 		{
-			if (! xmlStrcmp(curNode->name, BAD_CAST pKey))
-			{
-				break;
-			}
-
-			curNode = curNode->next;
+			xmlFree(content);
 		}
-	} while (0);
+	}
 
-	return curNode;
+	xmlFreeDoc(doc);
 }
 
-static inline const char* getValueForKey(const char* pKey)
+const char* CCUserDefault::getValueForKey(const char* pKey)
 {
-	const char* ret = NULL;
-	xmlNodePtr rootNode;
-	xmlDocPtr doc;
-	xmlNodePtr node = getXMLNodeForKey(pKey, &rootNode, &doc);
-
-	// find the node
-	if (node)
+	if (! pKey)
 	{
-		ret = (const char*)xmlNodeGetContent(node);
+		return NULL;
 	}
 
-	// free doc
-	if (doc)
+	unordered_map<string, string>::const_iterator it = m_values.find(pKey);
+	if (it == m_values.end())
 	{
-		xmlFreeDoc(doc);
+		return NULL;
 	}
 
-	return ret;
+	return it->second.c_str();
 }
 
-static void setValueForKey(const char* pKey, const char* pValue)
+void CCUserDefault::setValueForKey(const char* pKey, const char* pValue)
 {
-	xmlNodePtr rootNode;
-	xmlDocPtr doc;
-	xmlNodePtr node;
-
 	// check the params
 	if (! pKey || ! pValue)
 	{
 		return;
 	}
 
-	// find the node
-	node = getXMLNodeForKey(pKey, &rootNode, &doc);
+	string& value = m_values[pKey];
+	if (value != pValue)
+	{
+		value = pValue;
+		m_bIsDirty = true;
+	}
+}
 
-	// if node exist, change the content
-	if (node)
+void CCUserDefault::flush()
+{
+	if (! m_bIsDirty)
 	{
-		xmlNodeSetContent(node, BAD_CAST pValue);
+		return;
 	}
-	else
+
+	xmlDocPtr doc = NULL;
+	bool bRet = false;
+
+	do 
 	{
-		if (rootNode)
+		doc = xmlNewDoc(BAD_CAST"1.0");
+		if (doc == NULL)
+		{
+			CCLOG("can not create xml doc");
+			break;
+		}
+
+		xmlNodePtr rootNode = xmlNewNode(NULL, BAD_CAST USERDEFAULT_ROOT_NAME);
+		if (rootNode == NULL)
+		{
+			CCLOG("can not create root node");
+			break;
+		}
+		xmlDocSetRootElement(doc, rootNode);
+
+		for (unordered_map<string, string>::const_iterator it = m_values.begin(); it != m_values.end(); ++it)
 		{
-			// the node doesn't exist, add a new one
 			// libxml in android donesn't support xmlNewTextChild, so use this approach
-			xmlNodePtr tmpNode = xmlNewNode(NULL, BAD_CAST pKey);
-			xmlNodePtr content = xmlNewText(BAD_CAST pValue);
+			xmlNodePtr tmpNode = xmlNewNode(NULL, BAD_CAST it->first.c_str());
+			xmlNodePtr content = xmlNewText(BAD_CAST it->second.c_str());
 			xmlAddChild(rootNode, tmpNode);
 			xmlAddChild(tmpNode, content);
-		}	
-	}
+		}
+
+		string tempPath = m_sFilePath + XML_TEMP_FILE_SUFFIX;
+		if (xmlSaveFile(tempPath.c_str(), doc) < 0)
+		{
+			CCLOG("can not write xml file");
+			break;
+		}
+
+		if (! replaceFile(tempPath, m_sFilePath))
+		{
+			CCLOG("can not replace xml file");
+			break;
+		}
+		// anybody reading the file through CCFileUtils sees the new contents
+		CCFileUtils::removeCachedFileData(m_sFilePath.c_str());
+
+		bRet = true;
+	} while (0);
 
-	// save file and free doc
 	if (doc)
 	{
-		xmlSaveFile(CCUserDefault::sharedUserDefault()->getXMLFilePath().c_str(),doc);
 		xmlFreeDoc(doc);
 	}
+
+	// keep the changes pending if the write failed, the next flush retries
+	if (bRet)
+	{
+		m_bIsDirty = false;
+	}
 }
 
-/**
- * implements of CCUserDefault
- */
+void CCUserDefault::setAutoFlushInterval(ccTime fInterval)
+{
+	if (m_fAutoFlushInterval > 0)
+	{
+		CCScheduler::sharedScheduler()->unscheduleSelector(schedule_selector(CCUserDefault::autoFlush), this);
+	}
 
-CCUserDefault* CCUserDefault::m_spUserDefault = 0;
-string CCUserDefault::m_sFilePath = string("");
-bool CCUserDefault::m_sbIsFilePathInitialized = false;
+	m_fAutoFlushInterval = fInterval;
 
-/**
- * If the user invoke delete CCUserDefault::sharedUserDefault(), should set m_spUserDefault
- * to null to avoid error when he invoke CCUserDefault::sharedUserDefault() later.
- */
-CCUserDefault::~CCUserDefault()
+	if (m_fAutoFlushInterval > 0)
+	{
+		CCScheduler::sharedScheduler()->scheduleSelector(schedule_selector(CCUserDefault::autoFlush), this, m_fAutoFlushInterval, false);
+	}
+}
+
+void CCUserDefault::autoFlush(ccTime dt)
 {
-	m_spUserDefault = NULL;
+	CC_UNUSED_PARAM(dt);
+	flush();
 }
 
 void CCUserDefault::purgeSharedUserDefault()
 {
-	CC_SAFE_DELETE(m_spUserDefault);
-	m_spUserDefault = NULL;
+	if (m_spUserDefault)
+	{
+		// the scheduler retains the instance while the auto flush timer runs
+		m_spUserDefault->setAutoFlushInterval(0);
+	}
+	CC_SAFE_RELEASE_NULL(m_spUserDefault);
 }
 
 bool CCUserDefault::getBoolForKey(const char* pKey, bool defaultValue)
@@ -185,7 +264,6 @@ bool CCUserDefault::getBoolForKey(const char* pKey, bool defaultValue)
 	if (value)
 	{
 		ret = (! strcmp(value, "true"));
-		xmlFree((void*)value);
 	}
 
 	return ret;
@@ -199,7 +277,6 @@ int CCUserDefault::getIntegerForKey(const char* pKey, int defaultValue)
 	if (value)
 	{
 		ret = atoi(value);
-		xmlFree((void*)value);
 	}
 
 	return ret;
@@ -220,7 +297,6 @@ double CCUserDefault::getDoubleForKey(const char* pKey, double defaultValue)
 	if (value)
 	{
 		ret = atof(value);
-		xmlFree((void*)value);
 	}
 
 	return ret;
@@ -234,7 +310,6 @@ string CCUserDefault::getStringForKey(const char* pKey, const std::string & defa
 	if (value)
 	{
 		ret = string(value);
-		xmlFree((void*)value);
 	}
 
 	return ret;
@@ -304,17 +379,17 @@ void CCUserDefault::setStringForKey(const char* pKey, const std::string & value)
 
 CCUserDefault* CCUserDefault::sharedUserDefault()
 {
-	initXMLFilePath();
-
-	// only create xml file one time
-	// the file exists after the programe exit
-	if ((! isXMLFileExist()) && (! createXMLFile()))
-	{
-		return NULL;
-	}
-
 	if (! m_spUserDefault)
 	{
+		initXMLFilePath();
+
+		// only create xml file one time
+		// the file exists after the programe exit
+		if ((! isXMLFileExist()) && (! createXMLFile()))
+		{
+			return NULL;
+		}
+
 		m_spUserDefault = new CCUserDefault();
 	}
 
@@ -373,6 +448,7 @@ bool CCUserDefault::createXMLFile()
 
 		// save xml file
 		xmlSaveFile(m_sFilePath.c_str(), doc);
+		CCFileUtils::removeCachedFileData(m_sFilePath.c_str());
 
 		bRet = true;
 	} while (0);
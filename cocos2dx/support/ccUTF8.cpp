@@ -0,0 +1,82 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "ccUTF8.h"
+
+namespace cocos2d
+{
+	unsigned int ccNextUTF8CodePoint(const char *&p)
+	{
+		const unsigned char *s = (const unsigned char*)p;
+		unsigned int c = s[0];
+		if (c < 0x80)
+		{
+			p += 1;
+			return c;
+		}
+
+		unsigned int uLength = 0;
+		unsigned int uMin = 0;
+		if ((c & 0xe0) == 0xc0)
+		{
+			uLength = 2;
+			uMin = 0x80;
+			c &= 0x1f;
+		}
+		else if ((c & 0xf0) == 0xe0)
+		{
+			uLength = 3;
+			uMin = 0x800;
+			c &= 0x0f;
+		}
+		else if ((c & 0xf8) == 0xf0)
+		{
+			uLength = 4;
+			uMin = 0x10000;
+			c &= 0x07;
+		}
+		else
+		{
+			p += 1;
+			return 0xfffd;
+		}
+
+		for (unsigned int i = 1; i < uLength; ++i)
+		{
+			// the terminating zero is not a continuation byte, so the string is never overrun
+			if ((s[i] & 0xc0) != 0x80)
+			{
+				p += i;
+				return 0xfffd;
+			}
+			c = (c << 6) | (s[i] & 0x3f);
+		}
+		p += uLength;
+
+		if (c < uMin || c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff))
+		{
+			return 0xfffd;
+		}
+		return c;
+	}
+}
@@ -0,0 +1,350 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "ccPixelConvert.h"
+#include "ccConfig.h"
+#include "ccMacros.h"
+#include <string.h>
+
+#if CC_PIXEL_CONVERT_SIMD && (defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__))
+#define CC_PIXEL_USE_SSE 1
+#include <emmintrin.h>
+#else
+#define CC_PIXEL_USE_SSE 0
+#endif
+
+namespace cocos2d {
+
+// the pixels are read as 32 bits words with R in the low byte, on little endian CPUs
+#define CC_PIXEL_R(p) ((p) & 0xFF)
+#define CC_PIXEL_G(p) (((p) >> 8) & 0xFF)
+#define CC_PIXEL_B(p) (((p) >> 16) & 0xFF)
+#define CC_PIXEL_A(p) (((p) >> 24) & 0xFF)
+
+static inline unsigned int ccPixelLoad(const unsigned char *p)
+{
+	unsigned int uPixel;
+	memcpy(&uPixel, p, 4);
+	return uPixel;
+}
+
+#if CC_PIXEL_USE_SSE
+
+// packs the low 16 bits of the 32 bits lanes, without the signed saturation of packs
+static inline __m128i ccPixelPack32To16(__m128i a, __m128i b)
+{
+	const __m128i bias32 = _mm_set1_epi32(0x8000);
+	const __m128i bias16 = _mm_set1_epi16((short)0x8000);
+	return _mm_add_epi16(_mm_packs_epi32(_mm_sub_epi32(a, bias32), _mm_sub_epi32(b, bias32)), bias16);
+}
+
+static inline __m128i ccPixelRGB565x4(__m128i p)
+{
+	__m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 8);
+	__m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xFC00)), 5);
+	__m128i b = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF80000)), 19);
+	return _mm_or_si128(_mm_or_si128(r, g), b);
+}
+
+static inline __m128i ccPixelRGB5A1x4(__m128i p)
+{
+	__m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 8);
+	__m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF800)), 5);
+	__m128i b = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF80000)), 18);
+	__m128i a = _mm_srli_epi32(p, 31);
+	return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+}
+
+static inline __m128i ccPixelRGBA4444x4(__m128i p)
+{
+	__m128i r = _mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF0)), 8);
+	__m128i g = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF000)), 4);
+	__m128i b = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF00000)), 16);
+	__m128i a = _mm_srli_epi32(p, 28);
+	return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+}
+
+#endif // CC_PIXEL_USE_SSE
+
+void ccPixelPremultiplyRGBA8888(const unsigned char *pIn, unsigned char *pOut, unsigned int uPixels)
+{
+	unsigned int i = 0;
+
+#if CC_PIXEL_USE_SSE
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16(1);
+	const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+	for (; i + 4 <= uPixels; i += 4)
+	{
+		__m128i p = _mm_loadu_si128((const __m128i*)(pIn + i * 4));
+
+		// two pixels per register, one component per 16 bits lane
+		__m128i lo = _mm_unpacklo_epi8(p, zero);
+		__m128i hi = _mm_unpackhi_epi8(p, zero);
+		__m128i alphaLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		__m128i alphaHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+		// c * (a + 1) is at most 65280, the low 16 bits of the product are enough
+		lo = _mm_srli_epi16(_mm_mullo_epi16(lo, _mm_add_epi16(alphaLo, one)), 8);
+		hi = _mm_srli_epi16(_mm_mullo_epi16(hi, _mm_add_epi16(alphaHi, one)), 8);
+
+		__m128i q = _mm_packus_epi16(lo, hi);
+		q = _mm_or_si128(_mm_andnot_si128(alphaMask, q), _mm_and_si128(alphaMask, p));
+		_mm_storeu_si128((__m128i*)(pOut + i * 4), q);
+	}
+#endif
+
+	for (; i < uPixels; ++i)
+	{
+		const unsigned char *p = pIn + i * 4;
+		unsigned int a = p[3];
+		unsigned char *q = pOut + i * 4;
+		q[0] = (unsigned char)((p[0] * (a + 1)) >> 8);
+		q[1] = (unsigned char)((p[1] * (a + 1)) >> 8);
+		q[2] = (unsigned char)((p[2] * (a + 1)) >> 8);
+		q[3] = (unsigned char)a;
+	}
+}
+
+void ccPixelRGB888ToRGBA8888(const unsigned char *pIn, unsigned char *pOut, unsigned int uPixels)
+{
+	for (unsigned int i = 0; i < uPixels; ++i, pIn += 3, pOut += 4)
+	{
+		pOut[0] = pIn[0];
+		pOut[1] = pIn[1];
+		pOut[2] = pIn[2];
+		pOut[3] = 255;
+	}
+}
+
+void ccPixelRGBA8888ToRGB565(const unsigned char *pIn, unsigned short *pOut, unsigned int uPixels)
+{
+	unsigned int i = 0;
+
+#if CC_PIXEL_USE_SSE
+	for (; i + 8 <= uPixels; i += 8)
+	{
+		__m128i p0 = _mm_loadu_si128((const __m128i*)(pIn + i * 4));
+		__m128i p1 = _mm_loadu_si128((const __m128i*)(pIn + i * 4 + 16));
+		_mm_storeu_si128((__m128i*)(pOut + i), ccPixelPack32To16(ccPixelRGB565x4(p0), ccPixelRGB565x4(p1)));
+	}
+#endif
+
+	for (; i < uPixels; ++i)
+	{
+		unsigned int p = ccPixelLoad(pIn + i * 4);
+		pOut[i] = (unsigned short)(
+			((CC_PIXEL_B(p) >> 3) << 0) |
+			((CC_PIXEL_G(p) >> 2) << 5) |
+			((CC_PIXEL_R(p) >> 3) << 11));
+	}
+}
+
+void ccPixelRGBA8888ToRGB5A1(const unsigned char *pIn, unsigned short *pOut, unsigned int uPixels)
+{
+	unsigned int i = 0;
+
+#if CC_PIXEL_USE_SSE
+	for (; i + 8 <= uPixels; i += 8)
+	{
+		__m128i p0 = _mm_loadu_si128((const __m128i*)(pIn + i * 4));
+		__m128i p1 = _mm_loadu_si128((const __m128i*)(pIn + i * 4 + 16));
+		_mm_storeu_si128((__m128i*)(pOut + i), ccPixelPack32To16(ccPixelRGB5A1x4(p0), ccPixelRGB5A1x4(p1)));
+	}
+#endif
+
+	for (; i < uPixels; ++i)
+	{
+		unsigned int p = ccPixelLoad(pIn + i * 4);
+		pOut[i] = (unsigned short)(
+			((CC_PIXEL_B(p) >> 3) << 1) |
+			((CC_PIXEL_G(p) >> 3) << 6) |
+			((CC_PIXEL_R(p) >> 3) << 11) |
+			((CC_PIXEL_A(p) >> 7) << 0));
+	}
+}
+
+void ccPixelRGBA8888ToRGBA4444(const unsigned char *pIn, unsigned short *pOut, unsigned int uPixels)
+{
+	unsigned int i = 0;
+
+#if CC_PIXEL_USE_SSE
+	for (; i + 8 <= uPixels; i += 8)
+	{
+		__m128i p0 = _mm_loadu_si128((const __m128i*)(pIn + i * 4));
+		__m128i p1 = _mm_loadu_si128((const __m128i*)(pIn + i * 4 + 16));
+		_mm_storeu_si128((__m128i*)(pOut + i), ccPixelPack32To16(ccPixelRGBA4444x4(p0), ccPixelRGBA4444x4(p1)));
+	}
+#endif
+
+	for (; i < uPixels; ++i)
+	{
+		unsigned int p = ccPixelLoad(pIn + i * 4);
+		pOut[i] = (unsigned short)(
+			((CC_PIXEL_R(p) >> 4) << 12) |
+			((CC_PIXEL_G(p) >> 4) << 8) |
+			((CC_PIXEL_B(p) >> 4) << 4) |
+			((CC_PIXEL_A(p) >> 4) << 0));
+	}
+}
+
+void ccPixelRGBA8888ToA8(const unsigned char *pIn, unsigned char *pOut, unsigned int uPixels)
+{
+	unsigned int i = 0;
+
+#if CC_PIXEL_USE_SSE
+	for (; i + 16 <= uPixels; i += 16)
+	{
+		__m128i p0 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(pIn + i * 4)), 24);
+		__m128i p1 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(pIn + i * 4 + 16)), 24);
+		__m128i p2 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(pIn + i * 4 + 32)), 24);
+		__m128i p3 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(pIn + i * 4 + 48)), 24);
+		__m128i q = _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3));
+		_mm_storeu_si128((__m128i*)(pOut + i), q);
+	}
+#endif
+
+	for (; i < uPixels; ++i)
+	{
+		pOut[i] = pIn[i * 4 + 3];
+	}
+}
+
+void ccPixelRGBA8888ToAI88(const unsigned char *pIn, unsigned char *pOut, unsigned int uPixels)
+{
+	for (unsigned int i = 0; i < uPixels; ++i, pIn += 4, pOut += 2)
+	{
+		pOut[0] = (unsigned char)((pIn[0] * 299 + pIn[1] * 587 + pIn[2] * 114 + 500) / 1000);
+		pOut[1] = pIn[3];
+	}
+}
+
+unsigned int ccPixelBytesPerPixel(CCTexture2DPixelFormat format)
+{
+	switch (format)
+	{
+	case kCCTexture2DPixelFormat_RGBA8888:
+		return 4;
+	case kCCTexture2DPixelFormat_RGB888:
+		return 3;
+	case kCCTexture2DPixelFormat_RGB565:
+	case kCCTexture2DPixelFormat_RGBA4444:
+	case kCCTexture2DPixelFormat_RGB5A1:
+	case kCCTexture2DPixelFormat_AI88:
+		return 2;
+	case kCCTexture2DPixelFormat_A8:
+	case kCCTexture2DPixelFormat_I8:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+// converts a row of RGBA8888 pixels
+static void ccPixelConvertRow(const unsigned char *pIn, unsigned char *pOut, CCTexture2DPixelFormat outFormat, unsigned int uPixels)
+{
+	switch (outFormat)
+	{
+	case kCCTexture2DPixelFormat_RGBA8888:
+		memcpy(pOut, pIn, uPixels * 4);
+		break;
+	case kCCTexture2DPixelFormat_RGB565:
+		ccPixelRGBA8888ToRGB565(pIn, (unsigned short*)pOut, uPixels);
+		break;
+	case kCCTexture2DPixelFormat_RGB5A1:
+		ccPixelRGBA8888ToRGB5A1(pIn, (unsigned short*)pOut, uPixels);
+		break;
+	case kCCTexture2DPixelFormat_RGBA4444:
+		ccPixelRGBA8888ToRGBA4444(pIn, (unsigned short*)pOut, uPixels);
+		break;
+	case kCCTexture2DPixelFormat_A8:
+		ccPixelRGBA8888ToA8(pIn, pOut, uPixels);
+		break;
+	case kCCTexture2DPixelFormat_AI88:
+		ccPixelRGBA8888ToAI88(pIn, pOut, uPixels);
+		break;
+	default:
+		break;
+	}
+}
+
+bool ccPixelConvertImage(const unsigned char *pIn, CCTexture2DPixelFormat inFormat,
+						 unsigned int uWidth, unsigned int uHeight, unsigned int uInStride,
+						 void *pOut, CCTexture2DPixelFormat outFormat,
+						 unsigned int uOutWidth, unsigned int uOutHeight)
+{
+	if (inFormat != kCCTexture2DPixelFormat_RGBA8888 && inFormat != kCCTexture2DPixelFormat_RGB888)
+	{
+		return false;
+	}
+
+	switch (outFormat)
+	{
+	case kCCTexture2DPixelFormat_RGBA8888:
+	case kCCTexture2DPixelFormat_RGB565:
+	case kCCTexture2DPixelFormat_RGB5A1:
+	case kCCTexture2DPixelFormat_RGBA4444:
+	case kCCTexture2DPixelFormat_A8:
+	case kCCTexture2DPixelFormat_AI88:
+		break;
+	default:
+		return false;
+	}
+
+	CCAssert(uWidth <= uOutWidth && uHeight <= uOutHeight, "ccPixelConvertImage: the output is smaller than the image");
+
+	unsigned int uBytesPerPixel = ccPixelBytesPerPixel(outFormat);
+	unsigned int uOutStride = uOutWidth * uBytesPerPixel;
+	unsigned int uRowBytes = uWidth * uBytesPerPixel;
+	unsigned char *pOutRow = (unsigned char*)pOut;
+
+	for (unsigned int y = 0; y < uHeight; ++y, pIn += uInStride, pOutRow += uOutStride)
+	{
+		if (inFormat == kCCTexture2DPixelFormat_RGBA8888)
+		{
+			ccPixelConvertRow(pIn, pOutRow, outFormat, uWidth);
+		}
+		else if (outFormat == kCCTexture2DPixelFormat_RGBA8888)
+		{
+			ccPixelRGB888ToRGBA8888(pIn, pOutRow, uWidth);
+		}
+		else
+		{
+			// expand the row in pieces that stay in the cache
+			unsigned char expanded[256 * 4];
+			for (unsigned int x = 0; x < uWidth; x += 256)
+			{
+				unsigned int uPixels = (uWidth - x < 256) ? uWidth - x : 256;
+				ccPixelRGB888ToRGBA8888(pIn + x * 3, expanded, uPixels);
+				ccPixelConvertRow(expanded, pOutRow + x * uBytesPerPixel, outFormat, uPixels);
+			}
+		}
+
+		memset(pOutRow + uRowBytes, 0, uOutStride - uRowBytes);
+	}
+
+	memset(pOutRow, 0, (uOutHeight - uHeight) * uOutStride);
+	return true;
+}
+
+}//namespace   cocos2d
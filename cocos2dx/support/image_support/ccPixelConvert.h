@@ -0,0 +1,82 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __SUPPORT_IMAGE_SUPPORT_CCPIXELCONVERT_H__
+#define __SUPPORT_IMAGE_SUPPORT_CCPIXELCONVERT_H__
+
+#include "CCTexture2D.h"
+
+namespace cocos2d {
+
+/**
+ Pixel conversions used to load images into textures.
+
+ The row functions convert uPixels pixels. RGBA8888 pixels are stored as the bytes
+ R, G, B, A. 16 bits pixels are written in the native byte order with the first
+ named component in the high bits, the layouts CCTexture2D always uploaded.
+ With CC_PIXEL_CONVERT_SIMD they use SSE2 on x86 and x64, which gives the same
+ results as the scalar loops.
+ */
+
+/** premultiplies the colors by the alpha, as (c * (a + 1)) >> 8. pIn and pOut may be the same */
+void CC_DLL ccPixelPremultiplyRGBA8888(const unsigned char *pIn, unsigned char *pOut, unsigned int uPixels);
+
+/** expands RGB888 to RGBA8888 with an opaque alpha */
+void CC_DLL ccPixelRGB888ToRGBA8888(const unsigned char *pIn, unsigned char *pOut, unsigned int uPixels);
+
+/** RGBA8888 to RRRRRGGGGGGBBBBB */
+void CC_DLL ccPixelRGBA8888ToRGB565(const unsigned char *pIn, unsigned short *pOut, unsigned int uPixels);
+
+/** RGBA8888 to RRRRRGGGGGBBBBBA */
+void CC_DLL ccPixelRGBA8888ToRGB5A1(const unsigned char *pIn, unsigned short *pOut, unsigned int uPixels);
+
+/** RGBA8888 to RRRRGGGGBBBBAAAA */
+void CC_DLL ccPixelRGBA8888ToRGBA4444(const unsigned char *pIn, unsigned short *pOut, unsigned int uPixels);
+
+/** RGBA8888 to the alpha bytes */
+void CC_DLL ccPixelRGBA8888ToA8(const unsigned char *pIn, unsigned char *pOut, unsigned int uPixels);
+
+/** RGBA8888 to intensity and alpha bytes, the intensity is (299 R + 587 G + 114 B + 500) / 1000 */
+void CC_DLL ccPixelRGBA8888ToAI88(const unsigned char *pIn, unsigned char *pOut, unsigned int uPixels);
+
+/** the size of a pixel of a format in bytes, 0 for the compressed formats */
+unsigned int CC_DLL ccPixelBytesPerPixel(CCTexture2DPixelFormat format);
+
+/** Converts an image in one pass: each row is converted straight into the output and
+ the output is padded with zeros up to uOutWidth x uOutHeight pixels, for instance to
+ make a POT texture.
+ @param pIn the image, in RGBA8888 or RGB888
+ @param uInStride the distance between two input rows in bytes
+ @param pOut the output, uOutWidth * uOutHeight * ccPixelBytesPerPixel(outFormat) bytes
+ @param outFormat RGBA8888, RGB565, RGB5A1, RGBA4444, A8 or AI88
+ @return false if the conversion is not supported
+ */
+bool CC_DLL ccPixelConvertImage(const unsigned char *pIn, CCTexture2DPixelFormat inFormat,
+								unsigned int uWidth, unsigned int uHeight, unsigned int uInStride,
+								void *pOut, CCTexture2DPixelFormat outFormat,
+								unsigned int uOutWidth, unsigned int uOutHeight);
+
+}//namespace   cocos2d
+
+#endif // __SUPPORT_IMAGE_SUPPORT_CCPIXELCONVERT_H__
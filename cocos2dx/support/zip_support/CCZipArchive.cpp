@@ -0,0 +1,457 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include <zlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "CCZipArchive.h"
+#include "ccMacros.h"
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WIN8_METRO)
+#include <windows.h>
+#define CC_ZIP_MAP_WINDOWS 1
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_QNX) || (CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define CC_ZIP_MAP_POSIX 1
+#endif
+
+namespace cocos2d
+{
+	// records of the zip format, see the APPNOTE of PKWARE
+	enum
+	{
+		kCCZipLocalHeaderSignature = 0x04034b50,
+		kCCZipLocalHeaderSize = 30,
+		kCCZipCentralHeaderSignature = 0x02014b50,
+		kCCZipCentralHeaderSize = 46,
+		kCCZipEndOfDirectorySignature = 0x06054b50,
+		kCCZipEndOfDirectorySize = 22,
+		kCCZipMaxCommentSize = 0xFFFF,
+
+		kCCZipMethodStored = 0,
+		kCCZipMethodDeflated = 8,
+		kCCZipFlagEncrypted = 1,
+	};
+
+	static inline unsigned int ccZipRead16(const unsigned char *p)
+	{
+		return p[0] | (p[1] << 8);
+	}
+
+	static inline unsigned long ccZipRead32(const unsigned char *p)
+	{
+		return (unsigned long)p[0] | ((unsigned long)p[1] << 8) | ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+	}
+
+	// maps a whole file read only, NULL if the platform or the file can't
+	static const unsigned char* ccZipMapFile(const char *pszPath, unsigned long *pSize)
+	{
+#if CC_ZIP_MAP_WINDOWS
+		const unsigned char *pData = NULL;
+		int nLength = MultiByteToWideChar(CP_UTF8, 0, pszPath, -1, NULL, 0);
+		if (nLength <= 0)
+		{
+			return NULL;
+		}
+		std::wstring path(nLength, L'\0');
+		MultiByteToWideChar(CP_UTF8, 0, pszPath, -1, &path[0], nLength);
+
+	#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN8_METRO)
+		HANDLE hFile = ::CreateFile2(path.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, NULL);
+	#else
+		HANDLE hFile = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	#endif
+		if (hFile == INVALID_HANDLE_VALUE)
+		{
+			return NULL;
+		}
+
+		FILE_STANDARD_INFO fileStandardInfo = { 0 };
+		if (::GetFileInformationByHandleEx(hFile, FileStandardInfo, &fileStandardInfo, sizeof(fileStandardInfo))
+			&& fileStandardInfo.EndOfFile.HighPart == 0 && fileStandardInfo.EndOfFile.LowPart > 0)
+		{
+	#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN8_METRO)
+			HANDLE hMapping = ::CreateFileMappingFromApp(hFile, NULL, PAGE_READONLY, 0, NULL);
+	#else
+			HANDLE hMapping = ::CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	#endif
+			if (hMapping)
+			{
+				// the view keeps the mapping alive
+	#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN8_METRO)
+				pData = (const unsigned char*)::MapViewOfFileFromApp(hMapping, FILE_MAP_READ, 0, 0);
+	#else
+				pData = (const unsigned char*)::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	#endif
+				::CloseHandle(hMapping);
+				*pSize = fileStandardInfo.EndOfFile.LowPart;
+			}
+		}
+		::CloseHandle(hFile);
+		return pData;
+#elif CC_ZIP_MAP_POSIX
+		int fd = open(pszPath, O_RDONLY);
+		if (fd < 0)
+		{
+			return NULL;
+		}
+
+		const unsigned char *pData = NULL;
+		struct stat st;
+		if (fstat(fd, &st) == 0 && st.st_size > 0)
+		{
+			void *pMapped = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (pMapped != MAP_FAILED)
+			{
+				pData = (const unsigned char*)pMapped;
+				*pSize = (unsigned long)st.st_size;
+			}
+		}
+		close(fd);
+		return pData;
+#else
+		CC_UNUSED_PARAM(pszPath);
+		CC_UNUSED_PARAM(pSize);
+		return NULL;
+#endif
+	}
+
+	static void ccZipUnmapFile(const unsigned char *pData, unsigned long uSize)
+	{
+#if CC_ZIP_MAP_WINDOWS
+		CC_UNUSED_PARAM(uSize);
+		::UnmapViewOfFile(pData);
+#elif CC_ZIP_MAP_POSIX
+		munmap((void*)pData, uSize);
+#else
+		CC_UNUSED_PARAM(pData);
+		CC_UNUSED_PARAM(uSize);
+#endif
+	}
+
+	// reads a whole file into memory, for the platforms that can't map it
+	static const unsigned char* ccZipReadFile(const char *pszPath, unsigned long *pSize)
+	{
+		FILE *fp = fopen(pszPath, "rb");
+		if (! fp)
+		{
+			return NULL;
+		}
+
+		unsigned char *pData = NULL;
+		fseek(fp, 0, SEEK_END);
+		long nSize = ftell(fp);
+		fseek(fp, 0, SEEK_SET);
+		if (nSize > 0)
+		{
+			pData = new unsigned char[nSize];
+			if (fread(pData, 1, nSize, fp) != (size_t)nSize)
+			{
+				CC_SAFE_DELETE_ARRAY(pData);
+			}
+			else
+			{
+				*pSize = (unsigned long)nSize;
+			}
+		}
+		fclose(fp);
+		return pData;
+	}
+
+	CCZipArchive::CCZipArchive()
+	: m_pData(NULL)
+	, m_uSize(0)
+	, m_bIsMapped(false)
+	, m_nReferenceCount(1)
+	{
+	}
+
+	CCZipArchive::~CCZipArchive()
+	{
+		if (m_bIsMapped)
+		{
+			ccZipUnmapFile(m_pData, m_uSize);
+		}
+		else
+		{
+			delete [] m_pData;
+		}
+	}
+
+	CCZipArchive* CCZipArchive::archiveWithFile(const char *pszZipFilePath)
+	{
+		CCZipArchive *pRet = new CCZipArchive();
+		if (pRet->initWithFile(pszZipFilePath))
+		{
+			return pRet;
+		}
+		pRet->release();
+		return NULL;
+	}
+
+	void CCZipArchive::retain()
+	{
+		++m_nReferenceCount;
+	}
+
+	void CCZipArchive::release()
+	{
+		CCAssert(m_nReferenceCount > 0, "reference count should greater than 0");
+		if (--m_nReferenceCount == 0)
+		{
+			delete this;
+		}
+	}
+
+	bool CCZipArchive::initWithFile(const char *pszZipFilePath)
+	{
+		if (! pszZipFilePath || ! pszZipFilePath[0])
+		{
+			return false;
+		}
+
+		m_pData = ccZipMapFile(pszZipFilePath, &m_uSize);
+		m_bIsMapped = (m_pData != NULL);
+		if (! m_pData)
+		{
+			m_pData = ccZipReadFile(pszZipFilePath, &m_uSize);
+		}
+		if (! m_pData)
+		{
+			return false;
+		}
+
+		if (! indexCentralDirectory())
+		{
+			CCLOG("cocos2d: CCZipArchive: %s is not a zip archive that can be indexed", pszZipFilePath);
+			return false;
+		}
+		return true;
+	}
+
+	bool CCZipArchive::indexCentralDirectory()
+	{
+		if (m_uSize < kCCZipEndOfDirectorySize)
+		{
+			return false;
+		}
+
+		// the end of central directory record is followed by a comment of up to 64k
+		const unsigned char *pEnd = NULL;
+		unsigned long uLowest = (m_uSize > kCCZipEndOfDirectorySize + kCCZipMaxCommentSize) ? m_uSize - kCCZipEndOfDirectorySize - kCCZipMaxCommentSize : 0;
+		for (unsigned long uOffset = m_uSize - kCCZipEndOfDirectorySize; ; --uOffset)
+		{
+			if (ccZipRead32(m_pData + uOffset) == kCCZipEndOfDirectorySignature)
+			{
+				pEnd = m_pData + uOffset;
+				break;
+			}
+			if (uOffset == uLowest)
+			{
+				return false;
+			}
+		}
+
+		unsigned int uEntryCount = ccZipRead16(pEnd + 10);
+		unsigned long uDirectorySize = ccZipRead32(pEnd + 12);
+		unsigned long uDirectoryOffset = ccZipRead32(pEnd + 16);
+
+		// zip64 archives store 0xFFFF and 0xFFFFFFFF here
+		if (uEntryCount == 0xFFFF || uDirectoryOffset == 0xFFFFFFFF
+			|| uDirectoryOffset > m_uSize || uDirectorySize > m_uSize - uDirectoryOffset)
+		{
+			return false;
+		}
+
+		m_tEntries.rehash(uEntryCount);
+
+		const unsigned char *p = m_pData + uDirectoryOffset;
+		const unsigned char *pDirectoryEnd = p + uDirectorySize;
+		for (unsigned int i = 0; i < uEntryCount; ++i)
+		{
+			if (p + kCCZipCentralHeaderSize > pDirectoryEnd || ccZipRead32(p) != kCCZipCentralHeaderSignature)
+			{
+				return false;
+			}
+
+			unsigned int uNameLength = ccZipRead16(p + 28);
+			unsigned int uExtraLength = ccZipRead16(p + 30);
+			unsigned int uCommentLength = ccZipRead16(p + 32);
+			if (p + kCCZipCentralHeaderSize + uNameLength + uExtraLength + uCommentLength > pDirectoryEnd)
+			{
+				return false;
+			}
+
+			Entry entry;
+			entry.uFlags = (unsigned short)ccZipRead16(p + 8);
+			entry.uMethod = (unsigned short)ccZipRead16(p + 10);
+			entry.uCompressedSize = ccZipRead32(p + 20);
+			entry.uUncompressedSize = ccZipRead32(p + 24);
+			entry.uLocalHeaderOffset = ccZipRead32(p + 42);
+
+			// like unzLocateFile, the first of several files with the same name wins
+			m_tEntries.insert(std::make_pair(std::string((const char*)p + kCCZipCentralHeaderSize, uNameLength), entry));
+
+			p += kCCZipCentralHeaderSize + uNameLength + uExtraLength + uCommentLength;
+		}
+		return true;
+	}
+
+	const CCZipArchive::Entry* CCZipArchive::findEntry(const char *pszFileName)
+	{
+		if (! pszFileName)
+		{
+			return NULL;
+		}
+
+		std::unordered_map<std::string, Entry>::const_iterator it = m_tEntries.find(pszFileName);
+		return (it != m_tEntries.end()) ? &it->second : NULL;
+	}
+
+	// the compressed bytes of a file, NULL if its headers are damaged
+	const unsigned char* CCZipArchive::getEntryData(const Entry *pEntry)
+	{
+		unsigned long uOffset = pEntry->uLocalHeaderOffset;
+		if (uOffset > m_uSize || m_uSize - uOffset < kCCZipLocalHeaderSize)
+		{
+			return NULL;
+		}
+
+		const unsigned char *pHeader = m_pData + uOffset;
+		if (ccZipRead32(pHeader) != kCCZipLocalHeaderSignature)
+		{
+			return NULL;
+		}
+
+		// the local extra field may differ from the one of the central directory
+		unsigned long uDataOffset = uOffset + kCCZipLocalHeaderSize + ccZipRead16(pHeader + 26) + ccZipRead16(pHeader + 28);
+		if (uDataOffset > m_uSize || m_uSize - uDataOffset < pEntry->uCompressedSize)
+		{
+			return NULL;
+		}
+		return m_pData + uDataOffset;
+	}
+
+	bool CCZipArchive::containsFile(const char *pszFileName)
+	{
+		return findEntry(pszFileName) != NULL;
+	}
+
+	unsigned long CCZipArchive::getFileSize(const char *pszFileName)
+	{
+		const Entry *pEntry = findEntry(pszFileName);
+		return pEntry ? pEntry->uUncompressedSize : 0;
+	}
+
+	const unsigned char* CCZipArchive::getStoredFileData(const char *pszFileName, unsigned long *pSize)
+	{
+		*pSize = 0;
+
+		const Entry *pEntry = findEntry(pszFileName);
+		if (! pEntry || pEntry->uMethod != kCCZipMethodStored || (pEntry->uFlags & kCCZipFlagEncrypted)
+			|| pEntry->uCompressedSize != pEntry->uUncompressedSize)
+		{
+			return NULL;
+		}
+
+		const unsigned char *pData = getEntryData(pEntry);
+		if (pData)
+		{
+			*pSize = pEntry->uUncompressedSize;
+		}
+		return pData;
+	}
+
+	bool CCZipArchive::readFile(const char *pszFileName, unsigned char *pBuffer, unsigned long uBufferSize)
+	{
+		const Entry *pEntry = findEntry(pszFileName);
+		if (! pEntry || (pEntry->uFlags & kCCZipFlagEncrypted) || uBufferSize < pEntry->uUncompressedSize)
+		{
+			return false;
+		}
+
+		const unsigned char *pData = getEntryData(pEntry);
+		if (! pData)
+		{
+			return false;
+		}
+
+		if (pEntry->uMethod == kCCZipMethodStored)
+		{
+			if (pEntry->uCompressedSize != pEntry->uUncompressedSize)
+			{
+				return false;
+			}
+			memcpy(pBuffer, pData, pEntry->uUncompressedSize);
+			return true;
+		}
+
+		if (pEntry->uMethod != kCCZipMethodDeflated)
+		{
+			return false;
+		}
+
+		// each call has its own stream, the archive itself is only read
+		z_stream d_stream;
+		memset(&d_stream, 0, sizeof(d_stream));
+		d_stream.next_in = (Bytef*)pData;
+		d_stream.avail_in = (uInt)pEntry->uCompressedSize;
+		d_stream.next_out = pBuffer;
+		d_stream.avail_out = (uInt)pEntry->uUncompressedSize;
+
+		// raw deflate data, without the zlib header
+		if (inflateInit2(&d_stream, -MAX_WBITS) != Z_OK)
+		{
+			return false;
+		}
+		int err = inflate(&d_stream, Z_FINISH);
+		bool bRet = (err == Z_STREAM_END && d_stream.total_out == pEntry->uUncompressedSize);
+		inflateEnd(&d_stream);
+		return bRet;
+	}
+
+	unsigned char* CCZipArchive::getFileData(const char *pszFileName, unsigned long *pSize)
+	{
+		*pSize = 0;
+
+		const Entry *pEntry = findEntry(pszFileName);
+		if (! pEntry)
+		{
+			return NULL;
+		}
+
+		unsigned char *pBuffer = new unsigned char[pEntry->uUncompressedSize];
+		if (! readFile(pszFileName, pBuffer, pEntry->uUncompressedSize))
+		{
+			CC_SAFE_DELETE_ARRAY(pBuffer);
+			return NULL;
+		}
+		*pSize = pEntry->uUncompressedSize;
+		return pBuffer;
+	}
+
+} // end of namespace cocos2d
@@ -0,0 +1,115 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __SUPPORT_CCZIPARCHIVE_H__
+#define __SUPPORT_CCZIPARCHIVE_H__
+
+#include "CCPlatformMacros.h"
+#include <string>
+#include <unordered_map>
+#include <atomic>
+
+namespace cocos2d
+{
+	/**
+	@brief A zip archive kept open to read many files from it.
+
+	The archive file is mapped into memory, or read into memory where it can't be mapped,
+	and its central directory is indexed by file name once, when the archive is opened.
+	Stored files are served straight from the mapped bytes, deflated files are inflated
+	into the buffer of the caller.
+
+	The archive is not modified after it is opened, so files can be read from any number
+	of threads at the same time. The reference count is atomic as well.
+
+	Only the stored and deflated methods are read, without encryption nor zip64 extensions.
+	@since v1.0
+	*/
+	class CC_DLL CCZipArchive
+	{
+	public:
+		/** opens and indexes an archive. The reference count starts at 1.
+		@return NULL if the file can't be read or is not a zip archive
+		*/
+		static CCZipArchive* archiveWithFile(const char *pszZipFilePath);
+
+		void retain();
+		void release();
+
+		/** the number of files in the archive */
+		unsigned int getFileCount() { return (unsigned int)m_tEntries.size(); }
+
+		/** whether the archive has a file, the name is case sensitive */
+		bool containsFile(const char *pszFileName);
+
+		/** the uncompressed size of a file, 0 if the archive doesn't have it */
+		unsigned long getFileSize(const char *pszFileName);
+
+		/** Gets the bytes of a stored file without copying them.
+		@return NULL if the archive doesn't have the file or the file is compressed
+		@warning The bytes belong to the archive, they are valid until it is released.
+		*/
+		const unsigned char* getStoredFileData(const char *pszFileName, unsigned long *pSize);
+
+		/** Reads, or inflates, a whole file into a buffer of at least getFileSize() bytes.
+		@return false if the file is missing, damaged or uses an unsupported method
+		*/
+		bool readFile(const char *pszFileName, unsigned char *pBuffer, unsigned long uBufferSize);
+
+		/** Reads a whole file into a new buffer.
+		@return the buffer, to delete[] after use, or NULL if readFile() fails
+		*/
+		unsigned char* getFileData(const char *pszFileName, unsigned long *pSize);
+
+	private:
+		struct Entry
+		{
+			unsigned long uCompressedSize;
+			unsigned long uUncompressedSize;
+			unsigned long uLocalHeaderOffset;
+			unsigned short uMethod;
+			unsigned short uFlags;
+		};
+
+		CCZipArchive();
+		~CCZipArchive();
+		CCZipArchive(const CCZipArchive&);
+		CCZipArchive& operator=(const CCZipArchive&);
+
+		bool initWithFile(const char *pszZipFilePath);
+		bool indexCentralDirectory();
+		const Entry* findEntry(const char *pszFileName);
+		const unsigned char* getEntryData(const Entry *pEntry);
+
+		// the archive file, mapped or in memory
+		const unsigned char*   m_pData;
+		unsigned long          m_uSize;
+		bool                   m_bIsMapped;
+
+		std::unordered_map<std::string, Entry> m_tEntries;
+		std::atomic<int>       m_nReferenceCount;
+	};
+
+} // end of namespace cocos2d
+
+#endif // __SUPPORT_CCZIPARCHIVE_H__
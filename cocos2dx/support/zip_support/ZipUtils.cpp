@@ -213,26 +213,24 @@ namespace cocos2d
  		CCAssert(out, "");
  		CCAssert(&*out, "");
  
- 		// load file into memory
- 		unsigned char *compressed = NULL;
-        
-        int fileLen = 0;
-        compressed = CCFileUtils::getFileData(path, "rb", (unsigned long *)(&fileLen));
+ 		// borrow the file from the file cache
+        CCFileData data(path, "rb");
+        const unsigned char *compressed = data.getBuffer();
+        unsigned long fileLen = data.getSize();
  		// int fileLen  = CCFileUtils::ccLoadFileIntoMemory( path, &compressed );
 
- 		if( fileLen < 0 ) 
+ 		if( ! compressed || fileLen < sizeof(struct CCZHeader) ) 
  		{
  			CCLOG("cocos2d: Error loading CCZ compressed file");
             return -1;
  		}
  
- 		struct CCZHeader *header = (struct CCZHeader*) compressed;
+ 		const struct CCZHeader *header = (const struct CCZHeader*) compressed;
  
  		// verify header
  		if( header->sig[0] != 'C' || header->sig[1] != 'C' || header->sig[2] != 'Z' || header->sig[3] != '!' ) 
  		{
  			CCLOG("cocos2d: Invalid CCZ file");
- 			delete [] compressed;
  			return -1;
  		}
  
@@ -241,7 +239,6 @@ namespace cocos2d
  		if( version > 2 ) 
  		{
  			CCLOG("cocos2d: Unsupported CCZ header format");
- 			delete [] compressed;
  			return -1;
  		}
  
@@ -249,7 +246,6 @@ namespace cocos2d
  		if( CC_SWAP_INT16_BIG_TO_HOST(header->compression_type) != CCZ_COMPRESSION_ZLIB ) 
  		{
  			CCLOG("cocos2d: CCZ Unsupported compression method");
- 			delete [] compressed;
  			return -1;
  		}
  
@@ -259,16 +255,13 @@ namespace cocos2d
  		if(! *out )
  		{
  			CCLOG("cocos2d: CCZ: Failed to allocate memory for texture");
- 			delete [] compressed;
  			return -1;
  		}
  
  
  		unsigned long destlen = len;
- 		unsigned long source = (unsigned long) compressed + sizeof(*header);
- 		int ret = uncompress(*out, &destlen, (Bytef*)source, fileLen - sizeof(*header) );
- 
- 		delete [] compressed;
+ 		const Bytef *source = compressed + sizeof(*header);
+ 		int ret = uncompress(*out, &destlen, source, fileLen - sizeof(*header) );
  
  		if( ret != Z_OK )
  		{
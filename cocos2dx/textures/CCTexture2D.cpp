@@ -42,6 +42,8 @@ THE SOFTWARE.
 #include "platform/CCPlatformMacros.h"
 #include "CCTexturePVR.h"
 #include "CCDirector.h"
+#include "support/CCProfiling.h"
+#include "support/image_support/ccPixelConvert.h"
 
 #if CC_ENABLE_CACHE_TEXTTURE_DATA
     #include "CCTextureCache.h"
@@ -179,6 +181,8 @@ bool CCTexture2D::getHasPremultipliedAlpha()
 
 bool CCTexture2D::initWithData(const void *data, CCTexture2DPixelFormat pixelFormat, unsigned int pixelsWide, unsigned int pixelsHigh, const CCSize& contentSize)
 {
+	CCProfileScope scope(kCCProfilePhaseTextureUpload);
+
 	int formatTmp = DXGI_FORMAT_R8G8B8A8_UNORM;
 	int dataSizeByte = 4;
 	/*==
@@ -237,6 +241,9 @@ bool CCTexture2D::initWithData(const void *data, CCTexture2DPixelFormat pixelFor
 		CCAssert(0, "NSInternalInconsistencyException");
 
 	}
+	CCFrameProfiler::addCount(kCCProfileCounterTextureUploads, 1);
+	CCFrameProfiler::addCount(kCCProfileCounterTextureBytes, pixelsWide * pixelsHigh * dataSizeByte);
+
 	ID3D11Device *pdevice = CCDirector::sharedDirector()->getOpenGLView()->GetDevice();
 	ID3D11Texture2D *tex;
 	D3D11_TEXTURE2D_DESC tdesc;
@@ -297,6 +304,38 @@ bool CCTexture2D::initWithData(const void *data, CCTexture2DPixelFormat pixelFor
 	return true;
 }
 
+void CCTexture2D::updateWithData(const void *data, unsigned int dataRowPitch, unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+{
+	CCAssert(m_pTextureResource != NULL, "CCTexture2D: the texture must be initialized");
+	CCAssert(x + width <= m_uPixelsWide && y + height <= m_uPixelsHigh, "CCTexture2D: the rectangle must be in the texture");
+
+	if (! m_pTextureResource || width == 0 || height == 0)
+	{
+		return;
+	}
+
+	CCProfileScope scope(kCCProfilePhaseTextureUpload);
+	CCFrameProfiler::addCount(kCCProfileCounterTextureUploads, 1);
+	CCFrameProfiler::addCount(kCCProfileCounterTextureBytes, width * height * ccPixelBytesPerPixel(m_ePixelFormat));
+
+	ID3D11Resource *pResource = NULL;
+	m_pTextureResource->GetResource(&pResource);
+	if (! pResource)
+	{
+		return;
+	}
+
+	D3D11_BOX box;
+	box.left = x;
+	box.right = x + width;
+	box.top = y;
+	box.bottom = y + height;
+	box.front = 0;
+	box.back = 1;
+	CCID3D11DeviceContext->UpdateSubresource(pResource, 0, &box, data, dataRowPitch, 0);
+	pResource->Release();
+}
+
 
 char * CCTexture2D::description(void)
 {
@@ -348,11 +387,11 @@ bool CCTexture2D::initPremultipliedATextureWithImage(CCImage *image, unsigned in
 {
 	unsigned char*			data = NULL;
 	unsigned char*			tempData =NULL;
-	unsigned int*			inPixel32 = NULL;
-	unsigned short*			outPixel16 = NULL;
 	bool					hasAlpha;
 	CCSize					imageSize;
 	CCTexture2DPixelFormat	pixelFormat;
+	CCTexture2DPixelFormat	imageFormat;
+	CCTexture2DPixelFormat	uploadFormat;
 
 	hasAlpha = image->hasAlpha();
 
@@ -379,136 +418,53 @@ bool CCTexture2D::initPremultipliedATextureWithImage(CCImage *image, unsigned in
 
 	imageSize = CCSizeMake((float)(image->getWidth()), (float)(image->getHeight()));
 
-	switch(pixelFormat) {          
+	tempData = (unsigned char*)(image->getData());
+	CCAssert(tempData != NULL, "NULL image data.");
+
+	// CCImage holds RGBA8888 pixels, or RGB888 ones when there is no alpha
+	imageFormat = hasAlpha ? kCCTexture2DPixelFormat_RGBA8888 : kCCTexture2DPixelFormat_RGB888;
+
+	// the pixels handed to initWithData, which takes RGB888 and RGBA4444 as RGBA8888
+	switch(pixelFormat) {
 		case kCCTexture2DPixelFormat_RGBA8888:
+		case kCCTexture2DPixelFormat_RGB888:
 		case kCCTexture2DPixelFormat_RGBA4444:
+			uploadFormat = kCCTexture2DPixelFormat_RGBA8888;
+			break;
 		case kCCTexture2DPixelFormat_RGB5A1:
 		case kCCTexture2DPixelFormat_RGB565:
+			uploadFormat = pixelFormat;
+			break;
 		case kCCTexture2DPixelFormat_A8:
-			tempData = (unsigned char*)(image->getData());
-			CCAssert(tempData != NULL, "NULL image data.");
-
-			if(image->getWidth() == (short)POTWide && image->getHeight() == (short)POTHigh)
-			{
-				data = new unsigned char[POTHigh * POTWide * 4];
-				memcpy(data, tempData, POTHigh * POTWide * 4);
-			}
-			else
-			{
-				data = new unsigned char[POTHigh * POTWide * 4];
-				memset(data, 0, POTHigh * POTWide * 4);
-
-				unsigned char* pPixelData = (unsigned char*) tempData;
-				unsigned char* pTargetData = (unsigned char*) data;
-
-                int imageHeight = image->getHeight();
-				for(int y = 0; y < imageHeight; ++y)
-				{
-					memcpy(pTargetData+POTWide*4*y, pPixelData+(image->getWidth())*4*y, (image->getWidth())*4);
-				}
-			}
-
-			break;    
-		case kCCTexture2DPixelFormat_RGB888:
-			tempData = (unsigned char*)(image->getData());
-			CCAssert(tempData != NULL, "NULL image data.");
-			data = new unsigned char[POTHigh * POTWide * 4];
-			memset(data, 0, POTHigh * POTWide * 4);
-			if(image->getWidth() == (short)POTWide && image->getHeight() == (short)POTHigh)
-			{
-				for (int i = 0; i < POTHigh; ++i)
-				{
-					for (int j = 0; j < POTWide; ++j)
-					{
-						int m = (i * POTWide * 4) + (j * 4);
-						int n = (i * POTWide * 3) + (j * 3);
-						data[m+0] = tempData[n+0];
-						data[m+1] = tempData[n+1];
-						data[m+2] = tempData[n+2];
-						data[m+3] = 255;
-					}
-				}
-			}
-			else
-			{
-				int imagewidth = image->getWidth();
-				int imageHeight = image->getHeight();
-				for (int i = 0; i < imageHeight; ++i)
-				{
-					for (int j = 0; j < imagewidth; ++j)
-					{
-						int m = (i * POTWide * 4) + (j * 4);
-						int n = (i * imagewidth * 3) + (j * 3);
-						data[m+0] = tempData[n+0];
-						data[m+1] = tempData[n+1];
-						data[m+2] = tempData[n+2];
-						data[m+3] = 255;
-					}
-				}
-			}
-			break;   
+			// fix me, how to convert to A8
+			pixelFormat = kCCTexture2DPixelFormat_RGBA8888;
+			uploadFormat = kCCTexture2DPixelFormat_RGBA8888;
+			break;
 		default:
 			CCAssert(0, "Invalid pixel format");
+			return false;
 	}
 
-	// Repack the pixel data into the right format
-
-	if(pixelFormat == kCCTexture2DPixelFormat_RGB565) {
-		//Convert "RRRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA" to "RRRRRGGGGGGBBBBB"
-		tempData = new unsigned char[POTHigh * POTWide * 2];
-		inPixel32 = (unsigned int*)data;
-		outPixel16 = (unsigned short*)tempData;
-
-		unsigned int length = POTWide * POTHigh;
-		for(unsigned int i = 0; i < length; ++i, ++inPixel32)
-		{
-			*outPixel16++ = 
-				((((*inPixel32 >> 16) & 0xFF) >> 3) << 0) |  // B
-				((((*inPixel32 >> 8) & 0xFF) >> 2) << 5) |  // G
-				((((*inPixel32 >> 0) & 0xFF) >> 3) << 11); //
-		}
-
-		delete [] data;
-		data = tempData;
-	}
-	else if (pixelFormat == kCCTexture2DPixelFormat_RGBA4444) {
-		//TODO
-	}
-	else if (pixelFormat == kCCTexture2DPixelFormat_RGB5A1) {
-		//Convert "RRRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA" to "RRRRRGGGGGBBBBBA"
-		tempData = new unsigned char[POTHigh * POTWide * 2];
-		inPixel32 = (unsigned int*)data;
-		outPixel16 = (unsigned short*)tempData;
-
-		unsigned int length = POTWide * POTHigh;
-		for(unsigned int i = 0; i < length; ++i, ++inPixel32)
-		{
- 			*outPixel16++ = 
-				((((*inPixel32 >> 16) & 0xFF) >> 3) << 1) | // B
-				((((*inPixel32 >> 8) & 0xFF) >> 3) << 6) | // G
-				((((*inPixel32 >> 0) & 0xFF) >> 3) << 11) | // R
-				((((*inPixel32 >> 24) & 0xFF) >> 7) << 0); //
-		}
-
-		delete []data;
-		data = tempData;
-	}
-	else if (pixelFormat == kCCTexture2DPixelFormat_A8)
+	if (imageFormat == uploadFormat && image->getWidth() == POTWide && image->getHeight() == POTHigh)
 	{
-		// fix me, how to convert to A8
-		pixelFormat = kCCTexture2DPixelFormat_RGBA8888;
-		//TODO
+		// nothing to convert nor to pad, upload the image as it is
+		this->initWithData(tempData, pixelFormat, POTWide, POTHigh, imageSize);
 	}
-
-	if (data)
+	else
 	{
-		this->initWithData(data, pixelFormat, POTWide, POTHigh, imageSize);
-
-		// should be after calling super init
-		m_bHasPremultipliedAlpha = image->isPremultipliedAlpha();
+		// convert and pad to the POT size in a single pass
+		data = new unsigned char[POTHigh * POTWide * ccPixelBytesPerPixel(uploadFormat)];
+		unsigned int imageStride = image->getWidth() * (hasAlpha ? 4 : 3);
+		ccPixelConvertImage(tempData, imageFormat, image->getWidth(), image->getHeight(), imageStride,
+			data, uploadFormat, POTWide, POTHigh);
 
+		this->initWithData(data, pixelFormat, POTWide, POTHigh, imageSize);
 		delete [] data;
 	}
+
+	// should be after calling super init
+	m_bHasPremultipliedAlpha = image->isPremultipliedAlpha();
+
 	return true;
 }
 
@@ -34,8 +34,10 @@ THE SOFTWARE.
 #include "CCFileUtils.h"
 #include "DirectXHelper.h"
 #include <stdlib.h>
+#include <string.h>
 #include <fstream>
 #include "BasicLoader.h"
+#include "support/CCProfiling.h"
 
 using namespace DirectX;
 using namespace std;
@@ -46,6 +48,26 @@ using namespace std;
 
 namespace   cocos2d {
 
+// sends the vertices of a CCQuadUploader to the vertex buffer of an atlas
+class CCDXAtlasVertexTarget : public CCVertexBufferTarget
+{
+public:
+	CCDXAtlasVertexTarget(CCDXTextureAtlas& dxTextureAtlas, ID3D11Buffer* vertexBuffer)
+		: m_dxTextureAtlas(dxTextureAtlas)
+		, m_pVertexBuffer(vertexBuffer)
+	{
+	}
+
+	virtual void updateVertices(const ccV3F_C4F_T2F *pVertices, unsigned int uFirst, unsigned int uCount)
+	{
+		m_dxTextureAtlas.UpdateVertexBuffer(m_pVertexBuffer, pVertices, uFirst, uCount);
+	}
+
+private:
+	CCDXTextureAtlas& m_dxTextureAtlas;
+	ID3D11Buffer* m_pVertexBuffer;
+};
+
 CCDXTextureAtlas CCTextureAtlas::mDXTextureAtlas;
 
 CCTextureAtlas::CCTextureAtlas()
@@ -53,6 +75,9 @@ CCTextureAtlas::CCTextureAtlas()
 #if CC_USES_VBO
     , m_bDirty(false)
 #endif
+    ,m_pVertexBuffer(NULL)
+    ,m_pIndexBuffer(NULL)
+    ,m_uBufferCapacity(0)
     ,m_pTexture(NULL)
 	,m_pQuads(NULL)
 {
@@ -68,6 +93,7 @@ CCTextureAtlas::~CCTextureAtlas()
 #if CC_USES_VBO
 	//glDeleteBuffers(2, m_pBuffersVBO);
 #endif // CC_USES_VBO
+	releaseBuffers();
 
 	CC_SAFE_RELEASE(m_pTexture);
 }
@@ -102,6 +128,19 @@ ccV3F_C4B_T2F_Quad* CCTextureAtlas::getQuads()
 void CCTextureAtlas::setQuads(ccV3F_C4B_T2F_Quad *var)
 {
 	m_pQuads = var;
+	setDirtyRange(0, m_uCapacity);
+}
+
+void CCTextureAtlas::setDirtyRange(unsigned int start, unsigned int end)
+{
+	m_tQuadUploader.setDirtyRange(start, end);
+}
+
+void CCTextureAtlas::releaseBuffers()
+{
+	CC_SAFE_RELEASE_NULL_DX(m_pVertexBuffer);
+	CC_SAFE_RELEASE_NULL_DX(m_pIndexBuffer);
+	m_uBufferCapacity = 0;
 }
 
 // TextureAtlas - alloc & init
@@ -182,6 +221,8 @@ bool CCTextureAtlas::initWithTexture(CCTexture2D *texture, unsigned int capacity
 #endif // CC_USES_VBO
 
 	this->initIndices();
+	m_tQuadUploader.setCapacity(m_uCapacity);
+	setDirtyRange(0, m_uCapacity);
 	return true;
 }
 
@@ -246,6 +287,7 @@ void CCTextureAtlas::updateQuad(ccV3F_C4B_T2F_Quad *quad, unsigned int index)
 	m_uTotalQuads = max( index+1, m_uTotalQuads);
 
 	m_pQuads[index] = *quad;	
+	setDirtyRange(index, index + 1);
 
 #if CC_USES_VBO
 	m_bDirty = true;
@@ -269,6 +311,7 @@ void CCTextureAtlas::insertQuad(ccV3F_C4B_T2F_Quad *quad, unsigned int index)
 	}
 
 	m_pQuads[index] = *quad;
+	setDirtyRange(index, m_uTotalQuads);
 
 #if CC_USES_VBO
 	m_bDirty = true;
@@ -297,6 +340,7 @@ void CCTextureAtlas::insertQuadFromIndex(unsigned int oldIndex, unsigned int new
 	ccV3F_C4B_T2F_Quad quadsBackup = m_pQuads[oldIndex];
 	memmove( &m_pQuads[dst],&m_pQuads[src], sizeof(m_pQuads[0]) * howMany );
 	m_pQuads[newIndex] = quadsBackup;
+	setDirtyRange(min(oldIndex, newIndex), max(oldIndex, newIndex) + 1);
 
 #if CC_USES_VBO
 	m_bDirty = true;
@@ -314,6 +358,7 @@ void CCTextureAtlas::removeQuadAtIndex(unsigned int index)
 	if( remaining ) {
 		// texture coordinates
 		memmove( &m_pQuads[index],&m_pQuads[index+1], sizeof(m_pQuads[0]) * remaining );
+		setDirtyRange(index, m_uTotalQuads - 1);
 	}
 
 	m_uTotalQuads--;
@@ -373,6 +418,7 @@ bool CCTextureAtlas::resizeCapacity(unsigned int newCapacity)
 
 	m_pQuads = (ccV3F_C4B_T2F_Quad *)tmpQuads;
 	m_pIndices = (CCushort *)tmpIndices;
+	m_tQuadUploader.setCapacity(m_uCapacity);
 
 #if CC_USES_VBO
 	//glDeleteBuffers(2, m_pBuffersVBO);
@@ -383,6 +429,9 @@ bool CCTextureAtlas::resizeCapacity(unsigned int newCapacity)
 
 	this->initIndices();
 
+	// the GPU buffers are recreated with the new capacity on the next draw
+	releaseBuffers();
+
 #if CC_USES_VBO
 	m_bDirty = true;
 #endif
@@ -407,33 +456,54 @@ void CCTextureAtlas::drawNumberOfQuads(unsigned int n, unsigned int start)
 	if (0 == n)
 		return;
 
-	mDXTextureAtlas.Render(m_pQuads,m_pIndices,m_uCapacity,m_pTexture,n,start);
+	if (! m_pVertexBuffer || m_uBufferCapacity != m_uCapacity)
+	{
+		releaseBuffers();
+		if (! mDXTextureAtlas.initVertexBuffer(m_pIndices, m_uCapacity, &m_pVertexBuffer, &m_pIndexBuffer))
+		{
+			releaseBuffers();
+			return;
+		}
+		m_uBufferCapacity = m_uCapacity;
+		setDirtyRange(0, m_uCapacity);
+	}
+
+	// only the modified quads that are going to be drawn are uploaded,
+	// the rest of the dirty range stays pending until it is drawn
+	CCDXAtlasVertexTarget target(mDXTextureAtlas, m_pVertexBuffer);
+	m_tQuadUploader.upload(m_pQuads, start + n, &target);
+
+	mDXTextureAtlas.Render(m_pVertexBuffer,m_pIndexBuffer,m_pTexture,n,start);
 }
 
 
 void CCTextureAtlas::SetColor(UINT r,UINT g,UINT b,UINT a)
 {
-	for ( int i=0; i<m_uCapacity; i++ )
+	// called every frame by CCAtlasNode, so only the quads whose color changed are rewritten and uploaded
+	ccColor4B color = ccc4((CCubyte)r, (CCubyte)g, (CCubyte)b, (CCubyte)a);
+	unsigned int dirtyStart = m_uCapacity, dirtyEnd = 0;
+	for ( unsigned int i=0; i<m_uCapacity; i++ )
 	{
-		m_pQuads[i].tl.colors.r = r;
-		m_pQuads[i].tl.colors.g = g;
-		m_pQuads[i].tl.colors.b = b;
-		m_pQuads[i].tl.colors.a = a;
-
-		m_pQuads[i].tr.colors.r = r;
-		m_pQuads[i].tr.colors.g = g;
-		m_pQuads[i].tr.colors.b = b;
-		m_pQuads[i].tr.colors.a = a;
-
-		m_pQuads[i].br.colors.r = r;
-		m_pQuads[i].br.colors.g = g;
-		m_pQuads[i].br.colors.b = b;
-		m_pQuads[i].br.colors.a = a;
-
-		m_pQuads[i].bl.colors.r = r;
-		m_pQuads[i].bl.colors.g = g;
-		m_pQuads[i].bl.colors.b = b;
-		m_pQuads[i].bl.colors.a = a;
+		ccV3F_C4B_T2F_Quad& quad = m_pQuads[i];
+		ccColor4B* corners[4] = { &quad.tl.colors, &quad.tr.colors, &quad.br.colors, &quad.bl.colors };
+		bool changed = false;
+		for ( int j=0; j<4; j++ )
+		{
+			if ( memcmp(corners[j], &color, sizeof(ccColor4B)) != 0 )
+			{
+				*corners[j] = color;
+				changed = true;
+			}
+		}
+		if ( changed )
+		{
+			dirtyStart = min(dirtyStart, i);
+			dirtyEnd = i + 1;
+		}
+	}
+	if ( dirtyStart < dirtyEnd )
+	{
+		setDirtyRange(dirtyStart, dirtyEnd);
 	}
 }
 
@@ -444,8 +514,6 @@ CCDXTextureAtlas::CCDXTextureAtlas()
 	m_pixelShader = 0;
 	m_layout = 0;
 	m_matrixBuffer = 0;
-	m_indexBuffer = 0;
-	m_vertexBuffer = 0;
 
 	mIsInit = FALSE;
 }
@@ -455,8 +523,6 @@ CCDXTextureAtlas::~CCDXTextureAtlas()
 }
 void CCDXTextureAtlas::FreeBuffer()
 {
-	CC_SAFE_RELEASE_NULL_DX(m_vertexBuffer);
-	CC_SAFE_RELEASE_NULL_DX(m_indexBuffer);
 	CC_SAFE_RELEASE_NULL_DX(m_matrixBuffer);
 	CC_SAFE_RELEASE_NULL_DX(m_layout);
 	CC_SAFE_RELEASE_NULL_DX(m_pixelShader);
@@ -467,75 +533,49 @@ void CCDXTextureAtlas::setIsInit(bool isInit)
 	mIsInit = isInit;
 }
 
-void CCDXTextureAtlas::RenderVertexBuffer(ccV3F_C4B_T2F_Quad* quads,unsigned int capacity)
+void CCDXTextureAtlas::UpdateVertexBuffer(ID3D11Buffer* vertexBuffer,const ccV3F_C4F_T2F* vertices,unsigned int first,unsigned int count)
 {
-	VertexType* verticesTmp = new VertexType[4*capacity];
-	if(!verticesTmp)
-	{
-		return ;
-	}
-
-	for ( int i=0; i<capacity; i++ )
-	{
-		verticesTmp[4*i+0].position = XMFLOAT3(quads[i].tl.vertices.x, quads[i].tl.vertices.y, quads[i].tl.vertices.z);
-		verticesTmp[4*i+1].position = XMFLOAT3(quads[i].tr.vertices.x, quads[i].tr.vertices.y, quads[i].tr.vertices.z);
-		verticesTmp[4*i+2].position = XMFLOAT3(quads[i].br.vertices.x, quads[i].br.vertices.y, quads[i].br.vertices.z);
-		verticesTmp[4*i+3].position = XMFLOAT3(quads[i].bl.vertices.x, quads[i].bl.vertices.y, quads[i].bl.vertices.z);
-
-		verticesTmp[4*i+0].texture = XMFLOAT2(quads[i].tl.texCoords.u, quads[i].tl.texCoords.v);
-		verticesTmp[4*i+1].texture = XMFLOAT2(quads[i].tr.texCoords.u, quads[i].tr.texCoords.v);
-		verticesTmp[4*i+2].texture = XMFLOAT2(quads[i].br.texCoords.u, quads[i].br.texCoords.v);
-		verticesTmp[4*i+3].texture = XMFLOAT2(quads[i].bl.texCoords.u, quads[i].bl.texCoords.v);
-
-		verticesTmp[4*i+0].color = XMFLOAT4(quads[i].tl.colors.r/255.f, quads[i].tl.colors.g/255.f, quads[i].tl.colors.b/255.f, quads[i].tl.colors.a/255.f);
-		verticesTmp[4*i+1].color = XMFLOAT4(quads[i].tr.colors.r/255.f, quads[i].tr.colors.g/255.f, quads[i].tr.colors.b/255.f, quads[i].tr.colors.a/255.f);
-		verticesTmp[4*i+2].color = XMFLOAT4(quads[i].br.colors.r/255.f, quads[i].br.colors.g/255.f, quads[i].br.colors.b/255.f, quads[i].br.colors.a/255.f);
-		verticesTmp[4*i+3].color = XMFLOAT4(quads[i].bl.colors.r/255.f, quads[i].bl.colors.g/255.f, quads[i].bl.colors.b/255.f, quads[i].bl.colors.a/255.f);
-	}
-
-	D3D11_MAPPED_SUBRESOURCE mappedResourceVertex;
-	VertexType* verticesPtr;
-	if(FAILED(CCID3D11DeviceContext->Map(m_vertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResourceVertex))){return ;}
-	verticesPtr = (VertexType*)mappedResourceVertex.pData;
-	memcpy(verticesPtr, (void*)verticesTmp, (sizeof(VertexType) * 4 * capacity));
-	CCID3D11DeviceContext->Unmap(m_vertexBuffer, 0);
+	// the buffer is not discarded, so only the bytes of the modified quads are sent to the GPU
+	D3D11_BOX box;
+	box.left = sizeof(VertexType) * first;
+	box.right = sizeof(VertexType) * (first + count);
+	box.top = 0;
+	box.bottom = 1;
+	box.front = 0;
+	box.back = 1;
+	CCID3D11DeviceContext->UpdateSubresource(vertexBuffer, 0, &box, vertices, 0, 0);
+}
 
-	if ( verticesTmp )
-	{
-		delete[] verticesTmp;
-		verticesTmp = 0;
-	}
-	////////////////////////
+void CCDXTextureAtlas::RenderVertexBuffer(ID3D11Buffer* vertexBuffer,ID3D11Buffer* indexBuffer)
+{
 	unsigned int stride;
 	unsigned int offset;
 	stride = sizeof(VertexType); 
 	offset = 0;
-	CCID3D11DeviceContext->IASetVertexBuffers(0, 1, &m_vertexBuffer, &stride, &offset);
-	CCID3D11DeviceContext->IASetIndexBuffer( m_indexBuffer, DXGI_FORMAT_R16_UINT, 0);
+	CCID3D11DeviceContext->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+	CCID3D11DeviceContext->IASetIndexBuffer( indexBuffer, DXGI_FORMAT_R16_UINT, 0);
 
 	CCID3D11DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 	return;
 }
 
-void CCDXTextureAtlas::initVertexBuffer(unsigned short* indices,unsigned int capacity)
+bool CCDXTextureAtlas::initVertexBuffer(unsigned short* indices,unsigned int capacity,ID3D11Buffer** vertexBuffer,ID3D11Buffer** indexBuffer)
 {
-	CC_SAFE_RELEASE_NULL_DX(m_indexBuffer);
-	CC_SAFE_RELEASE_NULL_DX(m_vertexBuffer);
 	D3D11_BUFFER_DESC vertexBufferDesc;
 
-	// Set up the description of the static vertex buffer.
-	vertexBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	// Set up the description of the vertex buffer, it lives as long as the atlas and is updated in place.
+	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
 	vertexBufferDesc.ByteWidth = sizeof(VertexType)*4 * capacity;
 	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	vertexBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	vertexBufferDesc.CPUAccessFlags = 0;
 	vertexBufferDesc.MiscFlags = 0;
 	vertexBufferDesc.StructureByteStride = 0;
 
 	// Now create the vertex buffer.
-	if(FAILED(CCID3D11Device->CreateBuffer(&vertexBufferDesc, NULL, &m_vertexBuffer)))
+	if(FAILED(CCID3D11Device->CreateBuffer(&vertexBufferDesc, NULL, vertexBuffer)))
 	{
-		return ;
+		return false;
 	}
 
 
@@ -550,7 +590,12 @@ void CCDXTextureAtlas::initVertexBuffer(unsigned short* indices,unsigned int cap
 
 	D3D11_SUBRESOURCE_DATA iinitData;
 	iinitData.pSysMem = indices;
-	CCID3D11Device->CreateBuffer(&indexBufferDesc, &iinitData, &m_indexBuffer);
+	if(FAILED(CCID3D11Device->CreateBuffer(&indexBufferDesc, &iinitData, indexBuffer)))
+	{
+		return false;
+	}
+
+	return true;
 }
 
 bool CCDXTextureAtlas::InitializeShader()
@@ -671,20 +716,22 @@ void CCDXTextureAtlas::RenderShader(CCTexture2D* texture,unsigned int n, unsigne
 	CCID3D11DeviceContext->PSSetShader(m_pixelShader, NULL, 0);
 	CCID3D11DeviceContext->PSSetSamplers(0, 1, texture->GetSamplerState());
 	CCID3D11DeviceContext->DrawIndexed(n*6, start*6, 0 );
+	CCFrameProfiler::addDrawCall(n);
 
 	return;
 }
 
 
-void CCDXTextureAtlas::Render(ccV3F_C4B_T2F_Quad* quads,unsigned short* indices,unsigned int capacity,CCTexture2D* texture,unsigned int n, unsigned int start)
+void CCDXTextureAtlas::Render(ID3D11Buffer* vertexBuffer,ID3D11Buffer* indexBuffer,CCTexture2D* texture,unsigned int n, unsigned int start)
 {
+	CCD3DCLASS->D3DFlushBatch();
+
 	if ( !mIsInit )
 	{
 		mIsInit = TRUE;
 		FreeBuffer();
 		InitializeShader();
 	}
-	initVertexBuffer(indices,capacity);
 
 	XMMATRIX viewMatrix, projectionMatrix;
 	// Get the world, view, and projection matrices from the camera and d3d objects.
@@ -692,7 +739,7 @@ void CCDXTextureAtlas::Render(ccV3F_C4B_T2F_Quad* quads,unsigned short* indices,
 	CCD3DCLASS->GetProjectionMatrix(projectionMatrix);
 
 	// Put the model vertex and index buffers on the graphics pipeline to prepare them for drawing.
-	RenderVertexBuffer(quads,capacity);
+	RenderVertexBuffer(vertexBuffer,indexBuffer);
 
 	// Set the shader parameters that it will use for rendering.
 	SetShaderParameters(viewMatrix, projectionMatrix, texture->getTextureResource());
@@ -38,13 +38,72 @@ THE SOFTWARE.
 #include "CCImage.h"
 #include "support/ccUtils.h"
 #include "CCScheduler.h"
-//#include "pthread.h"
-//#include "CCThread.h"
-//#include "semaphore.h"
+#include <map>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 using namespace std;
 namespace   cocos2d {
 
+// one request per file, the callbacks of duplicated requests are appended to it
+typedef struct _AsyncStruct
+{
+	std::string pathKey;
+	std::string fullpath;
+	CCImage::EImageFormat imageType;
+	std::vector<std::pair<SelectorProtocol*, SEL_CallFuncO> > callbacks;
+	// written by the loading thread, NULL if the image couldn't be decoded
+	CCImage *image;
+} AsyncStruct;
+
+// the loading state is only touched by CCTextureCache, the mutex guards the two queues and s_bQuitLoading
+static std::vector<std::thread> s_loadingThreads;
+static std::mutex s_asyncMutex;
+static std::condition_variable s_asyncCondition;
+static std::queue<AsyncStruct*> s_asyncRequestQueue;
+static std::queue<AsyncStruct*> s_asyncDoneQueue;
+static bool s_bQuitLoading = false;
+
+// main thread only: requests that were issued and whose callbacks weren't called yet
+static std::map<std::string, AsyncStruct*> s_asyncInFlight;
+
+static void loadImageThread()
+{
+	while (true)
+	{
+		AsyncStruct *pAsyncStruct = NULL;
+		{
+			std::unique_lock<std::mutex> lock(s_asyncMutex);
+			while (! s_bQuitLoading && s_asyncRequestQueue.empty())
+			{
+				s_asyncCondition.wait(lock);
+			}
+
+			if (s_bQuitLoading)
+			{
+				break;
+			}
+
+			pAsyncStruct = s_asyncRequestQueue.front();
+			s_asyncRequestQueue.pop();
+		}
+
+		// read and decode the file, the texture is created on the main thread
+		CCImage *pImage = new CCImage();
+		if (! pImage->initWithImageFileThreadSafe(pAsyncStruct->fullpath.c_str(), pAsyncStruct->imageType))
+		{
+			CC_SAFE_DELETE(pImage);
+			CCLOG("cocos2d: Couldn't load image:%s asynchronously", pAsyncStruct->fullpath.c_str());
+		}
+		pAsyncStruct->image = pImage;
+
+		std::lock_guard<std::mutex> lock(s_asyncMutex);
+		s_asyncDoneQueue.push(pAsyncStruct);
+	}
+}
+
 static CCImage::EImageFormat computeImageFormatType(string& filename)
 {
 	CCImage::EImageFormat ret = CCImage::kFmtUnKnown;
@@ -85,11 +144,17 @@ CCTextureCache::~CCTextureCache()
 {
 	CCLOGINFO("cocos2d: deallocing CCTextureCache.");
 
+	stopAsyncLoading();
 	CC_SAFE_RELEASE(m_pTextures);
 }
 
 void CCTextureCache::purgeSharedTextureCache()
 {
+	if (g_sharedTextureCache)
+	{
+		// the scheduler retains the cache while asynchronous loads are in flight
+		g_sharedTextureCache->stopAsyncLoading();
+	}
 	CC_SAFE_RELEASE_NULL(g_sharedTextureCache);
 }
 
@@ -104,13 +169,196 @@ char * CCTextureCache::description()
 void CCTextureCache::addImageAsync(const char *path, SelectorProtocol *target, SEL_CallFuncO selector)
 {
 	CCAssert(path != NULL, "TextureCache: fileimage MUST not be NULL");	
-	//TODO
 
+	// remove possible -HD suffix to prevent caching the same image twice (issue #1040)
+	std::string pathKey = path;
+	CCFileUtils::ccRemoveHDSuffixFromFile(pathKey);
+	pathKey = CCFileUtils::fullPathFromRelativePath(pathKey.c_str());
+
+	// the texture is already loaded
+	CCTexture2D *texture = m_pTextures->objectForKey(pathKey);
+	if (texture)
+	{
+		if (target && selector)
+		{
+			(target->*selector)(texture);
+		}
+		return;
+	}
+
+	std::string lowerCase(path);
+	for (unsigned int i = 0; i < lowerCase.length(); ++i)
+	{
+		lowerCase[i] = tolower(lowerCase[i]);
+	}
+
+	// pvr files are uploaded without decoding, there is nothing to do in the background
+	if (std::string::npos != lowerCase.find(".pvr"))
+	{
+		texture = addImage(path);
+		if (target && selector)
+		{
+			(target->*selector)(texture);
+		}
+		return;
+	}
+
+	if (target)
+	{
+		target->selectorProtocolRetain();
+	}
+
+	// the file is already being loaded, wait for the same result
+	std::map<std::string, AsyncStruct*>::iterator it = s_asyncInFlight.find(pathKey);
+	if (it != s_asyncInFlight.end())
+	{
+		it->second->callbacks.push_back(std::make_pair(target, selector));
+		return;
+	}
+
+	if (s_loadingThreads.empty())
+	{
+		s_bQuitLoading = false;
+		for (int i = 0; i < CC_TEXTURE_CACHE_ASYNC_THREADS; ++i)
+		{
+			s_loadingThreads.push_back(std::thread(loadImageThread));
+		}
+	}
+
+	if (s_asyncInFlight.empty())
+	{
+		CCScheduler::sharedScheduler()->scheduleSelector(schedule_selector(CCTextureCache::addImageAsyncCallBack), this, 0, false);
+	}
+
+	AsyncStruct *pAsyncStruct = new AsyncStruct();
+	pAsyncStruct->pathKey = pathKey;
+	pAsyncStruct->fullpath = pathKey;
+	pAsyncStruct->imageType = computeImageFormatType(lowerCase);
+	// same rule as addImage: everything that isn't a jpeg is decoded as png
+	if (pAsyncStruct->imageType == CCImage::kFmtUnKnown)
+	{
+		pAsyncStruct->imageType = CCImage::kFmtPng;
+	}
+	pAsyncStruct->callbacks.push_back(std::make_pair(target, selector));
+	pAsyncStruct->image = NULL;
+	s_asyncInFlight[pathKey] = pAsyncStruct;
+
+	{
+		std::lock_guard<std::mutex> lock(s_asyncMutex);
+		s_asyncRequestQueue.push(pAsyncStruct);
+	}
+	s_asyncCondition.notify_one();
 }
 
 void CCTextureCache::addImageAsyncCallBack(ccTime dt)
 {
-	//TODO
+	CC_UNUSED_PARAM(dt);
+
+	std::queue<AsyncStruct*> doneQueue;
+	{
+		std::lock_guard<std::mutex> lock(s_asyncMutex);
+		doneQueue.swap(s_asyncDoneQueue);
+	}
+
+	while (! doneQueue.empty())
+	{
+		AsyncStruct *pAsyncStruct = doneQueue.front();
+		doneQueue.pop();
+		s_asyncInFlight.erase(pAsyncStruct->pathKey);
+
+		// a synchronous addImage may have loaded the file in the meantime
+		CCTexture2D *texture = m_pTextures->objectForKey(pAsyncStruct->pathKey);
+		if (! texture && pAsyncStruct->image)
+		{
+			texture = new CCTexture2D();
+			if (texture->initWithImage(pAsyncStruct->image))
+			{
+#if CC_ENABLE_CACHE_TEXTTURE_DATA
+				// cache the texture file name
+				VolatileTexture::addImageTexture(texture, pAsyncStruct->fullpath.c_str(), pAsyncStruct->imageType);
+#endif
+				m_pTextures->setObject(texture, pAsyncStruct->pathKey);
+				texture->autorelease();
+			}
+			else
+			{
+				CC_SAFE_RELEASE_NULL(texture);
+				CCLOG("cocos2d: Couldn't add image:%s in CCTextureCache", pAsyncStruct->pathKey.c_str());
+			}
+		}
+		CC_SAFE_DELETE(pAsyncStruct->image);
+
+		for (unsigned int i = 0; i < pAsyncStruct->callbacks.size(); ++i)
+		{
+			SelectorProtocol *target = pAsyncStruct->callbacks[i].first;
+			SEL_CallFuncO selector = pAsyncStruct->callbacks[i].second;
+			if (target)
+			{
+				if (selector)
+				{
+					(target->*selector)(texture);
+				}
+				target->selectorProtocolRelease();
+			}
+		}
+
+		delete pAsyncStruct;
+	}
+
+	if (s_asyncInFlight.empty())
+	{
+		CCScheduler::sharedScheduler()->unscheduleSelector(schedule_selector(CCTextureCache::addImageAsyncCallBack), this);
+	}
+}
+
+void CCTextureCache::stopAsyncLoading(void)
+{
+	if (s_loadingThreads.empty())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(s_asyncMutex);
+		s_bQuitLoading = true;
+	}
+	s_asyncCondition.notify_all();
+
+	for (unsigned int i = 0; i < s_loadingThreads.size(); ++i)
+	{
+		s_loadingThreads[i].join();
+	}
+	s_loadingThreads.clear();
+
+	// every request is either still queued or done, the callbacks are never called
+	while (! s_asyncRequestQueue.empty())
+	{
+		s_asyncRequestQueue.pop();
+	}
+	while (! s_asyncDoneQueue.empty())
+	{
+		s_asyncDoneQueue.pop();
+	}
+
+	if (! s_asyncInFlight.empty())
+	{
+		CCScheduler::sharedScheduler()->unscheduleSelector(schedule_selector(CCTextureCache::addImageAsyncCallBack), this);
+	}
+
+	for (std::map<std::string, AsyncStruct*>::iterator it = s_asyncInFlight.begin(); it != s_asyncInFlight.end(); ++it)
+	{
+		AsyncStruct *pAsyncStruct = it->second;
+		for (unsigned int i = 0; i < pAsyncStruct->callbacks.size(); ++i)
+		{
+			if (pAsyncStruct->callbacks[i].first)
+			{
+				pAsyncStruct->callbacks[i].first->selectorProtocolRelease();
+			}
+		}
+		CC_SAFE_DELETE(pAsyncStruct->image);
+		delete pAsyncStruct;
+	}
+	s_asyncInFlight.clear();
 }
 
 CCTexture2D * CCTextureCache::addImage(const char * path)
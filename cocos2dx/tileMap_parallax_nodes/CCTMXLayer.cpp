@@ -29,8 +29,10 @@ THE SOFTWARE.
 #include "CCSprite.h"
 #include "CCTextureCache.h"
 #include "CCPointExtension.h"
-#include "support/data_support/ccCArray.h"
 #include "CCDirector.h"
+#include "CCAffineTransform.h"
+#include "ccConfig.h"
+#include <algorithm>
 
 namespace cocos2d {
 
@@ -48,10 +50,11 @@ namespace cocos2d {
 	}
 	bool CCTMXLayer::initWithTilesetInfo(CCTMXTilesetInfo *tilesetInfo, CCTMXLayerInfo *layerInfo, CCTMXMapInfo *mapInfo)
 	{	
-		// XXX: is 35% a good estimate ?
+		// the atlas starts with the quads of one chunk, it grows with the chunks on the screen
 		CCSize size = layerInfo->m_tLayerSize;
-		float totalNumberOfTiles = size.width * size.height;
-		float capacity = totalNumberOfTiles * 0.35f + 1; // 35 percent is occupied ?
+		m_uChunkWidth = MAX(1u, MIN((unsigned int)CC_TMX_LAYER_CHUNK_SIZE, (unsigned int)size.width));
+		m_uChunkHeight = MAX(1u, MIN((unsigned int)CC_TMX_LAYER_CHUNK_SIZE, (unsigned int)size.height));
+		unsigned int capacity = m_uChunkWidth * m_uChunkHeight;
 
 		CCTexture2D *texture = NULL;
 		if( tilesetInfo )
@@ -59,7 +62,7 @@ namespace cocos2d {
 			texture = CCTextureCache::sharedTextureCache()->addImage(tilesetInfo->m_sSourceImage.c_str());
 		}
 
-		if (CCSpriteBatchNode::initWithTexture(texture, (unsigned int)capacity))
+		if (CCSpriteBatchNode::initWithTexture(texture, capacity))
 		{
 			// layerInfo
 			m_sLayerName = layerInfo->m_sName;
@@ -83,7 +86,12 @@ namespace cocos2d {
 			CCPoint offset = this->calculateLayerOffset(layerInfo->m_tOffset);
 			this->setPosition(offset);
 
-			m_pAtlasIndexArray = ccCArrayNew((unsigned int)totalNumberOfTiles);
+			m_uChunkColumns = ((unsigned int)m_tLayerSize.width + m_uChunkWidth - 1) / m_uChunkWidth;
+			m_uChunkRows = ((unsigned int)m_tLayerSize.height + m_uChunkHeight - 1) / m_uChunkHeight;
+			ccTMXLayerChunk emptyChunk = { -1, 0, 0, 0 };
+			m_tChunks.assign(m_uChunkColumns * m_uChunkRows, emptyChunk);
+			m_tSlotChunks.assign(1, -1);
+			m_uFrame = 0;
 
 			this->setContentSizeInPixels(CCSizeMake(m_tLayerSize.width * m_tMapTileSize.width, m_tLayerSize.height * m_tMapTileSize.height));
                         m_tMapTileSize.width /= m_fContentScaleFactor;
@@ -104,7 +112,11 @@ namespace cocos2d {
 		,m_pProperties(NULL)
         ,m_sLayerName("")
 		,m_pReusedTile(NULL)
-		,m_pAtlasIndexArray(NULL)	
+		,m_uChunkWidth(0)
+		,m_uChunkHeight(0)
+		,m_uChunkColumns(0)
+		,m_uChunkRows(0)
+		,m_uFrame(0)
 	{}
 	CCTMXLayer::~CCTMXLayer()
 	{
@@ -112,12 +124,6 @@ namespace cocos2d {
 		CC_SAFE_RELEASE(m_pReusedTile);
 		CC_SAFE_RELEASE(m_pProperties);
 
-		if( m_pAtlasIndexArray )
-		{
-			ccCArrayFree(m_pAtlasIndexArray);
-			m_pAtlasIndexArray = NULL;
-		}
-
 		CC_SAFE_DELETE_ARRAY(m_pTiles);
 	}
 	CCTMXTilesetInfo * CCTMXLayer::getTileSet()
@@ -134,15 +140,23 @@ namespace cocos2d {
 	{
 		if( m_pTiles )
 		{
+			// the chunks can't be created without the map, create all of them now
+			// and keep them all, marking them as drawn
+			for( unsigned int i=0; i < m_tChunks.size(); i++ )
+			{
+				if( m_tChunks[i].uTileCount > 0 )
+				{
+					m_tChunks[i].uLastDrawnFrame = m_uFrame;
+					if( m_tChunks[i].nSlot < 0 )
+					{
+						buildChunk(i);
+					}
+				}
+			}
+
 			delete [] m_pTiles;
 			m_pTiles = NULL;
 		}
-
-		if( m_pAtlasIndexArray )
-		{
-			ccCArrayFree(m_pAtlasIndexArray);
-			m_pAtlasIndexArray = NULL;
-		}
 	}
 
 	// CCTMXLayer - setup Tiles
@@ -177,9 +191,10 @@ namespace cocos2d {
 				/* We support little endian.*/
 
 				// XXX: gid == 0 --> empty tile
+				// the quads are created when the chunk of the tile is drawn
 				if( gid != 0 ) 
 				{
-					this->appendTileForGID(gid, ccp((float)x, (float)y));
+					m_tChunks[chunkForTile(x, y)].uTileCount++;
 
 					// Optimization: update min and max GID rendered by the layer
 					m_uMinGID = MIN(gid, m_uMinGID);
@@ -225,7 +240,7 @@ namespace cocos2d {
 	CCSprite * CCTMXLayer::tileAt(const CCPoint& pos)
 	{
 		CCAssert( pos.x < m_tLayerSize.width && pos.y < m_tLayerSize.height && pos.x >=0 && pos.y >=0, "TMXLayer: invalid position");
-		CCAssert( m_pTiles && m_pAtlasIndexArray, "TMXLayer: the tiles map has been released");
+		CCAssert( m_pTiles, "TMXLayer: the tiles map has been released");
 
 		CCSprite *tile = NULL;
 		unsigned int gid = this->tileGIDAt(pos);
@@ -239,6 +254,14 @@ namespace cocos2d {
 			// tile not created yet. create it
 			if( ! tile ) 
 			{
+				// the sprite takes the place of the quad of the tile
+				unsigned int chunk = chunkForTile((unsigned int)pos.x, (unsigned int)pos.y);
+				if( m_tChunks[chunk].nSlot < 0 )
+				{
+					buildChunk(chunk);
+				}
+				m_tChunks[chunk].uSpriteCount++;
+
 				CCRect rect = m_pTileSet->rectForGID(gid);
                                 rect = CCRectMake(rect.origin.x / m_fContentScaleFactor, rect.origin.y / m_fContentScaleFactor, rect.size.width/ m_fContentScaleFactor, rect.size.height/ m_fContentScaleFactor);
 
@@ -249,7 +272,7 @@ namespace cocos2d {
 				tile->setAnchorPoint(CCPointZero);
 				tile->setOpacity(m_cOpacity);
 
-				unsigned int indexForZ = atlasIndexForExistantZ(z);
+				unsigned int indexForZ = atlasIndexForTile((unsigned int)pos.x, (unsigned int)pos.y);
 				this->addSpriteWithoutQuad(tile, indexForZ, z);
 				tile->release();
 			}
@@ -259,20 +282,18 @@ namespace cocos2d {
 	unsigned int CCTMXLayer::tileGIDAt(const CCPoint& pos)
 	{
 		CCAssert( pos.x < m_tLayerSize.width && pos.y < m_tLayerSize.height && pos.x >=0 && pos.y >=0, "TMXLayer: invalid position");
-		CCAssert( m_pTiles && m_pAtlasIndexArray, "TMXLayer: the tiles map has been released");
+		CCAssert( m_pTiles, "TMXLayer: the tiles map has been released");
 
 		int idx = (int)(pos.x + pos.y * m_tLayerSize.width);
 		return m_pTiles[ idx ];
 	}
 
 	// CCTMXLayer - adding helper methods
-	CCSprite * CCTMXLayer::insertTileForGID(unsigned int gid, const CCPoint& pos)
+	void CCTMXLayer::setupReusedTileForGID(unsigned int gid, const CCPoint& pos)
 	{
 		CCRect rect = m_pTileSet->rectForGID(gid);
                 rect = CCRectMake(rect.origin.x / m_fContentScaleFactor, rect.origin.y / m_fContentScaleFactor, rect.size.width/ m_fContentScaleFactor, rect.size.height/ m_fContentScaleFactor);
 
-		int z = (int)(pos.x + pos.y * m_tLayerSize.width);
-
 		if( ! m_pReusedTile )
 		{
 			m_pReusedTile = new CCSprite();
@@ -282,142 +303,232 @@ namespace cocos2d {
 		{
 			m_pReusedTile->initWithBatchNode(this, rect);
 		}
-		m_pReusedTile->setPositionInPixels(positionAt(pos));
+
+		m_pReusedTile->setPosition(positionAt(pos));
 		m_pReusedTile->setVertexZ((float)vertexZForPos(pos));
 		m_pReusedTile->setAnchorPoint(CCPointZero);
 		m_pReusedTile->setOpacity(m_cOpacity);
+	}
+	CCSprite * CCTMXLayer::insertTileForGID(unsigned int gid, const CCPoint& pos)
+	{
+		unsigned int x = (unsigned int)pos.x;
+		unsigned int y = (unsigned int)pos.y;
+		int z = (int)(pos.x + pos.y * m_tLayerSize.width);
 
-		// get atlas index
-		unsigned int indexForZ = atlasIndexForNewZ(z);
-
-		// Optimization: add the quad without adding a child
-		this->addQuadFromSprite(m_pReusedTile, indexForZ);
-
-		// insert it into the local atlasindex array
-		ccCArrayInsertValueAtIndex(m_pAtlasIndexArray, (void*)z, indexForZ);
+		ccTMXLayerChunk& chunk = m_tChunks[chunkForTile(x, y)];
+		chunk.uTileCount++;
+		m_pTiles[z] = gid;
 
-		// update possible children
-		if (m_pChildren && m_pChildren->count()>0)
+		// the quad of the tile has its place in the chunk, nothing moves
+		if( chunk.nSlot >= 0 )
 		{
-            CCObject* pObject = NULL;
-            CCARRAY_FOREACH(m_pChildren, pObject)
-            {
-                CCSprite* pChild = (CCSprite*) pObject;
-                if (pChild)
-                {
-                    unsigned int ai = pChild->getAtlasIndex();
-                    if ( ai >= indexForZ )
-                    {
-                        pChild->setAtlasIndex(ai+1);
-                    }
-                }
-            }
+			return appendTileForGID(gid, pos);
 		}
-		m_pTiles[z] = gid;
-		return m_pReusedTile;
+		return NULL;
 	}
 	CCSprite * CCTMXLayer::updateTileForGID(unsigned int gid, const CCPoint& pos)	
 	{
-		CCRect rect = m_pTileSet->rectForGID(gid);
-                rect = CCRectMake(rect.origin.x / m_fContentScaleFactor, rect.origin.y / m_fContentScaleFactor, rect.size.width/ m_fContentScaleFactor, rect.size.height/ m_fContentScaleFactor);
 		int z = (int)(pos.x + pos.y * m_tLayerSize.width);
+		m_pTiles[z] = gid;
 
-		if( ! m_pReusedTile )
-		{
-			m_pReusedTile = new CCSprite();
-			m_pReusedTile->initWithBatchNode(this, rect);
-		}
-		else
+		if( m_tChunks[chunkForTile((unsigned int)pos.x, (unsigned int)pos.y)].nSlot >= 0 )
 		{
-			m_pReusedTile->initWithBatchNode(this, rect);
+			return appendTileForGID(gid, pos);
 		}
-		
-		m_pReusedTile->setPositionInPixels(positionAt(pos));
-		m_pReusedTile->setVertexZ((float)vertexZForPos(pos));
-		m_pReusedTile->setAnchorPoint(CCPointZero);
-		m_pReusedTile->setOpacity(m_cOpacity);
+		return NULL;
+	}
+
+	// writes the quad of a tile of a chunk that was created
+	CCSprite * CCTMXLayer::appendTileForGID(unsigned int gid, const CCPoint& pos)
+	{
+		setupReusedTileForGID(gid, pos);
 
-		// get atlas index
-		unsigned int indexForZ = atlasIndexForExistantZ(z);
-		m_pReusedTile->setAtlasIndex(indexForZ);
-        m_pReusedTile->setDirty(true);
+		m_pReusedTile->setAtlasIndex(atlasIndexForTile((unsigned int)pos.x, (unsigned int)pos.y));
+		m_pReusedTile->setDirty(true);
 		m_pReusedTile->updateTransform();
-		m_pTiles[z] = gid;
 
 		return m_pReusedTile;
 	}
+	void CCTMXLayer::clearQuadAtIndex(unsigned int index)
+	{
+		ccV3F_C4B_T2F_Quad quad;
+		memset(&quad, 0, sizeof(quad));
+		m_pobTextureAtlas->updateQuad(&quad, index);
+	}
 
-	// used only when parsing the map. useless after the map was parsed
-	// since lot's of assumptions are no longer true
-	CCSprite * CCTMXLayer::appendTileForGID(unsigned int gid, const CCPoint& pos)
+	// CCTMXLayer - chunks
+	unsigned int CCTMXLayer::chunkForTile(unsigned int x, unsigned int y)
 	{
-		CCRect rect = m_pTileSet->rectForGID(gid);
-                rect = CCRectMake(rect.origin.x / m_fContentScaleFactor, rect.origin.y / m_fContentScaleFactor, rect.size.width/ m_fContentScaleFactor, rect.size.height/ m_fContentScaleFactor);
+		return (y / m_uChunkHeight) * m_uChunkColumns + x / m_uChunkWidth;
+	}
+	unsigned int CCTMXLayer::atlasIndexForTile(unsigned int x, unsigned int y)
+	{
+		int slot = m_tChunks[chunkForTile(x, y)].nSlot;
+		CCAssert( slot >= 0, "TMX chunk of the tile not created. Shall not happen");
 
-		int z = (int)(pos.x + pos.y * m_tLayerSize.width);
+		return slot * m_uChunkWidth * m_uChunkHeight + (y % m_uChunkHeight) * m_uChunkWidth + x % m_uChunkWidth;
+	}
+	unsigned int CCTMXLayer::slotForNewChunk()
+	{
+		// a free slot
+		for( unsigned int i=0; i < m_tSlotChunks.size(); i++ )
+		{
+			if( m_tSlotChunks[i] < 0 )
+			{
+				return i;
+			}
+		}
 
-		if( ! m_pReusedTile )
+		// the slot of the chunk that was drawn the longest time ago, if it is not on the screen.
+		// Chunks with sprites keep their quads, and without the map the quads can't be created again
+		int oldest = -1;
+		if( m_pTiles )
 		{
-			m_pReusedTile = new CCSprite();
-			m_pReusedTile->initWithBatchNode(this, rect);
+			for( unsigned int i=0; i < m_tSlotChunks.size(); i++ )
+			{
+				const ccTMXLayerChunk& chunk = m_tChunks[m_tSlotChunks[i]];
+				if( chunk.uSpriteCount == 0 && chunk.uLastDrawnFrame != m_uFrame &&
+					(oldest < 0 || chunk.uLastDrawnFrame < m_tChunks[m_tSlotChunks[oldest]].uLastDrawnFrame) )
+				{
+					oldest = i;
+				}
+			}
 		}
-		else
+		if( oldest >= 0 )
 		{
-			m_pReusedTile->initWithBatchNode(this, rect);
+			m_tChunks[m_tSlotChunks[oldest]].nSlot = -1;
+			m_tSlotChunks[oldest] = -1;
+			return oldest;
 		}
-		
-		m_pReusedTile->setPosition(positionAt(pos));
-		m_pReusedTile->setVertexZ((float)vertexZForPos(pos));
-		m_pReusedTile->setAnchorPoint(CCPointZero);
-		m_pReusedTile->setOpacity(m_cOpacity);
 
-		// optimization:
-		// The difference between appendTileForGID and insertTileforGID is that append is faster, since
-		// it appends the tile at the end of the texture atlas
-		unsigned int indexForZ = m_pAtlasIndexArray->num;
+		// more chunks are on the screen than ever before, grow the texture atlas
+		unsigned int slotCount = m_tSlotChunks.size();
+		unsigned int newSlotCount = slotCount + MAX(1u, slotCount / 2);
+		unsigned int quadsPerChunk = m_uChunkWidth * m_uChunkHeight;
 
-		// don't add it using the "standard" way.
-		addQuadFromSprite(m_pReusedTile, indexForZ);
+		CCLOG("cocos2d: CCTMXLayer: resizing TextureAtlas capacity from [%u] to [%u].",
+			slotCount * quadsPerChunk, newSlotCount * quadsPerChunk);
 
-		// append should be after addQuadFromSprite since it modifies the quantity values
-		ccCArrayInsertValueAtIndex(m_pAtlasIndexArray, (void*)z, indexForZ);
-
-		return m_pReusedTile;
+		if( ! m_pobTextureAtlas->resizeCapacity(newSlotCount * quadsPerChunk) )
+		{
+			// serious problems
+			CCLOG("cocos2d: WARNING: Not enough memory to resize the atlas");
+			CCAssert(false, "Not enough memory to resize the atlas");
+		}
+		m_tSlotChunks.resize(newSlotCount, -1);
+		return slotCount;
 	}
-
-	// CCTMXLayer - atlasIndex and Z
-	static inline int compareInts(const void * a, const void * b)
+	void CCTMXLayer::buildChunk(unsigned int chunk)
 	{
-		return ( *(int*)a - *(int*)b );
+		CCAssert( m_pTiles, "TMXLayer: the tiles map has been released");
+
+		unsigned int slot = slotForNewChunk();
+		m_tChunks[chunk].nSlot = slot;
+		m_tSlotChunks[slot] = chunk;
+
+		// empty tiles have empty quads
+		unsigned int quadsPerChunk = m_uChunkWidth * m_uChunkHeight;
+		unsigned int start = slot * quadsPerChunk;
+		memset(&m_pobTextureAtlas->getQuads()[start], 0, quadsPerChunk * sizeof(ccV3F_C4B_T2F_Quad));
+		m_pobTextureAtlas->setDirtyRange(start, start + quadsPerChunk);
+
+		unsigned int x0 = (chunk % m_uChunkColumns) * m_uChunkWidth;
+		unsigned int y0 = (chunk / m_uChunkColumns) * m_uChunkHeight;
+		unsigned int x1 = MIN(x0 + m_uChunkWidth, (unsigned int)m_tLayerSize.width);
+		unsigned int y1 = MIN(y0 + m_uChunkHeight, (unsigned int)m_tLayerSize.height);
+		for( unsigned int y=y0; y < y1; y++ )
+		{
+			for( unsigned int x=x0; x < x1; x++ )
+			{
+				unsigned int gid = m_pTiles[ (unsigned int)(x + m_tLayerSize.width * y) ];
+				if( gid != 0 )
+				{
+					this->appendTileForGID(gid, ccp((float)x, (float)y));
+				}
+			}
+		}
 	}
-	unsigned int CCTMXLayer::atlasIndexForExistantZ(unsigned int z)
+	bool CCTMXLayer::canCullTiles()
 	{
-		int key=z;
-		int *item = (int*)bsearch((void*)&key, (void*)&m_pAtlasIndexArray->arr[0], m_pAtlasIndexArray->num, sizeof(void*), compareInts);
+		// the screen maps to a rectangle of the layer only while the tiles are drawn flat:
+		// a moved camera, or a depth seen through a perspective projection, shows other tiles
+		ccDirectorProjection projection = CCDirector::sharedDirector()->getProjection();
+		if( projection == kCCDirectorProjectionCustom )
+		{
+			return false;
+		}
 
-		CCAssert( item, "TMX atlas index not found. Shall not happen");
+		bool bPerspective = projection != kCCDirectorProjection2D;
+		if( bPerspective && (m_bUseAutomaticVertexZ || m_nVertexZvalue != 0) )
+		{
+			return false;
+		}
 
-        int index = ((size_t)item - (size_t)m_pAtlasIndexArray->arr) / sizeof(void*);
-		return index;
+		for( CCNode *pNode = this; pNode; pNode = pNode->getParent() )
+		{
+			if( pNode->isCameraMoved() || (bPerspective && pNode->getVertexZ() != 0) )
+			{
+				return false;
+			}
+		}
+		return true;
 	}
-	unsigned int CCTMXLayer::atlasIndexForNewZ(int z)
+
+	void CCTMXLayer::visibleTileRange(int& x0, int& y0, int& x1, int& y1)
 	{
-		// XXX: This can be improved with a sort of binary search
-		unsigned int i=0;
-		for( i=0; i< m_pAtlasIndexArray->num ; i++) 
+		// the screen in the layer coordinates, with a margin for the tiles bigger than the map tiles
+		CCSize winSize = CCDirector::sharedDirector()->getWinSizeInPixels();
+		CCRect rect = CCRectApplyAffineTransform(CCRectMake(0, 0, winSize.width, winSize.height), worldToNodeTransform());
+
+		float margin = MAX(MAX(m_tMapTileSize.width, m_tMapTileSize.height),
+			MAX(m_pTileSet->m_tTileSize.width, m_pTileSet->m_tTileSize.height) / m_fContentScaleFactor);
+		float left = rect.origin.x / m_fContentScaleFactor - margin;
+		float bottom = rect.origin.y / m_fContentScaleFactor - margin;
+		float right = (rect.origin.x + rect.size.width) / m_fContentScaleFactor + margin;
+		float top = (rect.origin.y + rect.size.height) / m_fContentScaleFactor + margin;
+
+		// the tile coordinates of the corners, a tile (x,y) covers [x, x+1] x [y, y+1]
+		CCPoint corners[4] = { ccp(left, bottom), ccp(right, bottom), ccp(left, top), ccp(right, top) };
+		float minX = 0, minY = 0, maxX = 0, maxY = 0;
+		for( int i=0; i < 4; i++ )
 		{
-            int val = (size_t) m_pAtlasIndexArray->arr[i];
-			if( z < val )
+			float tx = 0, ty = 0;
+			switch( m_uLayerOrientation )
+			{
+			case CCTMXOrientationOrtho:
+				tx = corners[i].x / m_tMapTileSize.width;
+				ty = m_tLayerSize.height - corners[i].y / m_tMapTileSize.height;
+				break;
+			case CCTMXOrientationIso:
+				{
+					float a = corners[i].x * 2 / m_tMapTileSize.width - m_tLayerSize.width;
+					float b = m_tLayerSize.height * 2 - 1 - corners[i].y * 2 / m_tMapTileSize.height;
+					tx = (a + b + 1) / 2;
+					ty = (b - a + 1) / 2;
+				}
+				break;
+			case CCTMXOrientationHex:
+				tx = corners[i].x / (m_tMapTileSize.width * 3 / 4);
+				ty = m_tLayerSize.height - corners[i].y / m_tMapTileSize.height;
 				break;
-		}	
-		return i;
+			}
+			minX = (i == 0 || tx < minX) ? tx : minX;
+			maxX = (i == 0 || tx > maxX) ? tx : maxX;
+			minY = (i == 0 || ty < minY) ? ty : minY;
+			maxY = (i == 0 || ty > maxY) ? ty : maxY;
+		}
+
+		x0 = (int)MAX(floorf(minX), 0.0f);
+		y0 = (int)MAX(floorf(minY), 0.0f);
+		x1 = (int)MIN(floorf(maxX), m_tLayerSize.width - 1);
+		y1 = (int)MIN(floorf(maxY), m_tLayerSize.height - 1);
 	}
 
 	// CCTMXLayer - adding / remove tiles
 	void CCTMXLayer::setTileGID(unsigned int gid, const CCPoint& pos)
 	{
 		CCAssert( pos.x < m_tLayerSize.width && pos.y < m_tLayerSize.height && pos.x >=0 && pos.y >=0, "TMXLayer: invalid position");
-		CCAssert( m_pTiles && m_pAtlasIndexArray, "TMXLayer: the tiles map has been released");
+		CCAssert( m_pTiles, "TMXLayer: the tiles map has been released");
         CCAssert( gid == 0 || gid >= m_pTileSet->m_uFirstGid, "TMXLayer: invalid gid" );
 
 		unsigned int currentGID = tileGIDAt(pos);
@@ -472,57 +583,81 @@ namespace cocos2d {
 
 		CCAssert( m_pChildren->containsObject(sprite), "Tile does not belong to TMXLayer");
 
-		unsigned int atlasIndex = sprite->getAtlasIndex();
-        unsigned int zz = (size_t) m_pAtlasIndexArray->arr[atlasIndex];
-		m_pTiles[zz] = 0;
-		ccCArrayRemoveValueAtIndex(m_pAtlasIndexArray, atlasIndex);
-		CCSpriteBatchNode::removeChild(sprite, cleanup);
+		unsigned int zz = (unsigned int)sprite->getTag();
+		if( m_pTiles && m_pTiles[zz] )
+		{
+			m_pTiles[zz] = 0;
+			m_tChunks[chunkForTile(zz % (unsigned int)m_tLayerSize.width, zz / (unsigned int)m_tLayerSize.width)].uTileCount--;
+		}
+		removeTileSprite(sprite, cleanup);
+	}
+	void CCTMXLayer::removeAllChildrenWithCleanup(bool cleanup)
+	{
+		if (m_pChildren && m_pChildren->count() > 0)
+		{
+            CCObject* pObject = NULL;
+            CCARRAY_FOREACH(m_pChildren, pObject)
+            {
+                CCSprite* pChild = (CCSprite*) pObject;
+                if (pChild)
+                {
+                    unsigned int zz = (unsigned int)pChild->getTag();
+                    ccTMXLayerChunk& chunk = m_tChunks[chunkForTile(zz % (unsigned int)m_tLayerSize.width, zz / (unsigned int)m_tLayerSize.width)];
+                    if( m_pTiles && m_pTiles[zz] )
+                    {
+                        m_pTiles[zz] = 0;
+                        chunk.uTileCount--;
+                    }
+                    chunk.uSpriteCount--;
+
+                    clearQuadAtIndex(pChild->getAtlasIndex());
+                    pChild->useSelfRender();
+                }
+            }
+		}
+
+		CCNode::removeAllChildrenWithCleanup(cleanup);
+		m_pobDescendants->removeAllObjects();
+	}
+	// the quads of the chunks don't move, so CCSpriteBatchNode::removeChild can't be used
+	void CCTMXLayer::removeTileSprite(CCSprite* sprite, bool cleanup)
+	{
+		unsigned int zz = (unsigned int)sprite->getTag();
+		m_tChunks[chunkForTile(zz % (unsigned int)m_tLayerSize.width, zz / (unsigned int)m_tLayerSize.width)].uSpriteCount--;
+
+		clearQuadAtIndex(sprite->getAtlasIndex());
+		sprite->useSelfRender();
+		m_pobDescendants->removeObject(sprite);
+		CCNode::removeChild(sprite, cleanup);
 	}
 	void CCTMXLayer::removeTileAt(const CCPoint& pos)
 	{
 		CCAssert( pos.x < m_tLayerSize.width && pos.y < m_tLayerSize.height && pos.x >=0 && pos.y >=0, "TMXLayer: invalid position");
-		CCAssert( m_pTiles && m_pAtlasIndexArray, "TMXLayer: the tiles map has been released");
+		CCAssert( m_pTiles, "TMXLayer: the tiles map has been released");
 
 		unsigned int gid = tileGIDAt(pos);
 
 		if( gid ) 
 		{
+			unsigned int x = (unsigned int)pos.x;
+			unsigned int y = (unsigned int)pos.y;
 			unsigned int z = (unsigned int)(pos.x + pos.y * m_tLayerSize.width);
-			unsigned int atlasIndex = atlasIndexForExistantZ(z);
 
 			// remove tile from GID map
 			m_pTiles[z] = 0;
 
-			// remove tile from atlas position array
-			ccCArrayRemoveValueAtIndex(m_pAtlasIndexArray, atlasIndex);
+			ccTMXLayerChunk& chunk = m_tChunks[chunkForTile(x, y)];
+			chunk.uTileCount--;
 
 			// remove it from sprites and/or texture atlas
 			CCSprite *sprite = (CCSprite*)getChildByTag(z);
 			if( sprite )
 			{
-				CCSpriteBatchNode::removeChild(sprite, true);
+				removeTileSprite(sprite, true);
 			}
-			else 
+			else if( chunk.nSlot >= 0 )
 			{
-				m_pobTextureAtlas->removeQuadAtIndex(atlasIndex);
-
-				// update possible children
-				if (m_pChildren && m_pChildren->count()>0)
-				{
-                    CCObject* pObject = NULL;
-                    CCARRAY_FOREACH(m_pChildren, pObject)
-                    {
-                        CCSprite* pChild = (CCSprite*) pObject;
-                        if (pChild)
-                        {
-                            unsigned int ai = pChild->getAtlasIndex();
-                            if ( ai >= atlasIndex )
-                            {
-                                pChild->setAtlasIndex(ai-1);
-                            }
-                        }
-                    }
-				}
+				clearQuadAtIndex(atlasIndexForTile(x, y));
 			}
 		}
 	}
@@ -620,13 +755,119 @@ namespace cocos2d {
 	// CCTMXLayer - draw
 	void CCTMXLayer::draw()
 	{
+		CCNode::draw();
+
+		m_uFrame++;
+		m_tDrawnChunks.clear();
+
+		// the chunks on the screen, created if they are new
+		int x0 = 0, y0 = 0, x1 = (int)m_tLayerSize.width - 1, y1 = (int)m_tLayerSize.height - 1;
+		if( canCullTiles() )
+		{
+			visibleTileRange(x0, y0, x1, y1);
+		}
+		if( x0 <= x1 && y0 <= y1 )
+		{
+			unsigned int firstChunk = chunkForTile(x0, y0);
+			unsigned int lastChunk = chunkForTile(x1, y1);
+			unsigned int firstColumn = firstChunk % m_uChunkColumns;
+			unsigned int lastColumn = lastChunk % m_uChunkColumns;
+
+			for( unsigned int row = firstChunk / m_uChunkColumns; row <= lastChunk / m_uChunkColumns; row++ )
+			{
+				for( unsigned int column = firstColumn; column <= lastColumn; column++ )
+				{
+					unsigned int i = row * m_uChunkColumns + column;
+					ccTMXLayerChunk& chunk = m_tChunks[i];
+					if( chunk.uTileCount == 0 && chunk.uSpriteCount == 0 )
+					{
+						continue;
+					}
+
+					chunk.uLastDrawnFrame = m_uFrame;
+					if( chunk.nSlot < 0 )
+					{
+						if( ! m_pTiles )
+						{
+							continue;
+						}
+						buildChunk(i);
+					}
+					m_tDrawnChunks.push_back(i);
+				}
+			}
+		}
+
+		// the sprites can be moved anywhere, their chunks are always drawn
+		bool bSort = false;
+		if (m_pobDescendants && m_pobDescendants->count() > 0)
+		{
+			CCObject* pObject = NULL;
+			CCARRAY_FOREACH(m_pobDescendants, pObject)
+			{
+				CCSprite* pChild = (CCSprite*) pObject;
+				if (pChild)
+				{
+					// fast dispatch
+					pChild->updateTransform();
+
+					unsigned int z = (unsigned int)pChild->getTag();
+					unsigned int i = chunkForTile(z % (unsigned int)m_tLayerSize.width, z / (unsigned int)m_tLayerSize.width);
+					if( m_tChunks[i].uLastDrawnFrame != m_uFrame )
+					{
+						m_tChunks[i].uLastDrawnFrame = m_uFrame;
+						m_tDrawnChunks.push_back(i);
+						bSort = true;
+					}
+				}
+			}
+		}
+		if( bSort )
+		{
+			std::sort(m_tDrawnChunks.begin(), m_tDrawnChunks.end());
+		}
+
+		if( m_tDrawnChunks.empty() )
+		{
+			return;
+		}
+
 		if( m_bUseAutomaticVertexZ )
 		{
 			//glEnable(GL_ALPHA_TEST);
 			//glAlphaFunc(GL_GREATER, m_fAlphaFuncValue);
 		}
 
-		CCSpriteBatchNode::draw();
+		bool newBlend = m_blendFunc.src != CC_BLEND_SRC || m_blendFunc.dst != CC_BLEND_DST;
+		if (newBlend)
+		{
+			CCD3DCLASS->D3DBlendFunc(m_blendFunc.src, m_blendFunc.dst);
+		}
+
+		// in the order of the chunks, with one draw call for the chunks in consecutive slots
+		unsigned int quadsPerChunk = m_uChunkWidth * m_uChunkHeight;
+		unsigned int start = m_tChunks[m_tDrawnChunks[0]].nSlot * quadsPerChunk;
+		unsigned int count = quadsPerChunk;
+		for( unsigned int i=1; i < m_tDrawnChunks.size(); i++ )
+		{
+			unsigned int chunkStart = m_tChunks[m_tDrawnChunks[i]].nSlot * quadsPerChunk;
+			if( chunkStart == start + count )
+			{
+				count += quadsPerChunk;
+			}
+			else
+			{
+				m_pobTextureAtlas->drawNumberOfQuads(count, start);
+				start = chunkStart;
+				count = quadsPerChunk;
+			}
+		}
+		m_pobTextureAtlas->drawNumberOfQuads(count, start);
+
+		if (newBlend)
+		{
+			CCD3DCLASS->D3DBlendFunc(CC_BLEND_SRC, CC_BLEND_DST);
+		}
 
 		if( m_bUseAutomaticVertexZ )
 		{
@@ -25,14 +25,13 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 
-#include <map>
+#include <string.h>
+#include <zlib.h>
 #include "CCTMXXMLParser.h"
 #include "CCTMXTiledMap.h"
 #include "ccMacros.h"
 #include "CCFileUtils.h"
-#include "support/zip_support/ZipUtils.h"
 #include "CCPointExtension.h"
-#include "support/base64.h"
 #include "platform/platform.h"
 
 using namespace std;
@@ -56,15 +55,171 @@ namespace cocos2d {
 	void tmx_characters(void *ctx, const xmlChar *ch, int len);
 	*/
 	
-	static const char* valueForKey(const char *key, std::map<std::string, std::string>* dict)
+	// looks an attribute up in the name/value pairs given by the SAX parser, without copying them
+	static const char* valueForKey(const char *key, const char **atts)
 	{
-		if (dict)
+		if (atts)
 		{
-			std::map<std::string, std::string>::iterator it = dict->find(key);
-			return it!=dict->end() ? it->second.c_str() : "";
+			for (int i = 0; atts[i]; i += 2)
+			{
+				if (strcmp(atts[i], key) == 0)
+				{
+					return atts[i+1] ? atts[i+1] : "";
+				}
+			}
 		}
 		return "";
 	}
+
+	// Decodes the base64 text of a <data> element while the parser delivers it, and inflates
+	// it when it is compressed, straight into the tiles of the layer.
+	class CCTMXTileDataDecoder
+	{
+	public:
+		CCTMXTileDataDecoder(unsigned char *pTiles, unsigned int uSize, bool bCompressed)
+			: m_pTiles(pTiles)
+			, m_uSize(uSize)
+			, m_uWritten(0)
+			, m_uBits(0)
+			, m_nCharCount(0)
+			, m_bPadded(false)
+			, m_bCompressed(bCompressed)
+			, m_bFailed(false)
+			, m_bStreamEnded(false)
+			, m_uChunkLength(0)
+		{
+			memset(&m_tStream, 0, sizeof(m_tStream));
+			if (m_bCompressed)
+			{
+				// 15 + 32 reads both zlib and gzip headers, like ZipUtils::ccInflateMemory
+				m_bFailed = (inflateInit2(&m_tStream, 15 + 32) != Z_OK);
+				m_tStream.next_out = m_pTiles;
+				m_tStream.avail_out = m_uSize;
+			}
+		}
+
+		~CCTMXTileDataDecoder()
+		{
+			if (m_bCompressed)
+			{
+				inflateEnd(&m_tStream);
+			}
+		}
+
+		void decode(const char *ch, int len)
+		{
+			for (int i = 0; i < len && ! m_bFailed && ! m_bPadded; ++i)
+			{
+				unsigned char c = (unsigned char)ch[i];
+				int value;
+				if (c >= 'A' && c <= 'Z')		value = c - 'A';
+				else if (c >= 'a' && c <= 'z')	value = c - 'a' + 26;
+				else if (c >= '0' && c <= '9')	value = c - '0' + 52;
+				else if (c == '+')				value = 62;
+				else if (c == '/')				value = 63;
+				else if (c == '=')
+				{
+					// like base64Decode, the text ends at the padding
+					m_bPadded = true;
+					break;
+				}
+				else
+				{
+					// white space between the lines
+					continue;
+				}
+
+				m_uBits = (m_uBits << 6) | value;
+				if (++m_nCharCount == 4)
+				{
+					unsigned char bytes[3] = { (unsigned char)(m_uBits >> 16), (unsigned char)(m_uBits >> 8), (unsigned char)m_uBits };
+					output(bytes, 3);
+					m_uBits = 0;
+					m_nCharCount = 0;
+				}
+			}
+		}
+
+		// true when the text decoded to exactly the tiles of the layer
+		bool finish()
+		{
+			if (m_nCharCount == 1)
+			{
+				m_bFailed = true;
+			}
+			else if (m_nCharCount > 1)
+			{
+				// the last quantum, 2 or 3 characters before the padding
+				m_uBits <<= 6 * (4 - m_nCharCount);
+				unsigned char bytes[2] = { (unsigned char)(m_uBits >> 16), (unsigned char)(m_uBits >> 8) };
+				output(bytes, m_nCharCount - 1);
+			}
+
+			if (m_bCompressed)
+			{
+				inflateChunk();
+				return ! m_bFailed && m_bStreamEnded && m_tStream.total_out == m_uSize;
+			}
+			return ! m_bFailed && m_uWritten == m_uSize;
+		}
+
+	private:
+		void output(const unsigned char *pBytes, unsigned int uLength)
+		{
+			if (m_bCompressed)
+			{
+				if (m_uChunkLength + uLength > sizeof(m_pChunk))
+				{
+					inflateChunk();
+				}
+				memcpy(m_pChunk + m_uChunkLength, pBytes, uLength);
+				m_uChunkLength += uLength;
+			}
+			else if (m_uWritten + uLength <= m_uSize)
+			{
+				memcpy(m_pTiles + m_uWritten, pBytes, uLength);
+				m_uWritten += uLength;
+			}
+			else
+			{
+				m_bFailed = true;
+			}
+		}
+
+		void inflateChunk()
+		{
+			if (m_uChunkLength && ! m_bFailed && ! m_bStreamEnded)
+			{
+				m_tStream.next_in = m_pChunk;
+				m_tStream.avail_in = m_uChunkLength;
+				int err = inflate(&m_tStream, Z_NO_FLUSH);
+				if (err == Z_STREAM_END)
+				{
+					m_bStreamEnded = true;
+				}
+				else if (err != Z_OK || m_tStream.avail_in != 0)
+				{
+					// a damaged stream, or more tiles than the layer has
+					m_bFailed = true;
+				}
+			}
+			m_uChunkLength = 0;
+		}
+
+		unsigned char	*m_pTiles;
+		unsigned int	m_uSize;
+		unsigned int	m_uWritten;
+		unsigned int	m_uBits;
+		int				m_nCharCount;
+		bool			m_bPadded;
+		bool			m_bCompressed;
+		bool			m_bFailed;
+		bool			m_bStreamEnded;
+		z_stream		m_tStream;
+		unsigned char	m_pChunk[4096];
+		unsigned int	m_uChunkLength;
+	};
+
 	// implementation CCTMXLayerInfo
 	CCTMXLayerInfo::CCTMXLayerInfo()
         : m_sName("")
@@ -162,11 +317,13 @@ namespace cocos2d {
         ,m_bStoringCharacters(false)		
 		,m_pProperties(NULL)
 		,m_pTileProperties(NULL)
+		,m_pTileDataDecoder(NULL)
 	{
 	}
 	CCTMXMapInfo::~CCTMXMapInfo()
 	{
 		CCLOGINFO("cocos2d: deallocing.");
+		CC_SAFE_DELETE(m_pTileDataDecoder);
 		CC_SAFE_RELEASE(m_pTilesets);
 		CC_SAFE_RELEASE(m_pLayers);
 		CC_SAFE_RELEASE(m_pProperties);
@@ -244,50 +401,39 @@ namespace cocos2d {
 	{	
         CC_UNUSED_PARAM(ctx);
 		CCTMXMapInfo *pTMXMapInfo = this;
-		std::string elementName = (char*)name;
-		std::map<std::string, std::string> *attributeDict = new std::map<std::string, std::string>();
-		if(atts && atts[0])
-		{
-			for(int i = 0; atts[i]; i += 2) 
-			{
-				std::string key = (char*)atts[i];
-				std::string value = (char*)atts[i+1];
-				attributeDict->insert(pair<std::string, std::string>(key, value));
-			}
-		}
-		if(elementName == "map")
+		if(strcmp(name, "map") == 0)
 		{
-			std::string version = valueForKey("version", attributeDict);
-			if ( version != "1.0")
+			const char *version = valueForKey("version", atts);
+			if ( strcmp(version, "1.0") != 0)
 			{
-				CCLOG("cocos2d: TMXFormat: Unsupported TMX version: %@", version.c_str());
+				CCLOG("cocos2d: TMXFormat: Unsupported TMX version: %s", version);
 			}
-			std::string orientationStr = valueForKey("orientation", attributeDict);
-			if( orientationStr == "orthogonal")
+			const char *orientationStr = valueForKey("orientation", atts);
+			if( strcmp(orientationStr, "orthogonal") == 0)
 				pTMXMapInfo->setOrientation(CCTMXOrientationOrtho);
-			else if ( orientationStr  == "isometric")
+			else if ( strcmp(orientationStr, "isometric") == 0)
 				pTMXMapInfo->setOrientation(CCTMXOrientationIso);
-			else if( orientationStr == "hexagonal")
+			else if( strcmp(orientationStr, "hexagonal") == 0)
 				pTMXMapInfo->setOrientation(CCTMXOrientationHex);
 			else
 				CCLOG("cocos2d: TMXFomat: Unsupported orientation: %d", pTMXMapInfo->getOrientation());
 
 			CCSize s;
-			s.width = (float)atof(valueForKey("width", attributeDict));
-			s.height = (float)atof(valueForKey("height", attributeDict));
+			s.width = (float)atof(valueForKey("width", atts));
+			s.height = (float)atof(valueForKey("height", atts));
 			pTMXMapInfo->setMapSize(s);
 
-			s.width = (float)atof(valueForKey("tilewidth", attributeDict));
-			s.height = (float)atof(valueForKey("tileheight", attributeDict));
+			s.width = (float)atof(valueForKey("tilewidth", atts));
+			s.height = (float)atof(valueForKey("tileheight", atts));
 			pTMXMapInfo->setTileSize(s);
 
 			// The parent element is now "map"
 			pTMXMapInfo->setParentElement(TMXPropertyMap);
 		} 
-		else if(elementName == "tileset") 
+		else if(strcmp(name, "tileset") == 0) 
 		{
 			// If this is an external tileset then start parsing that
-			std::string externalTilesetFilename = valueForKey("source", attributeDict);
+			std::string externalTilesetFilename = valueForKey("source", atts);
 			if (externalTilesetFilename != "")
 			{
 				externalTilesetFilename = CCFileUtils::fullPathFromRelativeFile(externalTilesetFilename.c_str(), pTMXMapInfo->getTMXFileName());
@@ -296,55 +442,55 @@ namespace cocos2d {
 			else
 			{
 				CCTMXTilesetInfo *tileset = new CCTMXTilesetInfo();
-				tileset->m_sName = valueForKey("name", attributeDict);
-				tileset->m_uFirstGid = (unsigned int)atoi(valueForKey("firstgid", attributeDict));
-				tileset->m_uSpacing = (unsigned int)atoi(valueForKey("spacing", attributeDict));
-				tileset->m_uMargin = (unsigned int)atoi(valueForKey("margin", attributeDict));
+				tileset->m_sName = valueForKey("name", atts);
+				tileset->m_uFirstGid = (unsigned int)atoi(valueForKey("firstgid", atts));
+				tileset->m_uSpacing = (unsigned int)atoi(valueForKey("spacing", atts));
+				tileset->m_uMargin = (unsigned int)atoi(valueForKey("margin", atts));
 				CCSize s;
-				s.width = (float)atof(valueForKey("tilewidth", attributeDict));
-				s.height = (float)atof(valueForKey("tileheight", attributeDict));
+				s.width = (float)atof(valueForKey("tilewidth", atts));
+				s.height = (float)atof(valueForKey("tileheight", atts));
 				tileset->m_tTileSize = s;
 
 				pTMXMapInfo->getTilesets()->addObject(tileset);
 				tileset->release();
 			}
 		}
-		else if(elementName == "tile")
+		else if(strcmp(name, "tile") == 0)
 		{
 			CCTMXTilesetInfo* info = pTMXMapInfo->getTilesets()->getLastObject();
 			CCStringToStringDictionary *dict = new CCStringToStringDictionary();
-			pTMXMapInfo->setParentGID(info->m_uFirstGid + atoi(valueForKey("id", attributeDict)));
+			pTMXMapInfo->setParentGID(info->m_uFirstGid + atoi(valueForKey("id", atts)));
 			pTMXMapInfo->getTileProperties()->setObject(dict, pTMXMapInfo->getParentGID());
 			CC_SAFE_RELEASE(dict);
 			
 			pTMXMapInfo->setParentElement(TMXPropertyTile);
 
 		}
-		else if(elementName == "layer")
+		else if(strcmp(name, "layer") == 0)
 		{
 			CCTMXLayerInfo *layer = new CCTMXLayerInfo();
-			layer->m_sName = valueForKey("name", attributeDict);
+			layer->m_sName = valueForKey("name", atts);
 
 			CCSize s;
-			s.width = (float)atof(valueForKey("width", attributeDict));
-			s.height = (float)atof(valueForKey("height", attributeDict));
+			s.width = (float)atof(valueForKey("width", atts));
+			s.height = (float)atof(valueForKey("height", atts));
 			layer->m_tLayerSize = s;
 
-			std::string visible = valueForKey("visible", attributeDict);
-			layer->m_bVisible = !(visible == "0");
+			const char *visible = valueForKey("visible", atts);
+			layer->m_bVisible = strcmp(visible, "0") != 0;
 
-			std::string opacity = valueForKey("opacity", attributeDict);
-			if( opacity != "" )
+			const char *opacity = valueForKey("opacity", atts);
+			if( opacity[0] )
 			{
-				layer->m_cOpacity = (unsigned char)(255 * atof(opacity.c_str()));
+				layer->m_cOpacity = (unsigned char)(255 * atof(opacity));
 			}
 			else
 			{
 				layer->m_cOpacity = 255;
 			}
 
-			float x = (float)atof(valueForKey("x", attributeDict));
-			float y = (float)atof(valueForKey("y", attributeDict));
+			float x = (float)atof(valueForKey("x", atts));
+			float y = (float)atof(valueForKey("y", atts));
 			layer->m_tOffset = ccp(x,y);
 
 			pTMXMapInfo->getLayers()->addObject(layer);
@@ -354,13 +500,13 @@ namespace cocos2d {
 			pTMXMapInfo->setParentElement(TMXPropertyLayer);
 
 		} 
-		else if(elementName == "objectgroup")
+		else if(strcmp(name, "objectgroup") == 0)
 		{
 			CCTMXObjectGroup *objectGroup = new CCTMXObjectGroup();
-			objectGroup->setGroupName(valueForKey("name", attributeDict));
+			objectGroup->setGroupName(valueForKey("name", atts));
 			CCPoint positionOffset;
-			positionOffset.x = (float)atof(valueForKey("x", attributeDict)) * pTMXMapInfo->getTileSize().width;
-			positionOffset.y = (float)atof(valueForKey("y", attributeDict)) * pTMXMapInfo->getTileSize().height;
+			positionOffset.x = (float)atof(valueForKey("x", atts)) * pTMXMapInfo->getTileSize().width;
+			positionOffset.y = (float)atof(valueForKey("y", atts)) * pTMXMapInfo->getTileSize().height;
 			objectGroup->setPositionOffset(positionOffset);
 
 			pTMXMapInfo->getObjectGroups()->addObject(objectGroup);
@@ -370,42 +516,56 @@ namespace cocos2d {
 			pTMXMapInfo->setParentElement(TMXPropertyObjectGroup);
 
 		}
-		else if(elementName == "image")
+		else if(strcmp(name, "image") == 0)
 		{
 			CCTMXTilesetInfo *tileset = pTMXMapInfo->getTilesets()->getLastObject();
 
 			// build full path
-			std::string imagename = valueForKey("source", attributeDict);		
+			std::string imagename = valueForKey("source", atts);		
 			tileset->m_sSourceImage = CCFileUtils::fullPathFromRelativeFile(imagename.c_str(), pTMXMapInfo->getTMXFileName());
 
 		} 
-		else if(elementName == "data")
+		else if(strcmp(name, "data") == 0)
 		{
-			std::string encoding = valueForKey("encoding", attributeDict);
-			std::string compression = valueForKey("compression", attributeDict);
+			const char *encoding = valueForKey("encoding", atts);
+			const char *compression = valueForKey("compression", atts);
 
-			if( encoding == "base64" )
+			if( strcmp(encoding, "base64") == 0 )
 			{
 				int layerAttribs = pTMXMapInfo->getLayerAttribs();
 				pTMXMapInfo->setLayerAttribs(layerAttribs | TMXLayerAttribBase64);
 				pTMXMapInfo->setStoringCharacters(true);
 
-				if( compression == "gzip" )
+				if( strcmp(compression, "gzip") == 0 )
 				{
 					layerAttribs = pTMXMapInfo->getLayerAttribs();
 					pTMXMapInfo->setLayerAttribs(layerAttribs | TMXLayerAttribGzip);
 				} else
-				if (compression == "zlib")
+				if (strcmp(compression, "zlib") == 0)
 				{
 					layerAttribs = pTMXMapInfo->getLayerAttribs();
 					pTMXMapInfo->setLayerAttribs(layerAttribs | TMXLayerAttribZlib);
 				}
-				CCAssert( compression == "" || compression == "gzip" || compression == "zlib", "TMX: unsupported compression method" );
+				CCAssert( compression[0] == 0 || strcmp(compression, "gzip") == 0 || strcmp(compression, "zlib") == 0, "TMX: unsupported compression method" );
+
+				// the tiles are decoded into their final array while the text arrives
+				CCTMXLayerInfo *layer = pTMXMapInfo->getLayers()->getLastObject();
+				unsigned int tileCount = (unsigned int)(layer->m_tLayerSize.width * layer->m_tLayerSize.height);
+				if( layer->m_bOwnTiles )
+				{
+					CC_SAFE_DELETE_ARRAY(layer->m_pTiles);
+				}
+				layer->m_pTiles = new unsigned int[tileCount];
+				layer->m_bOwnTiles = true;
+
+				CC_SAFE_DELETE(m_pTileDataDecoder);
+				m_pTileDataDecoder = new CCTMXTileDataDecoder((unsigned char*)layer->m_pTiles, tileCount * sizeof(unsigned int),
+					compression[0] != 0);
 			}
 			CCAssert( pTMXMapInfo->getLayerAttribs() != TMXLayerAttribNone, "TMX tile map: Only base64 and/or gzip/zlib maps are supported" );
 
 		} 
-		else if(elementName == "object")
+		else if(strcmp(name, "object") == 0)
 		{
 			char buffer[32];
 			CCTMXObjectGroup *objectGroup = pTMXMapInfo->getObjectGroups()->getLastObject();
@@ -416,26 +576,26 @@ namespace cocos2d {
 
 			// Set the name of the object to the value for "name"
 			std::string key = "name";
-			CCString *value = new CCString(valueForKey("name", attributeDict));
+			CCString *value = new CCString(valueForKey("name", atts));
 			dict->setObject(value, key);
 			value->release();
 
 			// Assign all the attributes as key/name pairs in the properties dictionary
 			key = "type";
-			value = new CCString(valueForKey("type", attributeDict));
+			value = new CCString(valueForKey("type", atts));
 			dict->setObject(value, key);
 			value->release();
 
-			int x = atoi(valueForKey("x", attributeDict)) + (int)objectGroup->getPositionOffset().x;
+			int x = atoi(valueForKey("x", atts)) + (int)objectGroup->getPositionOffset().x;
 			key = "x";
 			sprintf(buffer, "%d", x);
 			value = new CCString(buffer);
 			dict->setObject(value, key);
 			value->release();
 
-			int y = atoi(valueForKey("y", attributeDict)) + (int)objectGroup->getPositionOffset().y;
+			int y = atoi(valueForKey("y", atts)) + (int)objectGroup->getPositionOffset().y;
 			// Correct y position. (Tiled uses Flipped, cocos2d uses Standard)
-			y = (int)(pTMXMapInfo->getMapSize().height * pTMXMapInfo->getTileSize().height) - y - atoi(valueForKey("height", attributeDict));
+			y = (int)(pTMXMapInfo->getMapSize().height * pTMXMapInfo->getTileSize().height) - y - atoi(valueForKey("height", atts));
 			key = "y";
 			sprintf(buffer, "%d", y);
 			value = new CCString(buffer);
@@ -443,12 +603,12 @@ namespace cocos2d {
 			value->release();
 
 			key = "width";
-			value = new CCString(valueForKey("width", attributeDict));
+			value = new CCString(valueForKey("width", atts));
 			dict->setObject(value, key);
 			value->release();
 
 			key = "height";
-			value = new CCString(valueForKey("height", attributeDict));
+			value = new CCString(valueForKey("height", atts));
 			dict->setObject(value, key);
 			value->release();
 
@@ -460,18 +620,18 @@ namespace cocos2d {
 			pTMXMapInfo->setParentElement(TMXPropertyObject);
 
 		} 
-		else if(elementName == "property")
+		else if(strcmp(name, "property") == 0)
 		{
 			if ( pTMXMapInfo->getParentElement() == TMXPropertyNone ) 
 			{
 				CCLOG( "TMX tile map: Parent element is unsupported. Cannot add property named '%s' with value '%s'",
-					valueForKey("name", attributeDict), valueForKey("value",attributeDict) );
+					valueForKey("name", atts), valueForKey("value",atts) );
 			} 
 			else if ( pTMXMapInfo->getParentElement() == TMXPropertyMap )
 			{
 				// The parent element is the map
-				CCString *value = new CCString(valueForKey("value", attributeDict));
-				std::string key = valueForKey("name", attributeDict);
+				CCString *value = new CCString(valueForKey("value", atts));
+				std::string key = valueForKey("name", atts);
 				pTMXMapInfo->getProperties()->setObject(value, key);
 				value->release();
 
@@ -480,8 +640,8 @@ namespace cocos2d {
 			{
 				// The parent element is the last layer
 				CCTMXLayerInfo *layer = pTMXMapInfo->getLayers()->getLastObject();
-				CCString *value = new CCString(valueForKey("value", attributeDict));
-				std::string key = valueForKey("name", attributeDict);
+				CCString *value = new CCString(valueForKey("value", atts));
+				std::string key = valueForKey("name", atts);
 				// Add the property to the layer
 				layer->getProperties()->setObject(value, key);
 				value->release();
@@ -491,8 +651,8 @@ namespace cocos2d {
 			{
 				// The parent element is the last object group
 				CCTMXObjectGroup *objectGroup = pTMXMapInfo->getObjectGroups()->getLastObject();
-				CCString *value = new CCString(valueForKey("value", attributeDict));
-				std::string key = valueForKey("name", attributeDict);
+				CCString *value = new CCString(valueForKey("value", atts));
+				std::string key = valueForKey("name", atts);
 				objectGroup->getProperties()->setObject(value, key);
 				value->release();
 
@@ -503,8 +663,8 @@ namespace cocos2d {
 				CCTMXObjectGroup *objectGroup = pTMXMapInfo->getObjectGroups()->getLastObject();
 				CCStringToStringDictionary *dict = objectGroup->getObjects()->getLastObject();
 
-				std::string propertyName = valueForKey("name", attributeDict);
-				CCString *propertyValue = new CCString(valueForKey("value", attributeDict));
+				std::string propertyName = valueForKey("name", atts);
+				CCString *propertyValue = new CCString(valueForKey("value", atts));
 				dict->setObject(propertyValue, propertyName);
 				propertyValue->release();
 			} 
@@ -513,89 +673,50 @@ namespace cocos2d {
 				CCStringToStringDictionary *dict;
 				dict = pTMXMapInfo->getTileProperties()->objectForKey(pTMXMapInfo->getParentGID());
 
-				std::string propertyName = valueForKey("name", attributeDict);
-				CCString *propertyValue = new CCString(valueForKey("value", attributeDict));
+				std::string propertyName = valueForKey("name", atts);
+				CCString *propertyValue = new CCString(valueForKey("value", atts));
 				dict->setObject(propertyValue, propertyName);
 				propertyValue->release();
 			}
 		}
-		if (attributeDict)
-		{
-			attributeDict->clear();
-			delete attributeDict;
-		}
 	}
 
 	void CCTMXMapInfo::endElement(void *ctx, const char *name)
 	{
         CC_UNUSED_PARAM(ctx);
 		CCTMXMapInfo *pTMXMapInfo = this;
-		std::string elementName = (char*)name;
-
-		int len = 0;
 
-		if(elementName == "data" && pTMXMapInfo->getLayerAttribs()&TMXLayerAttribBase64) 
+		if(strcmp(name, "data") == 0 && pTMXMapInfo->getLayerAttribs()&TMXLayerAttribBase64) 
 		{
 			pTMXMapInfo->setStoringCharacters(false);
 
 			CCTMXLayerInfo *layer = pTMXMapInfo->getLayers()->getLastObject();
 
-			std::string currentString = pTMXMapInfo->getCurrentString();
-			unsigned char *buffer;
-			len = base64Decode((unsigned char*)currentString.c_str(), (unsigned int)currentString.length(), &buffer);
-			if( ! buffer ) 
+			bool decoded = m_pTileDataDecoder && m_pTileDataDecoder->finish();
+			CC_SAFE_DELETE(m_pTileDataDecoder);
+			if( ! decoded )
 			{
 				CCLOG("cocos2d: TiledMap: decode data error");
+				CC_SAFE_DELETE_ARRAY(layer->m_pTiles);
 				return;
 			}
-
-			if( pTMXMapInfo->getLayerAttribs() & (TMXLayerAttribGzip | TMXLayerAttribZlib) )
-			{
-				unsigned char *deflated;
-				CCSize s = layer->m_tLayerSize;
-				// int sizeHint = s.width * s.height * sizeof(uint32_t);
-				int sizeHint = (int)(s.width * s.height * sizeof(unsigned int));
-
-				int inflatedLen = ZipUtils::ccInflateMemoryWithHint(buffer, len, &deflated, sizeHint);
-				CCAssert(inflatedLen == sizeHint, "");
-
-                inflatedLen = (size_t)&inflatedLen; // XXX: to avoid warings in compiler
-				
-				delete [] buffer;
-				buffer = NULL;
-
-				if( ! deflated ) 
-				{
-					CCLOG("cocos2d: TiledMap: inflate data error");
-					return;
-				}
-
-				layer->m_pTiles = (unsigned int*) deflated;
-			}
-			else
-			{
-				layer->m_pTiles = (unsigned int*) buffer;
-			}
-
-			pTMXMapInfo->setCurrentString("");
-
 		} 
-		else if (elementName == "map")
+		else if (strcmp(name, "map") == 0)
 		{
 			// The map element has ended
 			pTMXMapInfo->setParentElement(TMXPropertyNone);
 		}	
-		else if (elementName == "layer")
+		else if (strcmp(name, "layer") == 0)
 		{
 			// The layer element has ended
 			pTMXMapInfo->setParentElement(TMXPropertyNone);
 		}
-		else if (elementName == "objectgroup")
+		else if (strcmp(name, "objectgroup") == 0)
 		{
 			// The objectgroup element has ended
 			pTMXMapInfo->setParentElement(TMXPropertyNone);
 		} 
-		else if (elementName == "object") 
+		else if (strcmp(name, "object") == 0) 
 		{
 			// The object element has ended
 			pTMXMapInfo->setParentElement(TMXPropertyNone);
@@ -606,13 +727,17 @@ namespace cocos2d {
 	{
         CC_UNUSED_PARAM(ctx);
 		CCTMXMapInfo *pTMXMapInfo = this;
-		std::string pText((char*)ch,0,len);
 
 		if (pTMXMapInfo->getStoringCharacters())
 		{
-			std::string currentString = pTMXMapInfo->getCurrentString();
-			currentString += pText;
-			pTMXMapInfo->setCurrentString(currentString.c_str());
+			if (m_pTileDataDecoder)
+			{
+				m_pTileDataDecoder->decode(ch, len);
+			}
+			else
+			{
+				m_sCurrentString.append(ch, len);
+			}
 		}
 	}
 
@@ -0,0 +1,141 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "HeadlessTest.h"
+#include "CCBMFontConfiguration.h"
+#include "CCAutoreleasePool.h"
+#include <string.h>
+
+using namespace cocos2d;
+
+// the same font saved by the AngelCode editor as a text and as a binary .fnt file
+static const char *s_pszTextFile = "../Resource/fonts/bitmapFontTest2.fnt";
+static const char *s_pszBinaryFile = "../Resource/fonts/bitmapFontTest2-binary.fnt";
+
+static bool sameCharacter(const ccBMFontDef *a, const ccBMFontDef *b)
+{
+	if (! a || ! b)
+	{
+		return a == b;
+	}
+	return a->charID == b->charID
+		&& CCRect::CCRectEqualToRect(a->rect, b->rect)
+		&& a->xOffset == b->xOffset
+		&& a->yOffset == b->yOffset
+		&& a->xAdvance == b->xAdvance;
+}
+
+static void testTextFile()
+{
+	CCBMFontConfiguration *pConfiguration = CCBMFontConfiguration::configurationWithFNTFile(s_pszTextFile);
+	CHECK(pConfiguration != NULL);
+	if (! pConfiguration)
+	{
+		return;
+	}
+	CHECK(pConfiguration->retainCount() == 1);
+
+	CHECK(pConfiguration->m_uCommonHeight == 104);
+	CHECK(pConfiguration->m_sAtlasName == "../Resource/fonts/bitmapFontTest2.png");
+	// 95 char lines, "chars count=94" is only a hint
+	CHECK(pConfiguration->getCharacterCount() == 95);
+	CHECK(pConfiguration->characterDefinition('A') != NULL);
+	CHECK(pConfiguration->characterDefinition(0x4f60) == NULL);
+	CHECK(pConfiguration->characterDefinition(kCCBMFontMaxChars) == NULL);
+
+	// the kernings are sorted for the binary search
+	bool bSorted = true;
+	for (size_t i = 1; i < pConfiguration->m_tKernings.size(); ++i)
+	{
+		bSorted = bSorted && pConfiguration->m_tKernings[i - 1].key <= pConfiguration->m_tKernings[i].key;
+	}
+	CHECK(bSorted);
+	CHECK(pConfiguration->m_tKernings.size() == 88);
+	CHECK(pConfiguration->kerningAmountForPair('A', 0x4f60) == 0);
+
+	CCPoolManager::getInstance()->pop();
+}
+
+static void testBinaryFileMatchesTextFile()
+{
+	CCBMFontConfiguration *pText = CCBMFontConfiguration::configurationWithFNTFile(s_pszTextFile);
+	CCBMFontConfiguration *pBinary = CCBMFontConfiguration::configurationWithFNTFile(s_pszBinaryFile);
+	CHECK(pText != NULL && pBinary != NULL);
+	if (! pText || ! pBinary)
+	{
+		CCPoolManager::getInstance()->pop();
+		return;
+	}
+
+	CHECK(pBinary->m_uCommonHeight == pText->m_uCommonHeight);
+	CHECK(memcmp(&pBinary->m_tPadding, &pText->m_tPadding, sizeof(ccBMFontPadding)) == 0);
+	CHECK(pBinary->m_sAtlasName == pText->m_sAtlasName);
+	CHECK(pBinary->getCharacterCount() == pText->getCharacterCount());
+
+	unsigned int uDifferentCharacters = 0;
+	for (unsigned int c = 0; c < kCCBMFontMaxChars; ++c)
+	{
+		if (! sameCharacter(pBinary->characterDefinition(c), pText->characterDefinition(c)))
+		{
+			++uDifferentCharacters;
+		}
+	}
+	CHECK(uDifferentCharacters == 0);
+
+	bool bSameKernings = pBinary->m_tKernings.size() == pText->m_tKernings.size();
+	for (size_t i = 0; bSameKernings && i < pText->m_tKernings.size(); ++i)
+	{
+		bSameKernings = pBinary->m_tKernings[i].key == pText->m_tKernings[i].key
+			&& pBinary->m_tKernings[i].amount == pText->m_tKernings[i].amount;
+	}
+	CHECK(bSameKernings);
+
+	unsigned int uDifferentPairs = 0;
+	unsigned int uPairs = 0;
+	for (unsigned int first = ' '; first < 0x7f; ++first)
+	{
+		for (unsigned int second = ' '; second < 0x7f; ++second)
+		{
+			int nAmount = pText->kerningAmountForPair(first, second);
+			if (nAmount != 0)
+			{
+				++uPairs;
+			}
+			if (pBinary->kerningAmountForPair(first, second) != nAmount)
+			{
+				++uDifferentPairs;
+			}
+		}
+	}
+	CHECK(uPairs > 0);
+	CHECK(uDifferentPairs == 0);
+
+	CCPoolManager::getInstance()->pop();
+}
+
+int main()
+{
+	testTextFile();
+	testBinaryFileMatchesTextFile();
+	return checkResults("BMFontConfigurationTest");
+}
@@ -0,0 +1,161 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "HeadlessTest.h"
+#include <Box2D/Common/b2BlockAllocator.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+struct Allocation
+{
+	void* p;
+	int32 size;
+};
+
+// sizes of every block size class, and larger than b2_maxBlockSize
+static int32 allocationSize(int32 i)
+{
+	static const int32 sizes[] = { 8, 16, 24, 40, 64, 100, 128, 200, 256, 400, 512, 640, 1000 };
+	return sizes[i % (sizeof(sizes) / sizeof(sizes[0]))];
+}
+
+static void testFreeConcurrent(void)
+{
+	b2BlockAllocator allocator;
+	b2BlockAllocatorStats stats;
+
+	// the memory counts as live until the next Allocate takes it back
+	void* p = allocator.Allocate(64);
+	allocator.FreeConcurrent(p, 64);
+	allocator.GetStats(&stats);
+	CHECK(stats.liveBytes == 64);
+	CHECK(allocator.Allocate(64) == p);
+	allocator.GetStats(&stats);
+	CHECK(stats.liveBytes == 64);
+	allocator.Free(p, 64);
+
+	void* large = allocator.Allocate(1000);
+	allocator.FreeConcurrent(large, 1000);
+	allocator.GetStats(&stats);
+	CHECK(stats.largeCount == 1);
+	allocator.Free(allocator.Allocate(16), 16);
+	allocator.GetStats(&stats);
+	CHECK(stats.largeCount == 0);
+	CHECK(stats.liveBytes == 0);
+
+	// Clear takes back the queued memory too
+	allocator.FreeConcurrent(allocator.Allocate(1000), 1000);
+	allocator.Clear();
+	allocator.GetStats(&stats);
+	CHECK(stats.largeBytes == 0);
+}
+
+// threads free the blocks of an allocator while its thread keeps allocating
+static void testConcurrentFrees(void)
+{
+	const int32 threadCount = 4;
+	const int32 perThread = 20000;
+
+	b2BlockAllocator allocator;
+	std::vector<Allocation> allocations[threadCount];
+	for (int32 t = 0; t < threadCount; ++t)
+	{
+		for (int32 i = 0; i < perThread; ++i)
+		{
+			Allocation a;
+			a.size = allocationSize(t + i);
+			a.p = allocator.Allocate(a.size);
+			memset(a.p, t, a.size);
+			allocations[t].push_back(a);
+		}
+	}
+
+	std::vector<std::thread> threads;
+	for (int32 t = 0; t < threadCount; ++t)
+	{
+		threads.push_back(std::thread([&allocator, &allocations, t]()
+		{
+			for (size_t i = 0; i < allocations[t].size(); ++i)
+			{
+				allocator.FreeConcurrent(allocations[t][i].p, allocations[t][i].size);
+			}
+		}));
+	}
+
+	// the owner reuses the returned blocks meanwhile, they must not be handed out twice
+	std::vector<Allocation> owned;
+	bool distinct = true;
+	for (int32 i = 0; i < 50000; ++i)
+	{
+		Allocation a;
+		a.size = allocationSize(i);
+		a.p = allocator.Allocate(a.size);
+		memcpy(a.p, &i, sizeof(i));
+		owned.push_back(a);
+		if (owned.size() == 64)
+		{
+			for (size_t j = 0; j < owned.size(); ++j)
+			{
+				int32 tag;
+				memcpy(&tag, owned[j].p, sizeof(tag));
+				distinct = distinct && tag == i - int32(owned.size() - 1 - j);
+				allocator.Free(owned[j].p, owned[j].size);
+			}
+			owned.clear();
+		}
+	}
+	CHECK(distinct);
+
+	for (size_t t = 0; t < threads.size(); ++t)
+	{
+		threads[t].join();
+	}
+
+	for (size_t j = 0; j < owned.size(); ++j)
+	{
+		allocator.Free(owned[j].p, owned[j].size);
+	}
+
+	// every block came back
+	allocator.Free(allocator.Allocate(16), 16);
+	b2BlockAllocatorStats stats;
+	allocator.GetStats(&stats);
+	CHECK(stats.liveBytes == 0);
+	CHECK(stats.largeCount == 0);
+	int32 liveBlocks = 0;
+	for (int32 i = 0; i < b2_blockSizes; ++i)
+	{
+		liveBlocks += stats.liveBlocks[i];
+	}
+	CHECK(liveBlocks == 0);
+}
+
+int main()
+{
+	testFreeConcurrent();
+	testConcurrentFrees();
+
+	return checkResults("BlockAllocatorTest");
+}
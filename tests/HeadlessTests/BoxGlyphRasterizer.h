@@ -0,0 +1,77 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __BOX_GLYPH_RASTERIZER_H__
+#define __BOX_GLYPH_RASTERIZER_H__
+
+#include "CCGlyphAtlas.h"
+
+/** @brief Software CCGlyphRasterizer standing in for the platform one.
+
+Each character is a cell of (size / 2) x size pixels, with a transparent border of one pixel
+around a filled box, so the atlas trims the glyph to (size / 2 - 2) x (size - 2) at (1, 1).
+The coverage of the box is coverageOf() of the character. The spaces are cells without pixels.
+*/
+class BoxGlyphRasterizer : public cocos2d::CCGlyphRasterizer
+{
+public:
+	BoxGlyphRasterizer() : m_nCalls(0) {}
+
+	static unsigned char coverageOf(unsigned int uCodePoint)
+	{
+		return (unsigned char)((uCodePoint & 0x7f) | 0x80);
+	}
+
+	virtual bool rasterizeGlyph(const char *pszFontName, unsigned int uFontSize, unsigned int uCodePoint, cocos2d::ccGlyphBitmap *pBitmap)
+	{
+		(void)pszFontName;
+		++m_nCalls;
+
+		unsigned int uWidth = uFontSize / 2;
+		unsigned int uHeight = uFontSize;
+		pBitmap->uWidth = uWidth;
+		pBitmap->uHeight = uHeight;
+		pBitmap->nLeft = 0;
+		pBitmap->nTop = 0;
+		pBitmap->nAdvance = (int)uWidth;
+		pBitmap->uLineHeight = uHeight;
+		pBitmap->tCoverage.assign(uWidth * uHeight, 0);
+		if (uCodePoint == ' ')
+		{
+			return true;
+		}
+
+		for (unsigned int y = 1; y + 1 < uHeight; ++y)
+		{
+			for (unsigned int x = 1; x + 1 < uWidth; ++x)
+			{
+				pBitmap->tCoverage[y * uWidth + x] = coverageOf(uCodePoint);
+			}
+		}
+		return true;
+	}
+
+	int m_nCalls;
+};
+
+#endif // __BOX_GLYPH_RASTERIZER_H__
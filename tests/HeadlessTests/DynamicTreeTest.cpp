@@ -0,0 +1,271 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "HeadlessTest.h"
+#include <Box2D/Box2D.h>
+#include <vector>
+
+// collects the proxies a query finds
+class ProxyCollector
+{
+public:
+	bool QueryCallback(int32 proxyId)
+	{
+		m_found.push_back(proxyId);
+		return true;
+	}
+
+	std::vector<int32> m_found;
+};
+
+static float32 random(float32 lo, float32 hi)
+{
+	static uint32 seed = 12345;
+	seed = seed * 1664525 + 1013904223;
+	return lo + (hi - lo) * float32(seed >> 8) / float32(1 << 24);
+}
+
+static b2AABB randomAABB(void)
+{
+	b2AABB aabb;
+	aabb.lowerBound.Set(random(-100.0f, 100.0f), random(-100.0f, 100.0f));
+	aabb.upperBound = aabb.lowerBound + b2Vec2(random(0.1f, 2.0f), random(0.1f, 2.0f));
+	return aabb;
+}
+
+// compares a query to testing every fat AABB
+static bool matchesBruteForce(const b2DynamicTree& tree, const std::vector<int32>& proxyIds, const b2AABB& aabb)
+{
+	ProxyCollector collector;
+	tree.Query(&collector, aabb);
+
+	size_t expected = 0;
+	for (size_t i = 0; i < proxyIds.size(); ++i)
+	{
+		if (b2TestOverlap(tree.GetFatAABB(proxyIds[i]), aabb))
+		{
+			++expected;
+		}
+	}
+	return collector.m_found.size() == expected;
+}
+
+static void testCreateProxies(void)
+{
+	const int32 count = 2000;
+	std::vector<b2AABB> aabbs(count);
+	std::vector<void*> userData(count);
+	for (int32 i = 0; i < count; ++i)
+	{
+		aabbs[i] = randomAABB();
+		userData[i] = &aabbs[i];
+	}
+
+	b2DynamicTree inserted;
+	std::vector<int32> insertedIds(count);
+	for (int32 i = 0; i < count; ++i)
+	{
+		insertedIds[i] = inserted.CreateProxy(aabbs[i], userData[i]);
+	}
+
+	b2DynamicTree built;
+	std::vector<int32> builtIds(count);
+	built.CreateProxies(&aabbs[0], &userData[0], count, &builtIds[0]);
+	built.Validate();
+
+	bool userDataKept = true;
+	for (int32 i = 0; i < count; ++i)
+	{
+		userDataKept = userDataKept && built.GetUserData(builtIds[i]) == userData[i];
+	}
+	CHECK(userDataKept);
+
+	// the bulk build gives a better tree than inserting the proxies one by one
+	CHECK(built.GetAreaRatio() < inserted.GetAreaRatio());
+	CHECK(built.GetAverageDepth() < inserted.GetAverageDepth());
+
+	bool matches = true;
+	for (int32 i = 0; i < 200; ++i)
+	{
+		b2AABB aabb = randomAABB();
+		aabb.upperBound += b2Vec2(5.0f, 5.0f);
+		matches = matches && matchesBruteForce(built, builtIds, aabb);
+	}
+	CHECK(matches);
+
+	// proxies can still be added and removed one by one
+	int32 proxyId = built.CreateProxy(randomAABB(), NULL);
+	built.DestroyProxy(builtIds[0]);
+	built.Validate();
+	builtIds[0] = proxyId;
+	CHECK(matchesBruteForce(built, builtIds, aabbs[1]));
+}
+
+static void testRefitProxy(void)
+{
+	const int32 count = 1000;
+	b2DynamicTree tree;
+	std::vector<int32> proxyIds(count);
+	std::vector<b2AABB> aabbs(count);
+	for (int32 i = 0; i < count; ++i)
+	{
+		aabbs[i] = randomAABB();
+		proxyIds[i] = tree.CreateProxy(aabbs[i], NULL);
+	}
+	tree.RebuildTopDown();
+	float32 rebuiltQuality = tree.GetAreaRatio();
+
+	// a move inside the fat AABB changes nothing
+	b2AABB inside = aabbs[0];
+	inside.lowerBound += b2Vec2(0.01f, 0.0f);
+	inside.upperBound += b2Vec2(0.01f, 0.0f);
+	CHECK(tree.RefitProxy(proxyIds[0], inside, b2Vec2(0.01f, 0.0f)) == false);
+
+	// the proxies travel, the tree keeps its shape and grows its AABBs
+	int32 height = tree.GetHeight();
+	int32 refitCount = 0;
+	for (int32 step = 0; step < 20; ++step)
+	{
+		for (int32 i = 0; i < count; ++i)
+		{
+			b2Vec2 d(random(-2.0f, 2.0f), random(-2.0f, 2.0f));
+			aabbs[i].lowerBound += d;
+			aabbs[i].upperBound += d;
+			if (tree.RefitProxy(proxyIds[i], aabbs[i], d))
+			{
+				++refitCount;
+			}
+		}
+	}
+	tree.Validate();
+	CHECK(refitCount > 0);
+	CHECK(tree.GetHeight() == height);
+
+	bool contained = true;
+	for (int32 i = 0; i < count; ++i)
+	{
+		contained = contained && tree.GetFatAABB(proxyIds[i]).Contains(aabbs[i]);
+	}
+	CHECK(contained);
+
+	bool matches = true;
+	for (int32 i = 0; i < 200; ++i)
+	{
+		matches = matches && matchesBruteForce(tree, proxyIds, randomAABB());
+	}
+	CHECK(matches);
+
+	// the refit degrades the tree until it is rebuilt
+	float32 refitQuality = tree.GetAreaRatio();
+	CHECK(refitQuality > rebuiltQuality);
+	tree.RebuildTopDown();
+	tree.Validate();
+	CHECK(tree.GetAreaRatio() < refitQuality);
+}
+
+// a count x count grid of boxes on one body, like the tiles of a level
+static b2Body* createTiles(b2World& world, int32 count, bool active)
+{
+	b2BodyDef bd;
+	bd.active = active;
+	b2Body* ground = world.CreateBody(&bd);
+	for (int32 i = 0; i < count; ++i)
+	{
+		for (int32 j = 0; j < count; ++j)
+		{
+			b2PolygonShape shape;
+			shape.SetAsBox(0.5f, 0.5f, b2Vec2(float32(i), float32(-j)), 0.0f);
+			ground->CreateFixture(&shape, 0.0f);
+		}
+	}
+	return ground;
+}
+
+class FixtureCounter : public b2QueryCallback
+{
+public:
+	FixtureCounter() : m_count(0) {}
+
+	virtual bool ReportFixture(b2Fixture* fixture)
+	{
+		++m_count;
+		return true;
+	}
+
+	int32 m_count;
+};
+
+static void testBodyActivation(void)
+{
+	b2World inserted(b2Vec2(0.0f, -10.0f));
+	createTiles(inserted, 40, true);
+
+	b2World built(b2Vec2(0.0f, -10.0f));
+	b2Body* ground = createTiles(built, 40, false);
+	CHECK(built.GetProxyCount() == 0);
+	ground->SetActive(true);
+	CHECK(built.GetProxyCount() == 40 * 40);
+	CHECK(built.GetTreeQuality() < inserted.GetTreeQuality());
+	CHECK(built.GetTreeAverageDepth() < inserted.GetTreeAverageDepth());
+
+	// the activated tiles collide like the inserted ones
+	b2PolygonShape shape;
+	shape.SetAsBox(0.5f, 0.5f);
+	b2BodyDef bd;
+	bd.type = b2_dynamicBody;
+	bd.position.Set(10.0f, 2.0f);
+	built.CreateBody(&bd)->CreateFixture(&shape, 1.0f);
+	inserted.CreateBody(&bd)->CreateFixture(&shape, 1.0f);
+
+	built.SetTreeRefit(true);
+	CHECK(built.GetTreeRefit());
+	for (int32 i = 0; i < 120; ++i)
+	{
+		built.Step(1.0f / 60.0f, 8, 3);
+		inserted.Step(1.0f / 60.0f, 8, 3);
+	}
+	CHECK(built.GetContactCount() > 0);
+	CHECK(built.GetContactCount() == inserted.GetContactCount());
+	CHECK(b2Abs(built.GetBodyList()->GetPosition().y - 1.0f) < 0.05f);
+
+	b2AABB aabb;
+	aabb.lowerBound.Set(5.2f, -5.2f);
+	aabb.upperBound.Set(9.8f, -0.2f);
+	FixtureCounter counter;
+	built.QueryAABB(&counter, aabb);
+	CHECK(counter.m_count == 6 * 6);
+
+	// deactivating removes every proxy
+	ground->SetActive(false);
+	CHECK(built.GetProxyCount() == 1);
+}
+
+int main()
+{
+	testCreateProxies();
+	testRefitProxy();
+	testBodyActivation();
+
+	return checkResults("DynamicTreeTest");
+}
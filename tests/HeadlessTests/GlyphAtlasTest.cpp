@@ -0,0 +1,311 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "HeadlessTest.h"
+#include "CCGlyphAtlas.h"
+#include "ccUTF8.h"
+#include "BoxGlyphRasterizer.h"
+
+using namespace cocos2d;
+
+// with the BoxGlyphRasterizer, a glyph of size 10 is 3x8 pixels at (1, 1), advancing by 5, in lines of 10
+enum {
+	kFontSize = 10,
+};
+
+// decodes the first character of a string, and how many bytes it takes
+static unsigned int decode(const char *pszText, int *pLength)
+{
+	const char *p = pszText;
+	unsigned int uCodePoint = ccNextUTF8CodePoint(p);
+	*pLength = (int)(p - pszText);
+	return uCodePoint;
+}
+
+// true if the pixels of the glyph in the atlas are the box drawn for the character
+static bool hasPixelsOf(CCGlyphAtlas& atlas, const ccGlyph& glyph, unsigned int uCodePoint)
+{
+	const unsigned char *pPixels = atlas.getPixels();
+	for (unsigned int y = glyph.uY; y < glyph.uY + glyph.uHeight; ++y)
+	{
+		for (unsigned int x = glyph.uX; x < glyph.uX + glyph.uWidth; ++x)
+		{
+			const unsigned char *pPixel = pPixels + (y * atlas.getWidth() + x) * 4;
+			if (pPixel[0] != 0xff || pPixel[1] != 0xff || pPixel[2] != 0xff || pPixel[3] != BoxGlyphRasterizer::coverageOf(uCodePoint))
+			{
+				return false;
+			}
+		}
+	}
+	return glyph.uWidth > 0 && glyph.uHeight > 0;
+}
+
+static bool overlap(const ccGlyph& a, const ccGlyph& b)
+{
+	return a.uX < b.uX + b.uWidth && b.uX < a.uX + a.uWidth
+		&& a.uY < b.uY + b.uHeight && b.uY < a.uY + a.uHeight;
+}
+
+static void testNextCodePoint()
+{
+	int nLength = 0;
+
+	CHECK(decode("A", &nLength) == 'A' && nLength == 1);
+	CHECK(decode("\xc3\xa9", &nLength) == 0xe9 && nLength == 2);
+	CHECK(decode("\xe4\xbd\xa0", &nLength) == 0x4f60 && nLength == 3);
+	CHECK(decode("\xf0\x9f\x98\x80", &nLength) == 0x1f600 && nLength == 4);
+
+	// a continuation byte or an invalid byte alone
+	CHECK(decode("\x80" "A", &nLength) == 0xfffd && nLength == 1);
+	CHECK(decode("\xff" "A", &nLength) == 0xfffd && nLength == 1);
+	// a truncated character stops before the byte that isn't a continuation
+	CHECK(decode("\xe4\xbd" "A", &nLength) == 0xfffd && nLength == 2);
+	CHECK(decode("\xe4\xbd", &nLength) == 0xfffd && nLength == 2);
+	CHECK(decode("\xf0\x9f\x98", &nLength) == 0xfffd && nLength == 3);
+	// overlong encodings, surrogates, and characters above U+10FFFF
+	CHECK(decode("\xc0\xaf", &nLength) == 0xfffd && nLength == 2);
+	CHECK(decode("\xe0\x80\xaf", &nLength) == 0xfffd && nLength == 3);
+	CHECK(decode("\xed\xa0\x80", &nLength) == 0xfffd && nLength == 3);
+	CHECK(decode("\xf4\x90\x80\x80", &nLength) == 0xfffd && nLength == 4);
+
+	// the decoding goes on after an invalid byte
+	const char *pszText = "\xe4\xbd\xa0\xc3\xa9\xff\xe4\xbd";
+	const char *p = pszText;
+	CHECK(ccNextUTF8CodePoint(p) == 0x4f60);
+	CHECK(ccNextUTF8CodePoint(p) == 0xe9);
+	CHECK(ccNextUTF8CodePoint(p) == 0xfffd);
+	CHECK(ccNextUTF8CodePoint(p) == 0xfffd);
+	CHECK(*p == 0 && p == pszText + 8);
+}
+
+static void testShelfReuse()
+{
+	BoxGlyphRasterizer rasterizer;
+	CCGlyphAtlas atlas(64, 64);
+	atlas.setRasterizer(&rasterizer);
+	unsigned int uFont = atlas.fontID("Arial");
+	CHECK(atlas.fontID("Arial") == uFont);
+	CHECK(atlas.fontID("Marker Felt") != uFont);
+
+	const ccGlyph *pA = atlas.glyph(uFont, kFontSize, 'A', 1);
+	const ccGlyph *pB = atlas.glyph(uFont, kFontSize, 'B', 1);
+	CHECK(pA && pB);
+	CHECK(pA->uX == 0 && pA->uY == 0 && pA->uWidth == 3 && pA->uHeight == 8);
+	CHECK(pA->nLeft == 1 && pA->nTop == 1 && pA->nAdvance == 5 && pA->uLineHeight == 10);
+	// next to A on its shelf, after a pixel of padding
+	CHECK(pB->uShelf == pA->uShelf && pB->uY == pA->uY && pB->uX == pA->uX + pA->uWidth + 1);
+	CHECK(hasPixelsOf(atlas, *pA, 'A') && hasPixelsOf(atlas, *pB, 'B'));
+	CHECK(! overlap(*pA, *pB));
+
+	// the glyphs are drawn once
+	CHECK(atlas.glyph(uFont, kFontSize, 'A', 2) == pA);
+	CHECK(rasterizer.m_nCalls == 2 && atlas.getRasterizedCount() == 2);
+
+	// a space has no pixels and no shelf
+	const ccGlyph *pSpace = atlas.glyph(uFont, kFontSize, ' ', 2);
+	CHECK(pSpace && pSpace->uShelf == kCCGlyphNoShelf && pSpace->uWidth == 0 && pSpace->nAdvance == 5);
+
+	// a slightly smaller glyph goes on the same shelf, a much taller one on a new shelf below
+	const ccGlyph *pSmall = atlas.glyph(uFont, kFontSize - 1, 'C', 2);
+	CHECK(pSmall && pSmall->uShelf == pA->uShelf && pSmall->uY == pA->uY);
+	const ccGlyph *pTall = atlas.glyph(uFont, 2 * kFontSize, 'D', 2);
+	CHECK(pTall && pTall->uShelf != pA->uShelf && pTall->uY == pA->uHeight + 1);
+	CHECK(atlas.getShelfCount() == 2);
+	CHECK(hasPixelsOf(atlas, *pSmall, 'C') && hasPixelsOf(atlas, *pTall, 'D'));
+
+	// the dirty rectangle covers the glyphs drawn, until it is cleared
+	unsigned int x = 0, y = 0, uWidth = 0, uHeight = 0;
+	CHECK(atlas.getDirtyRect(&x, &y, &uWidth, &uHeight));
+	CHECK(x == 0 && y == 0 && uWidth >= pSmall->uX + pSmall->uWidth && y + uHeight == pTall->uY + pTall->uHeight);
+	atlas.clearDirtyRect();
+	CHECK(! atlas.getDirtyRect(&x, &y, &uWidth, &uHeight));
+
+	// a glyph larger than the atlas doesn't fit
+	CHECK(atlas.glyph(uFont, 200, 'E', 2) == NULL);
+	CHECK(atlas.getEvictedShelfCount() == 0);
+}
+
+static void testEviction()
+{
+	// two shelves of two glyphs of size 10, padded to 4x9
+	BoxGlyphRasterizer rasterizer;
+	CCGlyphAtlas atlas(8, 18);
+	atlas.setRasterizer(&rasterizer);
+	unsigned int uFont = atlas.fontID("Arial");
+	std::vector<ccGlyphPlacement> placements;
+
+	atlas.layoutString("AB", uFont, kFontSize, 1, 0, 0, kCCGlyphAlignmentLeft, placements, NULL, NULL);
+	atlas.layoutString("CD", uFont, kFontSize, 2, 0, 0, kCCGlyphAlignmentLeft, placements, NULL, NULL);
+	CHECK(atlas.getShelfCount() == 2 && atlas.getGlyphCount() == 4);
+	unsigned int uShelfAB = atlas.glyph(uFont, kFontSize, 'A', 3)->uShelf;
+	unsigned int uShelfCD = atlas.glyph(uFont, kFontSize, 'C', 2)->uShelf;
+	CHECK(uShelfAB != uShelfCD);
+	CHECK(atlas.getEvictedShelfCount() == 0 && rasterizer.m_nCalls == 4);
+
+	// A was used at tick 3, so the shelf of C and D is the one used the longest time ago
+	const ccGlyph *pE = atlas.glyph(uFont, kFontSize, 'E', 4);
+	CHECK(pE && pE->uShelf == uShelfCD && pE->uX == 0);
+	CHECK(atlas.getEvictedShelfCount() == 1);
+	CHECK(atlas.getGlyphCount() == 3);
+	CHECK(hasPixelsOf(atlas, *pE, 'E'));
+	// the pixels of D were cleared
+	CHECK(atlas.getPixels()[(pE->uY * atlas.getWidth() + 4) * 4 + 3] == 0);
+
+	int nCalls = rasterizer.m_nCalls;
+	atlas.glyph(uFont, kFontSize, 'B', 4);
+	CHECK(rasterizer.m_nCalls == nCalls);
+
+	// during a single tick, the glyphs of the tick evict the older ones but never each other:
+	// F fills the shelf of E, G and H replace A and B, and I and J don't fit
+	atlas.layoutString("FGHIJ", uFont, kFontSize, 5, 0, 0, kCCGlyphAlignmentLeft, placements, NULL, NULL);
+	CHECK(placements.size() == 3);
+	CHECK(atlas.getEvictedShelfCount() == 2);
+	CHECK(atlas.getGlyphCount() == 4);
+	for (unsigned int i = 0; i < placements.size(); ++i)
+	{
+		CHECK(hasPixelsOf(atlas, placements[i].glyph, 'F' + i));
+		for (unsigned int j = i + 1; j < placements.size(); ++j)
+		{
+			CHECK(! overlap(placements[i].glyph, placements[j].glyph));
+		}
+	}
+	nCalls = rasterizer.m_nCalls;
+	CHECK(atlas.glyph(uFont, kFontSize, 'E', 5) == pE && hasPixelsOf(atlas, *pE, 'E'));
+	CHECK(rasterizer.m_nCalls == nCalls);
+
+	// I didn't fit, it is drawn again during the next tick
+	CHECK(atlas.glyph(uFont, kFontSize, 'I', 5) == NULL);
+	CHECK(atlas.glyph(uFont, kFontSize, 'I', 6) != NULL);
+	CHECK(atlas.getEvictedShelfCount() == 3);
+}
+
+static void testGeneration()
+{
+	BoxGlyphRasterizer rasterizer;
+	CCGlyphAtlas atlas(8, 18);
+	atlas.setRasterizer(&rasterizer);
+	unsigned int uFont = atlas.fontID("Arial");
+
+	// removing the glyphs of an empty atlas changes nothing
+	unsigned int uGeneration = atlas.getGeneration();
+	atlas.removeAllGlyphs();
+	CHECK(atlas.getGeneration() == uGeneration);
+
+	// adding glyphs doesn't move the ones already there
+	atlas.glyph(uFont, kFontSize, 'A', 1);
+	atlas.glyph(uFont, kFontSize, 'B', 1);
+	atlas.glyph(uFont, kFontSize, 'C', 2);
+	atlas.glyph(uFont, kFontSize, 'D', 2);
+	CHECK(atlas.getGeneration() == uGeneration);
+
+	// evicting a shelf does
+	atlas.glyph(uFont, kFontSize, 'E', 3);
+	CHECK(atlas.getGeneration() == uGeneration + 1);
+
+	// a glyph taller than the shelves, when none is used during the tick, starts the atlas again
+	const ccGlyph *pTall = atlas.glyph(uFont, 12, 'F', 4);
+	CHECK(pTall && pTall->uY == 0);
+	CHECK(atlas.getGeneration() == uGeneration + 2);
+	CHECK(atlas.getGlyphCount() == 1 && atlas.getShelfCount() == 1);
+
+	// but not while the shelves are used during the tick
+	CHECK(atlas.glyph(uFont, 16, 'G', 4) == NULL);
+	CHECK(atlas.getGeneration() == uGeneration + 2);
+
+	atlas.removeAllGlyphs();
+	CHECK(atlas.getGeneration() == uGeneration + 3);
+	CHECK(atlas.getGlyphCount() == 0 && atlas.getShelfCount() == 0);
+	unsigned int x = 0, y = 0, uWidth = 0, uHeight = 0;
+	CHECK(atlas.getDirtyRect(&x, &y, &uWidth, &uHeight) && uWidth == 8 && uHeight == 18);
+}
+
+// the bottom left corners of the placements, as "x,y x,y ..."
+static std::string corners(const std::vector<ccGlyphPlacement>& placements)
+{
+	std::string text;
+	for (unsigned int i = 0; i < placements.size(); ++i)
+	{
+		char szCorner[32];
+		sprintf(szCorner, "%s%g,%g", i ? " " : "", placements[i].fLeft, placements[i].fBottom);
+		text += szCorner;
+	}
+	return text;
+}
+
+static void testLayout()
+{
+	BoxGlyphRasterizer rasterizer;
+	CCGlyphAtlas atlas(64, 64);
+	atlas.setRasterizer(&rasterizer);
+	unsigned int uFont = atlas.fontID("Arial");
+	std::vector<ccGlyphPlacement> placements;
+	float fWidth = 0, fHeight = 0;
+
+	// without a box, the size of the text, the spaces take room but aren't placed
+	atlas.layoutString("AB C", uFont, kFontSize, 1, 0, 0, kCCGlyphAlignmentLeft, placements, &fWidth, &fHeight);
+	CHECK(fWidth == 20 && fHeight == 10);
+	CHECK(corners(placements) == "1,1 6,1 16,1");
+	CHECK(placements[2].glyph.uWidth == 3 && hasPixelsOf(atlas, placements[2].glyph, 'C'));
+
+	// the lines are wrapped after their last space, and aligned without their trailing spaces
+	const char *pszText = "AA AA AA\nB";
+	atlas.layoutString(pszText, uFont, kFontSize, 1, 22, 0, kCCGlyphAlignmentLeft, placements, &fWidth, &fHeight);
+	CHECK(fWidth == 22 && fHeight == 40);
+	CHECK(corners(placements) == "1,31 6,31 1,21 6,21 1,11 6,11 1,1");
+	atlas.layoutString(pszText, uFont, kFontSize, 1, 22, 0, kCCGlyphAlignmentCenter, placements, &fWidth, &fHeight);
+	CHECK(corners(placements) == "7,31 12,31 7,21 12,21 7,11 12,11 9,1");
+	atlas.layoutString(pszText, uFont, kFontSize, 1, 22, 0, kCCGlyphAlignmentRight, placements, &fWidth, &fHeight);
+	CHECK(corners(placements) == "13,31 18,31 13,21 18,21 13,11 18,11 18,1");
+
+	// a word longer than the box is cut before the glyph that doesn't fit
+	atlas.layoutString("AAAAA", uFont, kFontSize, 1, 12, 0, kCCGlyphAlignmentLeft, placements, &fWidth, &fHeight);
+	CHECK(fWidth == 12 && fHeight == 30);
+	CHECK(corners(placements) == "1,21 6,21 1,11 6,11 1,1");
+
+	// centered vertically in the box height
+	atlas.layoutString("A", uFont, kFontSize, 1, 0, 30, kCCGlyphAlignmentLeft, placements, &fWidth, &fHeight);
+	CHECK(fWidth == 5 && fHeight == 30);
+	CHECK(corners(placements) == "1,11");
+
+	// the invalid bytes are drawn as U+FFFD, the carriage returns are skipped
+	int nCalls = rasterizer.m_nCalls;
+	atlas.layoutString("A\xff\r\nA", uFont, kFontSize, 1, 0, 0, kCCGlyphAlignmentLeft, placements, &fWidth, &fHeight);
+	CHECK(rasterizer.m_nCalls == nCalls + 1);
+	CHECK(corners(placements) == "1,11 6,11 1,1");
+	CHECK(hasPixelsOf(atlas, placements[1].glyph, 0xfffd));
+
+	// an empty string is a line of the font size
+	atlas.layoutString("", uFont, kFontSize, 1, 0, 0, kCCGlyphAlignmentLeft, placements, &fWidth, &fHeight);
+	CHECK(placements.empty() && fWidth == 0 && fHeight == 10);
+}
+
+int main()
+{
+	testNextCodePoint();
+	testShelfReuse();
+	testEviction();
+	testGeneration();
+	testLayout();
+
+	return checkResults("GlyphAtlasTest");
+}
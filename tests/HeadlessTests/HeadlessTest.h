@@ -0,0 +1,50 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __HEADLESS_TEST_H__
+#define __HEADLESS_TEST_H__
+
+#include <stdio.h>
+
+// checks of the headless tests, each test is a program with its own main()
+
+static int s_nChecks = 0;
+static int s_nFailures = 0;
+
+#define CHECK(cond) \
+	do { \
+		++s_nChecks; \
+		if (! (cond)) { \
+			++s_nFailures; \
+			printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+		} \
+	} while (0)
+
+// prints the results, and returns the exit code of the test
+static inline int checkResults(const char *pszTestName)
+{
+	printf("%s: %d checks, %d failed\n", pszTestName, s_nChecks, s_nFailures);
+	return s_nFailures ? 1 : 0;
+}
+
+#endif // __HEADLESS_TEST_H__
@@ -0,0 +1,192 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "HeadlessTest.h"
+#include "support/CCQuadUploader.h"
+#include <math.h>
+#include <vector>
+
+using namespace cocos2d;
+
+// records what a CCQuadUploader sends to the GPU
+class RecordingVertexBuffer : public CCVertexBufferTarget
+{
+public:
+	RecordingVertexBuffer(unsigned int uQuads)
+		: m_tVertices(uQuads * 4)
+		, m_nUploads(0)
+		, m_uBytes(0)
+		, m_uFirst(0)
+		, m_uCount(0)
+	{
+	}
+
+	virtual void updateVertices(const ccV3F_C4F_T2F *pVertices, unsigned int uFirst, unsigned int uCount)
+	{
+		++m_nUploads;
+		m_uBytes += uCount * sizeof(ccV3F_C4F_T2F);
+		m_uFirst = uFirst;
+		m_uCount = uCount;
+		for (unsigned int i = 0; i < uCount; ++i)
+		{
+			m_tVertices[uFirst + i] = pVertices[i];
+		}
+	}
+
+	std::vector<ccV3F_C4F_T2F> m_tVertices;
+	int m_nUploads;
+	unsigned int m_uBytes;
+	// the last upload, in vertices
+	unsigned int m_uFirst;
+	unsigned int m_uCount;
+};
+
+enum {
+	kQuadBytes = 4 * sizeof(ccV3F_C4F_T2F),
+};
+
+static bool near(float a, float b)
+{
+	return fabsf(a - b) < 1e-6f;
+}
+
+static void setQuad(ccV3F_C4B_T2F_Quad& quad, float x, CCubyte alpha)
+{
+	ccV3F_C4B_T2F *corners[4] = { &quad.tl, &quad.tr, &quad.br, &quad.bl };
+	for (int i = 0; i < 4; ++i)
+	{
+		corners[i]->vertices = vertex3(x + i, 2.0f * i, 0.5f);
+		corners[i]->colors = ccc4(255, 0, 51, alpha);
+		corners[i]->texCoords = tex2(0.25f * i, 1.0f - 0.25f * i);
+	}
+}
+
+static void testDirtyRange()
+{
+	CCQuadUploader uploader;
+	uploader.setCapacity(100);
+	unsigned int uStart = 0, uEnd = 0;
+	CHECK(! uploader.getDirtyRange(&uStart, &uEnd));
+
+	uploader.setDirtyRange(10, 20);
+	uploader.setDirtyRange(40, 50);
+	CHECK(uploader.getDirtyRange(&uStart, &uEnd) && uStart == 10 && uEnd == 50);
+
+	// clamped to the capacity
+	uploader.setDirtyRange(90, 120);
+	CHECK(uploader.getDirtyRange(&uStart, &uEnd) && uStart == 10 && uEnd == 100);
+	uploader.setCapacity(60);
+	CHECK(uploader.getDirtyRange(&uStart, &uEnd) && uStart == 10 && uEnd == 60);
+	uploader.setDirtyRange(70, 80);
+	CHECK(uploader.getDirtyRange(&uStart, &uEnd) && uStart == 10 && uEnd == 60);
+}
+
+static void testUploadedBytes()
+{
+	const unsigned int uCapacity = 1000;
+	std::vector<ccV3F_C4B_T2F_Quad> quads(uCapacity);
+	for (unsigned int i = 0; i < uCapacity; ++i)
+	{
+		setQuad(quads[i], (float)i, 255);
+	}
+
+	CCQuadUploader uploader;
+	uploader.setCapacity(uCapacity);
+	RecordingVertexBuffer buffer(uCapacity);
+
+	// a new buffer is uploaded once, only up to the quads drawn
+	uploader.setDirtyRange(0, uCapacity);
+	CHECK(uploader.upload(&quads[0], 600, &buffer) == 600);
+	CHECK(buffer.m_uBytes == 600 * kQuadBytes);
+	CHECK(uploader.upload(&quads[0], uCapacity, &buffer) == 400);
+	CHECK(buffer.m_uFirst == 600 * 4 && buffer.m_uCount == 400 * 4);
+	CHECK(buffer.m_uBytes == uCapacity * kQuadBytes);
+
+	// the frames without changes upload nothing
+	buffer.m_nUploads = 0;
+	buffer.m_uBytes = 0;
+	for (int frame = 0; frame < 10; ++frame)
+	{
+		CHECK(uploader.upload(&quads[0], uCapacity, &buffer) == 0);
+	}
+	CHECK(buffer.m_nUploads == 0 && buffer.m_uBytes == 0);
+
+	// a modified quad uploads that quad only
+	setQuad(quads[123], 5000.0f, 10);
+	uploader.setDirtyRange(123, 124);
+	CHECK(uploader.upload(&quads[0], uCapacity, &buffer) == 1);
+	CHECK(buffer.m_nUploads == 1 && buffer.m_uBytes == kQuadBytes);
+	CHECK(buffer.m_uFirst == 123 * 4 && buffer.m_uCount == 4);
+
+	// two modified quads upload the range between them
+	buffer.m_uBytes = 0;
+	uploader.setDirtyRange(200, 201);
+	uploader.setDirtyRange(209, 210);
+	CHECK(uploader.upload(&quads[0], uCapacity, &buffer) == 10);
+	CHECK(buffer.m_uBytes == 10 * kQuadBytes);
+
+	// the modified quads that aren't drawn stay pending until they are
+	buffer.m_uBytes = 0;
+	uploader.setDirtyRange(50, 60);
+	uploader.setDirtyRange(700, 710);
+	CHECK(uploader.upload(&quads[0], 100, &buffer) == 50);
+	CHECK(buffer.m_uFirst == 50 * 4 && buffer.m_uCount == 50 * 4);
+	unsigned int uStart = 0, uEnd = 0;
+	CHECK(uploader.getDirtyRange(&uStart, &uEnd) && uStart == 100 && uEnd == 710);
+	CHECK(uploader.upload(&quads[0], uCapacity, &buffer) == 610);
+	CHECK(buffer.m_uBytes == 660 * kQuadBytes);
+	CHECK(! uploader.getDirtyRange(&uStart, &uEnd));
+}
+
+static void testConversion()
+{
+	ccV3F_C4B_T2F_Quad quads[3];
+	setQuad(quads[0], 0.0f, 255);
+	setQuad(quads[1], 10.0f, 0);
+	setQuad(quads[2], 20.0f, 255);
+
+	CCQuadUploader uploader;
+	uploader.setCapacity(3);
+	uploader.setDirtyRange(1, 2);
+	RecordingVertexBuffer buffer(3);
+	uploader.upload(quads, 3, &buffer);
+
+	// the corners in the order tl, tr, br, bl, the colors from 0 to 1
+	const ccV3F_C4B_T2F *corners[4] = { &quads[1].tl, &quads[1].tr, &quads[1].br, &quads[1].bl };
+	for (int i = 0; i < 4; ++i)
+	{
+		const ccV3F_C4F_T2F& vertex = buffer.m_tVertices[4 + i];
+		CHECK(vertex.vertices.x == corners[i]->vertices.x && vertex.vertices.y == corners[i]->vertices.y && vertex.vertices.z == 0.5f);
+		CHECK(near(vertex.colors.r, 1.0f) && near(vertex.colors.g, 0.0f) && near(vertex.colors.b, 0.2f) && near(vertex.colors.a, 0.0f));
+		CHECK(vertex.texCoords.u == corners[i]->texCoords.u && vertex.texCoords.v == corners[i]->texCoords.v);
+	}
+	CHECK(buffer.m_uFirst == 4 && buffer.m_uCount == 4);
+}
+
+int main()
+{
+	testDirtyRange();
+	testUploadedBytes();
+	testConversion();
+	return checkResults("QuadUploaderTest");
+}
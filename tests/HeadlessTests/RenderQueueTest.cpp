@@ -0,0 +1,250 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "HeadlessTest.h"
+#include "CCRenderQueue.h"
+#include "CCTexture2D.h"
+#include "CCNode.h"
+#include <string>
+
+using namespace cocos2d;
+
+static const float s_identity[16] = {
+	1, 0, 0, 0,
+	0, 1, 0, 0,
+	0, 0, 1, 0,
+	0, 0, 0, 1,
+};
+
+static const ccBlendFunc s_alphaBlend = { CC_ONE, CC_ONE_MINUS_SRC_ALPHA };
+
+static CCTexture2D *s_pTextures[3];
+
+static void addQuad(CCRenderQueue& queue, char texture)
+{
+	ccV3F_C4B_T2F_Quad quad = ccV3F_C4B_T2F_Quad();
+	queue.addQuad(s_pTextures[texture - 'A'], s_alphaBlend, quad, s_identity, s_identity);
+}
+
+// records a quad for each letter of a string
+static void addQuads(CCRenderQueue& queue, const char *pszTextures)
+{
+	for (const char *p = pszTextures; *p; ++p)
+	{
+		addQuad(queue, *p);
+	}
+}
+
+// a node that records quads while it draws, like a transition visits its scenes
+class RecordingNode : public CCNode
+{
+public:
+	RecordingNode(CCRenderQueue& queue, const char *pszTextures) : m_queue(queue), m_pszTextures(pszTextures) {}
+
+	virtual void draw(void)
+	{
+		addQuads(m_queue, m_pszTextures);
+	}
+
+private:
+	CCRenderQueue& m_queue;
+	const char *m_pszTextures;
+};
+
+// writes the draw calls: the texture letter once per quad, and N for a node, separated by spaces
+class LoggingBackend : public CCRenderBackend
+{
+public:
+	LoggingBackend(CCRenderQueue& queue) : m_queue(queue) {}
+
+	virtual void drawQuads(const ccRenderCommand& command, const float *projection, const ccV3F_C4B_T2F_Quad *quads)
+	{
+		(void)projection;
+		(void)quads;
+		char texture = 'A';
+		while (s_pTextures[texture - 'A'] != command.texture)
+		{
+			++texture;
+		}
+		m_log.append(command.quadCount, texture);
+		m_log += ' ';
+
+		// like the device state changes, a flush while the commands are executed doesn't draw anything itself
+		m_queue.flush();
+	}
+
+	virtual void drawNode(const ccRenderCommand& command, const float *view, const float *projection)
+	{
+		(void)view;
+		(void)projection;
+		m_log += "N ";
+		command.node->draw();
+	}
+
+	std::string m_log;
+
+private:
+	CCRenderQueue& m_queue;
+};
+
+static void testNullBackend()
+{
+	CCNullRenderBackend backend;
+	CCRenderQueue queue;
+	queue.setBackend(&backend);
+	CCNode *pNode = new CCNode();
+
+	// the scene traversal is measured without a device
+	addQuads(queue, "AA");
+	queue.addNode(pNode, s_identity, s_identity);
+	addQuads(queue, "AAB");
+	CHECK(queue.getCommandCount() == 4);
+	CHECK(pNode->retainCount() == 2);
+	queue.flush();
+	CHECK(pNode->retainCount() == 1);
+	CHECK(backend.getDrawCalls() == 3 && backend.getQuads() == 5 && backend.getNodes() == 1);
+	CHECK(queue.getDrawCalls() == 3 && queue.getQuadsDrawn() == 5 && queue.getNodesDrawn() == 1);
+
+	// sprites of alternating textures only batch in a sort group
+	backend.reset();
+	addQuads(queue, "ABAB");
+	queue.flush();
+	CHECK(backend.getDrawCalls() == 4);
+
+	backend.reset();
+	queue.beginSortGroup();
+	addQuads(queue, "ABAB");
+	queue.endSortGroup();
+	addQuads(queue, "B");
+	queue.flush();
+	CHECK(backend.getDrawCalls() == 2 && backend.getQuads() == 5);
+
+	// a node is a barrier, the quads aren't moved across it
+	backend.reset();
+	queue.beginSortGroup();
+	addQuads(queue, "AB");
+	queue.addNode(pNode, s_identity, s_identity);
+	addQuads(queue, "AB");
+	queue.endSortGroup();
+	queue.flush();
+	CHECK(backend.getDrawCalls() == 4 && backend.getNodes() == 1);
+
+	// without a backend, the commands are dropped
+	queue.setBackend(NULL);
+	queue.addNode(pNode, s_identity, s_identity);
+	queue.flush();
+	CHECK(queue.getCommandCount() == 0 && pNode->retainCount() == 1);
+
+	pNode->release();
+}
+
+static void testSortOrder()
+{
+	CCRenderQueue queue;
+	LoggingBackend backend(queue);
+	queue.setBackend(&backend);
+
+	// the lower keys are drawn first, then the commands are grouped by texture
+	queue.beginSortGroup();
+	queue.setSortKey(1);
+	addQuads(queue, "CA");
+	queue.setSortKey(0);
+	addQuads(queue, "BAB");
+	queue.endSortGroup();
+	addQuads(queue, "A");
+	queue.flush();
+	CHECK(backend.m_log == "A BB A C A ");
+
+	// the keys of a nested group are part of the outermost child
+	backend.m_log.clear();
+	queue.beginSortGroup();
+	queue.setSortKey(1);
+	queue.beginSortGroup();
+	queue.setSortKey(-1);
+	addQuads(queue, "A");
+	queue.endSortGroup();
+	queue.setSortKey(0);
+	addQuads(queue, "B");
+	queue.endSortGroup();
+	queue.flush();
+	CHECK(backend.m_log == "B A ");
+
+	// the sorted commands are merged up to the batch capacity
+	backend.m_log.clear();
+	queue.setBatchCapacity(2);
+	queue.beginSortGroup();
+	addQuads(queue, "ABABA");
+	queue.endSortGroup();
+	queue.flush();
+	CHECK(backend.m_log == "AA A BB ");
+	queue.setBatchCapacity(0);
+	CHECK(queue.getCommandCount() == 0);
+}
+
+static void testNestedFlush()
+{
+	CCRenderQueue queue;
+	LoggingBackend backend(queue);
+	queue.setBackend(&backend);
+
+	// the quads recorded by a node while it draws are drawn right after it
+	RecordingNode *pTransition = new RecordingNode(queue, "BBC");
+	addQuads(queue, "AA");
+	queue.addNode(pTransition, s_identity, s_identity);
+	addQuads(queue, "A");
+	queue.flush();
+	CHECK(backend.m_log == "AA N BB C A ");
+	CHECK(queue.getCommandCount() == 0);
+
+	// and so are the nodes recorded by those nodes
+	backend.m_log.clear();
+	RecordingNode *pScene = new RecordingNode(queue, "C");
+	queue.addNode(pScene, s_identity, s_identity);
+	queue.flush();
+	CHECK(backend.m_log == "N C ");
+	CHECK(pScene->retainCount() == 1);
+
+	CHECK(queue.getNodesDrawn() == 2 && queue.getDrawCalls() == 5);
+
+	pScene->release();
+	pTransition->release();
+}
+
+int main()
+{
+	for (int i = 0; i < 3; ++i)
+	{
+		s_pTextures[i] = new CCTexture2D();
+	}
+
+	testNullBackend();
+	testSortOrder();
+	testNestedFlush();
+
+	for (int i = 0; i < 3; ++i)
+	{
+		CHECK(s_pTextures[i]->retainCount() == 1);
+		s_pTextures[i]->release();
+	}
+	return checkResults("RenderQueueTest");
+}
@@ -0,0 +1,206 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "HeadlessTest.h"
+#include <Box2D/Box2D.h>
+#include <Box2D/Common/b2ThreadPool.h>
+#include <Box2D/Dynamics/b2WorldSnapshot.h>
+
+static const int32 s_steps = 120;
+
+// bodies in contact, on a chain, and a motor driving a slider through a gear
+static void createScene(b2World& world)
+{
+	b2BodyDef bd;
+	b2Body* ground = world.CreateBody(&bd);
+	{
+		b2Vec2 vs[5];
+		vs[0].Set(-30.0f, 10.0f);
+		vs[1].Set(-20.0f, 0.0f);
+		vs[2].Set(0.0f, -2.0f);
+		vs[3].Set(20.0f, 0.0f);
+		vs[4].Set(30.0f, 10.0f);
+		b2ChainShape shape;
+		shape.CreateChain(vs, 5);
+		ground->CreateFixture(&shape, 0.0f);
+	}
+
+	b2PolygonShape box;
+	box.SetAsBox(0.5f, 0.5f);
+	b2CircleShape circle;
+	circle.m_radius = 0.5f;
+	for (int32 i = 0; i < 5; ++i)
+	{
+		for (int32 j = 0; j < 8; ++j)
+		{
+			b2BodyDef bd;
+			bd.type = b2_dynamicBody;
+			bd.position.Set(-8.0f + 4.0f * i + 0.1f * j, 1.0f + 1.1f * j);
+			b2Body* body = world.CreateBody(&bd);
+
+			b2FixtureDef fd;
+			fd.shape = (i + j) & 1 ? (b2Shape*)&box : (b2Shape*)&circle;
+			fd.density = 1.0f;
+			fd.friction = 0.4f;
+			body->CreateFixture(&fd);
+		}
+	}
+
+	b2PolygonShape plank;
+	plank.SetAsBox(2.0f, 0.25f);
+	bd.type = b2_dynamicBody;
+	bd.position.Set(-14.0f, 12.0f);
+	b2Body* wheel = world.CreateBody(&bd);
+	wheel->CreateFixture(&plank, 2.0f);
+	bd.position.Set(14.0f, 12.0f);
+	b2Body* slider = world.CreateBody(&bd);
+	slider->CreateFixture(&plank, 2.0f);
+
+	b2RevoluteJointDef rjd;
+	rjd.Initialize(ground, wheel, wheel->GetPosition());
+	rjd.enableMotor = true;
+	rjd.motorSpeed = 1.0f;
+	rjd.maxMotorTorque = 500.0f;
+	b2Joint* revolute = world.CreateJoint(&rjd);
+
+	b2PrismaticJointDef pjd;
+	pjd.Initialize(ground, slider, slider->GetPosition(), b2Vec2(1.0f, 0.0f));
+	pjd.enableLimit = true;
+	pjd.lowerTranslation = -4.0f;
+	pjd.upperTranslation = 4.0f;
+	b2Joint* prismatic = world.CreateJoint(&pjd);
+
+	b2GearJointDef gjd;
+	gjd.bodyA = wheel;
+	gjd.bodyB = slider;
+	gjd.joint1 = revolute;
+	gjd.joint2 = prismatic;
+	gjd.ratio = 0.5f;
+	world.CreateJoint(&gjd);
+}
+
+// FNV-1a of the body states
+static uint32 hashBodies(b2World& world)
+{
+	uint32 hash = 2166136261U;
+	for (b2Body* b = world.GetBodyList(); b; b = b->GetNext())
+	{
+		float32 values[6];
+		values[0] = b->GetPosition().x;
+		values[1] = b->GetPosition().y;
+		values[2] = b->GetAngle();
+		values[3] = b->GetLinearVelocity().x;
+		values[4] = b->GetLinearVelocity().y;
+		values[5] = b->GetAngularVelocity();
+
+		const uint8* bytes = (const uint8*)values;
+		for (int32 i = 0; i < int32(sizeof(values)); ++i)
+		{
+			hash = (hash ^ bytes[i]) * 16777619U;
+		}
+	}
+
+	return hash;
+}
+
+static uint32 step(b2World& world, int32 count)
+{
+	for (int32 i = 0; i < count; ++i)
+	{
+		world.Step(1.0f / 60.0f, 8, 3);
+	}
+	return hashBodies(world);
+}
+
+// save, step, restore, step again: both runs must end bit exact
+static void testStepTwice(b2ThreadPool* threadPool)
+{
+	b2World world(b2Vec2(0.0f, -10.0f));
+	world.SetThreadPool(threadPool);
+	createScene(world);
+
+	// bodies resting on each other, with contacts and warm starting impulses
+	step(world, 60);
+	CHECK(world.GetContactCount() > 0);
+
+	b2WorldSnapshot snapshot;
+	world.SaveSnapshot(&snapshot);
+	CHECK(snapshot.GetSize() > 0);
+	uint32 savedHash = hashBodies(world);
+
+	uint32 hash1 = step(world, s_steps);
+	CHECK(hash1 != savedHash);
+
+	CHECK(world.RestoreSnapshot(&snapshot));
+	CHECK(hashBodies(world) == savedHash);
+	uint32 hash2 = step(world, s_steps);
+	CHECK(hash1 == hash2);
+
+	// a snapshot that went through a copy, like a file, restores the same state
+	b2WorldSnapshot copy;
+	copy.SetData(snapshot.GetData(), snapshot.GetSize());
+	CHECK(world.RestoreSnapshot(&copy));
+	CHECK(step(world, s_steps) == hash1);
+
+	// a save of the restored world holds the same data
+	CHECK(world.RestoreSnapshot(&snapshot));
+	b2WorldSnapshot again;
+	world.SaveSnapshot(&again);
+	CHECK(again.GetSize() == snapshot.GetSize());
+	CHECK(memcmp(again.GetData(), snapshot.GetData(), snapshot.GetSize()) == 0);
+
+	world.SetThreadPool(NULL);
+}
+
+static void testEmptySnapshot(void)
+{
+	b2World world(b2Vec2(0.0f, -10.0f));
+	createScene(world);
+	uint32 hash = hashBodies(world);
+
+	b2WorldSnapshot empty;
+	CHECK(empty.GetSize() == 0);
+	CHECK(world.RestoreSnapshot(&empty) == false);
+	CHECK(hashBodies(world) == hash);
+
+	// the first save grows the snapshot from no data
+	b2World emptyWorld(b2Vec2(0.0f, -10.0f));
+	b2WorldSnapshot snapshot;
+	emptyWorld.SaveSnapshot(&snapshot);
+	CHECK(snapshot.GetSize() > 0);
+	CHECK(emptyWorld.RestoreSnapshot(&snapshot));
+	CHECK(emptyWorld.GetBodyCount() == 0);
+}
+
+int main()
+{
+	testStepTwice(NULL);
+
+	b2ThreadPool threadPool(4);
+	testStepTwice(&threadPool);
+
+	testEmptySnapshot();
+
+	return checkResults("SnapshotTest");
+}
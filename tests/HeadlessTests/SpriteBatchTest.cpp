@@ -0,0 +1,208 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "HeadlessTest.h"
+#include "CCRenderQueue.h"
+#include "CCTexture2D.h"
+#include <vector>
+
+using namespace cocos2d;
+
+// a device that only records the draw calls
+class RecordingBackend : public CCRenderBackend
+{
+public:
+	struct DrawCall
+	{
+		CCTexture2D *texture;
+		ccBlendFunc blendFunc;
+		unsigned int quadCount;
+		// x of the top left corner of the first quad
+		float firstX;
+	};
+
+	virtual void drawQuads(const ccRenderCommand& command, const float *projection, const ccV3F_C4B_T2F_Quad *quads)
+	{
+		(void)projection;
+		DrawCall call = { command.texture, command.blendFunc, command.quadCount, quads[0].tl.vertices.x };
+		m_tDrawCalls.push_back(call);
+	}
+
+	virtual void drawNode(const ccRenderCommand& command, const float *view, const float *projection)
+	{
+		(void)command;
+		(void)view;
+		(void)projection;
+	}
+
+	std::vector<DrawCall> m_tDrawCalls;
+};
+
+static const float s_identity[16] = {
+	1, 0, 0, 0,
+	0, 1, 0, 0,
+	0, 0, 1, 0,
+	0, 0, 0, 1,
+};
+
+static const ccBlendFunc s_alphaBlend = { CC_ONE, CC_ONE_MINUS_SRC_ALPHA };
+static const ccBlendFunc s_additiveBlend = { CC_SRC_ALPHA, CC_ONE };
+
+static ccV3F_C4B_T2F_Quad quadAt(float x)
+{
+	ccV3F_C4B_T2F_Quad quad = ccV3F_C4B_T2F_Quad();
+	quad.tl.vertices = vertex3(x, 1, 0);
+	quad.tr.vertices = vertex3(x + 1, 1, 0);
+	quad.br.vertices = vertex3(x + 1, 0, 0);
+	quad.bl.vertices = vertex3(x, 0, 0);
+	return quad;
+}
+
+// draws the sprites of a string, one per character: the letter is the texture, '+' switches to the additive blending
+static void drawSprites(CCRenderQueue& queue, const char *pszSprites, CCTexture2D **pTextures)
+{
+	ccBlendFunc blendFunc = s_alphaBlend;
+	float x = 0;
+	for (const char *p = pszSprites; *p; ++p)
+	{
+		if (*p == '+')
+		{
+			blendFunc = s_additiveBlend;
+			continue;
+		}
+		queue.addQuad(pTextures[*p - 'A'], blendFunc, quadAt(x++), s_identity, s_identity);
+	}
+}
+
+static void testBatchBreaks()
+{
+	CCTexture2D *pTextures[3] = { new CCTexture2D(), new CCTexture2D(), new CCTexture2D() };
+	RecordingBackend backend;
+	CCRenderQueue queue;
+	queue.setBackend(&backend);
+
+	// consecutive sprites with the same texture and blending are one draw call
+	drawSprites(queue, "AAAAAAAAAA", pTextures);
+	CHECK(queue.getCommandCount() == 1);
+	queue.flush();
+	CHECK(backend.m_tDrawCalls.size() == 1 && backend.m_tDrawCalls[0].quadCount == 10);
+	CHECK(queue.getCommandCount() == 0);
+
+	// each texture change breaks the batch, the painter's order is kept
+	backend.m_tDrawCalls.clear();
+	drawSprites(queue, "AABBBAC", pTextures);
+	queue.flush();
+	CHECK(backend.m_tDrawCalls.size() == 4);
+	CHECK(backend.m_tDrawCalls[0].texture == pTextures[0] && backend.m_tDrawCalls[0].quadCount == 2 && backend.m_tDrawCalls[0].firstX == 0);
+	CHECK(backend.m_tDrawCalls[1].texture == pTextures[1] && backend.m_tDrawCalls[1].quadCount == 3 && backend.m_tDrawCalls[1].firstX == 2);
+	CHECK(backend.m_tDrawCalls[2].texture == pTextures[0] && backend.m_tDrawCalls[2].quadCount == 1 && backend.m_tDrawCalls[2].firstX == 5);
+	CHECK(backend.m_tDrawCalls[3].texture == pTextures[2] && backend.m_tDrawCalls[3].quadCount == 1 && backend.m_tDrawCalls[3].firstX == 6);
+
+	// so does a blend function change
+	backend.m_tDrawCalls.clear();
+	drawSprites(queue, "AAA+AA", pTextures);
+	queue.flush();
+	CHECK(backend.m_tDrawCalls.size() == 2);
+	CHECK(backend.m_tDrawCalls[1].blendFunc.src == CC_SRC_ALPHA && backend.m_tDrawCalls[1].quadCount == 2);
+
+	// and a projection change
+	backend.m_tDrawCalls.clear();
+	float projection[16];
+	for (int i = 0; i < 16; ++i)
+	{
+		projection[i] = s_identity[i] * 2;
+	}
+	queue.addQuad(pTextures[0], s_alphaBlend, quadAt(0), s_identity, s_identity);
+	queue.addQuad(pTextures[0], s_alphaBlend, quadAt(1), s_identity, projection);
+	queue.addQuad(pTextures[0], s_alphaBlend, quadAt(2), s_identity, projection);
+	queue.addQuad(pTextures[0], s_alphaBlend, quadAt(3), s_identity, s_identity);
+	queue.flush();
+	CHECK(backend.m_tDrawCalls.size() == 3);
+	CHECK(backend.m_tDrawCalls[1].quadCount == 2);
+
+	// a batch is also broken when it fills the vertex buffer
+	backend.m_tDrawCalls.clear();
+	queue.setBatchCapacity(4);
+	drawSprites(queue, "AAAAAAAAAABB", pTextures);
+	queue.flush();
+	CHECK(backend.m_tDrawCalls.size() == 4);
+	CHECK(backend.m_tDrawCalls[0].quadCount == 4 && backend.m_tDrawCalls[1].quadCount == 4);
+	CHECK(backend.m_tDrawCalls[2].quadCount == 2 && backend.m_tDrawCalls[2].firstX == 8);
+	CHECK(backend.m_tDrawCalls[3].texture == pTextures[1] && backend.m_tDrawCalls[3].quadCount == 2);
+	queue.setBatchCapacity(0);
+
+	CHECK(queue.getDrawCalls() == 1 + 4 + 2 + 3 + 4);
+	CHECK(queue.getQuadsDrawn() == 10 + 7 + 5 + 4 + 12);
+	queue.resetStats();
+	CHECK(queue.getDrawCalls() == 0 && queue.getQuadsDrawn() == 0);
+
+	for (int i = 0; i < 3; ++i)
+	{
+		pTextures[i]->release();
+	}
+}
+
+static void testRecordedQuads()
+{
+	CCTexture2D *pTexture = new CCTexture2D();
+	RecordingBackend backend;
+	CCRenderQueue queue;
+	queue.setBackend(&backend);
+
+	// the quads are stored in view space
+	float view[16];
+	for (int i = 0; i < 16; ++i)
+	{
+		view[i] = s_identity[i];
+	}
+	view[12] = 100;
+	view[13] = 50;
+	queue.addQuad(pTexture, s_alphaBlend, quadAt(0), view, s_identity);
+
+	// the texture is kept until the command is executed
+	CHECK(pTexture->retainCount() == 2);
+	queue.flush();
+	CHECK(pTexture->retainCount() == 1);
+	CHECK(backend.m_tDrawCalls.size() == 1 && backend.m_tDrawCalls[0].firstX == 100);
+
+	// the commands recorded before a backend change go to the previous backend
+	RecordingBackend otherBackend;
+	queue.addQuad(pTexture, s_alphaBlend, quadAt(0), s_identity, s_identity);
+	queue.setBackend(&otherBackend);
+	CHECK(backend.m_tDrawCalls.size() == 2 && otherBackend.m_tDrawCalls.empty());
+
+	// without a backend, the commands are dropped
+	queue.setBackend(NULL);
+	queue.addQuad(pTexture, s_alphaBlend, quadAt(0), s_identity, s_identity);
+	queue.flush();
+	CHECK(queue.getCommandCount() == 0 && pTexture->retainCount() == 1);
+
+	pTexture->release();
+}
+
+int main()
+{
+	testBatchBreaks();
+	testRecordedQuads();
+	return checkResults("SpriteBatchTest");
+}
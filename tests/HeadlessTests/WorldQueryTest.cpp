@@ -0,0 +1,134 @@
+/****************************************************************************
+Copyright (c) 2010-2011 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "HeadlessTest.h"
+#include <Box2D/Box2D.h>
+#include <Box2D/Common/b2ThreadPool.h>
+#include <algorithm>
+#include <vector>
+
+// the fixtures found by each query of a batch
+class BatchCollector : public b2BatchQueryCallback
+{
+public:
+	explicit BatchCollector(int32 count) : m_found(count) {}
+
+	// each query runs on a single thread, so the lists of the queries don't need a lock
+	virtual bool ReportFixture(int32 queryIndex, b2Fixture* fixture, int32 threadIndex)
+	{
+		m_found[queryIndex].push_back(fixture);
+		return true;
+	}
+
+	std::vector< std::vector<b2Fixture*> > m_found;
+};
+
+class Collector : public b2QueryCallback
+{
+public:
+	virtual bool ReportFixture(b2Fixture* fixture)
+	{
+		m_found.push_back(fixture);
+		return true;
+	}
+
+	std::vector<b2Fixture*> m_found;
+};
+
+// compares the batch to one QueryAABB per box, the order of the fixtures doesn't matter
+static bool matchesSingleQueries(const b2World& world, const b2AABB* aabbs, int32 count)
+{
+	BatchCollector batch(count);
+	world.QueryAABBBatch(&batch, aabbs, count);
+
+	int32 found = 0;
+	for (int32 i = 0; i < count; ++i)
+	{
+		Collector single;
+		world.QueryAABB(&single, aabbs[i]);
+
+		std::vector<b2Fixture*>& fixtures = batch.m_found[i];
+		std::sort(fixtures.begin(), fixtures.end());
+		std::sort(single.m_found.begin(), single.m_found.end());
+		if (fixtures != single.m_found)
+		{
+			return false;
+		}
+		found += (int32)fixtures.size();
+	}
+
+	// the boxes overlap the grid, an empty result would hide a broken batch
+	return found > 0;
+}
+
+int main()
+{
+	b2World world(b2Vec2(0.0f, -10.0f));
+
+	// a grid of boxes
+	b2PolygonShape shape;
+	shape.SetAsBox(0.5f, 0.5f);
+	for (int32 i = 0; i < 40; ++i)
+	{
+		for (int32 j = 0; j < 40; ++j)
+		{
+			b2BodyDef bd;
+			bd.type = (i + j) % 3 ? b2_staticBody : b2_dynamicBody;
+			bd.position.Set(1.5f * i, 1.5f * j);
+			world.CreateBody(&bd)->CreateFixture(&shape, 1.0f);
+		}
+	}
+	world.Step(1.0f / 60.0f, 8, 3);
+
+	// boxes of different sizes across the grid, some outside of it
+	const int32 count = 500;
+	std::vector<b2AABB> aabbs(count);
+	for (int32 i = 0; i < count; ++i)
+	{
+		float32 x = (float32)((i * 37) % 70) - 5.0f;
+		float32 y = (float32)((i * 53) % 70) - 5.0f;
+		float32 size = 0.25f + (float32)(i % 7);
+		aabbs[i].lowerBound.Set(x, y);
+		aabbs[i].upperBound.Set(x + size, y + size);
+	}
+
+	// on the calling thread
+	CHECK(matchesSingleQueries(world, &aabbs[0], count));
+	CHECK(matchesSingleQueries(world, &aabbs[10], 1));
+
+	// split across the pool of the world
+	b2ThreadPool threadPool(4);
+	world.SetThreadPool(&threadPool);
+	CHECK(matchesSingleQueries(world, &aabbs[0], count));
+	CHECK(matchesSingleQueries(world, &aabbs[10], 1));
+
+	// an empty batch doesn't call the callback
+	BatchCollector empty(0);
+	world.QueryAABBBatch(&empty, &aabbs[0], 0);
+	CHECK(empty.m_found.empty());
+
+	world.SetThreadPool(NULL);
+
+	return checkResults("WorldQueryTest");
+}
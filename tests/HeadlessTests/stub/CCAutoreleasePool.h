@@ -0,0 +1,46 @@
+/* CCAutoreleasePool.h for the headless tests: one pool, the tests pop it to release the autoreleased objects */
+#ifndef __AUTORELEASEPOOL_H__
+#define __AUTORELEASEPOOL_H__
+
+#include "CCObject.h"
+#include <algorithm>
+#include <vector>
+
+NS_CC_BEGIN;
+
+class CC_DLL CCPoolManager
+{
+public:
+	static CCPoolManager* getInstance()
+	{
+		static CCPoolManager s_manager;
+		return &s_manager;
+	}
+
+	void addObject(CCObject* pObject)
+	{
+		m_tObjects.push_back(pObject);
+	}
+
+	void removeObject(CCObject* pObject)
+	{
+		m_tObjects.erase(std::remove(m_tObjects.begin(), m_tObjects.end(), pObject), m_tObjects.end());
+	}
+
+	void pop()
+	{
+		std::vector<CCObject*> objects;
+		objects.swap(m_tObjects);
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			objects[i]->release();
+		}
+	}
+
+private:
+	std::vector<CCObject*> m_tObjects;
+};
+
+NS_CC_END;
+
+#endif // __AUTORELEASEPOOL_H__
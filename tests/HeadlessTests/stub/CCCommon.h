@@ -0,0 +1,14 @@
+/* CCCommon.h for the headless tests: the declarations of the engine headers, without the platform */
+#ifndef __CC_COMMON_H__
+#define __CC_COMMON_H__
+
+#include "CCPlatformMacros.h"
+#include <string>
+
+NS_CC_BEGIN;
+
+void CC_DLL CCLog(const char * pszFormat, ...);
+
+NS_CC_END;
+
+#endif // __CC_COMMON_H__
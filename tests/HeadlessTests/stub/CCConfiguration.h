@@ -0,0 +1,23 @@
+/* CCConfiguration.h for the headless tests: the limits of a Direct3D feature level 9.3 device */
+#ifndef __CCCONFIGURATION_H__
+#define __CCCONFIGURATION_H__
+
+#include "CCCommon.h"
+
+NS_CC_BEGIN;
+
+class CC_DLL CCConfiguration
+{
+public:
+	inline int getMaxTextureSize(void) { return 4096; }
+
+	static CCConfiguration *sharedConfiguration(void)
+	{
+		static CCConfiguration s_configuration;
+		return &s_configuration;
+	}
+};
+
+NS_CC_END;
+
+#endif // __CCCONFIGURATION_H__
@@ -0,0 +1,63 @@
+/* CCFileUtils.h for the headless tests: the paths are used as they are and the files are read with stdio */
+#ifndef __CC_FILEUTILS_PLATFORM_H__
+#define __CC_FILEUTILS_PLATFORM_H__
+
+#include "CCCommon.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+NS_CC_BEGIN;
+
+class CC_DLL CCFileUtils
+{
+public:
+	static const char* fullPathFromRelativePath(const char *pszRelativePath)
+	{
+		return pszRelativePath;
+	}
+
+	// the file next to pszRelativeFile
+	static const char* fullPathFromRelativeFile(const char *pszFilename, const char *pszRelativeFile)
+	{
+		static std::string s_path;
+		s_path = pszRelativeFile;
+		s_path = s_path.substr(0, s_path.find_last_of("/\\") + 1) + pszFilename;
+		return s_path.c_str();
+	}
+};
+
+class CCFileData
+{
+public:
+	CCFileData(const char* pszFileName, const char* pszMode)
+		: m_pBuffer(0)
+		, m_uSize(0)
+	{
+		FILE *fp = fopen(pszFileName, pszMode);
+		if (fp)
+		{
+			fseek(fp, 0, SEEK_END);
+			long nSize = ftell(fp);
+			fseek(fp, 0, SEEK_SET);
+			m_pBuffer = (unsigned char*)malloc(nSize > 0 ? nSize : 1);
+			m_uSize = (unsigned long)fread(m_pBuffer, 1, nSize > 0 ? nSize : 0, fp);
+			fclose(fp);
+		}
+	}
+	~CCFileData()
+	{
+		free(m_pBuffer);
+	}
+
+	unsigned char* getBuffer() { return m_pBuffer; }
+	unsigned long getSize() { return m_uSize; }
+
+private:
+	unsigned char *m_pBuffer;
+	unsigned long m_uSize;
+};
+
+NS_CC_END;
+
+#endif // __CC_FILEUTILS_PLATFORM_H__
@@ -0,0 +1,25 @@
+/* CCFrameProfiler for the headless tests: never created, so the CCProfileScope of the engine sources record nothing */
+#include "CCProfiling.h"
+
+NS_CC_BEGIN;
+
+CCFrameProfiler *CCFrameProfiler::s_pSharedFrameProfiler = NULL;
+
+CCFrameProfiler* CCFrameProfiler::sharedFrameProfiler(void)
+{
+	return s_pSharedFrameProfiler;
+}
+
+double CCFrameProfiler::beginPhase(ccProfilePhase ePhase)
+{
+	(void)ePhase;
+	return -1;
+}
+
+void CCFrameProfiler::endPhase(ccProfilePhase ePhase, double dStartTime)
+{
+	(void)ePhase;
+	(void)dStartTime;
+}
+
+NS_CC_END;
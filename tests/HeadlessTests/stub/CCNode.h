@@ -0,0 +1,17 @@
+/* CCNode.h for the headless tests: a node is only an object the render commands draw */
+#ifndef __PLATFOMR_CCNODE_H__
+#define __PLATFOMR_CCNODE_H__
+
+#include "CCObject.h"
+
+NS_CC_BEGIN;
+
+class CC_DLL CCNode : public CCObject
+{
+public:
+	virtual void draw(void) {}
+};
+
+NS_CC_END;
+
+#endif // __PLATFOMR_CCNODE_H__
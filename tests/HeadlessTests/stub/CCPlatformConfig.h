@@ -0,0 +1,8 @@
+/* CCPlatformConfig.h for the headless tests: no target platform */
+#ifndef __CC_PLATFORM_CONFIG_H__
+#define __CC_PLATFORM_CONFIG_H__
+
+#define CC_PLATFORM_UNKNOWN            0
+#define CC_TARGET_PLATFORM             CC_PLATFORM_UNKNOWN
+
+#endif // __CC_PLATFORM_CONFIG_H__
@@ -0,0 +1,25 @@
+/* CCPlatformMacros.h for building the engine sources of the headless tests, on any platform */
+#ifndef __CC_PLATFORM_MACROS_H__
+#define __CC_PLATFORM_MACROS_H__
+
+#include <assert.h>
+#include <stddef.h>
+
+#define CC_DLL
+
+#define NS_CC_BEGIN namespace cocos2d {
+#define NS_CC_END }
+#define USING_NS_CC using namespace cocos2d
+
+#define CC_ASSERT(cond) assert(cond)
+
+#define CC_SAFE_DELETE(p)			if(p) { delete (p); (p) = 0; }
+#define CC_SAFE_DELETE_ARRAY(p)		if(p) { delete[] (p); (p) = 0; }
+#define CC_SAFE_FREE(p)				if(p) { free(p); (p) = 0; }
+#define CC_SAFE_RELEASE(p)			if(p) { (p)->release(); }
+#define CC_SAFE_RELEASE_NULL(p)		if(p) { (p)->release(); (p) = 0; }
+#define CC_SAFE_RETAIN(p)			if(p) { (p)->retain(); }
+#define CC_BREAK_IF(cond)			if(cond) break;
+#define CC_UNUSED_PARAM(unusedparam)	(void)unusedparam
+
+#endif // __CC_PLATFORM_MACROS_H__
@@ -0,0 +1,15 @@
+/* CCTexture2D.h for the headless tests: a texture is only an object the commands refer to */
+#ifndef __CCTEXTURE2D_H__
+#define __CCTEXTURE2D_H__
+
+#include "CCObject.h"
+
+NS_CC_BEGIN;
+
+class CC_DLL CCTexture2D : public CCObject
+{
+};
+
+NS_CC_END;
+
+#endif // __CCTEXTURE2D_H__
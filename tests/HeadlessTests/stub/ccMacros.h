@@ -0,0 +1,19 @@
+/* ccMacros.h for the headless tests */
+#ifndef __CCMACROS_H__
+#define __CCMACROS_H__
+
+#include "CCCommon.h"
+#include "platform/CCGL.h"
+
+#define CCAssert(cond, msg) CC_ASSERT(cond)
+#define CCLOG(...) do {} while (0)
+#define CCLOGINFO(...) do {} while (0)
+
+// of CCStdC.h
+#define MIN(x,y) (((x) > (y)) ? (y) : (x))
+#define MAX(x,y) (((x) < (y)) ? (y) : (x))
+
+#define CC_BLEND_SRC CC_ONE
+#define CC_BLEND_DST CC_ONE_MINUS_SRC_ALPHA
+
+#endif // __CCMACROS_H__
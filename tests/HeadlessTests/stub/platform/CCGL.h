@@ -0,0 +1,24 @@
+/* platform/CCGL.h for the headless tests: the types of the Direct3D port, without a device */
+#ifndef __PLATFOMR_CCCC_H__
+#define __PLATFOMR_CCCC_H__
+
+#include "CCCommon.h"
+
+typedef unsigned int CCenum;
+typedef unsigned char CCboolean;
+typedef unsigned int CCbitfield;
+typedef signed char CCbyte;
+typedef short CCshort;
+typedef int CCint;
+typedef int CCsizei;
+typedef unsigned char CCubyte;
+typedef unsigned short CCushort;
+typedef unsigned int CCuint;
+typedef float CCfloat;
+
+#define CC_ZERO                           0
+#define CC_ONE                            1
+#define CC_SRC_ALPHA                      0x0302
+#define CC_ONE_MINUS_SRC_ALPHA            0x0303
+
+#endif // __PLATFOMR_CCCC_H__
@@ -29,6 +29,10 @@ Box2DTestLayer::Box2DTestLayer()
 	world->SetAllowSleeping(doSleep);
 	world->SetContinuousPhysics(true);
 
+	// Steps the world at 60 Hz and moves the sprites of the bodies.
+	m_pPhysics = CCPhysicsNode::nodeWithWorld(world, PTM_RATIO);
+	addChild(m_pPhysics);
+
 /*	
 	m_debugDraw = new GLESDebugDraw( PTM_RATIO );
 	world->SetDebugDraw(m_debugDraw);
@@ -79,8 +83,6 @@ Box2DTestLayer::Box2DTestLayer()
 	addChild(label, 0);
 	label->setColor( ccc3(0,0,255) );
 	label->setPosition( CCPointMake( screenSize.width/2, screenSize.height-50) );
-	
-	scheduleUpdate();
 }
 
 Box2DTestLayer::~Box2DTestLayer()
@@ -140,35 +142,11 @@ void Box2DTestLayer::addNewSpriteWithCoords(CCPoint p)
 	fixtureDef.density = 1.0f;
 	fixtureDef.friction = 0.3f;
 	body->CreateFixture(&fixtureDef);
-}
 
-
-void Box2DTestLayer::update(ccTime dt)
-{
-	//It is recommended that a fixed time step is used with Box2D for stability
-	//of the simulation, however, we are using a variable time step here.
-	//You need to make an informed choice, the following URL is useful
-	//http://gafferongames.com/game-physics/fix-your-timestep/
-	
-	int velocityIterations = 8;
-	int positionIterations = 1;
-
-	// Instruct the world to perform a single step of simulation. It is
-	// generally best to keep the time step and iterations fixed.
-	world->Step(dt, velocityIterations, positionIterations);
-	
-	//Iterate over the bodies in the physics world
-	for (b2Body* b = world->GetBodyList(); b; b = b->GetNext())
-	{
-		if (b->GetUserData() != NULL) {
-			//Synchronize the AtlasSprites position and rotation with the corresponding body
-			CCSprite* myActor = (CCSprite*)b->GetUserData();
-			myActor->setPosition( CCPointMake( b->GetPosition().x * PTM_RATIO, b->GetPosition().y * PTM_RATIO) );
-			myActor->setRotation( -1 * CC_RADIANS_TO_DEGREES(b->GetAngle()) );
-		}	
-	}
+	m_pPhysics->bindSprite(sprite, body);
 }
 
+
 void Box2DTestLayer::ccTouchesEnded(CCSet* touches, CCEvent* event)
 {
 	//Add a new body/atlas sprite at the touched location
@@ -3,11 +3,13 @@
 
 #include "cocos2d.h"
 #include "Box2D/Box2D.h"
+#include "CCPhysicsNode.h"
 #include "../testBasic.h"
 
 class Box2DTestLayer : public CCLayer
 {
 	b2World* world;
+	CCPhysicsNode* m_pPhysics;
 	//GLESDebugDraw *m_debugDraw;
 
 public:
@@ -17,7 +19,6 @@ public:
 	virtual void draw();
 
 	void addNewSpriteWithCoords(CCPoint p);
-	void update(ccTime dt);
 	virtual void ccTouchesEnded(CCSet* touches, CCEvent* event);
 
 	//CREATE_NODE(Box2DTestLayer);
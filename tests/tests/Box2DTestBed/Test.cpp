@@ -320,6 +320,14 @@ void Test::Step(Settings* settings)
 		float32 quality = m_world->GetTreeQuality();
 		m_debugDraw.DrawString(5, m_textLine, "proxies/height/balance/quality = %d/%d/%d/%g", proxyCount, height, balance, quality);
 		m_textLine += 15;
+
+		b2BlockAllocatorStats blockStats;
+		b2StackAllocatorStats stackStats;
+		m_world->GetBlockAllocatorStats(&blockStats);
+		m_world->GetStackAllocatorStats(&stackStats);
+		m_debugDraw.DrawString(5, m_textLine, "block/stack memory = %d/%d KB, max = %d/%d KB",
+			blockStats.liveBytes / 1024, stackStats.liveBytes / 1024, blockStats.maxLiveBytes / 1024, stackStats.maxLiveBytes / 1024);
+		m_textLine += 15;
 	}
 
 	// Track maximum profile times
@@ -50,6 +50,7 @@ using namespace std;
 #include "Tests/Prismatic.h"
 #include "Tests/Pulleys.h"
 #include "Tests/Pyramid.h"
+#include "Tests/Pyramids.h"
 #include "Tests/RayCast.h"
 #include "Tests/Revolute.h"
 //#include "Tests/Rope.h"
@@ -57,6 +58,7 @@ using namespace std;
 #include "Tests/SensorTest.h"
 #include "Tests/ShapeEditing.h"
 #include "Tests/SliderCrank.h"
+#include "Tests/Snapshot.h"
 #include "Tests/SphereStack.h"
 #include "Tests/TheoJansen.h"
 #include "Tests/Tiles.h"
@@ -71,6 +73,7 @@ TestEntry g_testEntries[] =
 {
 	{"Tumbler", Tumbler::Create},
 	{"Tiles", Tiles::Create},
+	{"Snapshot", Snapshot::Create},
 	{"Dump Shell", DumpShell::Create},
 	{"Gears", Gears::Create},
 	{"Cantilever", Cantilever::Create},
@@ -98,6 +101,7 @@ TestEntry g_testEntries[] =
 	{"Ray-Cast", RayCast::Create},
 	{"Confined", Confined::Create},
 	{"Pyramid", Pyramid::Create},
+	{"Pyramids", Pyramids::Create},
 	{"Theo Jansen's Walker", TheoJansen::Create},
 	{"Edge Shapes", EdgeShapes::Create},
 	{"PolyCollision", PolyCollision::Create},
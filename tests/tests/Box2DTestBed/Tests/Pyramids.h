@@ -0,0 +1,122 @@
+/*
+* Copyright (c) 2006-2011 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef PYRAMIDS_H
+#define PYRAMIDS_H
+
+/// Separate pyramids on a shared ground, each one is an island. This benchmarks
+/// solving the islands on a thread pool. Press 't' to switch the pool on and off
+/// and 'w' to switch the wide contact solver on and off.
+class Pyramids : public Test
+{
+public:
+	enum
+	{
+		e_pyramidCount = 16,
+		e_count = 12
+	};
+
+	Pyramids()
+	{
+		{
+			b2BodyDef bd;
+			b2Body* ground = m_world->CreateBody(&bd);
+
+			b2EdgeShape shape;
+			shape.Set(b2Vec2(-200.0f, 0.0f), b2Vec2(200.0f, 0.0f));
+			ground->CreateFixture(&shape, 0.0f);
+		}
+
+		{
+			float32 a = 0.5f;
+			b2PolygonShape shape;
+			shape.SetAsBox(a, a);
+
+			for (int32 k = 0; k < e_pyramidCount; ++k)
+			{
+				b2Vec2 x(-150.0f + k * (e_count * 1.125f + 4.0f), 0.75f);
+				b2Vec2 y;
+				b2Vec2 deltaX(0.5625f, 1.25f);
+				b2Vec2 deltaY(1.125f, 0.0f);
+
+				for (int32 i = 0; i < e_count; ++i)
+				{
+					y = x;
+
+					for (int32 j = i; j < e_count; ++j)
+					{
+						b2BodyDef bd;
+						bd.type = b2_dynamicBody;
+						bd.position = y;
+						b2Body* body = m_world->CreateBody(&bd);
+						body->CreateFixture(&shape, 5.0f);
+
+						y += deltaY;
+					}
+
+					x += deltaX;
+				}
+			}
+		}
+
+		m_threadPool = new b2ThreadPool;
+		m_world->SetThreadPool(m_threadPool);
+	}
+
+	~Pyramids()
+	{
+		m_world->SetThreadPool(NULL);
+		delete m_threadPool;
+	}
+
+	void Keyboard(unsigned char key)
+	{
+		switch (key)
+		{
+		case 't':
+			m_world->SetThreadPool(m_world->GetThreadPool() ? NULL : m_threadPool);
+			break;
+
+		case 'w':
+			m_world->SetWideContactSolver(!m_world->GetWideContactSolver());
+			break;
+		}
+	}
+
+	void Step(Settings* settings)
+	{
+		Test::Step(settings);
+
+		int32 threadCount = m_world->GetThreadPool() ? m_threadPool->GetThreadCount() : 1;
+		m_debugDraw.DrawString(5, m_textLine, "Press 't' to toggle the thread pool. threads = %d, solve = %5.2f ms",
+			threadCount, m_world->GetProfile().solve);
+		m_textLine += 15;
+		m_debugDraw.DrawString(5, m_textLine, "Press 'w' to toggle the wide contact solver. wide = %d",
+			m_world->GetWideContactSolver());
+		m_textLine += 15;
+	}
+
+	static Test* Create()
+	{
+		return new Pyramids;
+	}
+
+	b2ThreadPool* m_threadPool;
+};
+
+#endif
@@ -0,0 +1,269 @@
+/*
+* Copyright (c) 2006-2011 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+/// This tests world snapshots. A restored world must step exactly like the
+/// world it was saved from.
+class Snapshot : public Test
+{
+public:
+	enum
+	{
+		e_columnCount = 5,
+		e_rowCount = 8,
+		e_verifySteps = 120
+	};
+
+	Snapshot()
+	{
+		b2Body* ground = NULL;
+		{
+			b2BodyDef bd;
+			ground = m_world->CreateBody(&bd);
+
+			b2Vec2 vs[5];
+			vs[0].Set(-30.0f, 10.0f);
+			vs[1].Set(-20.0f, 0.0f);
+			vs[2].Set(0.0f, -2.0f);
+			vs[3].Set(20.0f, 0.0f);
+			vs[4].Set(30.0f, 10.0f);
+			b2ChainShape shape;
+			shape.CreateChain(vs, 5);
+			ground->CreateFixture(&shape, 0.0f);
+		}
+
+		{
+			b2PolygonShape box;
+			box.SetAsBox(0.5f, 0.5f);
+
+			b2CircleShape circle;
+			circle.m_radius = 0.5f;
+
+			for (int32 i = 0; i < e_columnCount; ++i)
+			{
+				for (int32 j = 0; j < e_rowCount; ++j)
+				{
+					b2BodyDef bd;
+					bd.type = b2_dynamicBody;
+					bd.position.Set(-8.0f + 4.0f * i + 0.1f * j, 1.0f + 1.1f * j);
+					b2Body* body = m_world->CreateBody(&bd);
+
+					b2FixtureDef fd;
+					fd.shape = (i + j) & 1 ? (b2Shape*)&box : (b2Shape*)&circle;
+					fd.density = 1.0f;
+					fd.friction = 0.4f;
+					body->CreateFixture(&fd);
+				}
+			}
+		}
+
+		// A motor driving a slider through a gear.
+		{
+			b2PolygonShape box;
+			box.SetAsBox(2.0f, 0.25f);
+
+			b2BodyDef bd;
+			bd.type = b2_dynamicBody;
+			bd.position.Set(-14.0f, 12.0f);
+			b2Body* wheel = m_world->CreateBody(&bd);
+			wheel->CreateFixture(&box, 2.0f);
+
+			bd.position.Set(14.0f, 12.0f);
+			b2Body* slider = m_world->CreateBody(&bd);
+			slider->CreateFixture(&box, 2.0f);
+
+			b2RevoluteJointDef rjd;
+			rjd.Initialize(ground, wheel, wheel->GetPosition());
+			rjd.enableMotor = true;
+			rjd.motorSpeed = 1.0f;
+			rjd.maxMotorTorque = 500.0f;
+			b2Joint* revolute = m_world->CreateJoint(&rjd);
+
+			b2PrismaticJointDef pjd;
+			pjd.Initialize(ground, slider, slider->GetPosition(), b2Vec2(1.0f, 0.0f));
+			pjd.enableLimit = true;
+			pjd.lowerTranslation = -4.0f;
+			pjd.upperTranslation = 4.0f;
+			b2Joint* prismatic = m_world->CreateJoint(&pjd);
+
+			b2GearJointDef gjd;
+			gjd.bodyA = wheel;
+			gjd.bodyB = slider;
+			gjd.joint1 = revolute;
+			gjd.joint2 = prismatic;
+			gjd.ratio = 0.5f;
+			m_world->CreateJoint(&gjd);
+		}
+
+		m_saved = false;
+		m_verified = false;
+		m_exact = false;
+		m_saveTime = 0.0f;
+		m_restoreTime = 0.0f;
+	}
+
+	// Compute a hash of the body states.
+	uint32 Hash()
+	{
+		uint32 hash = 2166136261U;
+		for (b2Body* b = m_world->GetBodyList(); b; b = b->GetNext())
+		{
+			float32 values[6];
+			values[0] = b->GetPosition().x;
+			values[1] = b->GetPosition().y;
+			values[2] = b->GetAngle();
+			values[3] = b->GetLinearVelocity().x;
+			values[4] = b->GetLinearVelocity().y;
+			values[5] = b->GetAngularVelocity();
+
+			const uint8* bytes = (const uint8*)values;
+			for (int32 i = 0; i < int32(sizeof(values)); ++i)
+			{
+				hash = (hash ^ bytes[i]) * 16777619U;
+			}
+		}
+
+		return hash;
+	}
+
+	void Save()
+	{
+		if (m_mouseJoint != NULL)
+		{
+			return;
+		}
+
+		b2Timer timer;
+		m_world->SaveSnapshot(&m_snapshot);
+		m_saveTime = timer.GetMilliseconds();
+		m_saved = true;
+	}
+
+	void Restore()
+	{
+		if (m_saved == false)
+		{
+			return;
+		}
+
+		// Restoring replaces every body and joint.
+		if (m_mouseJoint != NULL)
+		{
+			m_world->DestroyJoint(m_mouseJoint);
+			m_mouseJoint = NULL;
+		}
+		m_bomb = NULL;
+
+		b2Timer timer;
+		m_world->RestoreSnapshot(&m_snapshot);
+		m_restoreTime = timer.GetMilliseconds();
+
+		// The ground body of the test was created first, so it is the last one.
+		b2Body* body = m_world->GetBodyList();
+		while (body->GetNext())
+		{
+			body = body->GetNext();
+		}
+		m_groundBody = body;
+	}
+
+	// Step from the saved state twice and compare.
+	void Verify()
+	{
+		Save();
+		if (m_saved == false)
+		{
+			return;
+		}
+
+		for (int32 i = 0; i < e_verifySteps; ++i)
+		{
+			m_world->Step(1.0f / 60.0f, 8, 3);
+		}
+		uint32 hash1 = Hash();
+
+		Restore();
+
+		for (int32 i = 0; i < e_verifySteps; ++i)
+		{
+			m_world->Step(1.0f / 60.0f, 8, 3);
+		}
+		uint32 hash2 = Hash();
+
+		Restore();
+
+		m_verified = true;
+		m_exact = hash1 == hash2;
+	}
+
+	void Keyboard(unsigned char key)
+	{
+		switch (key)
+		{
+		case 's':
+			Save();
+			break;
+
+		case 'l':
+			Restore();
+			break;
+
+		case 'v':
+			Verify();
+			break;
+		}
+	}
+
+	void Step(Settings* settings)
+	{
+		Test::Step(settings);
+
+		m_debugDraw.DrawString(5, m_textLine, "Keys: (s) save, (l) restore, (v) verify");
+		m_textLine += 15;
+
+		if (m_saved)
+		{
+			m_debugDraw.DrawString(5, m_textLine, "snapshot size = %d bytes, save = %6.2f ms, restore = %6.2f ms",
+				m_snapshot.GetSize(), m_saveTime, m_restoreTime);
+			m_textLine += 15;
+		}
+
+		if (m_verified)
+		{
+			m_debugDraw.DrawString(5, m_textLine, "%d steps after restore: %s", int32(e_verifySteps),
+				m_exact ? "bit exact" : "DIFFERENT");
+			m_textLine += 15;
+		}
+	}
+
+	static Test* Create()
+	{
+		return new Snapshot;
+	}
+
+	b2WorldSnapshot m_snapshot;
+	bool m_saved;
+	bool m_verified;
+	bool m_exact;
+	float32 m_saveTime;
+	float32 m_restoreTime;
+};
+
+#endif
@@ -32,6 +32,9 @@ public:
 	Tiles()
 	{
 		m_fixtureCount = 0;
+		m_rebuildTime = 0.0f;
+		m_qualityBefore = 0.0f;
+		m_depthBefore = 0.0f;
 		b2Timer timer;
 
 		{
@@ -120,6 +123,26 @@ public:
 		m_createTime = timer.GetMilliseconds();
 	}
 
+	void Keyboard(unsigned char key)
+	{
+		switch (key)
+		{
+		case 'r':
+			{
+				m_qualityBefore = m_world->GetTreeQuality();
+				m_depthBefore = m_world->GetTreeAverageDepth();
+				b2Timer timer;
+				m_world->RebuildTree();
+				m_rebuildTime = timer.GetMilliseconds();
+			}
+			break;
+
+		case 'f':
+			m_world->SetTreeRefit(!m_world->GetTreeRefit());
+			break;
+		}
+	}
+
 	void Step(Settings* settings)
 	{
 		const b2ContactManager& cm = m_world->GetContactManager();
@@ -129,19 +152,25 @@ public:
 		float32 minimumHeight = ceilf(logf(float32(minimumNodeCount)) / logf(2.0f));
 		m_debugDraw.DrawString(5, m_textLine, "dynamic tree height = %d, min = %d", height, int32(minimumHeight));
 		m_textLine += 15;
+		m_debugDraw.DrawString(5, m_textLine, "tree quality = %.2f, average depth = %.2f",
+			m_world->GetTreeQuality(), m_world->GetTreeAverageDepth());
+		m_textLine += 15;
+		m_debugDraw.DrawString(5, m_textLine, "Press 'r' to rebuild the tree, rebuild time = %6.2f ms", m_rebuildTime);
+		m_textLine += 15;
+		if (m_rebuildTime > 0.0f)
+		{
+			m_debugDraw.DrawString(5, m_textLine, "before the rebuild: tree quality = %.2f, average depth = %.2f",
+				m_qualityBefore, m_depthBefore);
+			m_textLine += 15;
+		}
+		m_debugDraw.DrawString(5, m_textLine, "Press 'f' to toggle the tree refit, refit = %d", m_world->GetTreeRefit());
+		m_textLine += 15;
 
 		Test::Step(settings);
 
 		m_debugDraw.DrawString(5, m_textLine, "create time = %6.2f ms, fixture count = %d",
 			m_createTime, m_fixtureCount);
 		m_textLine += 15;
-
-		//b2DynamicTree* tree = &m_world->m_contactManager.m_broadPhase.m_tree;
-
-		//if (m_stepCount == 400)
-		//{
-		//	tree->RebuildBottomUp();
-		//}
 	}
 
 	static Test* Create()
@@ -151,6 +180,9 @@ public:
 
 	int32 m_fixtureCount;
 	float32 m_createTime;
+	float32 m_rebuildTime;
+	float32 m_qualityBefore;
+	float32 m_depthBefore;
 };
 
 #endif
@@ -456,6 +456,8 @@ Atlas4::Atlas4()
 
 	// Upper Label
 	CCLabelBMFont *label = CCLabelBMFont::labelWithString("Bitmap Font Atlas", "fonts/bitmapFontTest.fnt");
+	// the characters are animated one by one
+	label->setIsUsingCharSprites(true);
 	addChild(label);
 	
 	CCSize s = CCDirector::sharedDirector()->getWinSize();
@@ -493,6 +495,7 @@ Atlas4::Atlas4()
 	
 	// Bottom Label
 	CCLabelBMFont *label2 = CCLabelBMFont::labelWithString("00.0", "fonts/bitmapFontTest.fnt");
+	label2->setIsUsingCharSprites(true);
 	addChild(label2, 0, kTagBitmapAtlas2);
 	label2->setPosition( ccp(s.width/2.0f, 80) );
 	
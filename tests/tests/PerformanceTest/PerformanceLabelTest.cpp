@@ -0,0 +1,169 @@
+#include "PerformanceLabelTest.h"
+
+enum
+{
+    TEST_COUNT = 1,
+    kLabelUpdateRepeat = 1000,
+    kFontLoadRepeat = 20,
+};
+
+static float millisecondsSince(struct timeval *lastUpdate)
+{
+    struct timeval now;
+
+    gettimeofday( &now, NULL);
+
+    return (now.tv_sec - lastUpdate->tv_sec) * 1000.0f + (now.tv_usec - lastUpdate->tv_usec) / 1000.0f;
+}
+
+////////////////////////////////////////////////////////
+//
+// LabelUpdateTest
+//
+////////////////////////////////////////////////////////
+void LabelUpdateTest::showCurrentTest()
+{
+    CCScene* pScene = LabelUpdateTest::scene();
+
+    if (pScene)
+    {
+        CCDirector::sharedDirector()->replaceScene(pScene);
+    }
+}
+
+void LabelUpdateTest::onEnter()
+{
+    PerformBasicLayer::onEnter();
+
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+
+    // Title
+    CCLabelTTF *label = CCLabelTTF::labelWithString(title().c_str(), "Arial", 40);
+    addChild(label, 1);
+    label->setPosition(ccp(s.width/2, s.height-32));
+    label->setColor(ccc3(255,255,40));
+
+    // Subtitle
+    CCLabelTTF *l = CCLabelTTF::labelWithString(subtitle().c_str(), "Thonburi", 16);
+    addChild(l, 1);
+    l->setPosition(ccp(s.width/2, s.height-80));
+
+    performTests();
+}
+
+void LabelUpdateTest::performTests()
+{
+    struct timeval now;
+    char text[64];
+
+    CCLog("\n\n--------\n\n");
+    CCLog("--- CCLabelBMFont setString, %d updates ---\n", (int)kLabelUpdateRepeat);
+
+    for (int charSprites = 0; charSprites < 2; ++charSprites)
+    {
+        CCLabelBMFont *pLabel = CCLabelBMFont::labelWithString("Score: 0", "fonts/bitmapFontTest.fnt");
+        pLabel->setIsUsingCharSprites(charSprites != 0);
+
+        // a score counter, only the last characters change
+        gettimeofday(&now, NULL);
+        for (int i = 0; i < kLabelUpdateRepeat; ++i)
+        {
+            sprintf(text, "Score: %d", i * 7);
+            pLabel->setString(text);
+        }
+        float scoreMs = millisecondsSince(&now);
+
+        // a chat line, the whole string changes
+        gettimeofday(&now, NULL);
+        for (int i = 0; i < kLabelUpdateRepeat; ++i)
+        {
+            sprintf(text, "%s message number %d is here", (i & 1) ? "Another" : "A", i);
+            pLabel->setString(text);
+        }
+        float chatMs = millisecondsSince(&now);
+
+        CCLog("%s  score ms:%f  chat ms:%f\n", charSprites ? "char sprites" : "glyph quads", scoreMs, chatMs);
+    }
+
+    CCLog("--- CCLabelTTF setString, %d updates ---\n", (int)kLabelUpdateRepeat);
+
+    for (int glyphCache = 1; glyphCache >= 0; --glyphCache)
+    {
+        CCLabelTTF *pLabel = CCLabelTTF::labelWithString("Time: 0", "Arial", 24);
+        pLabel->setIsUsingGlyphCache(glyphCache != 0);
+
+        // a timer, the digits are drawn once by the glyph cache
+        gettimeofday(&now, NULL);
+        for (int i = 0; i < kLabelUpdateRepeat; ++i)
+        {
+            sprintf(text, "Time: %d.%02d", i / 100, i % 100);
+            pLabel->setString(text);
+        }
+        float timerMs = millisecondsSince(&now);
+
+        CCLog("%s  timer ms:%f\n", glyphCache ? "glyph cache" : "string textures", timerMs);
+    }
+
+    CCGlyphAtlas *pAtlas = CCGlyphCache::sharedGlyphCache()->getAtlas();
+    CCLog("glyph cache: %u glyphs, %u drawn, %u shelves emptied\n",
+        pAtlas->getGlyphCount(), pAtlas->getRasterizedCount(), pAtlas->getEvictedShelfCount());
+
+    // parsing the .fnt files, then finding them in the cache
+    const char *fontFiles[] = {
+        "fonts/bitmapFontTest.fnt", "fonts/bitmapFontTest2.fnt", "fonts/futura-48.fnt",
+        "fonts/arial16.fnt", "fonts/konqa32.fnt",
+    };
+    const int fontFileCount = sizeof(fontFiles) / sizeof(fontFiles[0]);
+
+    CCLog("--- .fnt loading, %d times %d files ---\n", (int)kFontLoadRepeat, fontFileCount);
+
+    float parseMs = 0;
+    for (int i = 0; i < kFontLoadRepeat; ++i)
+    {
+        FNTConfigRemoveCache();
+        gettimeofday(&now, NULL);
+        for (int j = 0; j < fontFileCount; ++j)
+        {
+            FNTConfigLoadFile(fontFiles[j]);
+        }
+        parseMs += millisecondsSince(&now);
+    }
+
+    gettimeofday(&now, NULL);
+    for (int i = 0; i < kFontLoadRepeat; ++i)
+    {
+        for (int j = 0; j < fontFileCount; ++j)
+        {
+            FNTConfigLoadFile(fontFiles[j]);
+        }
+    }
+    float cachedMs = millisecondsSince(&now);
+
+    CCLog("parse ms:%f  cached ms:%f\n", parseMs, cachedMs);
+}
+
+std::string LabelUpdateTest::title()
+{
+    return "Label Performance Test";
+}
+
+std::string LabelUpdateTest::subtitle()
+{
+    return "See console for results";
+}
+
+CCScene* LabelUpdateTest::scene()
+{
+    CCScene *pScene = CCScene::node();
+    LabelUpdateTest *layer = new LabelUpdateTest(false, TEST_COUNT, 0);
+    pScene->addChild(layer);
+    layer->release();
+
+    return pScene;
+}
+
+void runLabelTest()
+{
+    CCScene* pScene = LabelUpdateTest::scene();
+    CCDirector::sharedDirector()->replaceScene(pScene);
+}
@@ -0,0 +1,25 @@
+#ifndef __PERFORMANCE_LABEL_TEST_H__
+#define __PERFORMANCE_LABEL_TEST_H__
+
+#include "PerformanceTest.h"
+
+class LabelUpdateTest : public PerformBasicLayer
+{
+public:
+    LabelUpdateTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void showCurrentTest();
+    virtual void onEnter();
+    virtual std::string title();
+    virtual std::string subtitle();
+    void performTests();
+
+    static CCScene* scene();
+};
+
+void runLabelTest();
+
+#endif
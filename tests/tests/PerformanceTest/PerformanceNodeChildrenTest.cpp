@@ -7,12 +7,14 @@ enum {
 
     kTagBase = 20000,
 
-    TEST_COUNT = 4,
+    TEST_COUNT = 5,
 };
 
 enum {
     kMaxNodes = 15000,
     kNodesIncrease = 500,
+    kMoveTreeNodes = 10000,
+    kMoveTreeGroupSize = 100,
 };
 
 static int s_nCurCase = 0;
@@ -50,6 +52,9 @@ void NodeChildrenMenuLayer::showCurrentTest()
     case 3:
         pScene = new ReorderSpriteSheet();
         break;
+    case 4:
+        pScene = new MoveNodeTree();
+        break;
     }
     s_nCurCase = m_nCurCase;
 
@@ -553,6 +558,128 @@ std::string ReorderSpriteSheet::profilerName()
     return "reorder sprites";
 }
 
+////////////////////////////////////////////////////////
+//
+// MoveNodeTree
+//
+////////////////////////////////////////////////////////
+MoveNodeTree::MoveNodeTree()
+: rootNode(NULL)
+, leafNodes(NULL)
+{
+}
+
+MoveNodeTree::~MoveNodeTree()
+{
+    CC_SAFE_RELEASE(leafNodes);
+#if CC_ENABLE_PROFILERS
+    CCProfiler::releaseTimer(_profilingTimer);
+    _profilingTimer = NULL;
+#endif
+}
+
+void MoveNodeTree::initWithQuantityOfNodes(unsigned int nNodes)
+{
+    rootNode = CCNode::node();
+    addChild(rootNode);
+
+    leafNodes = CCArray::arrayWithCapacity(kMoveTreeNodes);
+    leafNodes->retain();
+
+    // the tree is measured with at least 10000 nodes, + and - change it from there
+    NodeChildrenMainScene::initWithQuantityOfNodes(MAX(nNodes, (unsigned int)kMoveTreeNodes));
+
+#if CC_ENABLE_PROFILERS
+    _profilingTimer = CCProfiler::timerWithName(profilerName().c_str(), this);
+#endif
+
+    scheduleUpdate();
+}
+
+void MoveNodeTree::updateQuantityOfNodes()
+{
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+
+    // increase nodes, kMoveTreeGroupSize leaves under each group node
+    while( currentQuantityOfNodes < quantityOfNodes )
+    {
+        if( currentQuantityOfNodes % kMoveTreeGroupSize == 0 )
+        {
+            CCNode *group = CCNode::node();
+            group->setPosition(ccp( CCRANDOM_0_1()*s.width, CCRANDOM_0_1()*s.height));
+            group->setRotation(CCRANDOM_0_1()*360);
+            rootNode->addChild(group);
+        }
+
+        CCNode *group = (CCNode*)rootNode->getChildren()->lastObject();
+        CCNode *leaf = CCNode::node();
+        leaf->setPosition(ccp( CCRANDOM_MINUS1_1()*50, CCRANDOM_MINUS1_1()*50));
+        group->addChild(leaf);
+        leafNodes->addObject(leaf);
+
+        currentQuantityOfNodes++;
+    }
+
+    // decrease nodes
+    while( currentQuantityOfNodes > quantityOfNodes )
+    {
+        CCNode *leaf = (CCNode*)leafNodes->lastObject();
+        CCNode *group = leaf->getParent();
+        group->removeChild(leaf, true);
+        leafNodes->removeLastObject();
+        if( group->getChildren()->count() == 0 )
+        {
+            rootNode->removeChild(group, true);
+        }
+
+        currentQuantityOfNodes--;
+    }
+}
+
+void MoveNodeTree::update(ccTime dt)
+{
+    unsigned int count = leafNodes->count();
+    if( count == 0 )
+        return;
+
+#if CC_ENABLE_PROFILERS
+    CCProfilingBeginTimingBlock(_profilingTimer);
+#endif
+
+    // move 1% of the nodes
+    for( unsigned int i = 0; i < count / 100; i++ )
+    {
+        CCNode *leaf = (CCNode*)leafNodes->objectAtIndex(rand() % count);
+        leaf->setPosition(ccp( CCRANDOM_MINUS1_1()*50, CCRANDOM_MINUS1_1()*50));
+    }
+
+    // and read the world transform of all of them, as particle systems and touch tests do
+    CCObject* pObject = NULL;
+    CCARRAY_FOREACH(leafNodes, pObject)
+    {
+        ((CCNode*)pObject)->nodeToWorldTransform();
+    }
+
+#if CC_ENABLE_PROFILERS
+    CCProfilingEndTimingBlock(_profilingTimer);
+#endif
+}
+
+std::string MoveNodeTree::title()
+{
+    return "F - Move 1% of a node tree";
+}
+
+std::string MoveNodeTree::subtitle()
+{
+    return "Move 1% of the nodes and get all world transforms. See console";
+}
+
+std::string MoveNodeTree::profilerName()
+{
+    return "move 1% of nodes";
+}
+
 void runNodeChildrenTest()
 {
     IterateSpriteSheet* pScene = new IterateSpriteSheetCArray();
@@ -115,6 +115,28 @@ public:
     virtual std::string profilerName();
 };
 
+class MoveNodeTree : public NodeChildrenMainScene
+{
+public:
+    MoveNodeTree();
+    ~MoveNodeTree();
+    virtual void updateQuantityOfNodes();
+    virtual void initWithQuantityOfNodes(unsigned int nNodes);
+    virtual void update(ccTime dt);
+
+    virtual std::string title();
+    virtual std::string subtitle();
+    virtual std::string profilerName();
+
+protected:
+    CCNode  *rootNode;
+    CCArray *leafNodes;
+
+#if CC_ENABLE_PROFILERS
+    CCProfilingTimer* _profilingTimer;
+#endif
+};
+
 void runNodeChildrenTest();
 
 #endif // __PERFORMANCE_NODE_CHILDREN_TEST_H__
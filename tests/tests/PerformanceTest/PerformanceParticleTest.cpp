@@ -14,10 +14,15 @@ enum {
 enum {
     kMaxParticles = 14000,
     kNodesIncrease = 100,
+    kBenchmarkWarmUpFrames = 180,
+    kBenchmarkFrames = 600,
 };
 
 static int s_nParCurIdx = 0;
 
+// defined in PerformanceTextureTest.cpp
+float calculateDeltaTime( struct timeval *lastUpdate );
+
 ////////////////////////////////////////////////////////
 //
 // ParticleMenuLayer
@@ -89,6 +94,14 @@ void ParticleMainScene::initWithSubTest(int asubtest, int particles)
     menu->setPosition(ccp(s.width/2, s.height/2+15));
     addChild(menu, 1);
 
+    CCMenuItemFont::setFontSize(30);
+    CCMenuItemFont *benchmark = CCMenuItemFont::itemFromString("Benchmark", this, menu_selector(ParticleMainScene::onBenchmark));
+    benchmark->setColor(ccc3(0,200,20));
+
+    CCMenu *benchmarkMenu = CCMenu::menuWithItems(benchmark, NULL);
+    benchmarkMenu->setPosition(ccp(s.width/2, s.height/2-40));
+    addChild(benchmarkMenu, 1);
+
     CCLabelTTF *infoLabel = CCLabelTTF::labelWithString("0 nodes", "Marker Felt", 30);
     infoLabel->setColor(ccc3(0,200,20));
     infoLabel->setPosition(ccp(s.width/2, s.height - 90));
@@ -249,6 +262,32 @@ void ParticleMainScene::testNCallback(CCObject* pSender)
     pMenu->restartCallback(pSender);
 }
 
+// Updates the emitter without rendering and logs how many particles are updated per millisecond
+void ParticleMainScene::onBenchmark(CCObject* pSender)
+{
+    createParticleSystem();
+    CCParticleSystem *emitter = (CCParticleSystem*) getChildByTag(kTagParticleSystem);
+
+    // let the emitter fill up
+    for (int i = 0; i < kBenchmarkWarmUpFrames; ++i)
+    {
+        emitter->update(1.0f / 60);
+    }
+
+    struct timeval now;
+    unsigned int nUpdated = 0;
+    gettimeofday(&now, NULL);
+    for (int i = 0; i < kBenchmarkFrames; ++i)
+    {
+        emitter->update(1.0f / 60);
+        nUpdated += emitter->getParticleCount();
+    }
+    float dt = calculateDeltaTime(&now);
+
+    CCLog("%s, %d particles: %f ms per update, %f particles/ms\n", title().c_str(), quantityParticles,
+        dt * 1000 / kBenchmarkFrames, nUpdated / (dt * 1000));
+}
+
 void ParticleMainScene::onIncrease(CCObject* pSender)
 {
     quantityParticles += kNodesIncrease;
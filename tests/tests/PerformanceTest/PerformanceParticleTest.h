@@ -21,6 +21,7 @@ public:
     void onDecrease(CCObject* pSender);
     void onIncrease(CCObject* pSender);
     void testNCallback(CCObject* pSender);
+    void onBenchmark(CCObject* pSender);
     void updateQuantityLabel();
     int getSubTestNum() { return subtestNumber; }
     int getParticlesNum() { return quantityParticles; }
@@ -0,0 +1,157 @@
+#include "PerformanceSchedulerTest.h"
+
+enum
+{
+    TEST_COUNT = 1,
+    kTicksPerTest = 600,
+};
+
+static int s_nSchedulerCurCase = 0;
+
+// defined in PerformanceTextureTest.cpp
+float calculateDeltaTime( struct timeval *lastUpdate );
+
+class SchedulerTimerTarget : public CCObject, public SelectorProtocol
+{
+public:
+    SchedulerTimerTarget() : m_nCalls(0) {}
+
+    void onTimer(ccTime dt)
+    {
+        m_nCalls++;
+    }
+
+    int m_nCalls;
+};
+
+////////////////////////////////////////////////////////
+//
+// SchedulerMenuLayer
+//
+////////////////////////////////////////////////////////
+void SchedulerMenuLayer::showCurrentTest()
+{
+    CCScene* pScene = NULL;
+
+    switch (m_nCurCase)
+    {
+    case 0:
+        pScene = SchedulerTimersTest::scene();
+        break;
+    }
+    s_nSchedulerCurCase = m_nCurCase;
+
+    if (pScene)
+    {
+        CCDirector::sharedDirector()->replaceScene(pScene);
+    }
+}
+
+void SchedulerMenuLayer::onEnter()
+{
+    PerformBasicLayer::onEnter();
+
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+
+    // Title
+    CCLabelTTF *label = CCLabelTTF::labelWithString(title().c_str(), "Arial", 40);
+    addChild(label, 1);
+    label->setPosition(ccp(s.width/2, s.height-32));
+    label->setColor(ccc3(255,255,40));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        CCLabelTTF *l = CCLabelTTF::labelWithString(strSubTitle.c_str(), "Thonburi", 16);
+        addChild(l, 1);
+        l->setPosition(ccp(s.width/2, s.height-80));
+    }
+
+    performTests();
+}
+
+std::string SchedulerMenuLayer::title()
+{
+    return "no title";
+}
+
+std::string SchedulerMenuLayer::subtitle()
+{
+    return "no subtitle";
+}
+
+////////////////////////////////////////////////////////
+//
+// SchedulerTimersTest
+//
+////////////////////////////////////////////////////////
+void SchedulerTimersTest::performTestsWithTimers(int nTimers)
+{
+    struct timeval now;
+    CCScheduler *pScheduler = CCScheduler::sharedScheduler();
+    CCMutableArray<SchedulerTimerTarget*> *pTargets = new CCMutableArray<SchedulerTimerTarget*>(nTimers);
+
+    // intervals between 1 and 5 seconds, most timers are not due in a given frame
+    for (int i = 0; i < nTimers; ++i)
+    {
+        SchedulerTimerTarget *pTarget = new SchedulerTimerTarget();
+        pScheduler->scheduleSelector(schedule_selector(SchedulerTimerTarget::onTimer), pTarget, 1.0f + (i % 400) / 100.0f, false);
+        pTargets->addObject(pTarget);
+        pTarget->release();
+    }
+
+    gettimeofday(&now, NULL);
+    for (int i = 0; i < kTicksPerTest; ++i)
+    {
+        pScheduler->tick(1.0f / 60);
+    }
+    float dt = calculateDeltaTime(&now);
+
+    int nCalls = 0;
+    for (unsigned int i = 0; i < pTargets->count(); ++i)
+    {
+        SchedulerTimerTarget *pTarget = pTargets->getObjectAtIndex(i);
+        nCalls += pTarget->m_nCalls;
+        pScheduler->unscheduleAllSelectorsForTarget(pTarget);
+    }
+    pTargets->release();
+
+    CCLog("%d timers: %f ms per tick, %d calls\n", nTimers, dt * 1000 / kTicksPerTest, nCalls);
+}
+
+void SchedulerTimersTest::performTests()
+{
+    CCLog("\n\n--------\n\n");
+
+    CCLog("--- %d ticks ---\n", kTicksPerTest);
+    performTestsWithTimers(10000);
+    performTestsWithTimers(100000);
+}
+
+std::string SchedulerTimersTest::title()
+{
+    return "Scheduler Performance Test";
+}
+
+std::string SchedulerTimersTest::subtitle()
+{
+    return "See console for results";
+}
+
+CCScene* SchedulerTimersTest::scene()
+{
+    CCScene *pScene = CCScene::node();
+    SchedulerTimersTest *layer = new SchedulerTimersTest(false, TEST_COUNT, s_nSchedulerCurCase);
+    pScene->addChild(layer);
+    layer->release();
+
+    return pScene;
+}
+
+void runSchedulerTest()
+{
+    s_nSchedulerCurCase = 0;
+    CCScene* pScene = SchedulerTimersTest::scene();
+    CCDirector::sharedDirector()->replaceScene(pScene);
+}
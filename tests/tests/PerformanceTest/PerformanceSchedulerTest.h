@@ -0,0 +1,40 @@
+#ifndef __PERFORMANCE_SCHEDULER_TEST_H__
+#define __PERFORMANCE_SCHEDULER_TEST_H__
+
+#include "PerformanceTest.h"
+
+class SchedulerMenuLayer : public PerformBasicLayer
+{
+public:
+    SchedulerMenuLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void showCurrentTest();
+
+    virtual void onEnter();
+    virtual std::string title();
+    virtual std::string subtitle();
+    virtual void performTests() = 0;
+};
+
+class SchedulerTimersTest : public SchedulerMenuLayer
+{
+public:
+    SchedulerTimersTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :SchedulerMenuLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void performTests();
+    virtual std::string title();
+    virtual std::string subtitle();
+    void performTestsWithTimers(int nTimers);
+
+    static CCScene* scene();
+};
+
+void runSchedulerTest();
+
+#endif
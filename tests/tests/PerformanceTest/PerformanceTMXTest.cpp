@@ -0,0 +1,326 @@
+#include "PerformanceTMXTest.h"
+
+enum
+{
+    TEST_COUNT = 2,
+    kTMXLoadRepeat = 20,
+    kTMXEditRepeat = 10,
+    kTMXScrollStep = 64,
+    kTagTMXTimedNode = 1,
+};
+
+static const char* s_pTMXFiles[] =
+{
+    "TileMaps/hexa-test.tmx",
+    "TileMaps/iso-test.tmx",
+    "TileMaps/iso-test1.tmx",
+    "TileMaps/iso-test2.tmx",
+    "TileMaps/iso-test2-uncompressed.tmx",
+    "TileMaps/iso-test-objectgroup.tmx",
+    "TileMaps/ortho-objects.tmx",
+    "TileMaps/orthogonal-test1.tmx",
+    "TileMaps/orthogonal-test2.tmx",
+    "TileMaps/orthogonal-test3.tmx",
+    "TileMaps/orthogonal-test4.tmx",
+    "TileMaps/orthogonal-test5.tmx",
+    "TileMaps/orthogonal-test6.tmx",
+    "TileMaps/orthogonal-test-zorder.tmx",
+    "TileMaps/test-object-layer.tmx",
+};
+
+static float millisecondsSince(struct timeval *lastUpdate)
+{
+    struct timeval now;
+
+    gettimeofday( &now, NULL);
+
+    return (now.tv_sec - lastUpdate->tv_sec) * 1000.0f + (now.tv_usec - lastUpdate->tv_usec) / 1000.0f;
+}
+
+static void showTMXTest(int nCase)
+{
+    CCScene* pScene = NULL;
+
+    switch (nCase)
+    {
+    case 0:
+        pScene = TMXLoadTest::scene();
+        break;
+    case 1:
+        pScene = TMXChunkTest::scene();
+        break;
+    }
+
+    if (pScene)
+    {
+        CCDirector::sharedDirector()->replaceScene(pScene);
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// TMXLoadTest
+//
+////////////////////////////////////////////////////////
+void TMXLoadTest::showCurrentTest()
+{
+    showTMXTest(m_nCurCase);
+}
+
+void TMXLoadTest::onEnter()
+{
+    PerformBasicLayer::onEnter();
+
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+
+    // Title
+    CCLabelTTF *label = CCLabelTTF::labelWithString(title().c_str(), "Arial", 40);
+    addChild(label, 1);
+    label->setPosition(ccp(s.width/2, s.height-32));
+    label->setColor(ccc3(255,255,40));
+
+    // Subtitle
+    CCLabelTTF *l = CCLabelTTF::labelWithString(subtitle().c_str(), "Thonburi", 16);
+    addChild(l, 1);
+    l->setPosition(ccp(s.width/2, s.height-80));
+
+    performTests();
+}
+
+void TMXLoadTest::performTests()
+{
+    struct timeval now;
+    float totalMs = 0;
+
+    CCLog("\n\n--------\n\n");
+    CCLog("--- TMX parse, average of %d loads ---\n", (int)kTMXLoadRepeat);
+
+    for (unsigned int i = 0; i < sizeof(s_pTMXFiles) / sizeof(s_pTMXFiles[0]); ++i)
+    {
+        // the first load reads the file, the others parse it from the file cache
+        CCTMXMapInfo *mapInfo = CCTMXMapInfo::formatWithTMXFile(s_pTMXFiles[i]);
+        if (! mapInfo)
+        {
+            CCLog("%s ERROR\n", s_pTMXFiles[i]);
+            continue;
+        }
+
+        gettimeofday(&now, NULL);
+        for (int j = 0; j < kTMXLoadRepeat; ++j)
+        {
+            mapInfo = new CCTMXMapInfo();
+            mapInfo->initWithTMXFile(s_pTMXFiles[i]);
+            mapInfo->release();
+        }
+        float ms = millisecondsSince(&now) / kTMXLoadRepeat;
+        totalMs += ms;
+
+        CCLog("%s  ms:%f\n", s_pTMXFiles[i], ms);
+    }
+
+    CCLog("total  ms:%f\n", totalMs);
+}
+
+std::string TMXLoadTest::title()
+{
+    return "TMX Load Performance Test";
+}
+
+std::string TMXLoadTest::subtitle()
+{
+    return "See console for results";
+}
+
+CCScene* TMXLoadTest::scene()
+{
+    CCScene *pScene = CCScene::node();
+    TMXLoadTest *layer = new TMXLoadTest(true, TEST_COUNT, 0);
+    pScene->addChild(layer);
+    layer->release();
+
+    return pScene;
+}
+
+////////////////////////////////////////////////////////
+//
+// TMXTimedNode
+//
+////////////////////////////////////////////////////////
+void TMXTimedNode::visit()
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+
+    CCNode::visit();
+
+    m_fTotalMs += millisecondsSince(&now);
+    m_nFrames++;
+}
+
+float TMXTimedNode::popAverageMs()
+{
+    float ms = m_nFrames > 0 ? m_fTotalMs / m_nFrames : 0;
+    m_fTotalMs = 0;
+    m_nFrames = 0;
+    return ms;
+}
+
+////////////////////////////////////////////////////////
+//
+// TMXChunkTest
+//
+////////////////////////////////////////////////////////
+void TMXChunkTest::showCurrentTest()
+{
+    showTMXTest(m_nCurCase);
+}
+
+void TMXChunkTest::onEnter()
+{
+    PerformBasicLayer::onEnter();
+
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+
+    // the map is drawn under the labels, its visit times the chunks built and evicted while it scrolls
+    TMXTimedNode *timedNode = new TMXTimedNode();
+    addChild(timedNode, -1, kTagTMXTimedNode);
+    timedNode->release();
+
+    m_pMap = CCTMXTiledMap::tiledMapWithTMXFile("TileMaps/orthogonal-test2.tmx");
+    timedNode->addChild(m_pMap);
+    m_nFrames = 0;
+    m_nPasses = 0;
+
+    // Title
+    CCLabelTTF *label = CCLabelTTF::labelWithString(title().c_str(), "Arial", 40);
+    addChild(label, 1);
+    label->setPosition(ccp(s.width/2, s.height-32));
+    label->setColor(ccc3(255,255,40));
+
+    // Subtitle
+    CCLabelTTF *l = CCLabelTTF::labelWithString(subtitle().c_str(), "Thonburi", 16);
+    addChild(l, 1);
+    l->setPosition(ccp(s.width/2, s.height-80));
+
+    scheduleUpdate();
+}
+
+void TMXChunkTest::update(ccTime dt)
+{
+    // the chunks on the screen are built by the first frame, edits then rewrite their quads
+    if (++m_nFrames == 2)
+    {
+        performEditTests();
+        ((TMXTimedNode*)getChildByTag(kTagTMXTimedNode))->popAverageMs();
+        return;
+    }
+    if (m_nFrames < 2)
+    {
+        return;
+    }
+
+    // scroll the map row by row, the chunks leaving the screen are evicted for the new ones
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+    CCSize mapSize = m_pMap->getContentSize();
+    CCPoint pos = m_pMap->getPosition();
+    pos.x -= kTMXScrollStep;
+    if (pos.x < s.width - mapSize.width)
+    {
+        pos.x = 0;
+        pos.y -= s.height / 2;
+        if (pos.y < s.height - mapSize.height)
+        {
+            pos.y = 0;
+            float ms = ((TMXTimedNode*)getChildByTag(kTagTMXTimedNode))->popAverageMs();
+            CCLog("scroll pass %d  visit ms per frame:%f\n", ++m_nPasses, ms);
+        }
+    }
+    m_pMap->setPosition(pos);
+}
+
+void TMXChunkTest::performEditTests()
+{
+    struct timeval now;
+
+    CCTMXLayer *layer = m_pMap->layerNamed("Layer 0");
+    unsigned int width = (unsigned int)layer->getLayerSize().width;
+    unsigned int height = (unsigned int)layer->getLayerSize().height;
+    unsigned int tiles = width * height;
+    unsigned int firstGid = layer->getTileSet()->m_uFirstGid;
+
+    std::vector<unsigned int> gids(tiles);
+    for (unsigned int i = 0; i < tiles; ++i)
+    {
+        gids[i] = layer->tileGIDAt(ccp((float)(i % width), (float)(i / width)));
+    }
+
+    CCLog("\n\n--------\n\n");
+    CCLog("--- TMX tile edits, %u tiles, %d passes ---\n", tiles, (int)kTMXEditRepeat);
+
+    // setTileGID on every tile, to another gid and back
+    gettimeofday(&now, NULL);
+    for (int j = 0; j < kTMXEditRepeat; ++j)
+    {
+        for (unsigned int i = 0; i < tiles; ++i)
+        {
+            CCPoint pos = ccp((float)(i % width), (float)(i / width));
+            layer->setTileGID(gids[i] == firstGid ? firstGid + 1 : firstGid, pos);
+            layer->setTileGID(gids[i], pos);
+        }
+    }
+    float setMs = millisecondsSince(&now);
+
+    // removeTileAt on every tile, then setTileGID to put them back
+    float removeMs = 0, restoreMs = 0;
+    for (int j = 0; j < kTMXEditRepeat; ++j)
+    {
+        gettimeofday(&now, NULL);
+        for (unsigned int i = 0; i < tiles; ++i)
+        {
+            layer->removeTileAt(ccp((float)(i % width), (float)(i / width)));
+        }
+        removeMs += millisecondsSince(&now);
+
+        gettimeofday(&now, NULL);
+        for (unsigned int i = 0; i < tiles; ++i)
+        {
+            if (gids[i])
+            {
+                layer->setTileGID(gids[i], ccp((float)(i % width), (float)(i / width)));
+            }
+        }
+        restoreMs += millisecondsSince(&now);
+    }
+
+    // the time of a call, it must not depend on the number of tiles
+    float calls = (float)tiles * kTMXEditRepeat;
+    CCLog("setTileGID  us:%f\n", setMs * 1000 / (calls * 2));
+    CCLog("removeTileAt  us:%f\n", removeMs * 1000 / calls);
+    CCLog("setTileGID on empty tiles  us:%f\n", restoreMs * 1000 / calls);
+}
+
+std::string TMXChunkTest::title()
+{
+    return "TMX Chunk Performance Test";
+}
+
+std::string TMXChunkTest::subtitle()
+{
+    return "Tile edits, then scrolling. See console for results";
+}
+
+CCScene* TMXChunkTest::scene()
+{
+    CCScene *pScene = CCScene::node();
+    TMXChunkTest *layer = new TMXChunkTest(true, TEST_COUNT, 1);
+    pScene->addChild(layer);
+    layer->release();
+
+    return pScene;
+}
+
+void runTMXTest()
+{
+    CCScene* pScene = TMXLoadTest::scene();
+    CCDirector::sharedDirector()->replaceScene(pScene);
+}
@@ -0,0 +1,63 @@
+#ifndef __PERFORMANCE_TMX_TEST_H__
+#define __PERFORMANCE_TMX_TEST_H__
+
+#include "PerformanceTest.h"
+
+class TMXLoadTest : public PerformBasicLayer
+{
+public:
+    TMXLoadTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void showCurrentTest();
+    virtual void onEnter();
+    virtual std::string title();
+    virtual std::string subtitle();
+    void performTests();
+
+    static CCScene* scene();
+};
+
+// times the visits of its children
+class TMXTimedNode : public CCNode
+{
+public:
+    TMXTimedNode() : m_fTotalMs(0), m_nFrames(0) {}
+
+    virtual void visit();
+    // the average visit time since the last call
+    float popAverageMs();
+
+protected:
+    float m_fTotalMs;
+    int   m_nFrames;
+};
+
+class TMXChunkTest : public PerformBasicLayer
+{
+public:
+    TMXChunkTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void showCurrentTest();
+    virtual void onEnter();
+    virtual void update(ccTime dt);
+    virtual std::string title();
+    virtual std::string subtitle();
+    void performEditTests();
+
+    static CCScene* scene();
+
+protected:
+    CCTMXTiledMap *m_pMap;
+    int m_nFrames;
+    int m_nPasses;
+};
+
+void runTMXTest();
+
+#endif
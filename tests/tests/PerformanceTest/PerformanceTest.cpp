@@ -2,13 +2,17 @@
 #include "../testResource.h"
 #include "PerformanceNodeChildrenTest.h"
 #include "PerformanceParticleTest.h"
+#include "PerformanceSchedulerTest.h"
 #include "PerformanceSpriteTest.h"
 #include "PerformanceTextureTest.h"
 #include "PerformanceTouchesTest.h"
+#include "PerformanceTMXTest.h"
+#include "PerformanceLabelTest.h"
+#include "support/CCProfiling.h"
 
 enum
 {
-    MAX_COUNT = 5,
+    MAX_COUNT = 8,
     LINE_SPACE = 40,
     kItemTagBasic = 1000,
 };
@@ -17,9 +21,12 @@ const std::string testsName[MAX_COUNT] =
 {
     "PerformanceNodeChildrenTest",
     "PerformanceParticleTest",
+    "PerformanceSchedulerTest",
     "PerformanceSpriteTest",
     "PerformanceTextureTest",
-    "PerformanceTouchesTest"
+    "PerformanceTouchesTest",
+    "PerformanceTMXTest",
+    "PerformanceLabelTest"
 };
 
 ////////////////////////////////////////////////////////
@@ -62,14 +69,23 @@ void PerformanceMainLayer::menuCallback(CCObject* pSender)
         runParticleTest();
         break;
     case 2:
-        runSpriteTest();
+        runSchedulerTest();
         break;
     case 3:
-        runTextureTest();
+        runSpriteTest();
         break;
     case 4:
+        runTextureTest();
+        break;
+    case 5:
         runTouchesTest();
         break;
+    case 6:
+        runTMXTest();
+        break;
+    case 7:
+        runLabelTest();
+        break;
     default:
         break;
     }
@@ -115,9 +131,56 @@ void PerformBasicLayer::onEnter()
         pMenu->addChild(item2, kItemTagBasic);
         pMenu->addChild(item3, kItemTagBasic);
     }
+
+    // the frame profiler records every test while it is on, dump writes what it recorded
+    CCMenuItemFont* pProfilerItem = CCMenuItemFont::itemFromString(profilerItemString(), this,
+                                                    menu_selector(PerformBasicLayer::toggleProfiler));
+    pProfilerItem->setPosition(ccp(80, 25));
+    pMenu->addChild(pProfilerItem, kItemTagBasic);
+
+    CCMenuItemFont* pDumpItem = CCMenuItemFont::itemFromString("Dump", this,
+                                                    menu_selector(PerformBasicLayer::dumpProfiler));
+    pDumpItem->setPosition(ccp(180, 25));
+    pMenu->addChild(pDumpItem, kItemTagBasic);
+
     addChild(pMenu);
 }
 
+const char* PerformBasicLayer::profilerItemString()
+{
+    return CCFrameProfiler::isRecording() ? "Profiler: on" : "Profiler: off";
+}
+
+void PerformBasicLayer::toggleProfiler(CCObject* pSender)
+{
+    CCFrameProfiler* pProfiler = CCFrameProfiler::sharedFrameProfiler();
+    pProfiler->clear();
+    pProfiler->setIsEnabled(! pProfiler->getIsEnabled());
+
+    ((CCMenuItemFont*)pSender)->setString(profilerItemString());
+}
+
+void PerformBasicLayer::dumpProfiler(CCObject* pSender)
+{
+    CCFrameProfiler* pProfiler = CCFrameProfiler::sharedFrameProfiler();
+    if (pProfiler->getFrameCount() == 0)
+    {
+        CCLog("frame profiler: no frame recorded, turn the profiler on first\n");
+        return;
+    }
+
+    std::string statsPath = CCFileUtils::getWriteablePath() + "frame_profile.json";
+    std::string tracePath = CCFileUtils::getWriteablePath() + "frame_trace.json";
+    if (pProfiler->dumpStatsToFile(statsPath.c_str()) && pProfiler->dumpChromeTraceToFile(tracePath.c_str()))
+    {
+        CCLog("frame profiler: %u frames written to %s and %s\n", pProfiler->getFrameCount(), statsPath.c_str(), tracePath.c_str());
+    }
+    else
+    {
+        CCLog("frame profiler: can't write %s\n", statsPath.c_str());
+    }
+}
+
 void PerformBasicLayer::toMainLayer(CCObject* pSender)
 {
     PerformanceTestScene* pScene = new PerformanceTestScene();
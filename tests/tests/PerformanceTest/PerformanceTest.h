@@ -24,7 +24,14 @@ public:
 
     virtual void toMainLayer(CCObject* pSender);
 
+    // turns the frame profiler on and off, and writes its statistics and trace
+    void toggleProfiler(CCObject* pSender);
+    void dumpProfiler(CCObject* pSender);
+
 protected:
+    static const char* profilerItemString();
+
+
     bool m_bControlMenuVisible;
     int  m_nMaxCases;
     int  m_nCurCase;
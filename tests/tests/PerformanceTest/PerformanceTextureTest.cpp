@@ -1,8 +1,9 @@
 #include "PerformanceTextureTest.h"
+#include "support/image_support/ccPixelConvert.h"
 
 enum
 {
-    TEST_COUNT = 1,
+    TEST_COUNT = 2,
 };
 
 static int s_nTexCurCase = 0;
@@ -32,6 +33,9 @@ void TextureMenuLayer::showCurrentTest()
     case 0:
         pScene = TextureTest::scene();
         break;
+    case 1:
+        pScene = PixelConvertTest::scene();
+        break;
     }
     s_nTexCurCase = m_nCurCase;
 
@@ -345,7 +349,164 @@ std::string TextureTest::subtitle()
 CCScene* TextureTest::scene()
 {
     CCScene *pScene = CCScene::node();
-    TextureTest *layer = new TextureTest(false, TEST_COUNT, s_nTexCurCase);
+    TextureTest *layer = new TextureTest(true, TEST_COUNT, s_nTexCurCase);
+    pScene->addChild(layer);
+    layer->release();
+
+    return pScene;
+}
+
+////////////////////////////////////////////////////////
+//
+// PixelConvertTest
+//
+////////////////////////////////////////////////////////
+enum
+{
+    kPixelImageWidth = 1000,
+    kPixelImageHeight = 1000,
+    kPixelTextureSize = 1024,
+};
+
+static unsigned char* s_pPixelImage = NULL;
+
+// the conversion CCTexture2D did before ccPixelConvert: pad to 8888, then repack the whole texture
+static void convertImageReference(CCTexture2DPixelFormat format, unsigned char* pOut)
+{
+    unsigned int length = kPixelTextureSize * kPixelTextureSize;
+    unsigned char* data = new unsigned char[length * 4];
+    memset(data, 0, length * 4);
+    for (int y = 0; y < kPixelImageHeight; ++y)
+    {
+        memcpy(data + kPixelTextureSize * 4 * y, s_pPixelImage + kPixelImageWidth * 4 * y, kPixelImageWidth * 4);
+    }
+
+    unsigned int* inPixel32 = (unsigned int*)data;
+    unsigned short* outPixel16 = (unsigned short*)pOut;
+    for (unsigned int i = 0; i < length; ++i, ++inPixel32)
+    {
+        switch (format)
+        {
+        case kCCTexture2DPixelFormat_RGB565:
+            *outPixel16++ =
+                ((((*inPixel32 >> 16) & 0xFF) >> 3) << 0) |
+                ((((*inPixel32 >> 8) & 0xFF) >> 2) << 5) |
+                ((((*inPixel32 >> 0) & 0xFF) >> 3) << 11);
+            break;
+        case kCCTexture2DPixelFormat_RGB5A1:
+            *outPixel16++ =
+                ((((*inPixel32 >> 16) & 0xFF) >> 3) << 1) |
+                ((((*inPixel32 >> 8) & 0xFF) >> 3) << 6) |
+                ((((*inPixel32 >> 0) & 0xFF) >> 3) << 11) |
+                ((((*inPixel32 >> 24) & 0xFF) >> 7) << 0);
+            break;
+        case kCCTexture2DPixelFormat_RGBA4444:
+            *outPixel16++ =
+                ((((*inPixel32 >> 0) & 0xFF) >> 4) << 12) |
+                ((((*inPixel32 >> 8) & 0xFF) >> 4) << 8) |
+                ((((*inPixel32 >> 16) & 0xFF) >> 4) << 4) |
+                ((((*inPixel32 >> 24) & 0xFF) >> 4) << 0);
+            break;
+        case kCCTexture2DPixelFormat_A8:
+            pOut[i] = (unsigned char)(*inPixel32 >> 24);
+            break;
+        default:
+            break;
+        }
+    }
+
+    delete [] data;
+}
+
+void PixelConvertTest::performTestsFormat(CCTexture2DPixelFormat format, const char* name)
+{
+    struct timeval now;
+    unsigned int size = kPixelTextureSize * kPixelTextureSize * ccPixelBytesPerPixel(format);
+    unsigned char* pExpected = new unsigned char[size];
+    unsigned char* pResult = new unsigned char[size];
+
+    CCLog("%s", name);
+
+    gettimeofday(&now, NULL);
+    convertImageReference(format, pExpected);
+    CCLog("  two passes ms:%f\n", calculateDeltaTime(&now) * 1000);
+
+    gettimeofday(&now, NULL);
+    ccPixelConvertImage(s_pPixelImage, kCCTexture2DPixelFormat_RGBA8888, kPixelImageWidth, kPixelImageHeight, kPixelImageWidth * 4,
+        pResult, format, kPixelTextureSize, kPixelTextureSize);
+    CCLog("  ccPixelConvertImage ms:%f\n", calculateDeltaTime(&now) * 1000);
+
+    CCLog("  %s\n", memcmp(pExpected, pResult, size) == 0 ? "identical" : "ERROR: results differ");
+
+    delete [] pExpected;
+    delete [] pResult;
+}
+
+void PixelConvertTest::performTests()
+{
+    struct timeval now;
+    unsigned int length = kPixelImageWidth * kPixelImageHeight;
+
+    // every alpha with every component value, then noise
+    s_pPixelImage = new unsigned char[length * 4];
+    unsigned int seed = 1;
+    for (unsigned int i = 0; i < length * 4; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        s_pPixelImage[i] = (unsigned char)(seed >> 16);
+    }
+    for (unsigned int i = 0; i < 65536; ++i)
+    {
+        s_pPixelImage[i * 4] = (unsigned char)i;
+        s_pPixelImage[i * 4 + 3] = (unsigned char)(i >> 8);
+    }
+
+    CCLog("\n\n--------\n\n");
+    CCLog("--- %dx%d to %dx%d ---\n", kPixelImageWidth, kPixelImageHeight, kPixelTextureSize, kPixelTextureSize);
+
+    // premultiply, the way CCImage used to do it
+    CCLog("Premultiply");
+    unsigned int* pExpected = new unsigned int[length];
+    unsigned char* pResult = new unsigned char[length * 4];
+    gettimeofday(&now, NULL);
+    for (unsigned int i = 0; i < length; ++i)
+    {
+        unsigned char* p = s_pPixelImage + i * 4;
+        unsigned int a = p[3] + 1;
+        pExpected[i] = ((p[0] * a) >> 8) | (((p[1] * a) >> 8) << 8) | (((p[2] * a) >> 8) << 16) | ((unsigned int)p[3] << 24);
+    }
+    CCLog("  scalar ms:%f\n", calculateDeltaTime(&now) * 1000);
+
+    gettimeofday(&now, NULL);
+    ccPixelPremultiplyRGBA8888(s_pPixelImage, pResult, length);
+    CCLog("  ccPixelPremultiplyRGBA8888 ms:%f\n", calculateDeltaTime(&now) * 1000);
+    CCLog("  %s\n", memcmp(pExpected, pResult, length * 4) == 0 ? "identical" : "ERROR: results differ");
+    delete [] pExpected;
+    delete [] pResult;
+
+    performTestsFormat(kCCTexture2DPixelFormat_RGB565, "RGB 565");
+    performTestsFormat(kCCTexture2DPixelFormat_RGB5A1, "RGBA 5551");
+    performTestsFormat(kCCTexture2DPixelFormat_RGBA4444, "RGBA 4444");
+    performTestsFormat(kCCTexture2DPixelFormat_A8, "A 8");
+
+    delete [] s_pPixelImage;
+    s_pPixelImage = NULL;
+}
+
+std::string PixelConvertTest::title()
+{
+    return "Pixel Conversion Test";
+}
+
+std::string PixelConvertTest::subtitle()
+{
+    return "See console for results";
+}
+
+CCScene* PixelConvertTest::scene()
+{
+    CCScene *pScene = CCScene::node();
+    PixelConvertTest *layer = new PixelConvertTest(true, TEST_COUNT, s_nTexCurCase);
     pScene->addChild(layer);
     layer->release();
 
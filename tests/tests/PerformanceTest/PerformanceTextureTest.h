@@ -35,6 +35,22 @@ public:
     static CCScene* scene();
 };
 
+class PixelConvertTest : public TextureMenuLayer
+{
+public:
+    PixelConvertTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :TextureMenuLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void performTests();
+    virtual std::string title();
+    virtual std::string subtitle();
+    void performTestsFormat(CCTexture2DPixelFormat format, const char* name);
+
+    static CCScene* scene();
+};
+
 void runTextureTest();
 
 #endif